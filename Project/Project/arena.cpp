@@ -0,0 +1,151 @@
+/*
+* FILENAME      : arena.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the bump allocator declared in arena.h.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "metrics.h"
+
+// chunk payloads start after the header, rounded up so the first allocation is aligned
+#define CHUNK_HEADER_SIZE   ((sizeof(ArenaChunk) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+/*
+* FUNCTION      : initArena
+* DESCRIPTION   : This functoin prepares an empty arena, no memory is reserved until the first allocation.
+* PARAMETERS    :
+*   Arena* arena        :   the arena to be initialised.
+*   size_t chunkSize    :   the size of each chunk requested from the system.
+* RETURNS       : void
+*/
+void initArena(Arena* arena, size_t chunkSize)
+{
+    arena->Head = NULL;
+    arena->ChunkSize = chunkSize;
+    arena->ChunkCount = 0;
+    arena->BytesReserved = 0;
+    arena->BytesUsed = 0;
+}
+
+/*
+* FUNCTION      : arenaAlloc
+* DESCRIPTION   :
+*   This functoin returns a block of at least size bytes aligned to ARENA_ALIGNMENT. A new chunk is
+*   requested when the current one is full; requests larger than a chunk get a chunk of their own.
+* PARAMETERS    :
+*   Arena* arena    :   the arena to allocate from.
+*   size_t size     :   the number of bytes needed.
+* RETURNS       :
+*   void*   : the start of the block, it stays valid until the arena is released.
+*/
+void* arenaAlloc(Arena* arena, size_t size)
+{
+    size_t padded = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    ArenaChunk* chunk = arena->Head;
+
+    if (chunk == NULL || chunk->Size - chunk->Used < padded)
+    {
+        size_t chunkSize = padded > arena->ChunkSize ? padded : arena->ChunkSize;
+        chunk = (ArenaChunk*)malloc(CHUNK_HEADER_SIZE + chunkSize);
+        if (chunk == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+        chunk->Size = chunkSize;
+        chunk->Used = 0;
+        chunk->Next = arena->Head;
+        arena->Head = chunk;
+        arena->ChunkCount++;
+        arena->BytesReserved += chunkSize;
+        METRIC_ADD(METRIC_ARENA_CHUNKS, 1);
+    }
+
+    void* block = (char*)chunk + CHUNK_HEADER_SIZE + chunk->Used;
+    chunk->Used += padded;
+    arena->BytesUsed += padded;
+    METRIC_ADD(METRIC_ARENA_ALLOCS, 1);
+    METRIC_ADD(METRIC_ARENA_BYTES, padded);
+    return block;
+}
+
+/*
+* FUNCTION      : arenaStrDup
+* DESCRIPTION   : This functoin copies a string of a given length into the arena and terminates it.
+* PARAMETERS    :
+*   Arena* arena        :   the arena to allocate from.
+*   const char* str     :   the string to be copied, it does not need to be null terminated.
+*   size_t len          :   the number of bytes to copy.
+* RETURNS       :
+*   char*   : the null terminated copy.
+*/
+char* arenaStrDup(Arena* arena, const char* str, size_t len)
+{
+    char* copy = (char*)arenaAlloc(arena, len + 1);
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+/*
+* FUNCTION      : adoptArena
+* DESCRIPTION   :
+*   This functoin hands every chunk of a source arena to a target arena, so blocks carved from the
+*   source are released together with the target. The source is left empty. The target keeps carving
+*   from its current chunk.
+* PARAMETERS    :
+*   Arena* target   :   the arena taking ownership.
+*   Arena* source   :   the arena giving up its chunks.
+* RETURNS       : void
+*/
+void adoptArena(Arena* target, Arena* source)
+{
+    ArenaChunk* last = source->Head;
+    if (last == NULL)
+    {
+        return;
+    }
+    while (last->Next != NULL)
+    {
+        last = last->Next;
+    }
+    if (target->Head == NULL)
+    {
+        target->Head = source->Head;
+    }
+    else
+    {
+        last->Next = target->Head->Next;
+        target->Head->Next = source->Head;
+    }
+    target->ChunkCount += source->ChunkCount;
+    target->BytesReserved += source->BytesReserved;
+    target->BytesUsed += source->BytesUsed;
+    initArena(source, source->ChunkSize);
+}
+
+/*
+* FUNCTION      : releaseArena
+* DESCRIPTION   : This functoin returns every chunk to the system, invalidating all blocks of the arena.
+* PARAMETERS    :
+*   Arena* arena    :   the arena to be released.
+* RETURNS       : void
+*/
+void releaseArena(Arena* arena)
+{
+    ArenaChunk* chunk = arena->Head;
+    while (chunk != NULL)
+    {
+        ArenaChunk* next = chunk->Next;
+        free(chunk);
+        chunk = next;
+    }
+    initArena(arena, arena->ChunkSize);
+}
@@ -0,0 +1,37 @@
+/*
+* FILENAME      : arena.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares a bump allocator. Memory is carved out of large chunks and is never freed one
+*   object at a time; the whole arena is released at once when its owner is torn down.
+*/
+
+#pragma once
+#include <stddef.h>
+
+#define ARENA_CHUNK_SIZE    (1u << 20)      // 1 MiB per chunk
+#define ARENA_ALIGNMENT     16
+
+typedef struct ArenaChunk
+{
+    ArenaChunk* Next;
+    size_t Size;            // usable bytes after the header
+    size_t Used;
+} ArenaChunk;
+
+typedef struct Arena
+{
+    ArenaChunk* Head;       // the chunk currently being carved, older chunks follow it
+    size_t ChunkSize;
+    size_t ChunkCount;
+    size_t BytesReserved;   // total size of all chunks
+    size_t BytesUsed;       // total size of all allocations, including alignment padding
+} Arena;
+
+void initArena(Arena* arena, size_t chunkSize);
+void* arenaAlloc(Arena* arena, size_t size);
+char* arenaStrDup(Arena* arena, const char* str, size_t len);
+void adoptArena(Arena* target, Arena* source);
+void releaseArena(Arena* arena);
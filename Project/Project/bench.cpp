@@ -0,0 +1,487 @@
+/*
+* FILENAME      : bench.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the generator and the benchmark harness declared in bench.h. Both draw from
+*   the same small seeded generator, so a run can be repeated exactly.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "bench.h"
+#include "destTable.h"
+#include "loader.h"
+#include "output.h"
+#include "query.h"
+
+// the latencies of one timed operation
+typedef struct BenchSamples
+{
+    uint64_t* Nanos;
+    size_t Count;
+    uint64_t TotalNanos;
+} BenchSamples;
+
+static uint64_t nextRandom(uint64_t* state);
+static double nextUnit(uint64_t* state);
+static uint64_t benchNow(void);
+static void initSamples(BenchSamples* samples, size_t count);
+static void addSample(BenchSamples* samples, uint64_t start);
+static int compareNanos(const void* a, const void* b);
+static void reportSamples(const char* name, BenchSamples* samples);
+
+/*
+* FUNCTION      : initGenOptions
+* DESCRIPTION   : This functoin sets the generator options to their defaults.
+* PARAMETERS    :
+*   GenOptions* options :   the options to be initialised.
+* RETURNS       : void
+*/
+void initGenOptions(GenOptions* options)
+{
+    options->Rows = 1000000;
+    options->Countries = 200;
+    options->Skew = 1.0;
+    options->Order = ORDER_RANDOM;
+    options->Duplicates = 0.0;
+    options->Seed = 1;
+}
+
+/*
+* FUNCTION      : parseWeightOrder
+* DESCRIPTION   : This functoin converts the name of a weight order: random, sorted or reverse.
+* PARAMETERS    :
+*   const char* name    :   the name.
+*   WeightOrder* order  :   receives the order.
+* RETURNS       :
+*   bool    : true, if the name is known. otherwise, false.
+*/
+bool parseWeightOrder(const char* name, WeightOrder* order)
+{
+    if (strcmp(name, "random") == 0)
+    {
+        *order = ORDER_RANDOM;
+    }
+    else if (strcmp(name, "sorted") == 0)
+    {
+        *order = ORDER_SORTED;
+    }
+    else if (strcmp(name, "reverse") == 0)
+    {
+        *order = ORDER_REVERSE;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/*
+* FUNCTION      : generateCouriers
+* DESCRIPTION   :
+*   This functoin writes a synthetic courier file. Destination k (counted from 1) is named "Country k"
+*   and is picked with a probability proportional to 1 / k^Skew. Weights are uniform, or rise or fall
+*   steadily over the file; a duplicate repeats one of the last BENCH_RECENT_ROWS lines, so a sorted
+*   file stays sorted except for those repeats. The file is streamed, so its size is not limited by
+*   memory.
+* PARAMETERS    :
+*   const char* path            :   the file to be written.
+*   const GenOptions* options   :   the shape of the data.
+* RETURNS       :
+*   bool    : true, if the whole file was written. otherwise, false.
+*/
+bool generateCouriers(const char* path, const GenOptions* options)
+{
+    unsigned int countries = options->Countries > 0 ? options->Countries : 1;
+    uint64_t state = options->Seed != 0 ? options->Seed : 1;
+    double* cumulative = (double*)malloc(countries * sizeof(double));
+    unsigned int* recentDest = (unsigned int*)malloc(BENCH_RECENT_ROWS * sizeof(unsigned int));
+    int* recentWeight = (int*)malloc(BENCH_RECENT_ROWS * sizeof(int));
+    int64_t* recentCents = (int64_t*)malloc(BENCH_RECENT_ROWS * sizeof(int64_t));
+    if (cumulative == NULL || recentDest == NULL || recentWeight == NULL || recentCents == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    FILE* file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        free(cumulative);
+        free(recentDest);
+        free(recentWeight);
+        free(recentCents);
+        return false;
+    }
+
+    double total = 0.0;
+    for (unsigned int k = 0; k < countries; ++k)
+    {
+        total += 1.0 / pow((double)(k + 1), options->Skew);
+        cumulative[k] = total;
+    }
+
+    OutBuf out;
+    initOutBuf(&out, file);
+    uint64_t fresh = 0;         // lines generated rather than repeated, the next one goes to slot fresh % BENCH_RECENT_ROWS
+    size_t recent = 0;          // slots of the ring written so far, the ones a duplicate may repeat
+    for (uint64_t row = 0; row < options->Rows; ++row)
+    {
+        unsigned int dest = 0;
+        int weight = 0;
+        int64_t cents = 0;
+        if (recent > 0 && nextUnit(&state) < options->Duplicates)
+        {
+            size_t pick = (size_t)(nextRandom(&state) % recent);
+            dest = recentDest[pick];
+            weight = recentWeight[pick];
+            cents = recentCents[pick];
+        }
+        else
+        {
+            // the first destination whose cumulative weight reaches the draw
+            double draw = nextUnit(&state) * total;
+            unsigned int low = 0;
+            unsigned int high = countries - 1;
+            while (low < high)
+            {
+                unsigned int middle = low + (high - low) / 2;
+                if (cumulative[middle] < draw)
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+            dest = low + 1;
+
+            int rising = 1 + (int)(row * (BENCH_MAX_WEIGHT - 1) / options->Rows);
+            switch (options->Order)
+            {
+            case ORDER_RANDOM:
+                weight = 1 + (int)(nextRandom(&state) % BENCH_MAX_WEIGHT);
+                break;
+            case ORDER_SORTED:
+                weight = rising;
+                break;
+            case ORDER_REVERSE:
+                weight = BENCH_MAX_WEIGHT + 1 - rising;
+                break;
+            }
+            cents = (int64_t)(nextRandom(&state) % (BENCH_MAX_CENTS + 1));
+
+            size_t slot = (size_t)(fresh++ % BENCH_RECENT_ROWS);
+            recentDest[slot] = dest;
+            recentWeight[slot] = weight;
+            recentCents[slot] = cents;
+            recent = recent < BENCH_RECENT_ROWS ? recent + 1 : recent;
+        }
+        outPrintf(&out, "Country %u, %d, %lld.%02d\n", dest, weight, (long long)(cents / 100), (int)(cents % 100));
+    }
+    flushOutBuf(&out);
+    freeOutBuf(&out);
+
+    bool written = ferror(file) == 0;
+    written = fclose(file) == 0 && written;
+    free(cumulative);
+    free(recentDest);
+    free(recentWeight);
+    free(recentCents);
+    return written;
+}
+
+/*
+* FUNCTION      : runBenchmark
+* DESCRIPTION   :
+*   This functoin loads a courier file and times, in order: the load itself, inserting up to
+*   BENCH_INSERT_COUNT of its parcels one by one into a single tree with insertParcelToBST, and
+*   weight-range prints, totals and lightest/heaviest lookups on random destinations. Query answers
+*   are written to memory, so the terminal does not take part in the timing. Columns are built
+*   before the queries are timed.
+* PARAMETERS    :
+*   const char* dataPath    :   the courier file.
+*   int queryCount          :   the number of each timed query.
+*   uint64_t seed           :   the seed of the random destinations and ranges.
+* RETURNS       :
+*   bool    : true, if the file could be loaded. otherwise, false.
+*/
+bool runBenchmark(const char* dataPath, int queryCount, uint64_t seed)
+{
+    DestTable table;
+    LoadResult result = {};
+    struct stat info;
+    uint64_t state = seed != 0 ? seed : 1;
+
+    if (stat(dataPath, &info) != 0)
+    {
+        return false;
+    }
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+    uint64_t start = benchNow();
+    if (!loadParcelsFromFile(&table, dataPath, &result))
+    {
+        deleteDestTable(&table);
+        return false;
+    }
+    uint64_t loadNanos = benchNow() - start;
+    double loadSeconds = loadNanos / 1e9;
+
+    printf("\n%-12s %12s %12s %14s %10s %10s %10s %10s\n",
+        "operation", "count", "total ms", "per second", "p50 us", "p90 us", "p99 us", "max us");
+    printf("%-12s %12zu %12.1f %14.0f %10s %10s %10s %10s   (%.1f MB/s)\n", "load", result.Loaded,
+        loadNanos / 1e6, loadSeconds > 0.0 ? result.Loaded / loadSeconds : 0.0, "-", "-", "-", "-",
+        loadSeconds > 0.0 ? (double)info.st_size / loadSeconds / 1e6 : 0.0);
+
+    // every destination, with its columns built
+    Destination** dests = (Destination**)malloc((table.Count + 1) * sizeof(Destination*));
+    if (dests == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t destCount = 0;
+    int minWeight = 0;
+    int maxWeight = 0;
+    for (size_t i = 0; i < table.Capacity; ++i)
+    {
+        Destination* dest = table.Slots[i].Dest;
+        if (dest == NULL || dest->Summary.Count == 0)
+        {
+            continue;
+        }
+        getDestColumns(dest);
+        if (destCount == 0 || dest->Summary.Lightest->Weight < minWeight)
+        {
+            minWeight = dest->Summary.Lightest->Weight;
+        }
+        if (destCount == 0 || dest->Summary.Heaviest->Weight > maxWeight)
+        {
+            maxWeight = dest->Summary.Heaviest->Weight;
+        }
+        dests[destCount++] = dest;
+    }
+    if (destCount == 0)
+    {
+        printf("**%s holds no parcels to benchmark\n", dataPath);
+        free(dests);
+        deleteDestTable(&table);
+        return true;
+    }
+
+    // insertParcelToBST, in a shuffled order of the loaded parcels
+    size_t insertCount = result.Loaded < BENCH_INSERT_COUNT ? result.Loaded : BENCH_INSERT_COUNT;
+    Arena nodes;
+    initArena(&nodes, ARENA_CHUNK_SIZE);
+    Parcel** parcels = (Parcel**)malloc((insertCount + 1) * sizeof(Parcel*));
+    if (parcels == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t taken = 0;
+    for (size_t d = 0; d < destCount && taken < insertCount; ++d)
+    {
+        const ParcelColumns* columns = &dests[d]->Columns;
+        for (size_t r = 0; r < columns->Count && taken < insertCount; ++r)
+        {
+            parcels[taken] = createNewParcel(&nodes, dests[d]->Id, columns->Weights[r], columns->Cents[r]);
+            parcels[taken]->Seq = (unsigned int)taken;
+            taken++;
+        }
+    }
+    for (size_t i = taken; i > 1; --i)
+    {
+        size_t j = (size_t)(nextRandom(&state) % i);
+        Parcel* swap = parcels[i - 1];
+        parcels[i - 1] = parcels[j];
+        parcels[j] = swap;
+    }
+    BenchSamples samples;
+    Parcel* root = NULL;
+    initSamples(&samples, taken);
+    for (size_t i = 0; i < taken; ++i)
+    {
+        start = benchNow();
+        root = insertParcelToBST(root, parcels[i]);
+        addSample(&samples, start);
+    }
+    reportSamples("insert", &samples);
+    free(parcels);
+    releaseArena(&nodes);
+
+    // queries on random destinations
+    OutBuf out;
+    int span = maxWeight - minWeight + 1;
+    int width = (int)((int64_t)span * BENCH_RANGE_PERMILLE / 1000);
+    initOutBuf(&out, NULL);
+    initSamples(&samples, (size_t)queryCount);
+    for (int q = 0; q < queryCount; ++q)
+    {
+        Destination* dest = dests[nextRandom(&state) % destCount];
+        int low = minWeight + (int)(nextRandom(&state) % (uint64_t)(span - width));
+        start = benchNow();
+        printParcelsBetweenWeightsInCountry(&out, &table, dest->Name, low, low + width);
+        addSample(&samples, start);
+        out.Length = 0;
+    }
+    reportSamples("range", &samples);
+
+    initSamples(&samples, (size_t)queryCount);
+    for (int q = 0; q < queryCount; ++q)
+    {
+        Destination* dest = dests[nextRandom(&state) % destCount];
+        start = benchNow();
+        printTotalParcelWgtAndValForCountry(&out, &table, dest->Name);
+        addSample(&samples, start);
+        out.Length = 0;
+    }
+    reportSamples("totals", &samples);
+
+    initSamples(&samples, (size_t)queryCount);
+    for (int q = 0; q < queryCount; ++q)
+    {
+        Destination* dest = dests[nextRandom(&state) % destCount];
+        start = benchNow();
+        printLightestAndHeaviestParcelInCountry(&out, &table, dest->Name);
+        addSample(&samples, start);
+        out.Length = 0;
+    }
+    reportSamples("minmax", &samples);
+
+    freeOutBuf(&out);
+    free(dests);
+    deleteDestTable(&table);
+    return true;
+}
+
+/*
+* FUNCTION      : nextRandom
+* DESCRIPTION   : This functoin draws the next number of a xorshift64* generator.
+* PARAMETERS    :
+*   uint64_t* state     :   the generator state, never 0.
+* RETURNS       :
+*   uint64_t    : a uniformly distributed number.
+*/
+static uint64_t nextRandom(uint64_t* state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/*
+* FUNCTION      : nextUnit
+* DESCRIPTION   : This functoin draws a number uniformly distributed in [0, 1).
+* PARAMETERS    :
+*   uint64_t* state     :   the generator state.
+* RETURNS       :
+*   double  : the number.
+*/
+static double nextUnit(uint64_t* state)
+{
+    return (double)(nextRandom(state) >> 11) / 9007199254740992.0;
+}
+
+/*
+* FUNCTION      : benchNow
+* DESCRIPTION   : This functoin reads a monotonic clock.
+* PARAMETERS    : none
+* RETURNS       :
+*   uint64_t    : nanoseconds since an arbitrary point.
+*/
+static uint64_t benchNow(void)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+* FUNCTION      : initSamples
+* DESCRIPTION   : This functoin makes room for the latencies of one timed operation.
+* PARAMETERS    :
+*   BenchSamples* samples   :   the samples to be initialised.
+*   size_t count            :   the number of operations to be timed.
+* RETURNS       : void
+*/
+static void initSamples(BenchSamples* samples, size_t count)
+{
+    samples->Nanos = (uint64_t*)malloc((count + 1) * sizeof(uint64_t));
+    if (samples->Nanos == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    samples->Count = 0;
+    samples->TotalNanos = 0;
+}
+
+/*
+* FUNCTION      : addSample
+* DESCRIPTION   : This functoin records the latency of an operation that has just finished.
+* PARAMETERS    :
+*   BenchSamples* samples   :   the samples.
+*   uint64_t start          :   benchNow() when the operation began.
+* RETURNS       : void
+*/
+static void addSample(BenchSamples* samples, uint64_t start)
+{
+    uint64_t nanos = benchNow() - start;
+    samples->Nanos[samples->Count++] = nanos;
+    samples->TotalNanos += nanos;
+}
+
+/*
+* FUNCTION      : compareNanos
+* DESCRIPTION   : This functoin orders two latencies for qsort.
+* PARAMETERS    :
+*   const void* a   :   the first latency.
+*   const void* b   :   the second latency.
+* RETURNS       :
+*   int     : negative, zero or positive as a is shorter, equal or longer.
+*/
+static int compareNanos(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/*
+* FUNCTION      : reportSamples
+* DESCRIPTION   : This functoin prints one line of the benchmark report and frees the samples.
+* PARAMETERS    :
+*   const char* name        :   the operation.
+*   BenchSamples* samples   :   its latencies.
+* RETURNS       : void
+*/
+static void reportSamples(const char* name, BenchSamples* samples)
+{
+    if (samples->Count == 0)
+    {
+        printf("%-12s %12d\n", name, 0);
+        free(samples->Nanos);
+        return;
+    }
+    qsort(samples->Nanos, samples->Count, sizeof(uint64_t), compareNanos);
+    double seconds = samples->TotalNanos / 1e9;
+    printf("%-12s %12zu %12.1f %14.0f %10.2f %10.2f %10.2f %10.2f\n", name, samples->Count,
+        samples->TotalNanos / 1e6, seconds > 0.0 ? samples->Count / seconds : 0.0,
+        samples->Nanos[(samples->Count - 1) / 2] / 1e3,
+        samples->Nanos[(size_t)((samples->Count - 1) * 0.90)] / 1e3,
+        samples->Nanos[(size_t)((samples->Count - 1) * 0.99)] / 1e3,
+        samples->Nanos[samples->Count - 1] / 1e3);
+    free(samples->Nanos);
+}
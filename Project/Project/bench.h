@@ -0,0 +1,45 @@
+/*
+* FILENAME      : bench.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the synthetic courier generator and the benchmark harness. The generator writes
+*   courier files of any size in the format couriers.txt uses, with a Zipfian spread of destinations,
+*   a choice of weight order and a share of repeated lines. The harness times loading a file and the
+*   hot operations on what it loaded, and reports throughput and latency percentiles, so runs on the
+*   same file can be compared to catch regressions.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BENCH_MAX_WEIGHT        50000       // grams, the heaviest generated parcel
+#define BENCH_MAX_CENTS         200000      // the most valuable generated parcel, in cents
+#define BENCH_RECENT_ROWS       1024        // lines a duplicate is drawn from
+#define BENCH_INSERT_COUNT      1000000     // parcels inserted one by one by the insert benchmark
+#define BENCH_QUERY_COUNT       100000      // default number of each timed query
+#define BENCH_RANGE_PERMILLE    10          // width of a timed weight range, per mille of the weight span
+
+typedef enum WeightOrder
+{
+    ORDER_RANDOM,
+    ORDER_SORTED,           // every line at least as heavy as the one before
+    ORDER_REVERSE           // every line at most as heavy as the one before
+} WeightOrder;
+
+typedef struct GenOptions
+{
+    uint64_t Rows;
+    unsigned int Countries;
+    double Skew;            // Zipf exponent of the destination spread, 0 for uniform
+    WeightOrder Order;
+    double Duplicates;      // share of lines repeating one of the recent lines, 0 to 1
+    uint64_t Seed;
+} GenOptions;
+
+void initGenOptions(GenOptions* options);
+bool parseWeightOrder(const char* name, WeightOrder* order);
+bool generateCouriers(const char* path, const GenOptions* options);
+bool runBenchmark(const char* dataPath, int queryCount, uint64_t seed);
@@ -0,0 +1,404 @@
+/*
+* FILENAME      : columns.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the columnar parcel store and its scan kernels declared in columns.h.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "columns.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COLUMNS_AVX2        1
+#elif defined(__SSE4_2__)
+#include <nmmintrin.h>
+#define COLUMNS_SSE42       1
+#endif
+
+static void growParcelColumns(ParcelColumns* columns, size_t count);
+
+/*
+* FUNCTION      : initParcelColumns
+* DESCRIPTION   : This functoin prepares an empty set of columns that still has to be built.
+* PARAMETERS    :
+*   ParcelColumns* columns  :   the columns to be initialised.
+* RETURNS       : void
+*/
+void initParcelColumns(ParcelColumns* columns)
+{
+    columns->Weights = NULL;
+    columns->Cents = NULL;
+    columns->Rows = NULL;
+    columns->Count = 0;
+    columns->Capacity = 0;
+    columns->Stale = true;
+}
+
+/*
+* FUNCTION      : buildParcelColumns
+* DESCRIPTION   :
+*   This functoin refills the columns from a weight tree with an in-order cursor, so the rows come out
+*   sorted by weight and, for equal weights, by arrival. The arrays are reused when they are big enough.
+* PARAMETERS    :
+*   ParcelColumns* columns  :   the columns to be filled.
+*   Parcel* root            :   the root of the weight tree.
+*   size_t count            :   the number of parcels in the tree.
+* RETURNS       : void
+*/
+void buildParcelColumns(ParcelColumns* columns, Parcel* root, size_t count)
+{
+    ParcelCursor cursor;
+    size_t row = 0;
+
+    growParcelColumns(columns, count);
+    initParcelCursor(&cursor, root, CURSOR_BY_WEIGHT);
+    for (Parcel* node = seekFirstParcel(&cursor); node != NULL; node = nextParcel(&cursor))
+    {
+        columns->Weights[row] = node->Weight;
+        columns->Cents[row] = node->Cents;
+        columns->Rows[row] = node;
+        row++;
+    }
+    columns->Count = row;
+    columns->Stale = false;
+}
+
+/*
+* FUNCTION      : fillParcelColumns
+* DESCRIPTION   :
+*   This functoin fills the columns from arrays that are already in weight order, such as the columns
+*   of a snapshot, without walking a tree.
+* PARAMETERS    :
+*   ParcelColumns* columns  :   the columns to be filled.
+*   const int* weights      :   the weights, ascending.
+*   const int64_t* cents    :   the value of each row, in cents.
+*   Parcel* parcels         :   the node of each row, stored contiguously in the same order.
+*   size_t count            :   the number of rows.
+* RETURNS       : void
+*/
+void fillParcelColumns(ParcelColumns* columns, const int* weights, const int64_t* cents, Parcel* parcels, size_t count)
+{
+    growParcelColumns(columns, count);
+    memcpy(columns->Weights, weights, count * sizeof(int));
+    memcpy(columns->Cents, cents, count * sizeof(int64_t));
+    for (size_t i = 0; i < count; ++i)
+    {
+        columns->Rows[i] = &parcels[i];
+    }
+    columns->Count = count;
+    columns->Stale = false;
+}
+
+/*
+* FUNCTION      : stageParcelColumn
+* DESCRIPTION   :
+*   This functoin appends a row that has no node yet, in arrival order. The bulk loader gathers a
+*   destination's parcels this way before sorting them and building its trees; the columns stay stale
+*   until adoptParcelColumns replaces them.
+* PARAMETERS    :
+*   ParcelColumns* columns  :   the columns of a destination that has no tree yet.
+*   int weight              :   the weight of the parcel.
+*   int64_t cents           :   the value of the parcel, in cents.
+* RETURNS       : void
+*/
+void stageParcelColumn(ParcelColumns* columns, int weight, int64_t cents)
+{
+    if (columns->Count == columns->Capacity)
+    {
+        size_t capacity = columns->Capacity == 0 ? 64 : columns->Capacity * 2;
+        int* weights = (int*)realloc(columns->Weights, capacity * sizeof(int));
+        int64_t* values = (int64_t*)realloc(columns->Cents, capacity * sizeof(int64_t));
+        Parcel** rows = (Parcel**)realloc(columns->Rows, capacity * sizeof(Parcel*));
+        if (weights == NULL || values == NULL || rows == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+        columns->Weights = weights;
+        columns->Cents = values;
+        columns->Rows = rows;
+        columns->Capacity = capacity;
+    }
+    columns->Weights[columns->Count] = weight;
+    columns->Cents[columns->Count] = cents;
+    columns->Rows[columns->Count] = NULL;
+    columns->Count++;
+    columns->Stale = true;
+}
+
+/*
+* FUNCTION      : adoptParcelColumns
+* DESCRIPTION   :
+*   This functoin frees the arrays of a set of columns and takes over arrays the caller has already
+*   filled in weight order.
+* PARAMETERS    :
+*   ParcelColumns* columns  :   the columns to be replaced.
+*   int* weights            :   the weights, ascending, allocated with malloc.
+*   int64_t* cents          :   the value of each row, in cents, allocated with malloc.
+*   Parcel** rows           :   the node of each row, allocated with malloc.
+*   size_t count            :   the number of rows.
+* RETURNS       : void
+*/
+void adoptParcelColumns(ParcelColumns* columns, int* weights, int64_t* cents, Parcel** rows, size_t count)
+{
+    free(columns->Weights);
+    free(columns->Cents);
+    free(columns->Rows);
+    columns->Weights = weights;
+    columns->Cents = cents;
+    columns->Rows = rows;
+    columns->Count = count;
+    columns->Capacity = count;
+    columns->Stale = false;
+}
+
+/*
+* FUNCTION      : freeParcelColumns
+* DESCRIPTION   : This functoin frees the arrays of a set of columns and leaves it empty and stale.
+* PARAMETERS    :
+*   ParcelColumns* columns  :   the columns to be released.
+* RETURNS       : void
+*/
+void freeParcelColumns(ParcelColumns* columns)
+{
+    free(columns->Weights);
+    free(columns->Cents);
+    free(columns->Rows);
+    initParcelColumns(columns);
+}
+
+/*
+* FUNCTION      : lowerBoundWeight
+* DESCRIPTION   : This functoin finds the first row weighing at least a given weight.
+* PARAMETERS    :
+*   const ParcelColumns* columns    :   the columns to search.
+*   int weight                      :   the weight to look for.
+* RETURNS       :
+*   size_t  : the index of that row, or Count if every row is lighter.
+*/
+size_t lowerBoundWeight(const ParcelColumns* columns, int weight)
+{
+    size_t low = 0;
+    size_t high = columns->Count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (columns->Weights[middle] < weight)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/*
+* FUNCTION      : upperBoundWeight
+* DESCRIPTION   : This functoin finds the first row weighing more than a given weight.
+* PARAMETERS    :
+*   const ParcelColumns* columns    :   the columns to search.
+*   int weight                      :   the weight to look for.
+* RETURNS       :
+*   size_t  : the index of that row, or Count if no row is heavier.
+*/
+size_t upperBoundWeight(const ParcelColumns* columns, int weight)
+{
+    size_t low = 0;
+    size_t high = columns->Count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (columns->Weights[middle] <= weight)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/*
+* FUNCTION      : scanValueRange
+* DESCRIPTION   :
+*   This functoin scans the rows [begin, end) and totals the ones valued from minCents to maxCents.
+*   The vector paths compare four (AVX2) or two (SSE4.2) values at once and fold the kept rows into
+*   per-lane accumulators with masks, so the loop has no branches; the lanes are combined at the end
+*   and the leftover rows are handled one at a time.
+* PARAMETERS    :
+*   const ParcelColumns* columns    :   the columns to scan.
+*   size_t begin                    :   the first row to scan.
+*   size_t end                      :   one past the last row to scan.
+*   int64_t minCents                :   the lowest value kept.
+*   int64_t maxCents                :   the highest value kept.
+*   ColumnTotals* totals            :   receives the totals of the kept rows.
+* RETURNS       : void
+*/
+void scanValueRange(const ParcelColumns* columns, size_t begin, size_t end, int64_t minCents, int64_t maxCents, ColumnTotals* totals)
+{
+    const int* weights = columns->Weights;
+    const int64_t* cents = columns->Cents;
+    size_t i = begin;
+
+    totals->Count = 0;
+    totals->TotalWeight = 0;
+    totals->TotalCents = 0;
+    totals->MinCents = INT64_MAX;
+    totals->MaxCents = INT64_MIN;
+
+#if defined(COLUMNS_AVX2)
+    {
+        __m256i low = _mm256_set1_epi64x(minCents);
+        __m256i high = _mm256_set1_epi64x(maxCents);
+        __m256i count = _mm256_setzero_si256();
+        __m256i sumWeight = _mm256_setzero_si256();
+        __m256i sumCents = _mm256_setzero_si256();
+        __m256i minimum = _mm256_set1_epi64x(INT64_MAX);
+        __m256i maximum = _mm256_set1_epi64x(INT64_MIN);
+        for (; i + 4 <= end; i += 4)
+        {
+            __m256i value = _mm256_loadu_si256((const __m256i*)(cents + i));
+            __m256i weight = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)(weights + i)));
+            __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(low, value), _mm256_cmpgt_epi64(value, high));
+            __m256i keep = _mm256_xor_si256(outside, _mm256_set1_epi64x(-1));
+            count = _mm256_sub_epi64(count, keep);
+            sumWeight = _mm256_add_epi64(sumWeight, _mm256_and_si256(keep, weight));
+            sumCents = _mm256_add_epi64(sumCents, _mm256_and_si256(keep, value));
+            __m256i lowCandidate = _mm256_blendv_epi8(minimum, value, keep);
+            __m256i highCandidate = _mm256_blendv_epi8(maximum, value, keep);
+            minimum = _mm256_blendv_epi8(minimum, lowCandidate, _mm256_cmpgt_epi64(minimum, lowCandidate));
+            maximum = _mm256_blendv_epi8(maximum, highCandidate, _mm256_cmpgt_epi64(highCandidate, maximum));
+        }
+        int64_t lanes[5][4];
+        _mm256_storeu_si256((__m256i*)lanes[0], count);
+        _mm256_storeu_si256((__m256i*)lanes[1], sumWeight);
+        _mm256_storeu_si256((__m256i*)lanes[2], sumCents);
+        _mm256_storeu_si256((__m256i*)lanes[3], minimum);
+        _mm256_storeu_si256((__m256i*)lanes[4], maximum);
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            totals->Count += lanes[0][lane];
+            totals->TotalWeight += lanes[1][lane];
+            totals->TotalCents += lanes[2][lane];
+            totals->MinCents = lanes[3][lane] < totals->MinCents ? lanes[3][lane] : totals->MinCents;
+            totals->MaxCents = lanes[4][lane] > totals->MaxCents ? lanes[4][lane] : totals->MaxCents;
+        }
+    }
+#elif defined(COLUMNS_SSE42)
+    {
+        __m128i low = _mm_set1_epi64x(minCents);
+        __m128i high = _mm_set1_epi64x(maxCents);
+        __m128i count = _mm_setzero_si128();
+        __m128i sumWeight = _mm_setzero_si128();
+        __m128i sumCents = _mm_setzero_si128();
+        __m128i minimum = _mm_set1_epi64x(INT64_MAX);
+        __m128i maximum = _mm_set1_epi64x(INT64_MIN);
+        for (; i + 2 <= end; i += 2)
+        {
+            __m128i value = _mm_loadu_si128((const __m128i*)(cents + i));
+            __m128i weight = _mm_cvtepi32_epi64(_mm_loadl_epi64((const __m128i*)(weights + i)));
+            __m128i outside = _mm_or_si128(_mm_cmpgt_epi64(low, value), _mm_cmpgt_epi64(value, high));
+            __m128i keep = _mm_xor_si128(outside, _mm_set1_epi64x(-1));
+            count = _mm_sub_epi64(count, keep);
+            sumWeight = _mm_add_epi64(sumWeight, _mm_and_si128(keep, weight));
+            sumCents = _mm_add_epi64(sumCents, _mm_and_si128(keep, value));
+            __m128i lowCandidate = _mm_blendv_epi8(minimum, value, keep);
+            __m128i highCandidate = _mm_blendv_epi8(maximum, value, keep);
+            minimum = _mm_blendv_epi8(minimum, lowCandidate, _mm_cmpgt_epi64(minimum, lowCandidate));
+            maximum = _mm_blendv_epi8(maximum, highCandidate, _mm_cmpgt_epi64(highCandidate, maximum));
+        }
+        int64_t lanes[5][2];
+        _mm_storeu_si128((__m128i*)lanes[0], count);
+        _mm_storeu_si128((__m128i*)lanes[1], sumWeight);
+        _mm_storeu_si128((__m128i*)lanes[2], sumCents);
+        _mm_storeu_si128((__m128i*)lanes[3], minimum);
+        _mm_storeu_si128((__m128i*)lanes[4], maximum);
+        for (int lane = 0; lane < 2; ++lane)
+        {
+            totals->Count += lanes[0][lane];
+            totals->TotalWeight += lanes[1][lane];
+            totals->TotalCents += lanes[2][lane];
+            totals->MinCents = lanes[3][lane] < totals->MinCents ? lanes[3][lane] : totals->MinCents;
+            totals->MaxCents = lanes[4][lane] > totals->MaxCents ? lanes[4][lane] : totals->MaxCents;
+        }
+    }
+#endif
+
+    for (; i < end; ++i)
+    {
+        if (cents[i] >= minCents && cents[i] <= maxCents)
+        {
+            totals->Count++;
+            totals->TotalWeight += weights[i];
+            totals->TotalCents += cents[i];
+            totals->MinCents = cents[i] < totals->MinCents ? cents[i] : totals->MinCents;
+            totals->MaxCents = cents[i] > totals->MaxCents ? cents[i] : totals->MaxCents;
+        }
+    }
+}
+
+/*
+* FUNCTION      : printColumnRows
+* DESCRIPTION   :
+*   This functoin displays the parcels of the rows [begin, end), lightest first. The rows are contiguous,
+*   so the buffer's page is applied by moving the bounds rather than visiting the skipped rows.
+* PARAMETERS    :
+*   OutBuf* out                     :   the buffer receiving the output.
+*   const ParcelColumns* columns    :   the columns holding the rows.
+*   size_t begin                    :   the first row to display.
+*   size_t end                      :   one past the last row to display.
+* RETURNS       : void
+*/
+void printColumnRows(OutBuf* out, const ParcelColumns* columns, size_t begin, size_t end)
+{
+    size_t skipped = out->Skip < end - begin ? out->Skip : end - begin;
+    out->Skip -= skipped;
+    begin += skipped;
+    if (end - begin > out->Limit)
+    {
+        end = begin + out->Limit;
+    }
+    for (size_t i = begin; i < end; ++i)
+    {
+        printParcel(out, columns->Rows[i]);
+    }
+}
+
+/*
+* FUNCTION      : growParcelColumns
+* DESCRIPTION   : This functoin makes sure the arrays of a set of columns can hold a number of rows.
+* PARAMETERS    :
+*   ParcelColumns* columns  :   the columns to be grown.
+*   size_t count            :   the number of rows needed.
+* RETURNS       : void
+*/
+static void growParcelColumns(ParcelColumns* columns, size_t count)
+{
+    if (count <= columns->Capacity)
+    {
+        return;
+    }
+    free(columns->Weights);
+    free(columns->Cents);
+    free(columns->Rows);
+    columns->Weights = (int*)malloc(count * sizeof(int));
+    columns->Cents = (int64_t*)malloc(count * sizeof(int64_t));
+    columns->Rows = (Parcel**)malloc(count * sizeof(Parcel*));
+    if (columns->Weights == NULL || columns->Cents == NULL || columns->Rows == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    columns->Capacity = count;
+}
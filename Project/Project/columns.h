@@ -0,0 +1,48 @@
+/*
+* FILENAME      : columns.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the columnar copy of a destination's parcels. The weights and values sit in
+*   two contiguous arrays sorted by weight, in the same order as an in-order walk of the weight tree,
+*   so scans stream through memory instead of chasing node pointers. The scan kernels use AVX2 or
+*   SSE4.2 when the target supports them and plain loops otherwise.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "parcel.h"
+
+typedef struct ParcelColumns
+{
+    int* Weights;           // ascending
+    int64_t* Cents;         // the value of the parcel at the same position, in cents
+    Parcel** Rows;          // the parcel at the same position, used for printing
+    size_t Count;
+    size_t Capacity;
+    bool Stale;             // the tree has changed since the columns were built
+} ParcelColumns;
+
+// totals of the rows a scan kept
+typedef struct ColumnTotals
+{
+    int64_t Count;
+    int64_t TotalWeight;
+    int64_t TotalCents;
+    int64_t MinCents;       // INT64_MAX when no row was kept
+    int64_t MaxCents;       // INT64_MIN when no row was kept
+} ColumnTotals;
+
+void initParcelColumns(ParcelColumns* columns);
+void buildParcelColumns(ParcelColumns* columns, Parcel* root, size_t count);
+void fillParcelColumns(ParcelColumns* columns, const int* weights, const int64_t* cents, Parcel* parcels, size_t count);
+void stageParcelColumn(ParcelColumns* columns, int weight, int64_t cents);
+void adoptParcelColumns(ParcelColumns* columns, int* weights, int64_t* cents, Parcel** rows, size_t count);
+void freeParcelColumns(ParcelColumns* columns);
+size_t lowerBoundWeight(const ParcelColumns* columns, int weight);
+size_t upperBoundWeight(const ParcelColumns* columns, int weight);
+void scanValueRange(const ParcelColumns* columns, size_t begin, size_t end, int64_t minCents, int64_t maxCents, ColumnTotals* totals);
+void printColumnRows(OutBuf* out, const ParcelColumns* columns, size_t begin, size_t end);
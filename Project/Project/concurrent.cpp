@@ -0,0 +1,697 @@
+/*
+* FILENAME      : concurrent.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the published views declared in concurrent.h. The two trees of a copy do not
+*   share nodes as the master's do: a node is in the weight tree or in the value index, never both, so
+*   path copying one tree never has to touch the other. Nodes are carved from the index's pool and
+*   stamped with the epoch of the publish that made them. A copy made in full is rebuilt balanced from
+*   in-order walks of the master's trees in O(n), the way a snapshot is loaded.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "concurrent.h"
+#include "metrics.h"
+
+// a view, a destination copy or a batch of nodes that a reader may still be using
+struct RetiredView
+{
+    uint64_t Epoch;         // the epoch in which it was replaced
+    DestTable* View;        // the slot array of a view, or NULL
+    Destination* Copy;      // a destination copy, or NULL
+    Parcel** Nodes;         // nodes of copies that a publish replaced, or NULL
+    size_t NodeCount;
+    RetiredView* Next;
+};
+
+// a node of a copy
+typedef struct ViewNode
+{
+    Parcel Node;            // first, so the node is handed out as a Parcel*
+    uint64_t Epoch;         // the epoch of the publish that made it
+} ViewNode;
+
+// a destination copy, with the lock its readers build its columns under
+typedef struct DestinationCopy
+{
+    Destination Dest;       // first, so the copy is handed out as a Destination*
+    std::mutex ColumnsLock;
+} DestinationCopy;
+
+static DestTable* makeView(ConcurrentIndex* index);
+static Destination* newDestinationCopy(Destination* dest);
+static Destination* copyDestination(ConcurrentIndex* index, Destination* dest);
+static Destination* replayDestination(ConcurrentIndex* index, Destination* dest, Destination* old);
+static void refreshCopyExtremes(Destination* copy);
+static Parcel* newViewNode(ConcurrentIndex* index, const Parcel* parcel);
+static Parcel* ownViewNode(void* context, Parcel* node);
+static void retireViewNode(ConcurrentIndex* index, Parcel* node);
+static void retireCopyNodes(ConcurrentIndex* index, Destination* copy);
+static void freeDestinationCopy(Destination* copy);
+static RetiredView* addRetired(ConcurrentIndex* index);
+static void retireView(ConcurrentIndex* index, DestTable* view, Destination* copy);
+static void retireNodes(ConcurrentIndex* index);
+static void reclaimViews(ConcurrentIndex* index);
+static void followLoop(ConcurrentIndex* index, FollowState* follow, LoadResult* result);
+
+/*
+* FUNCTION      : initConcurrentIndex
+* DESCRIPTION   : This functoin prepares a destination index for concurrent readers and publishes its first view.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the state to be initialised.
+*   DestTable* master       :   the destination index the writer keeps changing.
+* RETURNS       : void
+*/
+void initConcurrentIndex(ConcurrentIndex* index, DestTable* master)
+{
+    index->Master = master;
+    index->Retired = NULL;
+    index->Retiring = NULL;
+    index->RetiringCount = 0;
+    index->RetiringCapacity = 0;
+    initArena(&index->NodePool, ARENA_CHUNK_SIZE);
+    index->FreeNodes = NULL;
+    index->Follower = NULL;
+    index->Stopping.store(false);
+    index->Epoch.store(1);
+    for (int i = 0; i < CONCURRENT_MAX_READERS; ++i)
+    {
+        index->ReaderEpochs[i].store(0);
+    }
+    index->Current.store(makeView(index));
+    // the first view is published now, so the next publish must copy its nodes before changing them
+    index->Epoch.fetch_add(1);
+}
+
+/*
+* FUNCTION      : publishConcurrentIndex
+* DESCRIPTION   :
+*   This functoin makes the changes the writer has made to the master index visible to readers. The
+*   new view replaces the current one atomically; readers that already hold the old one keep using it
+*   until they call endRead. The caller must hold WriterLock.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+* RETURNS       : void
+*/
+void publishConcurrentIndex(ConcurrentIndex* index)
+{
+    METRIC_START(publishTimer);
+    DestTable* view = makeView(index);
+    DestTable* old = index->Current.exchange(view);
+    retireView(index, old, NULL);
+    retireNodes(index);
+    index->Epoch.fetch_add(1);
+    reclaimViews(index);
+    METRIC_STOP(METRIC_OP_PUBLISH, publishTimer);
+}
+
+/*
+* FUNCTION      : beginRead
+* DESCRIPTION   :
+*   This functoin hands a reader the current view without taking a lock. The view stays valid, and
+*   does not change, until the reader calls endRead. A reader must not nest beginRead calls.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+*   int reader              :   the reader's slot, in [0, CONCURRENT_MAX_READERS).
+* RETURNS       :
+*   DestTable*  : the view, to be passed only to queries that do not change the index.
+*/
+DestTable* beginRead(ConcurrentIndex* index, int reader)
+{
+    // announcing the epoch before loading the view means a publish that does not see the
+    // announcement has already swapped the view, so the reader cannot get a retired one
+    index->ReaderEpochs[reader].store(index->Epoch.load());
+    return index->Current.load();
+}
+
+/*
+* FUNCTION      : endRead
+* DESCRIPTION   : This functoin tells the writer a reader no longer uses the view beginRead gave it.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+*   int reader              :   the reader's slot.
+* RETURNS       : void
+*/
+void endRead(ConcurrentIndex* index, int reader)
+{
+    index->ReaderEpochs[reader].store(0, std::memory_order_release);
+}
+
+/*
+* FUNCTION      : startConcurrentFollow
+* DESCRIPTION   :
+*   This functoin starts a thread that keeps inserting the parcels appended to a followed file and
+*   publishes them. From now on the follow state and the load counters belong to that thread.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+*   FollowState* follow     :   a file opened by startFollow.
+*   LoadResult* result      :   the running load counters of the file.
+* RETURNS       : void
+*/
+void startConcurrentFollow(ConcurrentIndex* index, FollowState* follow, LoadResult* result)
+{
+    index->Stopping.store(false);
+    index->Follower = new std::thread(followLoop, index, follow, result);
+}
+
+/*
+* FUNCTION      : stopConcurrentFollow
+* DESCRIPTION   : This functoin stops the follow thread, if there is one, and waits for it.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+* RETURNS       : void
+*/
+void stopConcurrentFollow(ConcurrentIndex* index)
+{
+    if (index->Follower == NULL)
+    {
+        return;
+    }
+    index->Stopping.store(true);
+    index->Follower->join();
+    delete index->Follower;
+    index->Follower = NULL;
+}
+
+/*
+* FUNCTION      : stopConcurrentIndex
+* DESCRIPTION   :
+*   This functoin frees every view, copy and node once all readers and the follow thread have finished.
+*   The master index is left to its owner, and must still be alive here.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+* RETURNS       : void
+*/
+void stopConcurrentIndex(ConcurrentIndex* index)
+{
+    DestTable* view = index->Current.exchange(NULL);
+    retireView(index, view, NULL);
+    for (size_t i = 0; i < index->Master->Capacity; ++i)
+    {
+        Destination* dest = index->Master->Slots[i].Dest;
+        if (dest != NULL && dest->Published != NULL)
+        {
+            retireView(index, NULL, dest->Published);
+            dest->Published = NULL;
+        }
+        if (dest != NULL)
+        {
+            clearDestChanges(dest);
+        }
+    }
+    index->Epoch.fetch_add(1);
+    reclaimViews(index);
+    free(index->Retiring);
+    index->Retiring = NULL;
+    index->RetiringCount = 0;
+    index->RetiringCapacity = 0;
+    releaseArena(&index->NodePool);
+    index->FreeNodes = NULL;
+}
+
+/*
+* FUNCTION      : makeView
+* DESCRIPTION   :
+*   This functoin builds a view of the master index. The slot array is copied as it is, so names probe
+*   to the same slots, and each destination is replaced by its copy. A destination that changed since
+*   its copy was made gets a new one, made by replaying its change log on the old copy or, when the log
+*   was dropped, in full; the old copy is retired.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+* RETURNS       :
+*   DestTable*  : the new view.
+*/
+static DestTable* makeView(ConcurrentIndex* index)
+{
+    DestTable* master = index->Master;
+    DestTable* view = (DestTable*)calloc(1, sizeof(DestTable));
+    if (view == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    view->Slots = (DestSlot*)calloc(master->Capacity, sizeof(DestSlot));
+    if (view->Slots == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    view->Capacity = master->Capacity;
+    view->Count = master->Count;
+
+    for (size_t i = 0; i < master->Capacity; ++i)
+    {
+        Destination* dest = master->Slots[i].Dest;
+        if (dest == NULL)
+        {
+            continue;
+        }
+        if (dest->Published == NULL || dest->Changed)
+        {
+            Destination* old = dest->Published;
+            if (old == NULL || dest->ChangesLost)
+            {
+                if (old != NULL)
+                {
+                    retireCopyNodes(index, old);
+                }
+                dest->Published = copyDestination(index, dest);
+            }
+            else
+            {
+                dest->Published = replayDestination(index, dest, old);
+            }
+            if (old != NULL)
+            {
+                retireView(index, NULL, old);
+            }
+            dest->Changed = false;
+            clearDestChanges(dest);
+        }
+        view->Slots[i].Hash = master->Slots[i].Hash;
+        view->Slots[i].Dest = dest->Published;
+    }
+    return view;
+}
+
+/*
+* FUNCTION      : newDestinationCopy
+* DESCRIPTION   :
+*   This functoin makes the record of a destination copy, without trees. Its columns are left to be
+*   built by the first scan, under the copy's lock, and its parcels keep the master's destination id.
+* PARAMETERS    :
+*   Destination* dest   :   a destination of the master index.
+* RETURNS       :
+*   Destination*    : the record.
+*/
+static Destination* newDestinationCopy(Destination* dest)
+{
+    DestinationCopy* copy = new DestinationCopy;
+    copy->Dest = *dest;
+    initParcelColumns(&copy->Dest.Columns);
+    copy->Dest.ColumnsLock = &copy->ColumnsLock;
+    copy->Dest.Published = NULL;
+    copy->Dest.Changed = false;
+    copy->Dest.Changes = NULL;
+    copy->Dest.ChangeCount = 0;
+    copy->Dest.ChangeCapacity = 0;
+    copy->Dest.ChangesLost = false;
+    return &copy->Dest;
+}
+
+/*
+* FUNCTION      : copyDestination
+* DESCRIPTION   :
+*   This functoin makes a frozen copy of a destination in full, in O(n): each tree of the master is
+*   walked in order and its copy is linked balanced from the nodes that walk produced.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index owning the nodes.
+*   Destination* dest       :   a destination of the master index.
+* RETURNS       :
+*   Destination*    : the copy.
+*/
+static Destination* copyDestination(ConcurrentIndex* index, Destination* dest)
+{
+    Destination* copy = newDestinationCopy(dest);
+    size_t count = (size_t)dest->Summary.Count;
+    Parcel** sorted = (Parcel**)malloc((count + 1) * sizeof(Parcel*));
+    if (sorted == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    ParcelCursor cursor;
+    size_t row = 0;
+    initParcelCursor(&cursor, dest->Root, CURSOR_BY_WEIGHT);
+    for (Parcel* node = seekFirstParcel(&cursor); node != NULL; node = nextParcel(&cursor))
+    {
+        sorted[row++] = newViewNode(index, node);
+    }
+    copy->Root = buildBalancedBST(sorted, row);
+
+    row = 0;
+    initParcelCursor(&cursor, dest->ValueRoot, CURSOR_BY_VALUE);
+    for (Parcel* node = seekFirstParcel(&cursor); node != NULL; node = nextParcel(&cursor))
+    {
+        sorted[row++] = newViewNode(index, node);
+    }
+    copy->ValueRoot = buildBalancedValueBST(sorted, row);
+    free(sorted);
+    refreshCopyExtremes(copy);
+    return copy;
+}
+
+/*
+* FUNCTION      : replayDestination
+* DESCRIPTION   :
+*   This functoin makes the new copy of a changed destination from its old copy and its change log in
+*   O(k log n) for k changes. Every change is replayed on the old copy's trees by path copying, so the
+*   new trees share every subtree the changes did not touch and the old copy stays intact for the
+*   readers still using it.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index owning the nodes.
+*   Destination* dest       :   a destination of the master index, with its change log.
+*   Destination* old        :   its current copy, which stays as it is.
+* RETURNS       :
+*   Destination*    : the new copy.
+*/
+static Destination* replayDestination(ConcurrentIndex* index, Destination* dest, Destination* old)
+{
+    Destination* copy = newDestinationCopy(dest);
+    PathCopier copier = { ownViewNode, index };
+    Parcel* root = old->Root;
+    Parcel* valueRoot = old->ValueRoot;
+
+    for (size_t c = 0; c < dest->ChangeCount; ++c)
+    {
+        const DestChange* change = &dest->Changes[c];
+        Parcel key;
+        key.Weight = change->Weight;
+        key.Cents = change->Cents;
+        key.Seq = change->Seq;
+        key.Dest = dest->Id;
+        if (change->Added)
+        {
+            root = insertParcelToBSTCopying(root, newViewNode(index, &key), &copier);
+            valueRoot = insertParcelToValueBSTCopying(valueRoot, newViewNode(index, &key), &copier);
+        }
+        else
+        {
+            Parcel* removed = NULL;
+            root = removeParcelFromBSTCopying(root, &key, &removed, &copier);
+            retireViewNode(index, removed);
+            removed = NULL;
+            valueRoot = removeParcelFromValueBSTCopying(valueRoot, &key, &removed, &copier);
+            retireViewNode(index, removed);
+        }
+    }
+    copy->Root = root;
+    copy->ValueRoot = valueRoot;
+    refreshCopyExtremes(copy);
+    return copy;
+}
+
+/*
+* FUNCTION      : refreshCopyExtremes
+* DESCRIPTION   :
+*   This functoin points the summary of a copy at its own extreme parcels: the lightest and heaviest
+*   in its weight tree, the cheapest and most expensive in its value index.
+* PARAMETERS    :
+*   Destination* copy   :   a copy whose trees are complete.
+* RETURNS       : void
+*/
+static void refreshCopyExtremes(Destination* copy)
+{
+    copy->Summary.Lightest = findMinWeight(copy->Root);
+    copy->Summary.Heaviest = findMaxWeight(copy->Root);
+    copy->Summary.Cheapest = findCheapestParcel(copy->ValueRoot);
+    copy->Summary.MostExpensive = findMostExpensiveParcel(copy->ValueRoot);
+}
+
+/*
+* FUNCTION      : newViewNode
+* DESCRIPTION   :
+*   This functoin makes a single-node tree holding a parcel for a copy, reusing a reclaimed node first,
+*   and stamps it with the current epoch.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index owning the nodes.
+*   const Parcel* parcel    :   the parcel to be held.
+* RETURNS       :
+*   Parcel* : the node.
+*/
+static Parcel* newViewNode(ConcurrentIndex* index, const Parcel* parcel)
+{
+    ViewNode* node = (ViewNode*)index->FreeNodes;
+    if (node != NULL)
+    {
+        index->FreeNodes = node->Node.Left;
+    }
+    else
+    {
+        node = (ViewNode*)arenaAlloc(&index->NodePool, sizeof(ViewNode));
+    }
+    node->Node.Weight = parcel->Weight;
+    node->Node.Cents = parcel->Cents;
+    node->Node.Seq = parcel->Seq;
+    node->Node.Dest = parcel->Dest;
+    resetParcelLinks(&node->Node);
+    node->Epoch = index->Epoch.load();
+    return &node->Node;
+}
+
+/*
+* FUNCTION      : ownViewNode
+* DESCRIPTION   :
+*   This functoin is the path copier of the copies' trees. A node stamped with the current epoch was
+*   made by the publish under way and no reader has seen it, so it is handed back as it is; any older
+*   node belongs to a published view, the first one included, and is copied and retired.
+* PARAMETERS    :
+*   void* context   :   the concurrent index.
+*   Parcel* node    :   a node of a copy's tree.
+* RETURNS       :
+*   Parcel* : a node with the same contents and links that may be changed.
+*/
+static Parcel* ownViewNode(void* context, Parcel* node)
+{
+    ConcurrentIndex* index = (ConcurrentIndex*)context;
+    if (((ViewNode*)node)->Epoch == index->Epoch.load())
+    {
+        return node;
+    }
+    Parcel* copy = newViewNode(index, node);
+    *copy = *node;
+    retireViewNode(index, node);
+    return copy;
+}
+
+/*
+* FUNCTION      : retireViewNode
+* DESCRIPTION   :
+*   This functoin disposes of a node the publish under way took out of a tree. A node made by this
+*   publish was never seen by a reader and is reused at once; an older one waits for the readers.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+*   Parcel* node            :   the node, or NULL.
+* RETURNS       : void
+*/
+static void retireViewNode(ConcurrentIndex* index, Parcel* node)
+{
+    if (node == NULL)
+    {
+        return;
+    }
+    if (((ViewNode*)node)->Epoch == index->Epoch.load())
+    {
+        node->Left = index->FreeNodes;
+        index->FreeNodes = node;
+        return;
+    }
+    if (index->RetiringCount == index->RetiringCapacity)
+    {
+        size_t capacity = index->RetiringCapacity == 0 ? 64 : index->RetiringCapacity * 2;
+        Parcel** retiring = (Parcel**)realloc(index->Retiring, capacity * sizeof(Parcel*));
+        if (retiring == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+        index->Retiring = retiring;
+        index->RetiringCapacity = capacity;
+    }
+    index->Retiring[index->RetiringCount++] = node;
+}
+
+/*
+* FUNCTION      : retireCopyNodes
+* DESCRIPTION   : This functoin retires every node of a copy that is being replaced in full.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+*   Destination* copy       :   the copy, whose trees are left as they are for its readers.
+* RETURNS       : void
+*/
+static void retireCopyNodes(ConcurrentIndex* index, Destination* copy)
+{
+    ParcelCursor cursor;
+    initParcelCursor(&cursor, copy->Root, CURSOR_BY_WEIGHT);
+    for (Parcel* node = seekFirstParcel(&cursor); node != NULL; node = nextParcel(&cursor))
+    {
+        retireViewNode(index, node);
+    }
+    initParcelCursor(&cursor, copy->ValueRoot, CURSOR_BY_VALUE);
+    for (Parcel* node = seekFirstParcel(&cursor); node != NULL; node = nextParcel(&cursor))
+    {
+        retireViewNode(index, node);
+    }
+}
+
+/*
+* FUNCTION      : freeDestinationCopy
+* DESCRIPTION   : This functoin frees the record of a destination copy and its columns; its nodes are retired on their own.
+* PARAMETERS    :
+*   Destination* copy   :   a copy made by newDestinationCopy.
+* RETURNS       : void
+*/
+static void freeDestinationCopy(Destination* copy)
+{
+    freeParcelColumns(&copy->Columns);
+    delete (DestinationCopy*)copy;
+}
+
+/*
+* FUNCTION      : addRetired
+* DESCRIPTION   : This functoin queues an empty entry, stamped with the current epoch, on the retired list.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+* RETURNS       :
+*   RetiredView*    : the entry, for the caller to fill.
+*/
+static RetiredView* addRetired(ConcurrentIndex* index)
+{
+    RetiredView* retired = (RetiredView*)malloc(sizeof(RetiredView));
+    if (retired == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    retired->Epoch = index->Epoch.load();
+    retired->View = NULL;
+    retired->Copy = NULL;
+    retired->Nodes = NULL;
+    retired->NodeCount = 0;
+    retired->Next = index->Retired;
+    index->Retired = retired;
+    return retired;
+}
+
+/*
+* FUNCTION      : retireView
+* DESCRIPTION   : This functoin queues a replaced view or destination copy until no reader can reach it.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+*   DestTable* view         :   the replaced view, or NULL.
+*   Destination* copy       :   the replaced copy, or NULL.
+* RETURNS       : void
+*/
+static void retireView(ConcurrentIndex* index, DestTable* view, Destination* copy)
+{
+    if (view == NULL && copy == NULL)
+    {
+        return;
+    }
+    RetiredView* retired = addRetired(index);
+    retired->View = view;
+    retired->Copy = copy;
+}
+
+/*
+* FUNCTION      : retireNodes
+* DESCRIPTION   :
+*   This functoin queues the nodes the publish under way replaced, which the views before it still
+*   reach, until no reader can reach them.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+* RETURNS       : void
+*/
+static void retireNodes(ConcurrentIndex* index)
+{
+    if (index->RetiringCount == 0)
+    {
+        return;
+    }
+    RetiredView* retired = addRetired(index);
+    retired->Nodes = index->Retiring;
+    retired->NodeCount = index->RetiringCount;
+    index->Retiring = NULL;
+    index->RetiringCount = 0;
+    index->RetiringCapacity = 0;
+}
+
+/*
+* FUNCTION      : reclaimViews
+* DESCRIPTION   :
+*   This functoin frees everything retired before the oldest epoch a reader has announced. A reader
+*   that announced epoch e loaded its view after the publish that advanced the epoch to e, so nothing
+*   retired in an earlier epoch is reachable from it.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+* RETURNS       : void
+*/
+static void reclaimViews(ConcurrentIndex* index)
+{
+    uint64_t oldest = index->Epoch.load();
+    for (int i = 0; i < CONCURRENT_MAX_READERS; ++i)
+    {
+        uint64_t epoch = index->ReaderEpochs[i].load();
+        if (epoch != 0 && epoch < oldest)
+        {
+            oldest = epoch;
+        }
+    }
+
+    RetiredView** link = &index->Retired;
+    while (*link != NULL)
+    {
+        RetiredView* retired = *link;
+        if (retired->Epoch >= oldest)
+        {
+            link = &retired->Next;
+            continue;
+        }
+        *link = retired->Next;
+        if (retired->View != NULL)
+        {
+            free(retired->View->Slots);
+            free(retired->View);
+        }
+        if (retired->Copy != NULL)
+        {
+            freeDestinationCopy(retired->Copy);
+        }
+        for (size_t n = 0; n < retired->NodeCount; ++n)
+        {
+            retired->Nodes[n]->Left = index->FreeNodes;
+            index->FreeNodes = retired->Nodes[n];
+        }
+        free(retired->Nodes);
+        free(retired);
+    }
+}
+
+/*
+* FUNCTION      : followLoop
+* DESCRIPTION   :
+*   This functoin is the body of the follow thread. It polls the followed file under the writer lock
+*   and publishes after every poll that inserted something; it pauses only when the file had nothing
+*   new, so a large append is taken in at full speed.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+*   FollowState* follow     :   the followed file.
+*   LoadResult* result      :   the running load counters of the file.
+* RETURNS       : void
+*/
+static void followLoop(ConcurrentIndex* index, FollowState* follow, LoadResult* result)
+{
+    while (!index->Stopping.load())
+    {
+        size_t added = 0;
+        {
+            std::lock_guard<std::mutex> lock(index->WriterLock);
+            added = pollFollow(index->Master, follow, result);
+            if (added > 0)
+            {
+                publishConcurrentIndex(index);
+            }
+        }
+        if (added == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(CONCURRENT_POLL_MS));
+        }
+    }
+}
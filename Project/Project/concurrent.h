@@ -0,0 +1,67 @@
+/*
+* FILENAME      : concurrent.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the concurrent read path. One writer at a time changes the destination index as
+*   before and, after each batch of changes, publishes a read-only view of it through an atomic pointer.
+*   A view is a DestTable whose destinations are frozen copies, so every query in query.h runs on it
+*   unchanged and readers never take a lock. A publish touches only the destinations changed since the
+*   previous one; the others are shared between the two views. A changed destination gets a new copy
+*   whose trees are the old copy's with the logged changes replayed by path copying (see parcel.h):
+*   only the O(log n) nodes on the path of each change are new, and every untouched subtree is shared
+*   with the old copy, so publishing k changes costs O(k log n) instead of the size of the destination.
+*   A destination whose log was dropped, because it changed too much or was rebuilt in bulk, is copied
+*   in full. The scan columns of a copy are built on the first scan that needs them.
+*
+*   Replaced views, copies and the nodes path copying replaced are freed by epoch-based reclamation: a
+*   reader announces the epoch it entered in, and whatever was retired before the oldest announced
+*   epoch can no longer be reached. Each node of a copy is stamped with the epoch of the publish that
+*   made it, and the epoch advances as soon as that publish is visible, the first one included. So a
+*   node stamped with the current epoch belongs to the publish under way, which no reader can see
+*   yet, and only such a node is changed in place.
+*
+*   When a courier file is followed, a background thread is the writer: it polls the file and
+*   publishes whatever it inserted, while the readers keep answering queries.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "arena.h"
+#include "destTable.h"
+#include "follow.h"
+
+#define CONCURRENT_MAX_READERS  256     // reader slots, one per thread pool worker at most
+#define CONCURRENT_POLL_MS      100     // pause of the follow thread when the file has nothing new
+
+typedef struct RetiredView RetiredView;
+
+typedef struct ConcurrentIndex
+{
+    DestTable* Master;                  // the index the writer changes
+    std::mutex WriterLock;              // held while Master is changed and published
+    std::atomic<DestTable*> Current;    // the newest published view
+    std::atomic<uint64_t> Epoch;        // the epoch of the publish under way, advanced once each view is out
+    std::atomic<uint64_t> ReaderEpochs[CONCURRENT_MAX_READERS];    // 0 while the reader holds no view
+    RetiredView* Retired;               // views, copies and nodes waiting for the readers to move on
+    Parcel** Retiring;                  // nodes replaced by the publish under way, retired with its view
+    size_t RetiringCount;
+    size_t RetiringCapacity;
+    Arena NodePool;                     // owns the nodes of every copy
+    Parcel* FreeNodes;                  // reclaimed nodes chained through Left, reused first
+    std::thread* Follower;              // the thread polling a followed file, or NULL
+    std::atomic<bool> Stopping;         // tells the follow thread to finish
+} ConcurrentIndex;
+
+void initConcurrentIndex(ConcurrentIndex* index, DestTable* master);
+void publishConcurrentIndex(ConcurrentIndex* index);
+DestTable* beginRead(ConcurrentIndex* index, int reader);
+void endRead(ConcurrentIndex* index, int reader);
+void startConcurrentFollow(ConcurrentIndex* index, FollowState* follow, LoadResult* result);
+void stopConcurrentFollow(ConcurrentIndex* index);
+void stopConcurrentIndex(ConcurrentIndex* index);
@@ -0,0 +1,995 @@
+/*
+* FILENAME      : destTable.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the destination index declared in destTable.h. Slots are probed linearly and
+*   each slot caches the full hash of its key, so a probe only falls back to comparing names when the
+*   hashes match.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "destTable.h"
+#include "metrics.h"
+
+#if (defined(__SSE4_2__) || defined(__AVX2__)) && (defined(_M_X64) || defined(__x86_64__))
+#include <nmmintrin.h>
+#define DEST_HASH_CRC32     1
+#endif
+
+static void insertSlot(DestSlot* slots, size_t capacity, uint64_t hash, Destination* dest);
+static void growDestTable(DestTable* table);
+static void addDestinationSlot(DestTable* table, uint64_t hash, Destination* dest);
+static void linkParcel(Destination* dest, Parcel* parcel);
+static void refreshSummaryExtremes(Destination* dest);
+static void logParcelChange(Destination* dest, const Parcel* parcel, bool added);
+static void buildStagedDestination(DestTable* table, Destination* dest);
+static void packStagedDestination(DestTable* table, Destination* dest);
+static void sortRowKeys(uint64_t* keys, uint64_t* scratch, size_t count);
+static void sortRowsByCents(Parcel** rows, size_t count, uint64_t* keys, uint64_t* scratch, Parcel** sorted);
+
+/*
+* FUNCTION      : generateHash
+* DESCRIPTION   :
+*   This functoin converts a destination name of a given length to a 64-bit hash value. The name is
+*   hashed in its normalized form (see foldDestName), so names that match hash alike. That form is
+*   consumed eight bytes at a time: through the CRC32C instruction when the target supports SSE4.2,
+*   otherwise through a multiply-xorshift mix. Either way the result is finished with a 64-bit
+*   avalanche so the low bits used to pick a slot are well distributed.
+* PARAMETERS    :
+*   const char* str :   the string to be converted, it does not need to be null terminated
+*   size_t len      :   the number of bytes of str to hash
+* RETURNS       : uint64_t : the hash value.
+*/
+uint64_t generateHash(const char* str, size_t len)
+{
+    char buffer[DEST_FOLD_BUFFER];
+    char* folded = len <= sizeof buffer ? buffer : (char*)malloc(len);
+    if (folded == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t foldedLen = foldDestName(str, len, folded);
+    uint64_t hash = 0x9E3779B97F4A7C15ull ^ (uint64_t)foldedLen;
+    uint64_t word = 0;
+    size_t i = 0;
+
+    METRIC_ADD(METRIC_HASH_CALLS, 1);
+    METRIC_ADD(METRIC_HASH_BYTES, len);
+
+    for (; i + sizeof word <= foldedLen; i += sizeof word)
+    {
+        memcpy(&word, folded + i, sizeof word);
+#ifdef DEST_HASH_CRC32
+        hash = _mm_crc32_u64(hash, word) ^ (hash << 32);
+#else
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 32;
+#endif
+    }
+    if (i < foldedLen)
+    {
+        word = 0;
+        memcpy(&word, folded + i, foldedLen - i);
+#ifdef DEST_HASH_CRC32
+        hash = _mm_crc32_u64(hash, word) ^ (hash << 32);
+#else
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 32;
+#endif
+    }
+    if (folded != buffer)
+    {
+        free(folded);
+    }
+
+    // fmix64 finaliser from MurmurHash3
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/*
+* FUNCTION      : initDestTable
+* DESCRIPTION   : This functoin allocates an empty destination index.
+* PARAMETERS    :
+*   DestTable* table    :   the table to be initialised.
+*   size_t capacity     :   the initial number of slots, rounded up to a power of two.
+* RETURNS       : void
+*/
+void initDestTable(DestTable* table, size_t capacity)
+{
+    size_t size = DEST_TABLE_INITIAL_SIZE;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    table->Slots = (DestSlot*)calloc(size, sizeof(DestSlot));
+    if (table->Slots == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    table->Capacity = size;
+    table->Count = 0;
+    table->FreeParcels = NULL;
+    table->Packed = false;
+    initArena(&table->Pool, ARENA_CHUNK_SIZE);
+}
+
+/*
+* FUNCTION      : findDestination
+* DESCRIPTION   : This functoin looks up the Destination record stored under a given name.
+* PARAMETERS    :
+*   const DestTable* table  :   the destination index to search.
+*   const char* name        :   the destination name, it does not need to be null terminated.
+*   size_t len              :   the length of the name.
+* RETURNS       :
+*   Destination*    : the matching record, or NULL if the name has never been inserted.
+*/
+Destination* findDestination(const DestTable* table, const char* name, size_t len)
+{
+    return findDestinationHashed(table, name, len, generateHash(name, len));
+}
+
+/*
+* FUNCTION      : findDestinationHashed
+* DESCRIPTION   : This functoin is findDestination for a caller that has already hashed the name.
+* PARAMETERS    :
+*   const DestTable* table  :   the destination index to search.
+*   const char* name        :   the destination name, it does not need to be null terminated.
+*   size_t len              :   the length of the name.
+*   uint64_t hash           :   generateHash(name, len).
+* RETURNS       :
+*   Destination*    : the matching record, or NULL if the name has never been inserted.
+*/
+Destination* findDestinationHashed(const DestTable* table, const char* name, size_t len, uint64_t hash)
+{
+    size_t mask = table->Capacity - 1;
+    size_t i = (size_t)hash & mask;
+
+    METRIC_ADD(METRIC_DEST_LOOKUPS, 1);
+    while (table->Slots[i].Dest != NULL)
+    {
+        Destination* dest = table->Slots[i].Dest;
+        if (table->Slots[i].Hash == hash && sameDestName(dest->Name, dest->NameLen, name, len))
+        {
+            return dest;
+        }
+        i = (i + 1) & mask;
+        METRIC_ADD(METRIC_DEST_COLLISIONS, 1);
+    }
+    return NULL;
+}
+
+/*
+* FUNCTION      : findOrAddDestination
+* DESCRIPTION   :
+*   This functoin returns the Destination record for a name, creating an empty one (with the id and
+*   spelling of the name in the dictionary) if the name is not in the index yet. The table grows
+*   before it gets too full.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index.
+*   const char* name    :   the destination name, it does not need to be null terminated.
+*   size_t len          :   the length of the name.
+* RETURNS       :
+*   Destination*    : the existing or newly created record.
+*/
+Destination* findOrAddDestination(DestTable* table, const char* name, size_t len)
+{
+    return findOrAddDestinationHashed(table, name, len, generateHash(name, len));
+}
+
+/*
+* FUNCTION      : findOrAddDestinationHashed
+* DESCRIPTION   : This functoin is findOrAddDestination for a caller that has already hashed the name.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index.
+*   const char* name    :   the destination name, it does not need to be null terminated.
+*   size_t len          :   the length of the name.
+*   uint64_t hash       :   generateHash(name, len).
+* RETURNS       :
+*   Destination*    : the existing or newly created record.
+*/
+Destination* findOrAddDestinationHashed(DestTable* table, const char* name, size_t len, uint64_t hash)
+{
+    Destination* dest = findDestinationHashed(table, name, len, hash);
+    if (dest != NULL)
+    {
+        return dest;
+    }
+
+    dest = (Destination*)arenaAlloc(&table->Pool, sizeof(Destination));
+    dest->Id = internDestName(name, len);
+    dest->Name = getDestName(dest->Id);
+    dest->NameLen = getDestNameLen(dest->Id);
+    dest->Root = NULL;
+    dest->ValueRoot = NULL;
+    dest->NextSeq = 0;
+    memset(&dest->Summary, 0, sizeof(DestSummary));
+    initParcelColumns(&dest->Columns);
+    dest->ColumnsLock = NULL;
+    initPackedColumns(&dest->Packed);
+    dest->Published = NULL;
+    dest->Changed = false;
+    dest->Changes = NULL;
+    dest->ChangeCount = 0;
+    dest->ChangeCapacity = 0;
+    dest->ChangesLost = false;
+    addDestinationSlot(table, hash, dest);
+    return dest;
+}
+
+/*
+* FUNCTION      : deleteDestTable
+* DESCRIPTION   :
+*   This functoin frees the column arrays of every destination, the slot array and, through a single
+*   arena release, every Destination record and parcel node of the table. The names belong to the
+*   destination dictionary and outlive the table.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index to be released.
+* RETURNS       : void
+*/
+void deleteDestTable(DestTable* table)
+{
+    for (size_t i = 0; i < table->Capacity; ++i)
+    {
+        if (table->Slots[i].Dest != NULL)
+        {
+            freeParcelColumns(&table->Slots[i].Dest->Columns);
+            freePackedColumns(&table->Slots[i].Dest->Packed);
+            clearDestChanges(table->Slots[i].Dest);
+        }
+    }
+    free(table->Slots);
+    releaseArena(&table->Pool);
+    table->Slots = NULL;
+    table->Capacity = 0;
+    table->Count = 0;
+    table->FreeParcels = NULL;
+}
+
+/*
+* FUNCTION      : insertHashTableWithBST
+* DESCRIPTION   :
+*   This functoin creates a parcel node based on given data and inserts the node 
+*    to the BST of its destination within the destination index. A node left over by deleteParcel is
+*    reused before a new one is carved from the arena.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index containing BSTs.
+*   const char* dest    :   the destination of a parcel, it does not need to be null terminated
+*   size_t destLen      :   the length of the destination
+*   int weight          :   the weight of a parcel
+*   int64_t cents       :   the value of a parcel, in cents
+* RETURNS       :  void
+*/
+void insertHashTableWithBST(DestTable* table, const char* dest, size_t destLen, int weight, int64_t cents)
+{
+    METRIC_START(insertTimer);
+    Destination* destination = findOrAddDestination(table, dest, destLen);
+    Parcel* parcel = table->FreeParcels;
+    if (parcel != NULL)
+    {
+        table->FreeParcels = parcel->Left;
+        parcel->Weight = weight;
+        parcel->Cents = cents;
+        resetParcelLinks(parcel);
+    }
+    else
+    {
+        parcel = createNewParcel(&table->Pool, destination->Id, weight, cents);
+    }
+    addParcelToDestination(destination, parcel);
+    METRIC_STOP(METRIC_OP_INSERT, insertTimer);
+}
+
+/*
+* FUNCTION      : addParcelToDestination
+* DESCRIPTION   :
+*   This functoin links a new parcel node into a destination: it takes the destination's id and next
+*   sequence number, is inserted into the weight tree and the value index, and is
+*   folded into the summary.
+* PARAMETERS    :
+*   Destination* dest   :   the destination receiving the parcel.
+*   Parcel* parcel      :   a node that is not linked into any tree.
+* RETURNS       :  void
+*/
+void addParcelToDestination(Destination* dest, Parcel* parcel)
+{
+    parcel->Dest = dest->Id;
+    parcel->Seq = dest->NextSeq++;
+    linkParcel(dest, parcel);
+}
+
+/*
+* FUNCTION      : removeParcelFromDestination
+* DESCRIPTION   :
+*   This functoin unlinks a parcel from both trees of its destination and takes it out of the summary,
+*   in O(log n). The node itself is left to the caller.
+* PARAMETERS    :
+*   Destination* dest   :   the destination holding the parcel.
+*   Parcel* parcel      :   a parcel of that destination.
+* RETURNS       :  void
+*/
+void removeParcelFromDestination(Destination* dest, Parcel* parcel)
+{
+    DestSummary* summary = &dest->Summary;
+
+    dest->Root = removeParcelFromBST(dest->Root, parcel);
+    dest->ValueRoot = removeParcelFromValueBST(dest->ValueRoot, parcel);
+    dest->Columns.Stale = true;
+    dest->Changed = true;
+    logParcelChange(dest, parcel, false);
+
+    summary->Count--;
+    summary->TotalWeight -= parcel->Weight;
+    summary->TotalCents -= parcel->Cents;
+    refreshSummaryExtremes(dest);
+}
+
+/*
+* FUNCTION      : updateParcelInDestination
+* DESCRIPTION   :
+*   This functoin re-weighs or re-values a parcel in O(log n): it is unlinked, given its new weight
+*   and value, and linked back in. It keeps its sequence number, so it keeps its place among parcels
+*   of equal weight or value.
+* PARAMETERS    :
+*   Destination* dest   :   the destination holding the parcel.
+*   Parcel* parcel      :   a parcel of that destination.
+*   int weight          :   the new weight.
+*   int64_t cents       :   the new value, in cents.
+* RETURNS       :  void
+*/
+void updateParcelInDestination(Destination* dest, Parcel* parcel, int weight, int64_t cents)
+{
+    removeParcelFromDestination(dest, parcel);
+    parcel->Weight = weight;
+    parcel->Cents = cents;
+    resetParcelLinks(parcel);
+    linkParcel(dest, parcel);
+    refreshSummaryExtremes(dest);
+}
+
+/*
+* FUNCTION      : deleteParcel
+* DESCRIPTION   :
+*   This functoin removes a parcel from its destination and keeps the node for the next insert, since
+*   the arena does not free single nodes.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index.
+*   Destination* dest   :   the destination holding the parcel.
+*   Parcel* parcel      :   a parcel of that destination, it must not be used afterwards.
+* RETURNS       :  void
+*/
+void deleteParcel(DestTable* table, Destination* dest, Parcel* parcel)
+{
+    removeParcelFromDestination(dest, parcel);
+    parcel->Left = table->FreeParcels;
+    table->FreeParcels = parcel;
+}
+
+/*
+* FUNCTION      : linkParcel
+* DESCRIPTION   :
+*   This functoin inserts a parcel that already has its name and sequence number into the weight tree
+*   and the value index of a destination, and folds it into the summary.
+* PARAMETERS    :
+*   Destination* dest   :   the destination receiving the parcel.
+*   Parcel* parcel      :   a node that is not linked into any tree.
+* RETURNS       :  void
+*/
+static void linkParcel(Destination* dest, Parcel* parcel)
+{
+    DestSummary* summary = &dest->Summary;
+
+    dest->Root = insertParcelToBST(dest->Root, parcel);
+    METRIC_PATH_DONE();
+    dest->ValueRoot = insertParcelToValueBST(dest->ValueRoot, parcel);
+    dest->Columns.Stale = true;
+    dest->Changed = true;
+    logParcelChange(dest, parcel, true);
+
+    summary->Count++;
+    summary->TotalWeight += parcel->Weight;
+    summary->TotalCents += parcel->Cents;
+    if (summary->Lightest == NULL || parcel->Weight < summary->Lightest->Weight)
+    {
+        summary->Lightest = parcel;
+    }
+    if (summary->Heaviest == NULL || parcel->Weight >= summary->Heaviest->Weight)
+    {
+        summary->Heaviest = parcel;
+    }
+    if (summary->Cheapest == NULL || parcel->Cents < summary->Cheapest->Cents)
+    {
+        summary->Cheapest = parcel;
+    }
+    if (summary->MostExpensive == NULL || parcel->Cents >= summary->MostExpensive->Cents)
+    {
+        summary->MostExpensive = parcel;
+    }
+}
+
+/*
+* FUNCTION      : refreshSummaryExtremes
+* DESCRIPTION   :
+*   This functoin reads the extreme parcels of a destination back from its trees, which order equal
+*   keys by arrival exactly as the summary does. It is needed once a parcel has left or moved.
+* PARAMETERS    :
+*   Destination* dest   :   the destination whose summary is refreshed.
+* RETURNS       :  void
+*/
+static void refreshSummaryExtremes(Destination* dest)
+{
+    dest->Summary.Lightest = findMinWeight(dest->Root);
+    dest->Summary.Heaviest = findMaxWeight(dest->Root);
+    dest->Summary.Cheapest = findCheapestParcel(dest->ValueRoot);
+    dest->Summary.MostExpensive = findMostExpensiveParcel(dest->ValueRoot);
+}
+
+/*
+* FUNCTION      : logParcelChange
+* DESCRIPTION   :
+*   This functoin logs a parcel added to or removed from a destination that has been published, so
+*   the next publish can replay it. Once the log holds more changes than the replay is worth, it is
+*   dropped and the next publish copies the destination instead.
+* PARAMETERS    :
+*   Destination* dest       :   the destination that changed.
+*   const Parcel* parcel    :   the parcel, with the key it is filed under.
+*   bool added              :   true if the parcel was added, false if it was removed.
+* RETURNS       :  void
+*/
+static void logParcelChange(Destination* dest, const Parcel* parcel, bool added)
+{
+    if (dest->Published == NULL || dest->ChangesLost)
+    {
+        return;
+    }
+    if (dest->ChangeCount >= (size_t)dest->Summary.Count / DEST_CHANGE_LOG_RATIO + 1)
+    {
+        clearDestChanges(dest);
+        dest->ChangesLost = true;
+        return;
+    }
+    if (dest->ChangeCount == dest->ChangeCapacity)
+    {
+        size_t capacity = dest->ChangeCapacity == 0 ? 16 : dest->ChangeCapacity * 2;
+        DestChange* changes = (DestChange*)realloc(dest->Changes, capacity * sizeof(DestChange));
+        if (changes == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+        dest->Changes = changes;
+        dest->ChangeCapacity = capacity;
+    }
+    DestChange* change = &dest->Changes[dest->ChangeCount++];
+    change->Weight = parcel->Weight;
+    change->Cents = parcel->Cents;
+    change->Seq = parcel->Seq;
+    change->Added = added;
+}
+
+/*
+* FUNCTION      : clearDestChanges
+* DESCRIPTION   : This functoin frees the change log of a destination, once its published copy is up to date.
+* PARAMETERS    :
+*   Destination* dest   :   the destination.
+* RETURNS       :  void
+*/
+void clearDestChanges(Destination* dest)
+{
+    free(dest->Changes);
+    dest->Changes = NULL;
+    dest->ChangeCount = 0;
+    dest->ChangeCapacity = 0;
+    dest->ChangesLost = false;
+}
+
+/*
+* FUNCTION      : getDestColumns
+* DESCRIPTION   :
+*   This functoin returns the columnar copy of a destination's parcels, rebuilding it first if parcels
+*   have been added since it was last built. A copy in a concurrent view is shared by its readers, so
+*   the first of them to scan it builds its columns under its lock and the others wait for them.
+* PARAMETERS    :
+*   Destination* dest   :   the destination to be scanned.
+* RETURNS       :
+*   ParcelColumns*  : the up-to-date columns.
+*/
+ParcelColumns* getDestColumns(Destination* dest)
+{
+    if (dest->ColumnsLock != NULL)
+    {
+        std::lock_guard<std::mutex> lock(*dest->ColumnsLock);
+        if (dest->Columns.Stale)
+        {
+            buildParcelColumns(&dest->Columns, dest->Root, (size_t)dest->Summary.Count);
+        }
+        return &dest->Columns;
+    }
+    if (dest->Columns.Stale)
+    {
+        buildParcelColumns(&dest->Columns, dest->Root, (size_t)dest->Summary.Count);
+    }
+    return &dest->Columns;
+}
+
+/*
+* FUNCTION      : mergeDestTable
+* DESCRIPTION   :
+*   This functoin moves every destination of a source table into a target table and empties the
+*   source. A destination the target does not have yet is moved over as a whole; for one it already
+*   has, the source parcels are re-linked into the target's tree after the existing ones, in the order
+*   they arrived in the source, so ties come out as if they had been inserted one by one. The source
+*   arena is handed to the target, so no parcel is copied.
+* PARAMETERS    :
+*   DestTable* target   :   the destination index receiving the destinations.
+*   DestTable* source   :   the destination index to be emptied, it must be initialised again before reuse.
+* RETURNS       :  void
+*/
+void mergeDestTable(DestTable* target, DestTable* source)
+{
+    for (size_t i = 0; i < source->Capacity; ++i)
+    {
+        Destination* dest = source->Slots[i].Dest;
+        if (dest == NULL)
+        {
+            continue;
+        }
+        Destination* existing = findDestinationHashed(target, dest->Name, dest->NameLen, source->Slots[i].Hash);
+        if (existing == NULL)
+        {
+            addDestinationSlot(target, source->Slots[i].Hash, dest);
+            continue;
+        }
+
+        // in-order walk with an explicit stack, filing every node under its arrival number, so the
+        // parcels are re-linked in the order they arrived and keep that order among equal keys
+        Parcel** bySeq = (Parcel**)calloc((size_t)dest->NextSeq + 1, sizeof(Parcel*));
+        if (bySeq == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+        Parcel* stack[PARCEL_STACK_DEPTH];
+        int top = 0;
+        Parcel* node = dest->Root;
+        while (node != NULL || top > 0)
+        {
+            while (node != NULL)
+            {
+                stack[top++] = node;
+                node = node->Left;
+            }
+            Parcel* current = stack[--top];
+            node = current->Right;
+            bySeq[current->Seq] = current;
+        }
+        for (unsigned int seq = 0; seq < dest->NextSeq; ++seq)
+        {
+            if (bySeq[seq] != NULL)
+            {
+                resetParcelLinks(bySeq[seq]);
+                addParcelToDestination(existing, bySeq[seq]);
+            }
+        }
+        free(bySeq);
+        freeParcelColumns(&dest->Columns);
+    }
+    while (source->FreeParcels != NULL)
+    {
+        Parcel* parcel = source->FreeParcels;
+        source->FreeParcels = parcel->Left;
+        parcel->Left = target->FreeParcels;
+        target->FreeParcels = parcel;
+    }
+    adoptArena(&target->Pool, &source->Pool);
+    free(source->Slots);
+    source->Slots = NULL;
+    source->Capacity = 0;
+    source->Count = 0;
+}
+
+/*
+* FUNCTION      : buildStagedDestinations
+* DESCRIPTION   :
+*   This functoin builds the trees of every destination whose parcels were staged with
+*   stageParcelColumn instead of being inserted one by one, or its packed columns in a packed table.
+*   It is meant for a table that was filled that way from empty, such as a shard of the bulk loader.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index to be built.
+* RETURNS       :  void
+*/
+void buildStagedDestinations(DestTable* table)
+{
+    for (size_t i = 0; i < table->Capacity; ++i)
+    {
+        Destination* dest = table->Slots[i].Dest;
+        if (dest == NULL || dest->Root != NULL || !dest->Columns.Stale || dest->Columns.Count == 0)
+        {
+            continue;
+        }
+        if (table->Packed)
+        {
+            packStagedDestination(table, dest);
+        }
+        else
+        {
+            buildStagedDestination(table, dest);
+        }
+    }
+}
+
+/*
+* FUNCTION      : addDestinationSlot
+* DESCRIPTION   : This functoin adds a record that is not in the table yet, growing the table first if needed.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index.
+*   uint64_t hash       :   the hash of the record's name.
+*   Destination* dest   :   the record to be added.
+* RETURNS       : void
+*/
+static void addDestinationSlot(DestTable* table, uint64_t hash, Destination* dest)
+{
+    if ((table->Count + 1) * DEST_TABLE_LOAD_DEN > table->Capacity * DEST_TABLE_LOAD_NUM)
+    {
+        growDestTable(table);
+    }
+    insertSlot(table->Slots, table->Capacity, hash, dest);
+    table->Count++;
+}
+
+/*
+* FUNCTION      : insertSlot
+* DESCRIPTION   : This functoin places a record into the first free slot of its probe sequence.
+* PARAMETERS    :
+*   DestSlot* slots     :   the slot array.
+*   size_t capacity     :   the number of slots, a power of two.
+*   uint64_t hash       :   the hash of the record's name.
+*   Destination* dest   :   the record to be placed.
+* RETURNS       : void
+*/
+static void insertSlot(DestSlot* slots, size_t capacity, uint64_t hash, Destination* dest)
+{
+    size_t mask = capacity - 1;
+    size_t i = (size_t)hash & mask;
+    while (slots[i].Dest != NULL)
+    {
+        i = (i + 1) & mask;
+    }
+    slots[i].Hash = hash;
+    slots[i].Dest = dest;
+}
+
+/*
+* FUNCTION      : growDestTable
+* DESCRIPTION   : This functoin doubles the slot array and re-places every record using its cached hash.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index to grow.
+* RETURNS       : void
+*/
+static void growDestTable(DestTable* table)
+{
+    size_t newCapacity = table->Capacity * 2;
+    DestSlot* newSlots = (DestSlot*)calloc(newCapacity, sizeof(DestSlot));
+    if (newSlots == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < table->Capacity; ++i)
+    {
+        if (table->Slots[i].Dest != NULL)
+        {
+            insertSlot(newSlots, newCapacity, table->Slots[i].Hash, table->Slots[i].Dest);
+        }
+    }
+    free(table->Slots);
+    table->Slots = newSlots;
+    table->Capacity = newCapacity;
+}
+
+/*
+* FUNCTION      : buildStagedDestination
+* DESCRIPTION   :
+*   This functoin turns the staged rows of a destination, which are in arrival order, into its trees
+*   without a single comparison-based insert. The rows are radix-sorted by weight and the nodes are
+*   carved from the arena as one block in the Eytzinger layout of the weight tree, which is then
+*   linked bottom-up in one pass. A second radix sort by value links the value index over the same
+*   nodes. The row number is the sequence number, so equal keys keep their arrival order exactly as
+*   if the rows had been inserted one by one, and the columns come out already built.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index owning the destination.
+*   Destination* dest   :   a destination with staged rows and no tree.
+* RETURNS       :  void
+*/
+static void buildStagedDestination(DestTable* table, Destination* dest)
+{
+    ParcelColumns* staged = &dest->Columns;
+    DestSummary* summary = &dest->Summary;
+    size_t count = staged->Count;
+    uint64_t* keys = (uint64_t*)malloc(count * sizeof(uint64_t));
+    uint64_t* scratch = (uint64_t*)malloc(count * sizeof(uint64_t));
+    int* weights = (int*)malloc(count * sizeof(int));
+    int64_t* cents = (int64_t*)malloc(count * sizeof(int64_t));
+    Parcel** rows = (Parcel**)malloc(count * sizeof(Parcel*));
+    if (keys == NULL || scratch == NULL || weights == NULL || cents == NULL || rows == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // the key sits in the high half and the row number in the low half, so every key is distinct
+    for (size_t i = 0; i < count; ++i)
+    {
+        keys[i] = ((uint64_t)((uint32_t)staged->Weights[i] ^ 0x80000000u) << 32) | (uint64_t)i;
+    }
+    sortRowKeys(keys, scratch, count);
+
+    Parcel* nodes = (Parcel*)arenaAlloc(&table->Pool, count * sizeof(Parcel));
+    size_t slot = firstEytzingerSlot(count);
+    memset(summary, 0, sizeof(DestSummary));
+    for (size_t r = 0; r < count; ++r)
+    {
+        size_t row = (size_t)(uint32_t)keys[r];
+        Parcel* node = &nodes[slot - 1];
+        node->Weight = staged->Weights[row];
+        node->Cents = staged->Cents[row];
+        node->Dest = dest->Id;
+        node->Seq = (unsigned int)row;
+        weights[r] = node->Weight;
+        cents[r] = node->Cents;
+        rows[r] = node;
+        staged->Rows[row] = node;
+        summary->TotalWeight += weights[r];
+        summary->TotalCents += cents[r];
+        slot = nextEytzingerSlot(slot, count);
+    }
+    dest->Root = linkEytzingerBST(nodes, count);
+
+    Parcel** valueSorted = (Parcel**)malloc(count * sizeof(Parcel*));
+    if (valueSorted == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    sortRowsByCents(staged->Rows, count, keys, scratch, valueSorted);
+    free(scratch);
+    dest->ValueRoot = buildBalancedValueBST(valueSorted, count);
+
+    summary->Count = (int64_t)count;
+    summary->Lightest = rows[0];
+    summary->Heaviest = rows[count - 1];
+    summary->Cheapest = valueSorted[0];
+    summary->MostExpensive = valueSorted[count - 1];
+    dest->NextSeq = (unsigned int)count;
+    dest->Changed = true;
+    dest->ChangesLost = true;
+    adoptParcelColumns(staged, weights, cents, rows, count);
+    free(valueSorted);
+    free(keys);
+}
+
+/*
+* FUNCTION      : packStagedDestination
+* DESCRIPTION   :
+*   This functoin packs the staged rows of a destination of a packed table. The rows are radix-sorted
+*   by weight as for the trees, but no node is made for them: only the lightest, heaviest, cheapest
+*   and most expensive parcels get one, so the summary and everything that reads it work unchanged.
+*   The staged columns are freed, which leaves a few bytes per parcel in the packed columns.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index owning the destination.
+*   Destination* dest   :   a destination with staged rows and no tree.
+* RETURNS       :  void
+*/
+static void packStagedDestination(DestTable* table, Destination* dest)
+{
+    ParcelColumns* staged = &dest->Columns;
+    DestSummary* summary = &dest->Summary;
+    size_t count = staged->Count;
+    size_t cheapest = 0;
+    size_t mostExpensive = 0;
+    uint64_t* keys = (uint64_t*)malloc(count * sizeof(uint64_t));
+    uint64_t* scratch = (uint64_t*)malloc(count * sizeof(uint64_t));
+    int* weights = (int*)malloc(count * sizeof(int));
+    int64_t* cents = (int64_t*)malloc(count * sizeof(int64_t));
+    uint32_t* seqs = (uint32_t*)malloc(count * sizeof(uint32_t));
+    if (keys == NULL || scratch == NULL || weights == NULL || cents == NULL || seqs == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        keys[i] = ((uint64_t)((uint32_t)staged->Weights[i] ^ 0x80000000u) << 32) | (uint64_t)i;
+    }
+    sortRowKeys(keys, scratch, count);
+    free(scratch);
+    memset(summary, 0, sizeof(DestSummary));
+    for (size_t r = 0; r < count; ++r)
+    {
+        size_t row = (size_t)(uint32_t)keys[r];
+        weights[r] = staged->Weights[row];
+        cents[r] = staged->Cents[row];
+        seqs[r] = (uint32_t)row;
+        summary->TotalWeight += weights[r];
+        summary->TotalCents += cents[r];
+        if (cents[r] < cents[cheapest] || (cents[r] == cents[cheapest] && seqs[r] < seqs[cheapest]))
+        {
+            cheapest = r;
+        }
+        if (cents[r] > cents[mostExpensive] || (cents[r] == cents[mostExpensive] && seqs[r] > seqs[mostExpensive]))
+        {
+            mostExpensive = r;
+        }
+    }
+    free(keys);
+    packParcelColumns(&dest->Packed, weights, cents, seqs, count);
+
+    size_t extremes[4] = { 0, count - 1, cheapest, mostExpensive };
+    Parcel* nodes = (Parcel*)arenaAlloc(&table->Pool, 4 * sizeof(Parcel));
+    memset(nodes, 0, 4 * sizeof(Parcel));
+    for (int i = 0; i < 4; ++i)
+    {
+        size_t r = extremes[i];
+        nodes[i].Weight = weights[r];
+        nodes[i].Cents = cents[r];
+        nodes[i].Height = 1;
+        nodes[i].Count = 1;
+        nodes[i].SumWeight = weights[r];
+        nodes[i].SumCents = cents[r];
+        nodes[i].Seq = seqs[r];
+        nodes[i].Dest = dest->Id;
+        nodes[i].VHeight = 1;
+    }
+    summary->Count = (int64_t)count;
+    summary->Lightest = &nodes[0];
+    summary->Heaviest = &nodes[1];
+    summary->Cheapest = &nodes[2];
+    summary->MostExpensive = &nodes[3];
+    dest->NextSeq = (unsigned int)count;
+    dest->Changed = true;
+    dest->ChangesLost = true;
+    freeParcelColumns(staged);
+    staged->Stale = false;     // nothing to rebuild the columns from, and nothing scans them
+    free(weights);
+    free(cents);
+    free(seqs);
+}
+
+/*
+* FUNCTION      : sortRowKeys
+* DESCRIPTION   :
+*   This functoin sorts keys whose high 32 bits are the sort key and whose low 32 bits are a row
+*   number that already ascends. A least significant digit radix sort over the high half is stable, so
+*   equal keys stay in row order. Digits every key shares are skipped, which for typical weights
+*   leaves two passes. Short arrays are sorted by insertion instead.
+* PARAMETERS    :
+*   uint64_t* keys      :   the keys, sorted in place.
+*   uint64_t* scratch   :   room for count keys.
+*   size_t count        :   the number of keys.
+* RETURNS       :  void
+*/
+static void sortRowKeys(uint64_t* keys, uint64_t* scratch, size_t count)
+{
+    if (count < DEST_BULK_INSERTION_SORT)
+    {
+        for (size_t i = 1; i < count; ++i)
+        {
+            uint64_t key = keys[i];
+            size_t j = i;
+            while (j > 0 && keys[j - 1] > key)
+            {
+                keys[j] = keys[j - 1];
+                j--;
+            }
+            keys[j] = key;
+        }
+        return;
+    }
+
+    size_t counts[4][256];
+    uint64_t* from = keys;
+    uint64_t* to = scratch;
+    memset(counts, 0, sizeof counts);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t high = (uint32_t)(keys[i] >> 32);
+        counts[0][high & 0xFF]++;
+        counts[1][(high >> 8) & 0xFF]++;
+        counts[2][(high >> 16) & 0xFF]++;
+        counts[3][high >> 24]++;
+    }
+    for (int digit = 0; digit < 4; ++digit)
+    {
+        int shift = 32 + digit * 8;
+        size_t* bucket = counts[digit];
+        if (bucket[(from[0] >> shift) & 0xFF] == count)
+        {
+            continue;
+        }
+        size_t offset = 0;
+        for (int b = 0; b < 256; ++b)
+        {
+            size_t size = bucket[b];
+            bucket[b] = offset;
+            offset += size;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            to[bucket[(from[i] >> shift) & 0xFF]++] = from[i];
+        }
+        uint64_t* swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != keys)
+    {
+        memcpy(keys, from, count * sizeof(uint64_t));
+    }
+}
+
+/*
+* FUNCTION      : sortRowsByCents
+* DESCRIPTION   :
+*   This functoin sorts the nodes of a destination by value, keeping arrival order among equal values.
+*   A value takes 64 bits, twice what sortRowKeys sorts on, so the nodes are sorted on the low half of
+*   their biased value first and then, stably, on the high half; the second pass is skipped when every
+*   value shares its high half, as values below $42 million do.
+* PARAMETERS    :
+*   Parcel** rows       :   the nodes in arrival order.
+*   size_t count        :   the number of nodes.
+*   uint64_t* keys      :   room for count keys.
+*   uint64_t* scratch   :   room for count keys.
+*   Parcel** sorted     :   receives the nodes ordered by (Cents, Seq).
+* RETURNS       :  void
+*/
+static void sortRowsByCents(Parcel** rows, size_t count, uint64_t* keys, uint64_t* scratch, Parcel** sorted)
+{
+    uint64_t firstHigh = ((uint64_t)rows[0]->Cents ^ 0x8000000000000000ull) >> 32;
+    bool wide = false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t biased = (uint64_t)rows[i]->Cents ^ 0x8000000000000000ull;
+        keys[i] = (biased << 32) | (uint64_t)i;
+        wide = wide || (biased >> 32) != firstHigh;
+    }
+    sortRowKeys(keys, scratch, count);
+    if (!wide)
+    {
+        for (size_t r = 0; r < count; ++r)
+        {
+            sorted[r] = rows[(uint32_t)keys[r]];
+        }
+        return;
+    }
+
+    Parcel** byLow = (Parcel**)malloc(count * sizeof(Parcel*));
+    if (byLow == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t r = 0; r < count; ++r)
+    {
+        byLow[r] = rows[(uint32_t)keys[r]];
+        uint64_t biased = (uint64_t)byLow[r]->Cents ^ 0x8000000000000000ull;
+        keys[r] = (biased & 0xFFFFFFFF00000000ull) | (uint64_t)r;
+    }
+    sortRowKeys(keys, scratch, count);
+    for (size_t r = 0; r < count; ++r)
+    {
+        sorted[r] = byLow[(uint32_t)keys[r]];
+    }
+    free(byLow);
+}
@@ -0,0 +1,110 @@
+/*
+* FILENAME      : destTable.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the destination index: an open-addressing hash table that maps each destination
+*   name to its own Destination record (and therefore its own parcel tree). The table stores the key,
+*   so colliding names never share a tree, and it doubles in size whenever the load factor passes 3/4.
+*   Names are hashed and compared in normalized form, so a lookup ignores case and stray blanks, and
+*   each Destination carries the id its name has in the destination dictionary (see dictionary.h),
+*   which is what every parcel stores. Destination records and parcel nodes live in the table's arena;
+*   the names belong to the dictionary, and the column arrays built for scans are allocated on their own.
+*   A table marked Packed builds each destination's bulk-loaded rows into packed columns (see packed.h)
+*   instead of trees, and is never changed after that.
+*
+*   Once a destination has been published to concurrent readers (see concurrent.h), every parcel
+*   added to it or removed from it is also logged, so the next publish can replay the changes on the
+*   published copy instead of copying the whole destination again.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+#include "arena.h"
+#include "parcel.h"
+#include "columns.h"
+#include "packed.h"
+#include "dictionary.h"
+
+#define DEST_TABLE_INITIAL_SIZE     128     // must be a power of two
+#define DEST_TABLE_LOAD_NUM         3       // grow when Count / Capacity exceeds NUM / DEN
+#define DEST_TABLE_LOAD_DEN         4
+#define DEST_BULK_INSERTION_SORT    64      // staged destinations with fewer rows are sorted by insertion
+#define DEST_CHANGE_LOG_RATIO       4       // the log is dropped once it holds more than Count / RATIO changes
+
+// running totals of a destination, kept up to date by every insert and removal so that queries never walk the tree
+typedef struct DestSummary
+{
+    int64_t Count;
+    int64_t TotalWeight;    // grams
+    int64_t TotalCents;     // value as exact fixed-point cents
+    Parcel* Lightest;       // first-arrived parcel of the lowest weight
+    Parcel* Heaviest;       // last-arrived parcel of the highest weight
+    Parcel* Cheapest;       // first-arrived parcel of the lowest value
+    Parcel* MostExpensive;  // last-arrived parcel of the highest value
+} DestSummary;
+
+// a parcel added to or removed from a published destination, see concurrent.h
+typedef struct DestChange
+{
+    int Weight;
+    unsigned int Seq;
+    int64_t Cents;
+    bool Added;             // false for a removal, which carries the key the parcel was filed under
+} DestChange;
+
+typedef struct Destination
+{
+    const char* Name;       // the dictionary's spelling of the name
+    size_t NameLen;
+    DestId Id;
+    Parcel* Root;           // primary index, ordered by weight
+    Parcel* ValueRoot;      // secondary index over the same nodes, ordered by value
+    unsigned int NextSeq;   // sequence number handed to the next parcel inserted into Root
+    DestSummary Summary;
+    ParcelColumns Columns;  // weight-sorted copy of the tree for scans, rebuilt on demand
+    std::mutex* ColumnsLock;    // taken while Columns is rebuilt, only on copies shared by concurrent readers
+    PackedColumns Packed;   // the parcels of a destination of a packed table, which has no trees
+    struct Destination* Published;  // read-only copy in the newest concurrent view, see concurrent.h
+    bool Changed;           // a parcel was added or removed since Published was made
+    DestChange* Changes;    // those changes in order, while Published can be brought up to date from them
+    size_t ChangeCount;
+    size_t ChangeCapacity;
+    bool ChangesLost;       // the changes were too many, or not made one parcel at a time, to be logged
+} Destination;
+
+typedef struct DestSlot
+{
+    uint64_t Hash;
+    Destination* Dest;      // NULL marks an empty slot
+} DestSlot;
+
+typedef struct DestTable
+{
+    DestSlot* Slots;
+    size_t Capacity;
+    size_t Count;
+    Arena Pool;             // owns names, Destination records and parcel nodes
+    Parcel* FreeParcels;    // deleted nodes chained through Left, reused by the next inserts
+    bool Packed;            // staged destinations are packed instead of built into trees
+} DestTable;
+
+uint64_t generateHash(const char* str, size_t len);
+void initDestTable(DestTable* table, size_t capacity);
+Destination* findDestination(const DestTable* table, const char* name, size_t len);
+Destination* findDestinationHashed(const DestTable* table, const char* name, size_t len, uint64_t hash);
+Destination* findOrAddDestination(DestTable* table, const char* name, size_t len);
+Destination* findOrAddDestinationHashed(DestTable* table, const char* name, size_t len, uint64_t hash);
+void deleteDestTable(DestTable* table);
+void mergeDestTable(DestTable* target, DestTable* source);
+void buildStagedDestinations(DestTable* table);
+void addParcelToDestination(Destination* dest, Parcel* parcel);
+void removeParcelFromDestination(Destination* dest, Parcel* parcel);
+void updateParcelInDestination(Destination* dest, Parcel* parcel, int weight, int64_t cents);
+void deleteParcel(DestTable* table, Destination* dest, Parcel* parcel);
+ParcelColumns* getDestColumns(Destination* dest);
+void clearDestChanges(Destination* dest);
+void insertHashTableWithBST(DestTable* table, const char* dest, size_t destLen, int weight, int64_t cents);
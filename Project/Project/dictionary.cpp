@@ -0,0 +1,470 @@
+/*
+* FILENAME      : dictionary.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the destination dictionary declared in dictionary.h. Ids index a table of
+*   fixed-size blocks that are allocated once and never moved, so an id can be read while another
+*   thread adds names. The trie stores one node per byte of a normalized name, linked first-child /
+*   next-sibling in a single array, with every sibling list sorted by byte.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mutex>
+#include "dictionary.h"
+#include "arena.h"
+
+typedef struct DestEntry
+{
+    const char* Name;       // the first spelling seen, with its blanks normalized
+    size_t NameLen;
+} DestEntry;
+
+typedef struct TrieNode
+{
+    uint32_t FirstChild;    // 0 when there is none, the root is never a child
+    uint32_t NextSibling;   // the sibling with the next higher byte, 0 when there is none
+    DestId Id;              // the name ending here, or DEST_ID_NONE
+    unsigned char Byte;
+} TrieNode;
+
+static std::mutex dictionaryMutex;         // serialises every change, and reading the trie
+static DestEntry* blocks[DEST_DICT_MAX_BLOCKS];
+static DestId destCount = 0;
+static TrieNode* trie = NULL;
+static uint32_t trieCount = 0;
+static uint32_t trieCapacity = 0;
+static Arena names;
+static bool namesReady = false;
+
+static int nextFoldedChar(const char* name, size_t len, size_t* pos, bool foldCase);
+static uint32_t findTrieNode(const char* folded, size_t len);
+static uint32_t addTrieNode(unsigned char byte);
+
+/*
+* FUNCTION      : internDestName
+* DESCRIPTION   :
+*   This functoin returns the id of a destination name, adding the name to the dictionary and its trie
+*   if no name with the same normalized form is there yet.
+* PARAMETERS    :
+*   const char* name    :   the destination name, it does not need to be null terminated.
+*   size_t len          :   the length of the name.
+* RETURNS       :
+*   DestId  : the id of the name.
+*/
+DestId internDestName(const char* name, size_t len)
+{
+    char buffer[DEST_FOLD_BUFFER];
+    char* folded = len <= sizeof buffer ? buffer : (char*)malloc(len);
+    if (folded == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t foldedLen = foldDestName(name, len, folded);
+
+    std::lock_guard<std::mutex> lock(dictionaryMutex);
+    if (trie == NULL)
+    {
+        addTrieNode(0);     // the root
+    }
+    uint32_t node = 0;
+    for (size_t i = 0; i < foldedLen; ++i)
+    {
+        unsigned char byte = (unsigned char)folded[i];
+        uint32_t* link = &trie[node].FirstChild;
+        while (*link != 0 && trie[*link].Byte < byte)
+        {
+            link = &trie[*link].NextSibling;
+        }
+        if (*link == 0 || trie[*link].Byte != byte)
+        {
+            uint32_t child = addTrieNode(byte);     // may move the array, so the link is found again
+            link = &trie[node].FirstChild;
+            while (*link != 0 && trie[*link].Byte < byte)
+            {
+                link = &trie[*link].NextSibling;
+            }
+            trie[child].NextSibling = *link;
+            *link = child;
+        }
+        node = *link;
+    }
+    if (folded != buffer)
+    {
+        free(folded);
+    }
+    if (trie[node].Id != DEST_ID_NONE)
+    {
+        return trie[node].Id;
+    }
+
+    // a new name: its spelling is kept with the blanks normalized but the case untouched
+    DestId id = destCount;
+    if (id / DEST_DICT_BLOCK_SIZE >= DEST_DICT_MAX_BLOCKS)
+    {
+        printf("**ERROR: Too many destinations!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (blocks[id / DEST_DICT_BLOCK_SIZE] == NULL)
+    {
+        blocks[id / DEST_DICT_BLOCK_SIZE] = (DestEntry*)calloc(DEST_DICT_BLOCK_SIZE, sizeof(DestEntry));
+        if (blocks[id / DEST_DICT_BLOCK_SIZE] == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!namesReady)
+    {
+        initArena(&names, ARENA_CHUNK_SIZE);
+        namesReady = true;
+    }
+    char* spelling = (char*)arenaAlloc(&names, foldedLen + 1);
+    size_t pos = 0;
+    size_t spellingLen = 0;
+    for (int c = nextFoldedChar(name, len, &pos, false); c >= 0; c = nextFoldedChar(name, len, &pos, false))
+    {
+        spelling[spellingLen++] = (char)c;
+    }
+    spelling[spellingLen] = '\0';
+
+    DestEntry* entry = &blocks[id / DEST_DICT_BLOCK_SIZE][id % DEST_DICT_BLOCK_SIZE];
+    entry->Name = spelling;
+    entry->NameLen = spellingLen;
+    trie[node].Id = id;
+    destCount++;
+    return id;
+}
+
+/*
+* FUNCTION      : getDestName
+* DESCRIPTION   : This functoin returns the spelling of a destination id.
+* PARAMETERS    :
+*   DestId id   :   an id handed out by internDestName.
+* RETURNS       :
+*   const char* : the null-terminated name, valid until releaseDestDictionary.
+*/
+const char* getDestName(DestId id)
+{
+    return blocks[id / DEST_DICT_BLOCK_SIZE][id % DEST_DICT_BLOCK_SIZE].Name;
+}
+
+/*
+* FUNCTION      : getDestNameLen
+* DESCRIPTION   : This functoin returns the length of the spelling of a destination id.
+* PARAMETERS    :
+*   DestId id   :   an id handed out by internDestName.
+* RETURNS       :
+*   size_t  : the length of the name.
+*/
+size_t getDestNameLen(DestId id)
+{
+    return blocks[id / DEST_DICT_BLOCK_SIZE][id % DEST_DICT_BLOCK_SIZE].NameLen;
+}
+
+/*
+* FUNCTION      : completeDestName
+* DESCRIPTION   :
+*   This functoin lists the ids of every name whose normalized form starts with the normalized form of
+*   a prefix, in alphabetical order of the normalized names. The subtree below the prefix is walked
+*   depth first: a node comes before its children, and its children before its next sibling.
+* PARAMETERS    :
+*   const char* prefix  :   the start of the names, it does not need to be null terminated.
+*   size_t len          :   the length of the prefix; an empty prefix lists every name.
+*   size_t* count       :   receives the number of ids listed.
+* RETURNS       :
+*   DestId* : a new array of the ids, to be freed by the caller.
+*/
+DestId* completeDestName(const char* prefix, size_t len, size_t* count)
+{
+    char buffer[DEST_FOLD_BUFFER];
+    char* folded = len <= sizeof buffer ? buffer : (char*)malloc(len);
+    if (folded == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t foldedLen = foldDestName(prefix, len, folded);
+
+    std::lock_guard<std::mutex> lock(dictionaryMutex);
+    DestId* ids = (DestId*)malloc(((size_t)destCount + 1) * sizeof(DestId));
+    uint32_t* stack = (uint32_t*)malloc(((size_t)trieCount + 1) * sizeof(uint32_t));
+    if (ids == NULL || stack == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    *count = 0;
+    uint32_t start = findTrieNode(folded, foldedLen);     // the root for an empty prefix
+    if (folded != buffer)
+    {
+        free(folded);
+    }
+    if (trie == NULL || (start == 0 && foldedLen > 0))
+    {
+        free(stack);
+        return ids;
+    }
+
+    int top = 0;
+    if (trie[start].Id != DEST_ID_NONE)
+    {
+        ids[(*count)++] = trie[start].Id;
+    }
+    if (trie[start].FirstChild != 0)
+    {
+        stack[top++] = trie[start].FirstChild;
+    }
+    while (top > 0)
+    {
+        uint32_t node = stack[--top];
+        if (trie[node].Id != DEST_ID_NONE)
+        {
+            ids[(*count)++] = trie[node].Id;
+        }
+        if (trie[node].NextSibling != 0)
+        {
+            stack[top++] = trie[node].NextSibling;
+        }
+        if (trie[node].FirstChild != 0)
+        {
+            stack[top++] = trie[node].FirstChild;
+        }
+    }
+    free(stack);
+    return ids;
+}
+
+/*
+* FUNCTION      : seedDestDictionary
+* DESCRIPTION   :
+*   This functoin adds the destination names listed one per line in a file, such as countries.txt, so
+*   that they are known with their proper spelling before any parcel is loaded. Blank lines are skipped,
+*   and so are lines longer than DEST_SEED_LINE_SIZE, which are reported rather than split into names.
+* PARAMETERS    :
+*   const char* path    :   the file of names.
+* RETURNS       :
+*   bool    : true, if the file could be read. otherwise, false.
+*/
+bool seedDestDictionary(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    char line[DEST_SEED_LINE_SIZE];
+    size_t lineNumber = 0;
+    if (file == NULL)
+    {
+        return false;
+    }
+    while (fgets(line, sizeof line, file) != NULL)
+    {
+        size_t pos = 0;
+        size_t len = strlen(line);
+        lineNumber++;
+        if (len == sizeof line - 1 && line[len - 1] != '\n' && !feof(file))
+        {
+            int c = 0;
+            while ((c = fgetc(file)) != EOF && c != '\n');
+            printf("**%s line %zu: longer than %d characters, skipped\n", path, lineNumber, DEST_SEED_LINE_SIZE - 2);
+            continue;
+        }
+        if (nextFoldedChar(line, len, &pos, false) >= 0)
+        {
+            internDestName(line, len);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+/*
+* FUNCTION      : releaseDestDictionary
+* DESCRIPTION   :
+*   This functoin frees every name, id block and trie node of the dictionary. No id handed out before
+*   may be used afterwards.
+* PARAMETERS    : none
+* RETURNS       : void
+*/
+void releaseDestDictionary(void)
+{
+    std::lock_guard<std::mutex> lock(dictionaryMutex);
+    for (size_t i = 0; i < DEST_DICT_MAX_BLOCKS && blocks[i] != NULL; ++i)
+    {
+        free(blocks[i]);
+        blocks[i] = NULL;
+    }
+    if (namesReady)
+    {
+        releaseArena(&names);
+        namesReady = false;
+    }
+    free(trie);
+    trie = NULL;
+    trieCount = 0;
+    trieCapacity = 0;
+    destCount = 0;
+}
+
+/*
+* FUNCTION      : foldDestName
+* DESCRIPTION   :
+*   This functoin writes the normalized form of a destination name: no blanks at either end, one space
+*   for every run of blanks inside, and ASCII letters in lower case. Two names match exactly when
+*   their normalized forms are equal.
+* PARAMETERS    :
+*   const char* name    :   the destination name, it does not need to be null terminated.
+*   size_t len          :   the length of the name.
+*   char* folded        :   receives the normalized form, which is never longer than the name.
+* RETURNS       :
+*   size_t  : the length of the normalized form.
+*/
+size_t foldDestName(const char* name, size_t len, char* folded)
+{
+    size_t pos = 0;
+    size_t foldedLen = 0;
+    for (int c = nextFoldedChar(name, len, &pos, true); c >= 0; c = nextFoldedChar(name, len, &pos, true))
+    {
+        folded[foldedLen++] = (char)c;
+    }
+    return foldedLen;
+}
+
+/*
+* FUNCTION      : sameDestName
+* DESCRIPTION   :
+*   This functoin compares two destination names in normalized form without writing either out. Names
+*   that are byte for byte equal, by far the most common match, are settled with a single memcmp.
+* PARAMETERS    :
+*   const char* a   :   the first name, it does not need to be null terminated.
+*   size_t aLen     :   the length of the first name.
+*   const char* b   :   the second name, it does not need to be null terminated.
+*   size_t bLen     :   the length of the second name.
+* RETURNS       :
+*   bool    : true, if the names match. otherwise, false.
+*/
+bool sameDestName(const char* a, size_t aLen, const char* b, size_t bLen)
+{
+    if (aLen == bLen && memcmp(a, b, aLen) == 0)
+    {
+        return true;
+    }
+    size_t aPos = 0;
+    size_t bPos = 0;
+    int aChar;
+    int bChar;
+    do
+    {
+        aChar = nextFoldedChar(a, aLen, &aPos, true);
+        bChar = nextFoldedChar(b, bLen, &bPos, true);
+        if (aChar != bChar)
+        {
+            return false;
+        }
+    } while (aChar >= 0);
+    return true;
+}
+
+/*
+* FUNCTION      : nextFoldedChar
+* DESCRIPTION   :
+*   This functoin reads the next character of the normalized form of a name. Blanks at the start are
+*   skipped, a run of blanks followed by anything else reads as one space, and blanks at the end read
+*   as the end of the name.
+* PARAMETERS    :
+*   const char* name    :   the destination name.
+*   size_t len          :   the length of the name.
+*   size_t* pos         :   the position reached in the name, 0 at the start.
+*   bool foldCase       :   whether ASCII letters are read in lower case.
+* RETURNS       :
+*   int : the character, or -1 at the end of the name.
+*/
+static int nextFoldedChar(const char* name, size_t len, size_t* pos, bool foldCase)
+{
+    size_t start = *pos;
+    size_t i = start;
+    while (i < len && (name[i] == ' ' || name[i] == '\t' || name[i] == '\r' || name[i] == '\n'))
+    {
+        i++;
+    }
+    if (i == len)
+    {
+        *pos = len;
+        return -1;
+    }
+    if (i > start && start > 0)
+    {
+        *pos = i;
+        return ' ';
+    }
+    *pos = i + 1;
+    unsigned char c = (unsigned char)name[i];
+    return foldCase && c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+/*
+* FUNCTION      : findTrieNode
+* DESCRIPTION   : This functoin follows a normalized name down the trie. The caller holds the lock.
+* PARAMETERS    :
+*   const char* folded  :   the normalized name.
+*   size_t len          :   its length.
+* RETURNS       :
+*   uint32_t    : the node the name ends at, or 0 when no name starts with it.
+*/
+static uint32_t findTrieNode(const char* folded, size_t len)
+{
+    uint32_t node = 0;
+    if (trie == NULL)
+    {
+        return 0;
+    }
+    for (size_t i = 0; i < len; ++i)
+    {
+        unsigned char byte = (unsigned char)folded[i];
+        node = trie[node].FirstChild;
+        while (node != 0 && trie[node].Byte < byte)
+        {
+            node = trie[node].NextSibling;
+        }
+        if (node == 0 || trie[node].Byte != byte)
+        {
+            return 0;
+        }
+    }
+    return node;
+}
+
+/*
+* FUNCTION      : addTrieNode
+* DESCRIPTION   :
+*   This functoin appends an unlinked node to the trie, doubling the node array when it is full. The
+*   caller holds the lock.
+* PARAMETERS    :
+*   unsigned char byte  :   the byte the node stands for.
+* RETURNS       :
+*   uint32_t    : the index of the new node.
+*/
+static uint32_t addTrieNode(unsigned char byte)
+{
+    if (trieCount == trieCapacity)
+    {
+        uint32_t capacity = trieCapacity == 0 ? 256 : trieCapacity * 2;
+        TrieNode* nodes = (TrieNode*)realloc(trie, (size_t)capacity * sizeof(TrieNode));
+        if (nodes == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+        trie = nodes;
+        trieCapacity = capacity;
+    }
+    TrieNode* node = &trie[trieCount];
+    node->FirstChild = 0;
+    node->NextSibling = 0;
+    node->Id = DEST_ID_NONE;
+    node->Byte = byte;
+    return trieCount++;
+}
@@ -0,0 +1,39 @@
+/*
+* FILENAME      : dictionary.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the destination dictionary shared by every destination index of the process.
+*   It maps each destination name to a compact DestId, which is what a parcel stores instead of a
+*   pointer to its name. Names are matched in normalized form: blanks around a name are dropped, runs
+*   of blanks inside it count as one space and ASCII letters match whatever their case. A name keeps
+*   the spelling it was first seen with, so seeding the dictionary from countries.txt gives every
+*   destination its proper spelling whatever the courier files or the user type.
+*
+*   The normalized names are also kept in a compact trie whose children are sorted, so the names that
+*   start with a prefix can be listed in alphabetical order for autocompletion. Adding a name takes a
+*   lock; reading the name of an id does not, since ids are never moved or reused once handed out.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define DEST_DICT_BLOCK_SIZE    4096        // names per block of the id table
+#define DEST_DICT_MAX_BLOCKS    4096        // so at most 16M distinct destinations
+#define DEST_FOLD_BUFFER        256         // names up to this length are normalized on the stack
+#define DEST_SEED_LINE_SIZE     1024        // longest line of a seed file, newline and terminator included
+#define DEST_ID_NONE            0xFFFFFFFFu
+
+typedef uint32_t DestId;
+
+DestId internDestName(const char* name, size_t len);
+const char* getDestName(DestId id);
+size_t getDestNameLen(DestId id);
+DestId* completeDestName(const char* prefix, size_t len, size_t* count);
+bool seedDestDictionary(const char* path);
+void releaseDestDictionary(void);
+size_t foldDestName(const char* name, size_t len, char* folded);
+bool sameDestName(const char* a, size_t aLen, const char* b, size_t bLen);
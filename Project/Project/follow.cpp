@@ -0,0 +1,225 @@
+/*
+* FILENAME      : follow.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements follow mode declared in follow.h. The file is read through a plain descriptor
+*   rather than a mapping, because it keeps growing while it is followed.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "follow.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+* FUNCTION      : startFollow
+* DESCRIPTION   :
+*   This functoin loads every complete line of a courier file, like loadParcelsFromFile, and keeps the
+*   file open positioned after the last newline, so a line that is still being written is picked up
+*   by the next poll. A named pipe has nothing to load up front and is opened without blocking.
+* PARAMETERS    :
+*   DestTable* table        :   the destination index receiving the parcels.
+*   const char* path        :   the courier file or pipe.
+*   FollowState* follow     :   receives the open file.
+*   LoadResult* result      :   receives the number of loaded and rejected lines.
+* RETURNS       :
+*   bool    : true, if the file could be read. otherwise, false.
+*/
+bool startFollow(DestTable* table, const char* path, FollowState* follow, LoadResult* result)
+{
+    struct stat info;
+
+    result->Loaded = 0;
+    result->Rejected = 0;
+    result->Lines = 0;
+    follow->Path = path;
+    follow->Handle = -1;
+    follow->IsPipe = false;
+    follow->Offset = 0;
+    follow->Pending = 0;
+    follow->Overlong = false;
+    follow->Buffer = (char*)malloc(FOLLOW_BUFFER_SIZE);
+    if (follow->Buffer == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (stat(path, &info) != 0)
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    follow->Handle = _open(path, _O_RDONLY | _O_BINARY);
+#else
+    follow->IsPipe = S_ISFIFO(info.st_mode);
+    follow->Handle = open(path, O_RDONLY | (follow->IsPipe ? O_NONBLOCK : 0));
+#endif
+    if (follow->Handle < 0)
+    {
+        return false;
+    }
+    if (follow->IsPipe)
+    {
+        return true;
+    }
+
+    MappedFile file;
+    if (!mapFile(path, &file))
+    {
+        return false;
+    }
+    size_t complete = file.Size;
+    while (complete > 0 && file.Data[complete - 1] != '\n')
+    {
+        complete--;
+    }
+    loadParcelData(table, file.Data, complete, result);
+    unmapFile(&file);
+
+    follow->Offset = complete;
+#ifdef _WIN32
+    _lseeki64(follow->Handle, (__int64)complete, SEEK_SET);
+#else
+    lseek(follow->Handle, (off_t)complete, SEEK_SET);
+#endif
+    return true;
+}
+
+/*
+* FUNCTION      : pollFollow
+* DESCRIPTION   :
+*   This functoin reads what has been appended to the followed file since the last poll, up to
+*   FOLLOW_MAX_POLL_BYTES, and inserts every line that is complete. If the file has shrunk it is
+*   followed again from its start. A line longer than FOLLOW_BUFFER_SIZE is reported and skipped.
+* PARAMETERS    :
+*   DestTable* table        :   the destination index receiving the parcels.
+*   FollowState* follow     :   the followed file.
+*   LoadResult* result      :   running counters.
+* RETURNS       :
+*   size_t  : the number of parcels inserted by this poll.
+*/
+size_t pollFollow(DestTable* table, FollowState* follow, LoadResult* result)
+{
+    size_t loadedBefore = result->Loaded;
+    size_t polled = 0;
+
+    if (follow->Handle < 0)
+    {
+        return 0;
+    }
+    if (!follow->IsPipe)
+    {
+#ifdef _WIN32
+        struct _stat64 info;
+        bool shrunk = _fstat64(follow->Handle, &info) == 0 && (uint64_t)info.st_size < follow->Offset;
+#else
+        struct stat info;
+        bool shrunk = fstat(follow->Handle, &info) == 0 && (uint64_t)info.st_size < follow->Offset;
+#endif
+        if (shrunk)
+        {
+            printf("**%s was truncated, following it from the start\n", follow->Path);
+#ifdef _WIN32
+            _lseeki64(follow->Handle, 0, SEEK_SET);
+#else
+            lseek(follow->Handle, 0, SEEK_SET);
+#endif
+            follow->Offset = 0;
+            follow->Pending = 0;
+            follow->Overlong = false;
+        }
+    }
+
+    while (polled < FOLLOW_MAX_POLL_BYTES)
+    {
+#ifdef _WIN32
+        int count = _read(follow->Handle, follow->Buffer + follow->Pending, (unsigned int)(FOLLOW_BUFFER_SIZE - follow->Pending));
+#else
+        ssize_t count = read(follow->Handle, follow->Buffer + follow->Pending, FOLLOW_BUFFER_SIZE - follow->Pending);
+#endif
+        if (count <= 0)
+        {
+            break;      // nothing new yet, or no writer on the pipe
+        }
+        polled += (size_t)count;
+        follow->Offset += (uint64_t)count;
+
+        size_t filled = follow->Pending + (size_t)count;
+        size_t complete = filled;
+        while (complete > 0 && follow->Buffer[complete - 1] != '\n')
+        {
+            complete--;
+        }
+        if (complete == 0)
+        {
+            if (filled == FOLLOW_BUFFER_SIZE)
+            {
+                if (!follow->Overlong)
+                {
+                    result->Lines++;
+                    result->Rejected++;
+                    printf("**Line %zu: longer than %u bytes, skipped\n", result->Lines, FOLLOW_BUFFER_SIZE);
+                    follow->Overlong = true;
+                }
+                filled = 0;
+            }
+            follow->Pending = filled;
+            continue;
+        }
+
+        size_t start = 0;
+        if (follow->Overlong)
+        {
+            // the first newline ends the line being skipped
+            start = (size_t)((const char*)memchr(follow->Buffer, '\n', complete) - follow->Buffer) + 1;
+            follow->Overlong = false;
+        }
+        loadParcelBuffer(table, follow->Buffer + start, complete - start, result);
+        memmove(follow->Buffer, follow->Buffer + complete, filled - complete);
+        follow->Pending = filled - complete;
+    }
+    return result->Loaded - loadedBefore;
+}
+
+/*
+* FUNCTION      : stopFollow
+* DESCRIPTION   :
+*   This functoin closes the followed file; a pending partial line is dropped. A zeroed state that was
+*   never started is left alone.
+* PARAMETERS    :
+*   FollowState* follow     :   the followed file.
+* RETURNS       : void
+*/
+void stopFollow(FollowState* follow)
+{
+    if (follow->Buffer == NULL)
+    {
+        return;
+    }
+    if (follow->Handle >= 0)
+    {
+#ifdef _WIN32
+        _close(follow->Handle);
+#else
+        close(follow->Handle);
+#endif
+    }
+    free(follow->Buffer);
+    follow->Buffer = NULL;
+    follow->Handle = -1;
+    follow->Pending = 0;
+}
@@ -0,0 +1,36 @@
+/*
+* FILENAME      : follow.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares follow mode: after the initial load, the courier file (or a named pipe) is kept
+*   open and every poll inserts the complete lines appended since the last one. A poll only touches
+*   the new bytes, so its cost grows with the batch rather than with the data already loaded. A line
+*   still being written stays pending until its newline arrives.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "destTable.h"
+#include "loader.h"
+
+#define FOLLOW_BUFFER_SIZE      (64u << 10)     // also the longest line follow mode accepts
+#define FOLLOW_MAX_POLL_BYTES   (4u << 20)      // read at most this much per poll so queries are not starved
+
+typedef struct FollowState
+{
+    const char* Path;
+    int Handle;             // file descriptor, -1 when closed
+    bool IsPipe;            // a pipe cannot be sought or truncated
+    uint64_t Offset;        // bytes of the file consumed, including Pending
+    char* Buffer;
+    size_t Pending;         // bytes at the start of Buffer that do not end a line yet
+    bool Overlong;          // the pending line overflowed Buffer and is being skipped
+} FollowState;
+
+bool startFollow(DestTable* table, const char* path, FollowState* follow, LoadResult* result);
+size_t pollFollow(DestTable* table, FollowState* follow, LoadResult* result);
+void stopFollow(FollowState* follow);
@@ -0,0 +1,674 @@
+/*
+* FILENAME      : global.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the network-wide queries declared in global.h. Every destination already
+*   keeps O(1) totals and extremes, so the network totals only sum those; the top parcels walk each
+*   destination's tree, or its packed columns, with a row cursor from the wanted end, and only as far
+*   as the merge pulls.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "global.h"
+#include "parcel.h"
+#include "threadPool.h"
+#include "metrics.h"
+
+// a parcel waiting in a merge, with the cursor or block it came from
+typedef struct MergeEntry
+{
+    Parcel* Item;
+    int Source;
+} MergeEntry;
+
+// a destination and the index it was found in, while the destinations of several indexes are sorted
+typedef struct SortedDest
+{
+    Destination* Dest;
+    size_t Table;
+} SortedDest;
+
+// the destinations a network-wide query fans out over, and what each block of them found
+typedef struct GlobalJob
+{
+    Destination** Dests;
+    size_t DestCount;
+    int TaskCount;
+    GlobalOrder Order;
+    int Count;                  // parcels wanted by a top query
+    DestSummary* Partials;      // the totals of each block
+    Parcel* Runs;               // Count parcels per block, best first, copied out of their cursors
+    int* RunLengths;
+} GlobalJob;
+
+static Destination** collectDestinations(DestTable* const* tables, size_t tableCount, bool newestFirst, size_t* count);
+static int globalTaskCount(size_t destCount);
+static void blockBounds(const GlobalJob* job, int taskIndex, size_t* begin, size_t* end);
+static void sumBlockTask(void* context, int taskIndex, int workerIndex);
+static void mergeBlockTask(void* context, int taskIndex, int workerIndex);
+static void mergeSummary(DestSummary* into, const DestSummary* from);
+static Parcel* startCursor(RowCursor* cursor, Destination* dest, GlobalOrder order, int count);
+static Parcel* stepCursor(RowCursor* cursor, GlobalOrder order);
+static bool mergesBefore(GlobalOrder order, const MergeEntry* first, const MergeEntry* second);
+static void pushMerge(MergeEntry* heap, int* size, MergeEntry entry, GlobalOrder order);
+static MergeEntry popMerge(MergeEntry* heap, int* size, GlobalOrder order);
+static int compareByValue(const void* first, const void* second);
+static int compareByName(const void* first, const void* second);
+static int compareSortedDests(const void* first, const void* second);
+static int compareSortedDestsNewestFirst(const void* first, const void* second);
+
+/*
+* FUNCTION      : printNetworkTotals
+* DESCRIPTION   :
+*   This functoin displays the parcel count, total load and total valuation across every destination,
+*   with the lightest, heaviest, cheapest and most expensive parcels anywhere. Each block of
+*   destinations is summed on the pool, then the block sums are reduced pairwise.
+* PARAMETERS    :
+*   OutBuf* out                 :   the buffer receiving the output.
+*   DestTable* const* tables    :   the destination indexes containing all parcels.
+*   size_t tableCount           :   the number of indexes.
+* RETURNS       :  void
+*/
+void printNetworkTotals(OutBuf* out, DestTable* const* tables, size_t tableCount)
+{
+    METRIC_START(queryTimer);
+    GlobalJob job = {};
+    DestSummary total = {};
+    size_t distinct = 0;
+
+    job.Dests = collectDestinations(tables, tableCount, false, &job.DestCount);
+    for (size_t d = 0; d < job.DestCount; ++d)
+    {
+        distinct += d == 0 || job.Dests[d]->Id != job.Dests[d - 1]->Id;
+    }
+    job.TaskCount = globalTaskCount(job.DestCount);
+    if (job.TaskCount > 0)
+    {
+        job.Partials = (DestSummary*)malloc((size_t)job.TaskCount * sizeof(DestSummary));
+        if (job.Partials == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+        runParallel(job.TaskCount, sumBlockTask, &job);
+        for (int stride = 1; stride < job.TaskCount; stride *= 2)
+        {
+            for (int t = 0; t + stride < job.TaskCount; t += 2 * stride)
+            {
+                mergeSummary(&job.Partials[t], &job.Partials[t + stride]);
+            }
+        }
+        total = job.Partials[0];
+    }
+
+    outPrintf(out, "\nNetwork:\t Destinations: %zu\t Parcels: %lld\t Total Weight: %8lld gms\t Total: $%7lld.%02lld\n",
+        distinct, (long long)total.Count, (long long)total.TotalWeight,
+        (long long)(total.TotalCents / 100), (long long)(total.TotalCents % 100));
+    if (total.Count > 0)
+    {
+        outLabel(out, "\nThe Lightest Parcel:\n");
+        printParcel(out, total.Lightest);
+        outLabel(out, "\nThe Heaviest Parcel:\n");
+        printParcel(out, total.Heaviest);
+        outLabel(out, "\nThe Cheapest Parcel:\n");
+        printParcel(out, total.Cheapest);
+        outLabel(out, "\nThe Most Expensive Parcel:\n");
+        printParcel(out, total.MostExpensive);
+    }
+    free(job.Partials);
+    free(job.Dests);
+    METRIC_STOP_QUERY("network", queryTimer);
+}
+
+/*
+* FUNCTION      : printTopParcelsAnywhere
+* DESCRIPTION   :
+*   This functoin displays the heaviest, lightest or most valuable parcels across every destination,
+*   best first. Each block of destinations merges its destinations' cursors into its own best parcels
+*   on the pool; those runs are then merged again, stopping once enough parcels have been displayed.
+*   Ties go to the destination met first, then to the order of the destination's tree. When the
+*   heaviest or most valuable come first, the last arrived of a tie comes first too, so a destination
+*   found in several indexes is walked from the newest index down, as one index holding them all would.
+* PARAMETERS    :
+*   OutBuf* out                 :   the buffer receiving the output.
+*   DestTable* const* tables    :   the destination indexes containing all parcels.
+*   size_t tableCount           :   the number of indexes.
+*   GlobalOrder order           :   which parcels count as best.
+*   int count                   :   the most parcels to display.
+* RETURNS       :  void
+*/
+void printTopParcelsAnywhere(OutBuf* out, DestTable* const* tables, size_t tableCount, GlobalOrder order, int count)
+{
+    METRIC_START(queryTimer);
+    static const char* const titles[] = { "Heaviest", "Lightest", "Most Valuable" };
+    GlobalJob job = {};
+    int64_t parcels = 0;
+
+    outLabel(out, "\n/================ %d %s Parcels Anywhere ================/\n\n", count, titles[order]);
+    job.Dests = collectDestinations(tables, tableCount, order != GLOBAL_LIGHTEST, &job.DestCount);
+    for (size_t d = 0; d < job.DestCount; ++d)
+    {
+        parcels += job.Dests[d]->Summary.Count;
+    }
+    job.Order = order;
+    job.Count = parcels < count ? (int)parcels : count;
+    job.TaskCount = job.Count > 0 ? globalTaskCount(job.DestCount) : 0;
+    if (job.TaskCount > 0)
+    {
+        job.Runs = (Parcel*)malloc((size_t)job.TaskCount * (size_t)job.Count * sizeof(Parcel));
+        job.RunLengths = (int*)malloc((size_t)job.TaskCount * sizeof(int));
+        MergeEntry* heap = (MergeEntry*)malloc((size_t)job.TaskCount * sizeof(MergeEntry));
+        int* taken = (int*)calloc((size_t)job.TaskCount, sizeof(int));
+        if (job.Runs == NULL || job.RunLengths == NULL || heap == NULL || taken == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+        runParallel(job.TaskCount, mergeBlockTask, &job);
+
+        int heapSize = 0;
+        for (int t = 0; t < job.TaskCount; ++t)
+        {
+            if (job.RunLengths[t] > 0)
+            {
+                MergeEntry entry = { &job.Runs[(size_t)t * job.Count], t };
+                pushMerge(heap, &heapSize, entry, order);
+            }
+        }
+        for (int shown = 0; shown < job.Count && heapSize > 0 && !outPageFull(out); ++shown)
+        {
+            MergeEntry best = popMerge(heap, &heapSize, order);
+            printParcel(out, best.Item);
+            int t = best.Source;
+            if (++taken[t] < job.RunLengths[t])
+            {
+                MergeEntry entry = { &job.Runs[(size_t)t * job.Count + taken[t]], t };
+                pushMerge(heap, &heapSize, entry, order);
+            }
+        }
+        free(taken);
+        free(heap);
+    }
+    free(job.RunLengths);
+    free(job.Runs);
+    free(job.Dests);
+    METRIC_STOP_QUERY(order == GLOBAL_HEAVIEST ? "heaviest" : order == GLOBAL_LIGHTEST ? "lightest" : "valuable", queryTimer);
+}
+
+/*
+* FUNCTION      : printDestinationRanking
+* DESCRIPTION   :
+*   This functoin displays the totals of the most valuable destinations, most valuable first. The
+*   totals are kept by every destination, so ranking them is a sort of the destinations alone. A
+*   destination found in several indexes is ranked on the sum of its totals in each.
+* PARAMETERS    :
+*   OutBuf* out                 :   the buffer receiving the output.
+*   DestTable* const* tables    :   the destination indexes containing all parcels.
+*   size_t tableCount           :   the number of indexes.
+*   int count                   :   the most destinations to display.
+* RETURNS       :  void
+*/
+void printDestinationRanking(OutBuf* out, DestTable* const* tables, size_t tableCount, int count)
+{
+    METRIC_START(queryTimer);
+    size_t found = 0;
+    size_t destCount = 0;
+    Destination** dests = collectDestinations(tables, tableCount, false, &found);
+    Destination* combined = (Destination*)malloc((found > 0 ? found : 1) * sizeof(Destination));
+    if (combined == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t d = 0; d < found; ++d)
+    {
+        if (destCount > 0 && combined[destCount - 1].Id == dests[d]->Id)
+        {
+            mergeSummary(&combined[destCount - 1].Summary, &dests[d]->Summary);
+            continue;
+        }
+        combined[destCount] = *dests[d];
+        dests[destCount] = &combined[destCount];
+        destCount++;
+    }
+
+    outLabel(out, "\n/================ %d Most Valuable Destinations ================/\n\n", count);
+    qsort(dests, destCount, sizeof(Destination*), compareByValue);
+    for (size_t d = 0; d < destCount && d < (size_t)(count > 0 ? count : 0) && !outPageFull(out); ++d)
+    {
+        const DestSummary* summary = &dests[d]->Summary;
+        if (outTakeRow(out))
+        {
+            outPrintf(out, "%4zu. Destination:\t%10s\t Parcels: %lld\t Total Weight: %8lld gms\t Total: $%7lld.%02lld\n",
+                d + 1, dests[d]->Name, (long long)summary->Count, (long long)summary->TotalWeight,
+                (long long)(summary->TotalCents / 100), (long long)(summary->TotalCents % 100));
+        }
+    }
+    free(combined);
+    free(dests);
+    METRIC_STOP_QUERY("ranking", queryTimer);
+}
+
+/*
+* FUNCTION      : collectDestinations
+* DESCRIPTION   :
+*   This functoin lists the destinations of a list of tables in order of name, and a destination found
+*   in several tables in the order of the tables, or in reverse for a query that takes the last
+*   arrived first. Ties between destinations go to the one listed first, so they are settled the same
+*   way whatever slots the hashes picked.
+* PARAMETERS    :
+*   DestTable* const* tables    :   the destination indexes, oldest first.
+*   size_t tableCount           :   the number of indexes.
+*   bool newestFirst            :   list the records of one destination from the newest index down.
+*   size_t* count               :   receives the number of destinations.
+* RETURNS       :
+*   Destination**   : a new array of the destinations, to be freed by the caller.
+*/
+static Destination** collectDestinations(DestTable* const* tables, size_t tableCount, bool newestFirst, size_t* count)
+{
+    size_t total = 0;
+    for (size_t t = 0; t < tableCount; ++t)
+    {
+        total += tables[t]->Count;
+    }
+    SortedDest* sorted = (SortedDest*)malloc((total > 0 ? total : 1) * sizeof(SortedDest));
+    Destination** dests = (Destination**)malloc((total > 0 ? total : 1) * sizeof(Destination*));
+    if (sorted == NULL || dests == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    *count = 0;
+    for (size_t t = 0; t < tableCount; ++t)
+    {
+        const DestTable* table = tables[t];
+        for (size_t i = 0; i < table->Capacity; ++i)
+        {
+            if (table->Slots[i].Dest != NULL)
+            {
+                sorted[*count].Dest = table->Slots[i].Dest;
+                sorted[*count].Table = t;
+                (*count)++;
+            }
+        }
+    }
+    qsort(sorted, *count, sizeof(SortedDest), newestFirst ? compareSortedDestsNewestFirst : compareSortedDests);
+    for (size_t d = 0; d < *count; ++d)
+    {
+        dests[d] = sorted[d].Dest;
+    }
+    free(sorted);
+    return dests;
+}
+
+/*
+* FUNCTION      : globalTaskCount
+* DESCRIPTION   : This functoin picks how many blocks a number of destinations is split into.
+* PARAMETERS    :
+*   size_t destCount    :   the number of destinations.
+* RETURNS       :
+*   int     : the number of blocks, GLOBAL_TASKS_PER_WORKER per pool thread at most.
+*/
+static int globalTaskCount(size_t destCount)
+{
+    size_t tasks = (size_t)getWorkerCount() * GLOBAL_TASKS_PER_WORKER;
+    return (int)(destCount < tasks ? destCount : tasks);
+}
+
+/*
+* FUNCTION      : blockBounds
+* DESCRIPTION   : This functoin returns the destinations [begin, end) of one block of a job.
+* PARAMETERS    :
+*   const GlobalJob* job    :   the job.
+*   int taskIndex           :   the block.
+*   size_t* begin           :   receives the first destination of the block.
+*   size_t* end             :   receives one past its last destination.
+* RETURNS       : void
+*/
+static void blockBounds(const GlobalJob* job, int taskIndex, size_t* begin, size_t* end)
+{
+    *begin = job->DestCount * (size_t)taskIndex / (size_t)job->TaskCount;
+    *end = job->DestCount * (size_t)(taskIndex + 1) / (size_t)job->TaskCount;
+}
+
+/*
+* FUNCTION      : sumBlockTask
+* DESCRIPTION   : This functoin adds up the summaries of one block of destinations, as a pool task.
+* PARAMETERS    :
+*   void* context   :   the GlobalJob.
+*   int taskIndex   :   the block.
+*   int workerIndex :   unused.
+* RETURNS       : void
+*/
+static void sumBlockTask(void* context, int taskIndex, int workerIndex)
+{
+    GlobalJob* job = (GlobalJob*)context;
+    DestSummary* partial = &job->Partials[taskIndex];
+    size_t begin = 0;
+    size_t end = 0;
+
+    (void)workerIndex;
+    memset(partial, 0, sizeof *partial);
+    blockBounds(job, taskIndex, &begin, &end);
+    for (size_t d = begin; d < end; ++d)
+    {
+        mergeSummary(partial, &job->Dests[d]->Summary);
+    }
+}
+
+/*
+* FUNCTION      : mergeBlockTask
+* DESCRIPTION   :
+*   This functoin merges the cursors of one block of destinations into the block's best parcels, as a
+*   pool task. A destination's cursor moves only when its parcel is taken, so at most Count parcels
+*   of the whole block are visited.
+* PARAMETERS    :
+*   void* context   :   the GlobalJob.
+*   int taskIndex   :   the block.
+*   int workerIndex :   unused.
+* RETURNS       : void
+*/
+static void mergeBlockTask(void* context, int taskIndex, int workerIndex)
+{
+    GlobalJob* job = (GlobalJob*)context;
+    Parcel* run = job->Runs + (size_t)taskIndex * job->Count;
+    size_t begin = 0;
+    size_t end = 0;
+    int length = 0;
+    int heapSize = 0;
+
+    (void)workerIndex;
+    blockBounds(job, taskIndex, &begin, &end);
+    RowCursor* cursors = (RowCursor*)malloc((end - begin) * sizeof(RowCursor));
+    MergeEntry* heap = (MergeEntry*)malloc((end - begin) * sizeof(MergeEntry));
+    if (cursors == NULL || heap == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t d = begin; d < end; ++d)
+    {
+        Parcel* first = startCursor(&cursors[d - begin], job->Dests[d], job->Order, job->Count);
+        if (first != NULL)
+        {
+            MergeEntry entry = { first, (int)(d - begin) };
+            pushMerge(heap, &heapSize, entry, job->Order);
+        }
+    }
+    while (length < job->Count && heapSize > 0)
+    {
+        MergeEntry best = popMerge(heap, &heapSize, job->Order);
+        run[length++] = *best.Item;
+        Parcel* following = stepCursor(&cursors[best.Source], job->Order);
+        if (following != NULL)
+        {
+            MergeEntry entry = { following, best.Source };
+            pushMerge(heap, &heapSize, entry, job->Order);
+        }
+    }
+    job->RunLengths[taskIndex] = length;
+    for (size_t d = begin; d < end; ++d)
+    {
+        releaseRowCursor(&cursors[d - begin]);
+    }
+    free(heap);
+    free(cursors);
+}
+
+/*
+* FUNCTION      : mergeSummary
+* DESCRIPTION   :
+*   This functoin adds one summary into another. An extreme is replaced only by a strictly better
+*   one, so on ties the parcel of the earlier destination is kept; but the heaviest and most expensive
+*   are the last arrived of their key, so a tie within the same destination, found again in a newer
+*   index, goes to the newer parcel.
+* PARAMETERS    :
+*   DestSummary* into       :   the running summary.
+*   const DestSummary* from :   the summary added to it.
+* RETURNS       : void
+*/
+static void mergeSummary(DestSummary* into, const DestSummary* from)
+{
+    into->Count += from->Count;
+    into->TotalWeight += from->TotalWeight;
+    into->TotalCents += from->TotalCents;
+    if (from->Lightest != NULL && (into->Lightest == NULL || from->Lightest->Weight < into->Lightest->Weight))
+    {
+        into->Lightest = from->Lightest;
+    }
+    if (from->Heaviest != NULL && (into->Heaviest == NULL || from->Heaviest->Weight > into->Heaviest->Weight ||
+        (from->Heaviest->Weight == into->Heaviest->Weight && from->Heaviest->Dest == into->Heaviest->Dest)))
+    {
+        into->Heaviest = from->Heaviest;
+    }
+    if (from->Cheapest != NULL &&
+        (into->Cheapest == NULL || from->Cheapest->Cents < into->Cheapest->Cents))
+    {
+        into->Cheapest = from->Cheapest;
+    }
+    if (from->MostExpensive != NULL &&
+        (into->MostExpensive == NULL || from->MostExpensive->Cents > into->MostExpensive->Cents ||
+        (from->MostExpensive->Cents == into->MostExpensive->Cents &&
+        from->MostExpensive->Dest == into->MostExpensive->Dest)))
+    {
+        into->MostExpensive = from->MostExpensive;
+    }
+}
+
+/*
+* FUNCTION      : startCursor
+* DESCRIPTION   : This functoin puts a cursor on the best parcel of a destination for an order.
+* PARAMETERS    :
+*   RowCursor* cursor       :   the cursor.
+*   Destination* dest       :   the destination.
+*   GlobalOrder order       :   which parcels count as best.
+*   int count               :   the most parcels that will be taken from the cursor.
+* RETURNS       :
+*   Parcel*     : the best parcel, or NULL if the destination has none.
+*/
+static Parcel* startCursor(RowCursor* cursor, Destination* dest, GlobalOrder order, int count)
+{
+    switch (order)
+    {
+    case GLOBAL_HEAVIEST:
+        initRowCursor(cursor, dest, CURSOR_BY_WEIGHT, INT64_MIN, INT64_MAX, (size_t)count);
+        return seekLastRow(cursor);
+    case GLOBAL_LIGHTEST:
+        initRowCursor(cursor, dest, CURSOR_BY_WEIGHT, INT64_MIN, INT64_MAX, (size_t)count);
+        return seekFirstRow(cursor);
+    case GLOBAL_MOST_VALUABLE:
+        initRowCursor(cursor, dest, CURSOR_BY_VALUE, INT64_MIN, INT64_MAX, (size_t)count);
+        return seekLastRow(cursor);
+    }
+    return NULL;
+}
+
+/*
+* FUNCTION      : stepCursor
+* DESCRIPTION   : This functoin moves a cursor started by startCursor to the next best parcel.
+* PARAMETERS    :
+*   RowCursor* cursor       :   the cursor.
+*   GlobalOrder order       :   which parcels count as best.
+* RETURNS       :
+*   Parcel*     : the parcel, or NULL once the destination has no more.
+*/
+static Parcel* stepCursor(RowCursor* cursor, GlobalOrder order)
+{
+    return order == GLOBAL_LIGHTEST ? nextRow(cursor) : prevRow(cursor);
+}
+
+/*
+* FUNCTION      : mergesBefore
+* DESCRIPTION   : This functoin tells whether one merge entry is better than another, the earlier source winning ties.
+* PARAMETERS    :
+*   GlobalOrder order           :   which parcels count as best.
+*   const MergeEntry* first     :   one entry.
+*   const MergeEntry* second    :   the other entry.
+* RETURNS       :
+*   bool    : true, if first comes out of the merge before second. otherwise, false.
+*/
+static bool mergesBefore(GlobalOrder order, const MergeEntry* first, const MergeEntry* second)
+{
+    int64_t firstKey = 0;
+    int64_t secondKey = 0;
+    switch (order)
+    {
+    case GLOBAL_HEAVIEST:
+        firstKey = -(int64_t)first->Item->Weight;
+        secondKey = -(int64_t)second->Item->Weight;
+        break;
+    case GLOBAL_LIGHTEST:
+        firstKey = first->Item->Weight;
+        secondKey = second->Item->Weight;
+        break;
+    case GLOBAL_MOST_VALUABLE:
+        firstKey = -first->Item->Cents;
+        secondKey = -second->Item->Cents;
+        break;
+    }
+    return firstKey != secondKey ? firstKey < secondKey : first->Source < second->Source;
+}
+
+/*
+* FUNCTION      : pushMerge
+* DESCRIPTION   : This functoin adds an entry to a binary heap whose root is the best entry.
+* PARAMETERS    :
+*   MergeEntry* heap    :   the heap, with room for the entry.
+*   int* size           :   the number of entries, incremented.
+*   MergeEntry entry    :   the entry.
+*   GlobalOrder order   :   which parcels count as best.
+* RETURNS       : void
+*/
+static void pushMerge(MergeEntry* heap, int* size, MergeEntry entry, GlobalOrder order)
+{
+    int i = (*size)++;
+    while (i > 0 && mergesBefore(order, &entry, &heap[(i - 1) / 2]))
+    {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = entry;
+}
+
+/*
+* FUNCTION      : popMerge
+* DESCRIPTION   : This functoin removes the best entry from a binary heap.
+* PARAMETERS    :
+*   MergeEntry* heap    :   the heap, not empty.
+*   int* size           :   the number of entries, decremented.
+*   GlobalOrder order   :   which parcels count as best.
+* RETURNS       :
+*   MergeEntry  : the entry that was at the root.
+*/
+static MergeEntry popMerge(MergeEntry* heap, int* size, GlobalOrder order)
+{
+    MergeEntry best = heap[0];
+    MergeEntry last = heap[--(*size)];
+    int i = 0;
+    for (;;)
+    {
+        int child = 2 * i + 1;
+        if (child >= *size)
+        {
+            break;
+        }
+        if (child + 1 < *size && mergesBefore(order, &heap[child + 1], &heap[child]))
+        {
+            child++;
+        }
+        if (!mergesBefore(order, &heap[child], &last))
+        {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (*size > 0)
+    {
+        heap[i] = last;
+    }
+    return best;
+}
+
+/*
+* FUNCTION      : compareByValue
+* DESCRIPTION   : This functoin orders destinations for qsort, most valuable first and then by name.
+* PARAMETERS    :
+*   const void* first   :   a pointer to a Destination*.
+*   const void* second  :   a pointer to another Destination*.
+* RETURNS       :
+*   int     : negative, zero or positive as first goes before, with or after second.
+*/
+static int compareByValue(const void* first, const void* second)
+{
+    const Destination* a = *(const Destination* const*)first;
+    const Destination* b = *(const Destination* const*)second;
+    if (a->Summary.TotalCents != b->Summary.TotalCents)
+    {
+        return a->Summary.TotalCents > b->Summary.TotalCents ? -1 : 1;
+    }
+    return strcmp(a->Name, b->Name);
+}
+
+/*
+* FUNCTION      : compareByName
+* DESCRIPTION   : This functoin orders destinations for qsort by name.
+* PARAMETERS    :
+*   const void* first   :   a pointer to a Destination*.
+*   const void* second  :   a pointer to another Destination*.
+* RETURNS       :
+*   int     : negative, zero or positive as first goes before, with or after second.
+*/
+static int compareByName(const void* first, const void* second)
+{
+    const Destination* a = *(const Destination* const*)first;
+    const Destination* b = *(const Destination* const*)second;
+    return strcmp(a->Name, b->Name);
+}
+
+/*
+* FUNCTION      : compareSortedDests
+* DESCRIPTION   : This functoin orders destinations for qsort by name, and then by the index they were found in.
+* PARAMETERS    :
+*   const void* first   :   a pointer to a SortedDest.
+*   const void* second  :   a pointer to another SortedDest.
+* RETURNS       :
+*   int     : negative, zero or positive as first goes before, with or after second.
+*/
+static int compareSortedDests(const void* first, const void* second)
+{
+    const SortedDest* a = (const SortedDest*)first;
+    const SortedDest* b = (const SortedDest*)second;
+    int order = compareByName(&a->Dest, &b->Dest);
+    if (order != 0)
+    {
+        return order;
+    }
+    return a->Table < b->Table ? -1 : a->Table > b->Table ? 1 : 0;
+}
+
+/*
+* FUNCTION      : compareSortedDestsNewestFirst
+* DESCRIPTION   : This functoin orders destinations for qsort by name, and then by the index they were found in, newest first.
+* PARAMETERS    :
+*   const void* first   :   a pointer to a SortedDest.
+*   const void* second  :   a pointer to another SortedDest.
+* RETURNS       :
+*   int     : negative, zero or positive as first goes before, with or after second.
+*/
+static int compareSortedDestsNewestFirst(const void* first, const void* second)
+{
+    const SortedDest* a = (const SortedDest*)first;
+    const SortedDest* b = (const SortedDest*)second;
+    int order = compareByName(&a->Dest, &b->Dest);
+    if (order != 0)
+    {
+        return order;
+    }
+    return a->Table > b->Table ? -1 : a->Table < b->Table ? 1 : 0;
+}
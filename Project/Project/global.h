@@ -0,0 +1,30 @@
+/*
+* FILENAME      : global.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the network-wide queries, which look at every destination instead of one. They
+*   fan out over the thread pool in blocks of destinations and merge what the blocks found: network
+*   totals are reduced pairwise from each block's sums, and the heaviest, lightest or most valuable
+*   parcels anywhere come from a k-way merge of cursors, first within each block and then across them.
+*   They look at a list of indexes, so that the partitions of partitioned storage (see partition.h)
+*   are answered together; a destination found in several of them counts as one.
+*/
+
+#pragma once
+#include "destTable.h"
+#include "output.h"
+
+#define GLOBAL_TASKS_PER_WORKER     4       // blocks of destinations per pool thread, to even out the work
+
+typedef enum GlobalOrder
+{
+    GLOBAL_HEAVIEST,
+    GLOBAL_LIGHTEST,
+    GLOBAL_MOST_VALUABLE
+} GlobalOrder;
+
+void printNetworkTotals(OutBuf* out, DestTable* const* tables, size_t tableCount);
+void printTopParcelsAnywhere(OutBuf* out, DestTable* const* tables, size_t tableCount, GlobalOrder order, int count);
+void printDestinationRanking(OutBuf* out, DestTable* const* tables, size_t tableCount, int count);
@@ -0,0 +1,652 @@
+/*
+* FILENAME      : loader.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the memory-mapped courier file loader declared in loader.h. A courier line has
+*   the form "Destination, weight, value" where weight is a whole number of grams and value is a decimal
+*   amount of dollars.
+*
+*   Large files, and any file loaded into an empty index, are bulk loaded on the thread pool. The
+*   mapping is cut into newline-aligned chunks that the pool parses at the same time; every parsed
+*   record is routed by the hash of its destination to a shard, and each shard is owned by one thread,
+*   so no lock is taken. A shard stages each destination's rows in arrival order and builds the trees
+*   only once the whole file has been read, by sorting the rows rather than inserting them one by one.
+*   The shard indexes are merged into the caller's index at the end. Chunks are processed a window at
+*   a time to bound the memory held by parsed records.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "loader.h"
+#include "threadPool.h"
+#include "metrics.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define MAX_WHOLE_DOLLARS   1000000000000000LL      // keeps the cents total well inside int64_t
+
+typedef struct ShardRecord
+{
+    const char* Dest;
+    size_t DestLen;
+    uint64_t Hash;
+    int64_t Cents;
+    int Weight;
+} ShardRecord;
+
+typedef struct RecordBuffer
+{
+    ShardRecord* Items;
+    size_t Count;
+    size_t Capacity;
+} RecordBuffer;
+
+typedef struct BadLine
+{
+    const char* Start;
+    size_t Length;
+    size_t Line;            // relative to the start of its chunk
+} BadLine;
+
+typedef struct ChunkState
+{
+    const char* Start;
+    const char* End;
+    size_t Lines;
+    size_t Loaded;
+    size_t Rejected;
+    BadLine Bad[LOADER_MAX_REPORTED_ERRORS];
+    RecordBuffer* Shards;   // one buffer per shard
+} ChunkState;
+
+typedef struct ParallelLoad
+{
+    ChunkState* Chunks;
+    int ChunkCount;         // chunks in the current window
+    DestTable* ShardTables;
+    int ShardCount;
+} ParallelLoad;
+
+static const char* skipBlanks(const char* p, const char* end);
+static void loadParcelsParallel(DestTable* table, const char* data, size_t size, LoadResult* result);
+static void parseChunkTask(void* context, int taskIndex, int workerIndex);
+static void stageShardTask(void* context, int taskIndex, int workerIndex);
+static void buildShardTask(void* context, int taskIndex, int workerIndex);
+static void appendRecord(RecordBuffer* buffer, const ShardRecord* record);
+
+/*
+* FUNCTION      : mapFile
+* DESCRIPTION   :
+*   This functoin maps a whole file read-only into memory. The mapping stays valid after the file
+*   handle is closed, until unmapFile is called.
+* PARAMETERS    :
+*   const char* path    :   the file to be mapped.
+*   MappedFile* file    :   receives the address and size of the mapping.
+* RETURNS       :
+*   bool    : true, if the file was mapped (an empty file maps to NULL). otherwise, false.
+*/
+bool mapFile(const char* path, MappedFile* file)
+{
+    file->Data = NULL;
+    file->Size = 0;
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size))
+    {
+        CloseHandle(handle);
+        return false;
+    }
+    if (size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL)
+        {
+            CloseHandle(handle);
+            return false;
+        }
+        file->Data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (file->Data == NULL)
+        {
+            CloseHandle(handle);
+            return false;
+        }
+        file->Size = (size_t)size.QuadPart;
+    }
+    CloseHandle(handle);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    if (info.st_size > 0)
+    {
+        void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+        madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+        file->Data = (const char*)data;
+        file->Size = (size_t)info.st_size;
+    }
+    close(fd);
+#endif
+    return true;
+}
+
+/*
+* FUNCTION      : unmapFile
+* DESCRIPTION   : This functoin releases a mapping created by mapFile.
+* PARAMETERS    :
+*   MappedFile* file    :   the mapping to be released.
+* RETURNS       : void
+*/
+void unmapFile(MappedFile* file)
+{
+    if (file->Data != NULL)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(file->Data);
+#else
+        munmap((void*)file->Data, file->Size);
+#endif
+    }
+    file->Data = NULL;
+    file->Size = 0;
+}
+
+/*
+* FUNCTION      : parseParcelLine
+* DESCRIPTION   :
+*   This functoin parses one courier line in place. The destination is everything before the first
+*   comma with surrounding blanks trimmed. The weight must be a non-negative whole number that fits an
+*   int, and the value a non-negative decimal; it is rounded to whole cents. Blanks (including a
+*   trailing carriage return) are allowed around each field, anything else makes the line malformed.
+* PARAMETERS    :
+*   const char* line    :   the first character of the line.
+*   const char* end     :   one past the last character of the line, excluding the newline.
+*   ParsedEntry* entry  :   receives the parsed fields.
+* RETURNS       :
+*   bool    : true, if the line is well formed. otherwise, false.
+*/
+bool parseParcelLine(const char* line, const char* end, ParsedEntry* entry)
+{
+    const char* comma = (const char*)memchr(line, ',', (size_t)(end - line));
+    if (comma == NULL)
+    {
+        return false;
+    }
+
+    // destination
+    const char* destStart = skipBlanks(line, comma);
+    const char* destEnd = comma;
+    while (destEnd > destStart && (destEnd[-1] == ' ' || destEnd[-1] == '\t'))
+    {
+        destEnd--;
+    }
+    if (destStart == destEnd)
+    {
+        return false;
+    }
+
+    // weight
+    const char* p = skipBlanks(comma + 1, end);
+    if (p == end || *p < '0' || *p > '9')
+    {
+        return false;
+    }
+    int64_t weight = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        weight = weight * 10 + (*p - '0');
+        if (weight > INT_MAX)
+        {
+            return false;
+        }
+        p++;
+    }
+    p = skipBlanks(p, end);
+    if (p == end || *p != ',')
+    {
+        return false;
+    }
+
+    // value, as whole dollars and up to two digits of cents rounded on the third
+    p = skipBlanks(p + 1, end);
+    int64_t dollars = 0;
+    int64_t cents = 0;
+    int digits = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        dollars = dollars * 10 + (*p - '0');
+        if (dollars >= MAX_WHOLE_DOLLARS)
+        {
+            return false;
+        }
+        digits++;
+        p++;
+    }
+    if (p < end && *p == '.')
+    {
+        int fraction = 0;
+        p++;
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            if (fraction < 2)
+            {
+                cents = cents * 10 + (*p - '0');
+            }
+            else if (fraction == 2 && *p >= '5')
+            {
+                cents++;
+            }
+            fraction++;
+            digits++;
+            p++;
+        }
+        for (; fraction < 2; ++fraction)
+        {
+            cents *= 10;
+        }
+    }
+    if (digits == 0 || skipBlanks(p, end) != end)
+    {
+        return false;
+    }
+
+    entry->Dest = destStart;
+    entry->DestLen = (size_t)(destEnd - destStart);
+    entry->Weight = (int)weight;
+    entry->Cents = dollars * 100 + cents;
+    return true;
+}
+
+/*
+* FUNCTION      : loadParcelBuffer
+* DESCRIPTION   :
+*   This functoin parses every line of a buffer and inserts each well-formed parcel into the
+*   destination index. Blank lines are ignored; malformed lines are counted and the first few are
+*   reported with their line number.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index receiving the parcels.
+*   const char* data    :   the buffer, it does not need to be null terminated.
+*   size_t size         :   the number of bytes in the buffer.
+*   LoadResult* result  :   running counters, Lines continues from its current value.
+* RETURNS       : void
+*/
+void loadParcelBuffer(DestTable* table, const char* data, size_t size, LoadResult* result)
+{
+    const char* p = data;
+    const char* end = data + size;
+
+    while (p < end)
+    {
+        const char* newline = (const char*)memchr(p, '\n', (size_t)(end - p));
+        const char* lineEnd = newline == NULL ? end : newline;
+        ParsedEntry entry;
+
+        result->Lines++;
+        if (skipBlanks(p, lineEnd) != lineEnd)
+        {
+            METRIC_START(parseTimer);
+            bool parsed = parseParcelLine(p, lineEnd, &entry);
+            METRIC_STOP(METRIC_OP_PARSE, parseTimer);
+            if (parsed)
+            {
+                insertHashTableWithBST(table, entry.Dest, entry.DestLen, entry.Weight, entry.Cents);
+                result->Loaded++;
+            }
+            else
+            {
+                if (result->Rejected < LOADER_MAX_REPORTED_ERRORS)
+                {
+                    printf("**Line %zu: malformed parcel entry skipped: %.*s\n", result->Lines,
+                        (int)(lineEnd - p), p);
+                }
+                result->Rejected++;
+            }
+        }
+        p = newline == NULL ? end : newline + 1;
+    }
+}
+
+/*
+* FUNCTION      : loadParcelsFromFile
+* DESCRIPTION   : This functoin maps a courier file and loads all of its parcels into the destination index.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index receiving the parcels.
+*   const char* path    :   the courier file.
+*   LoadResult* result  :   receives the number of loaded and rejected lines.
+* RETURNS       :
+*   bool    : true, if the file could be read. otherwise, false.
+*/
+bool loadParcelsFromFile(DestTable* table, const char* path, LoadResult* result)
+{
+    MappedFile file;
+    result->Loaded = 0;
+    result->Rejected = 0;
+    result->Lines = 0;
+
+    if (!mapFile(path, &file))
+    {
+        return false;
+    }
+    loadParcelData(table, file.Data, file.Size, result);
+    unmapFile(&file);
+    return true;
+}
+
+/*
+* FUNCTION      : loadParcelData
+* DESCRIPTION   :
+*   This functoin loads a whole courier buffer and summarises the malformed lines that were not
+*   reported one by one. The bulk loader is used when the index is empty, so that every tree is built
+*   from sorted rows, when the index is packed, which only the bulk loader can build, or when the
+*   thread pool can share a large buffer; otherwise the parcels are inserted one by one.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index receiving the parcels.
+*   const char* data    :   the buffer, it does not need to be null terminated.
+*   size_t size         :   the number of bytes in the buffer.
+*   LoadResult* result  :   running counters.
+* RETURNS       : void
+*/
+void loadParcelData(DestTable* table, const char* data, size_t size, LoadResult* result)
+{
+    METRIC_START(loadTimer);
+    if (table->Packed || table->Count == 0 || (getWorkerCount() > 1 && size >= LOADER_PARALLEL_MIN_SIZE))
+    {
+        loadParcelsParallel(table, data, size, result);
+    }
+    else
+    {
+        loadParcelBuffer(table, data, size, result);
+    }
+    METRIC_STOP(METRIC_OP_LOAD, loadTimer);
+
+    if (result->Rejected > LOADER_MAX_REPORTED_ERRORS)
+    {
+        printf("**%zu malformed parcel entries skipped in total\n", result->Rejected);
+    }
+}
+
+/*
+* FUNCTION      : loadParcelsParallel
+* DESCRIPTION   :
+*   This functoin loads a mapped courier file on the thread pool. Each window of chunks is parsed in
+*   parallel, malformed lines are reported in file order, and then every shard stages its records (in
+*   file order, so equal weights keep their arrival order) in its private destination index. Once the
+*   last window is staged the shards build their trees in parallel.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index receiving the parcels.
+*   const char* data    :   the mapped file.
+*   size_t size         :   the size of the file.
+*   LoadResult* result  :   running counters.
+* RETURNS       : void
+*/
+static void loadParcelsParallel(DestTable* table, const char* data, size_t size, LoadResult* result)
+{
+    ParallelLoad load;
+    int windowChunks = getWorkerCount() * LOADER_CHUNKS_PER_WORKER;
+    const char* p = data;
+    const char* end = data + size;
+
+    load.ShardCount = getWorkerCount();
+    load.ShardTables = (DestTable*)calloc((size_t)load.ShardCount, sizeof(DestTable));
+    load.Chunks = (ChunkState*)calloc((size_t)windowChunks, sizeof(ChunkState));
+    if (load.ShardTables == NULL || load.Chunks == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < load.ShardCount; ++i)
+    {
+        initDestTable(&load.ShardTables[i], DEST_TABLE_INITIAL_SIZE);
+        load.ShardTables[i].Packed = table->Packed;
+    }
+    for (int i = 0; i < windowChunks; ++i)
+    {
+        load.Chunks[i].Shards = (RecordBuffer*)calloc((size_t)load.ShardCount, sizeof(RecordBuffer));
+        if (load.Chunks[i].Shards == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    while (p < end)
+    {
+        // cut the next window into chunks that end just after a newline
+        load.ChunkCount = 0;
+        while (p < end && load.ChunkCount < windowChunks)
+        {
+            ChunkState* chunk = &load.Chunks[load.ChunkCount++];
+            const char* chunkEnd = (size_t)(end - p) > LOADER_CHUNK_SIZE ? p + LOADER_CHUNK_SIZE : end;
+            if (chunkEnd < end)
+            {
+                const char* newline = (const char*)memchr(chunkEnd, '\n', (size_t)(end - chunkEnd));
+                chunkEnd = newline == NULL ? end : newline + 1;
+            }
+            chunk->Start = p;
+            chunk->End = chunkEnd;
+            p = chunkEnd;
+        }
+
+        runParallel(load.ChunkCount, parseChunkTask, &load);
+
+        for (int i = 0; i < load.ChunkCount; ++i)
+        {
+            ChunkState* chunk = &load.Chunks[i];
+            for (size_t j = 0; j < chunk->Rejected && j < LOADER_MAX_REPORTED_ERRORS; ++j)
+            {
+                if (result->Rejected + j < LOADER_MAX_REPORTED_ERRORS)
+                {
+                    printf("**Line %zu: malformed parcel entry skipped: %.*s\n", result->Lines + chunk->Bad[j].Line,
+                        (int)chunk->Bad[j].Length, chunk->Bad[j].Start);
+                }
+            }
+            result->Lines += chunk->Lines;
+            result->Loaded += chunk->Loaded;
+            result->Rejected += chunk->Rejected;
+        }
+
+        runParallel(load.ShardCount, stageShardTask, &load);
+    }
+    runParallel(load.ShardCount, buildShardTask, &load);
+
+    for (int i = 0; i < load.ShardCount; ++i)
+    {
+        mergeDestTable(table, &load.ShardTables[i]);
+    }
+    for (int i = 0; i < windowChunks; ++i)
+    {
+        for (int j = 0; j < load.ShardCount; ++j)
+        {
+            free(load.Chunks[i].Shards[j].Items);
+        }
+        free(load.Chunks[i].Shards);
+    }
+    free(load.Chunks);
+    free(load.ShardTables);
+}
+
+/*
+* FUNCTION      : parseChunkTask
+* DESCRIPTION   :
+*   This functoin parses one chunk of the current window, routing each well-formed line to the record
+*   buffer of its shard and remembering the first few malformed lines.
+* PARAMETERS    :
+*   void* context       :   the ParallelLoad being run.
+*   int taskIndex       :   the chunk to parse.
+*   int workerIndex     :   unused.
+* RETURNS       : void
+*/
+static void parseChunkTask(void* context, int taskIndex, int workerIndex)
+{
+    ParallelLoad* load = (ParallelLoad*)context;
+    ChunkState* chunk = &load->Chunks[taskIndex];
+    const char* p = chunk->Start;
+    const char* end = chunk->End;
+    (void)workerIndex;
+
+    chunk->Lines = 0;
+    chunk->Loaded = 0;
+    chunk->Rejected = 0;
+    for (int i = 0; i < load->ShardCount; ++i)
+    {
+        chunk->Shards[i].Count = 0;
+    }
+
+    while (p < end)
+    {
+        const char* newline = (const char*)memchr(p, '\n', (size_t)(end - p));
+        const char* lineEnd = newline == NULL ? end : newline;
+        ParsedEntry entry;
+
+        chunk->Lines++;
+        if (skipBlanks(p, lineEnd) != lineEnd)
+        {
+            METRIC_START(parseTimer);
+            bool parsed = parseParcelLine(p, lineEnd, &entry);
+            METRIC_STOP(METRIC_OP_PARSE, parseTimer);
+            if (parsed)
+            {
+                ShardRecord record;
+                record.Dest = entry.Dest;
+                record.DestLen = entry.DestLen;
+                record.Hash = generateHash(entry.Dest, entry.DestLen);
+                record.Weight = entry.Weight;
+                record.Cents = entry.Cents;
+                appendRecord(&chunk->Shards[record.Hash % (uint64_t)load->ShardCount], &record);
+                chunk->Loaded++;
+            }
+            else
+            {
+                if (chunk->Rejected < LOADER_MAX_REPORTED_ERRORS)
+                {
+                    chunk->Bad[chunk->Rejected].Start = p;
+                    chunk->Bad[chunk->Rejected].Length = (size_t)(lineEnd - p);
+                    chunk->Bad[chunk->Rejected].Line = chunk->Lines;
+                }
+                chunk->Rejected++;
+            }
+        }
+        p = newline == NULL ? end : newline + 1;
+    }
+}
+
+/*
+* FUNCTION      : stageShardTask
+* DESCRIPTION   :
+*   This functoin appends one shard's records of the current window to the staged rows of their
+*   destinations in the shard's index.
+* PARAMETERS    :
+*   void* context       :   the ParallelLoad being run.
+*   int taskIndex       :   the shard to stage.
+*   int workerIndex     :   unused.
+* RETURNS       : void
+*/
+static void stageShardTask(void* context, int taskIndex, int workerIndex)
+{
+    ParallelLoad* load = (ParallelLoad*)context;
+    DestTable* shard = &load->ShardTables[taskIndex];
+    (void)workerIndex;
+
+    for (int i = 0; i < load->ChunkCount; ++i)
+    {
+        RecordBuffer* buffer = &load->Chunks[i].Shards[taskIndex];
+        for (size_t j = 0; j < buffer->Count; ++j)
+        {
+            ShardRecord* record = &buffer->Items[j];
+            Destination* dest = findOrAddDestinationHashed(shard, record->Dest, record->DestLen, record->Hash);
+            stageParcelColumn(&dest->Columns, record->Weight, record->Cents);
+        }
+    }
+}
+
+/*
+* FUNCTION      : buildShardTask
+* DESCRIPTION   : This functoin builds the trees of every destination staged in one shard's index.
+* PARAMETERS    :
+*   void* context       :   the ParallelLoad being run.
+*   int taskIndex       :   the shard to build.
+*   int workerIndex     :   unused.
+* RETURNS       : void
+*/
+static void buildShardTask(void* context, int taskIndex, int workerIndex)
+{
+    ParallelLoad* load = (ParallelLoad*)context;
+    (void)workerIndex;
+
+    buildStagedDestinations(&load->ShardTables[taskIndex]);
+}
+
+/*
+* FUNCTION      : appendRecord
+* DESCRIPTION   : This functoin appends a record to a buffer, doubling the buffer when it is full.
+* PARAMETERS    :
+*   RecordBuffer* buffer        :   the buffer.
+*   const ShardRecord* record   :   the record to be copied in.
+* RETURNS       : void
+*/
+static void appendRecord(RecordBuffer* buffer, const ShardRecord* record)
+{
+    if (buffer->Count == buffer->Capacity)
+    {
+        size_t capacity = buffer->Capacity == 0 ? 1024 : buffer->Capacity * 2;
+        ShardRecord* items = (ShardRecord*)realloc(buffer->Items, capacity * sizeof(ShardRecord));
+        if (items == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+        buffer->Items = items;
+        buffer->Capacity = capacity;
+    }
+    buffer->Items[buffer->Count++] = *record;
+}
+
+/*
+* FUNCTION      : skipBlanks
+* DESCRIPTION   : This functoin skips spaces, tabs and carriage returns.
+* PARAMETERS    :
+*   const char* p   :   the first character to examine.
+*   const char* end :   one past the last character that may be examined.
+* RETURNS       : const char* : the first character that is not blank, or end.
+*/
+static const char* skipBlanks(const char* p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    {
+        p++;
+    }
+    return p;
+}
@@ -0,0 +1,51 @@
+/*
+* FILENAME      : loader.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the bulk loader for courier files. A file is memory-mapped and parsed in place:
+*   destination names are slices of the mapping and numbers are read by a hand-written scanner, so no
+*   line is ever copied into a fixed-size buffer. Malformed lines are reported and skipped. A file
+*   loaded into an empty index, or one of LOADER_PARALLEL_MIN_SIZE bytes or more, is parsed on the
+*   thread pool and its trees are built from sorted rows instead of by one insert per parcel.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "destTable.h"
+
+#define LOADER_MAX_REPORTED_ERRORS  10              // malformed lines reported one by one before summarising
+#define LOADER_CHUNK_SIZE           (8u << 20)      // bytes parsed by one task, extended to the next newline
+#define LOADER_CHUNKS_PER_WORKER    4               // chunks per worker in each window
+#define LOADER_PARALLEL_MIN_SIZE    (4u << 20)      // smaller files added to a non-empty index are inserted one by one
+
+typedef struct MappedFile
+{
+    const char* Data;       // NULL for an empty file
+    size_t Size;
+} MappedFile;
+
+typedef struct ParsedEntry
+{
+    const char* Dest;       // points into the parsed buffer, not null terminated
+    size_t DestLen;
+    int Weight;
+    int64_t Cents;          // the value in whole cents
+} ParsedEntry;
+
+typedef struct LoadResult
+{
+    size_t Loaded;
+    size_t Rejected;
+    size_t Lines;
+} LoadResult;
+
+bool mapFile(const char* path, MappedFile* file);
+void unmapFile(MappedFile* file);
+bool parseParcelLine(const char* line, const char* end, ParsedEntry* entry);
+void loadParcelBuffer(DestTable* table, const char* data, size_t size, LoadResult* result);
+void loadParcelData(DestTable* table, const char* data, size_t size, LoadResult* result);
+bool loadParcelsFromFile(DestTable* table, const char* path, LoadResult* result);
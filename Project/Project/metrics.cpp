@@ -0,0 +1,438 @@
+/*
+* FILENAME      : metrics.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the metrics declared in metrics.h. Latencies go into power-of-two buckets of
+*   nanoseconds, so recording one is a bucket index and three relaxed increments. Queries are told
+*   apart by name; a name gets its histogram the first time it is recorded.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "metrics.h"
+
+#ifdef PARCEL_METRICS
+
+#include <atomic>
+#include <chrono>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+typedef struct LatencyHistogram
+{
+    std::atomic<uint64_t> Buckets[METRIC_LATENCY_BUCKETS];
+    std::atomic<uint64_t> Count;
+    std::atomic<uint64_t> SumNanos;
+} LatencyHistogram;
+
+static const char* opNames[METRIC_OP_COUNT] = { "load", "parse", "insert", "publish" };
+static const char* counterNames[METRIC_COUNTER_COUNT] =
+{
+    "parcel_hash_calls_total",
+    "parcel_hash_bytes_total",
+    "parcel_dest_lookups_total",
+    "parcel_dest_collisions_total",
+    "parcel_arena_allocs_total",
+    "parcel_arena_bytes_total",
+    "parcel_arena_chunks_total",
+    "parcel_partitions_scanned_total",
+    "parcel_partitions_pruned_total",
+};
+
+static LatencyHistogram opLatency[METRIC_OP_COUNT];
+static LatencyHistogram queryLatency[METRIC_MAX_QUERIES];
+static std::atomic<const char*> queryNames[METRIC_MAX_QUERIES];
+static std::atomic<uint64_t> pathLengths[METRIC_PATH_BUCKETS];
+static std::atomic<uint64_t> counters[METRIC_COUNTER_COUNT];
+
+thread_local unsigned int metricPathLength = 0;
+
+static void recordLatency(LatencyHistogram* histogram, uint64_t nanos);
+static void writeEscaped(OutBuf* out, const char* text, bool json);
+static void writeHistogram(OutBuf* out, const char* metric, const char* label, const char* name,
+    const LatencyHistogram* histogram, MetricFormat format, bool first);
+
+/*
+* FUNCTION      : metricNow
+* DESCRIPTION   : This functoin reads the monotonic clock the latencies are measured with.
+* PARAMETERS    : none
+* RETURNS       :
+*   uint64_t    : nanoseconds since an arbitrary point.
+*/
+uint64_t metricNow(void)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+* FUNCTION      : recordOpLatency
+* DESCRIPTION   : This functoin adds the latency of one main operation to its histogram.
+* PARAMETERS    :
+*   MetricOp op     :   the operation.
+*   uint64_t nanos  :   how long it took.
+* RETURNS       : void
+*/
+void recordOpLatency(MetricOp op, uint64_t nanos)
+{
+    recordLatency(&opLatency[op], nanos);
+}
+
+/*
+* FUNCTION      : recordQueryLatency
+* DESCRIPTION   :
+*   This functoin adds the latency of one query to the histogram of its name, claiming a free
+*   histogram for a name seen for the first time. Names beyond METRIC_MAX_QUERIES are not recorded.
+* PARAMETERS    :
+*   const char* name    :   the query, a string that lives as long as the program.
+*   uint64_t nanos      :   how long it took.
+* RETURNS       : void
+*/
+void recordQueryLatency(const char* name, uint64_t nanos)
+{
+    for (int i = 0; i < METRIC_MAX_QUERIES; ++i)
+    {
+        const char* owner = queryNames[i].load(std::memory_order_acquire);
+        if (owner == NULL && queryNames[i].compare_exchange_strong(owner, name))
+        {
+            owner = name;
+        }
+        if (owner == name || strcmp(owner, name) == 0)
+        {
+            recordLatency(&queryLatency[i], nanos);
+            return;
+        }
+    }
+}
+
+/*
+* FUNCTION      : addMetricCounter
+* DESCRIPTION   : This functoin adds to a counter.
+* PARAMETERS    :
+*   MetricCounter counter   :   the counter.
+*   uint64_t amount         :   the amount to add.
+* RETURNS       : void
+*/
+void addMetricCounter(MetricCounter counter, uint64_t amount)
+{
+    counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+/*
+* FUNCTION      : recordPathLength
+* DESCRIPTION   : This functoin records the nodes passed by the insert that has just finished on this thread.
+* PARAMETERS    : none
+* RETURNS       : void
+*/
+void recordPathLength(void)
+{
+    unsigned int length = metricPathLength < METRIC_PATH_BUCKETS ? metricPathLength : METRIC_PATH_BUCKETS - 1;
+    pathLengths[length].fetch_add(1, std::memory_order_relaxed);
+    metricPathLength = 0;
+}
+
+/*
+* FUNCTION      : recordLatency
+* DESCRIPTION   : This functoin adds a latency to a histogram.
+* PARAMETERS    :
+*   LatencyHistogram* histogram :   the histogram.
+*   uint64_t nanos              :   the latency.
+* RETURNS       : void
+*/
+static void recordLatency(LatencyHistogram* histogram, uint64_t nanos)
+{
+    int bucket = 0;
+#ifdef _MSC_VER
+    unsigned long highest = 0;
+    bucket = _BitScanReverse64(&highest, nanos) ? (int)highest : 0;
+#else
+    bucket = nanos != 0 ? 63 - __builtin_clzll(nanos) : 0;
+#endif
+    bucket = bucket < METRIC_LATENCY_BUCKETS ? bucket : METRIC_LATENCY_BUCKETS - 1;
+    histogram->Buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    histogram->Count.fetch_add(1, std::memory_order_relaxed);
+    histogram->SumNanos.fetch_add(nanos, std::memory_order_relaxed);
+}
+
+/*
+* FUNCTION      : writeHistogram
+* DESCRIPTION   :
+*   This functoin writes one latency histogram. Prometheus gets cumulative buckets in seconds up to
+*   the last one in use; JSON gets the plain bucket counts, bucket i holding latencies below 2^(i+1) ns.
+* PARAMETERS    :
+*   OutBuf* out                         :   the buffer receiving the text.
+*   const char* metric                  :   the Prometheus metric name.
+*   const char* label                   :   the label telling histograms of the family apart.
+*   const char* name                    :   the value of that label.
+*   const LatencyHistogram* histogram   :   the histogram.
+*   MetricFormat format                 :   the output format.
+*   bool first                          :   the histogram is the first of its JSON object.
+* RETURNS       : void
+*/
+static void writeHistogram(OutBuf* out, const char* metric, const char* label, const char* name,
+    const LatencyHistogram* histogram, MetricFormat format, bool first)
+{
+    int used = 0;
+    for (int i = 0; i < METRIC_LATENCY_BUCKETS; ++i)
+    {
+        if (histogram->Buckets[i].load(std::memory_order_relaxed) != 0)
+        {
+            used = i + 1;
+        }
+    }
+    uint64_t count = histogram->Count.load(std::memory_order_relaxed);
+    double seconds = histogram->SumNanos.load(std::memory_order_relaxed) / 1e9;
+
+    if (format == METRIC_FORMAT_JSON)
+    {
+        outPrintf(out, "%s\"", first ? "" : ",");
+        writeEscaped(out, name, true);
+        outPrintf(out, "\":{\"count\":%llu,\"sum_seconds\":%.9g,\"buckets\":[", (unsigned long long)count, seconds);
+        for (int i = 0; i < used; ++i)
+        {
+            outPrintf(out, "%s%llu", i == 0 ? "" : ",",
+                (unsigned long long)histogram->Buckets[i].load(std::memory_order_relaxed));
+        }
+        outPrintf(out, "]}");
+        return;
+    }
+
+    uint64_t cumulative = 0;
+    for (int i = 0; i < used; ++i)
+    {
+        cumulative += histogram->Buckets[i].load(std::memory_order_relaxed);
+        outPrintf(out, "%s_bucket{%s=\"%s\",le=\"%.9g\"} %llu\n", metric, label, name,
+            (double)(2ull << i) / 1e9, (unsigned long long)cumulative);
+    }
+    outPrintf(out, "%s_bucket{%s=\"%s\",le=\"+Inf\"} %llu\n", metric, label, name, (unsigned long long)count);
+    outPrintf(out, "%s_sum{%s=\"%s\"} %.9g\n", metric, label, name, seconds);
+    outPrintf(out, "%s_count{%s=\"%s\"} %llu\n", metric, label, name, (unsigned long long)count);
+}
+
+#endif
+
+/*
+* FUNCTION      : parseMetricFormat
+* DESCRIPTION   : This functoin converts the name of a metrics format: prometheus or json.
+* PARAMETERS    :
+*   const char* name        :   the name.
+*   MetricFormat* format    :   receives the format.
+* RETURNS       :
+*   bool    : true, if the name is known. otherwise, false.
+*/
+bool parseMetricFormat(const char* name, MetricFormat* format)
+{
+    if (strcmp(name, "prometheus") == 0)
+    {
+        *format = METRIC_FORMAT_PROMETHEUS;
+    }
+    else if (strcmp(name, "json") == 0)
+    {
+        *format = METRIC_FORMAT_JSON;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/*
+* FUNCTION      : writeMetrics
+* DESCRIPTION   :
+*   This functoin writes every metric recorded so far, with the parcel count and tree height of each
+*   destination of an index. Without PARCEL_METRICS it only says the metrics are not compiled in.
+* PARAMETERS    :
+*   OutBuf* out                 :   the buffer receiving the text.
+*   const DestTable* table      :   the index whose destinations are described.
+*   MetricFormat format         :   the output format.
+* RETURNS       : void
+*/
+void writeMetrics(OutBuf* out, const DestTable* table, MetricFormat format)
+{
+#ifdef PARCEL_METRICS
+    bool json = format == METRIC_FORMAT_JSON;
+    bool first = true;
+
+    if (json)
+    {
+        outPrintf(out, "{\"ops\":{");
+    }
+    else
+    {
+        outPrintf(out, "# HELP parcel_op_duration_seconds Latency of loading, parsing, inserting and publishing.\n");
+        outPrintf(out, "# TYPE parcel_op_duration_seconds histogram\n");
+    }
+    for (int op = 0; op < METRIC_OP_COUNT; ++op)
+    {
+        writeHistogram(out, "parcel_op_duration_seconds", "op", opNames[op], &opLatency[op], format, op == 0);
+    }
+
+    if (json)
+    {
+        outPrintf(out, "},\"queries\":{");
+    }
+    else
+    {
+        outPrintf(out, "# HELP parcel_query_duration_seconds Latency of each per-country query.\n");
+        outPrintf(out, "# TYPE parcel_query_duration_seconds histogram\n");
+    }
+    for (int i = 0; i < METRIC_MAX_QUERIES; ++i)
+    {
+        const char* name = queryNames[i].load(std::memory_order_acquire);
+        if (name != NULL)
+        {
+            writeHistogram(out, "parcel_query_duration_seconds", "query", name, &queryLatency[i], format, first);
+            first = false;
+        }
+    }
+
+    int used = 0;
+    uint64_t inserts = 0;
+    uint64_t steps = 0;
+    for (int i = 0; i < METRIC_PATH_BUCKETS; ++i)
+    {
+        uint64_t count = pathLengths[i].load(std::memory_order_relaxed);
+        used = count != 0 ? i + 1 : used;
+        inserts += count;
+        steps += count * (uint64_t)i;
+    }
+    if (json)
+    {
+        outPrintf(out, "},\"insert_path_length\":[");
+    }
+    else
+    {
+        outPrintf(out, "# HELP parcel_insert_path_length Tree nodes passed on the way down by each insert.\n");
+        outPrintf(out, "# TYPE parcel_insert_path_length histogram\n");
+    }
+    uint64_t cumulative = 0;
+    for (int i = 0; i < used; ++i)
+    {
+        uint64_t count = pathLengths[i].load(std::memory_order_relaxed);
+        cumulative += count;
+        if (json)
+        {
+            outPrintf(out, "%s%llu", i == 0 ? "" : ",", (unsigned long long)count);
+        }
+        else
+        {
+            outPrintf(out, "parcel_insert_path_length_bucket{le=\"%d\"} %llu\n", i, (unsigned long long)cumulative);
+        }
+    }
+    if (json)
+    {
+        outPrintf(out, "],\"counters\":{");
+    }
+    else
+    {
+        outPrintf(out, "parcel_insert_path_length_bucket{le=\"+Inf\"} %llu\n", (unsigned long long)inserts);
+        outPrintf(out, "parcel_insert_path_length_sum %llu\n", (unsigned long long)steps);
+        outPrintf(out, "parcel_insert_path_length_count %llu\n", (unsigned long long)inserts);
+    }
+
+    for (int i = 0; i < METRIC_COUNTER_COUNT; ++i)
+    {
+        unsigned long long value = (unsigned long long)counters[i].load(std::memory_order_relaxed);
+        if (json)
+        {
+            outPrintf(out, "%s\"%s\":%llu", i == 0 ? "" : ",", counterNames[i], value);
+        }
+        else
+        {
+            outPrintf(out, "# TYPE %s counter\n%s %llu\n", counterNames[i], counterNames[i], value);
+        }
+    }
+
+    if (json)
+    {
+        outPrintf(out, "},\"dest_slots\":%zu,\"destinations\":[", table->Capacity);
+    }
+    else
+    {
+        outPrintf(out, "# TYPE parcel_dest_slots gauge\nparcel_dest_slots %zu\n", table->Capacity);
+        outPrintf(out, "# TYPE parcel_dest_count gauge\nparcel_dest_count %zu\n", table->Count);
+        outPrintf(out, "# HELP parcel_tree_height Height of the weight tree of each destination.\n");
+        outPrintf(out, "# TYPE parcel_tree_height gauge\n");
+    }
+    first = true;
+    for (int pass = json ? 1 : 0; pass < 2; ++pass)
+    {
+        if (!json && pass == 1)
+        {
+            outPrintf(out, "# TYPE parcel_dest_parcels gauge\n");
+        }
+        for (size_t i = 0; i < table->Capacity; ++i)
+        {
+            const Destination* dest = table->Slots[i].Dest;
+            if (dest == NULL)
+            {
+                continue;
+            }
+            int height = dest->Root == NULL ? 0 : dest->Root->Height;
+            if (json)
+            {
+                outPrintf(out, "%s{\"name\":\"", first ? "" : ",");
+                writeEscaped(out, dest->Name, true);
+                outPrintf(out, "\",\"parcels\":%lld,\"height\":%d}", (long long)dest->Summary.Count, height);
+                first = false;
+                continue;
+            }
+            outPrintf(out, pass == 0 ? "parcel_tree_height{dest=\"" : "parcel_dest_parcels{dest=\"");
+            writeEscaped(out, dest->Name, false);
+            outPrintf(out, "\"} %lld\n", pass == 0 ? (long long)height : (long long)dest->Summary.Count);
+        }
+    }
+    if (json)
+    {
+        outPrintf(out, "]}\n");
+    }
+#else
+    (void)table;
+    (void)format;
+    outPrintf(out, "**Metrics are not compiled in, build with PARCEL_METRICS defined\n");
+#endif
+}
+
+#ifdef PARCEL_METRICS
+
+/*
+* FUNCTION      : writeEscaped
+* DESCRIPTION   :
+*   This functoin writes a destination name inside a quoted label value or JSON string, escaping the
+*   backslash, the double quote and control characters.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the text.
+*   const char* text    :   the name.
+*   bool json           :   escape for JSON rather than for a Prometheus label.
+* RETURNS       : void
+*/
+static void writeEscaped(OutBuf* out, const char* text, bool json)
+{
+    for (const char* c = text; *c != '\0'; ++c)
+    {
+        if (*c == '\\' || *c == '"')
+        {
+            outPrintf(out, "\\%c", *c);
+        }
+        else if (*c == '\n')
+        {
+            outWrite(out, "\\n", 2);
+        }
+        else if (json && (unsigned char)*c < 0x20)
+        {
+            outPrintf(out, "\\u%04x", (unsigned int)(unsigned char)*c);
+        }
+        else
+        {
+            outWrite(out, c, 1);
+        }
+    }
+}
+
+#endif
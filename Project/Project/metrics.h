@@ -0,0 +1,86 @@
+/*
+* FILENAME      : metrics.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the hot-path metrics: latency histograms of the main operations and of each
+*   per-country query, whether it was asked from the menu, a batch or a client; a histogram of the
+*   nodes passed on the way down by each tree insert; and counters for hashing, destination probes
+*   and arena allocations. Tree heights per destination are read from the index when the metrics are
+*   written, in the Prometheus text format or as JSON.
+*
+*   Metrics are compiled in only when PARCEL_METRICS is defined. Otherwise every METRIC_ macro expands
+*   to nothing and the instrumented code is exactly the code without metrics. Counters are relaxed
+*   atomics, so the loader's workers can share them.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "destTable.h"
+#include "output.h"
+
+#define METRIC_LATENCY_BUCKETS  40      // bucket i counts latencies below 2^(i+1) ns
+#define METRIC_PATH_BUCKETS     64      // bucket i counts inserts that passed i nodes
+#define METRIC_MAX_QUERIES      32      // distinct query names timed
+
+typedef enum MetricOp
+{
+    METRIC_OP_LOAD,         // one loadParcelData call
+    METRIC_OP_PARSE,        // one courier line parsed
+    METRIC_OP_INSERT,       // one parcel inserted into the index
+    METRIC_OP_PUBLISH,      // one concurrent view published
+    METRIC_OP_COUNT
+} MetricOp;
+
+typedef enum MetricCounter
+{
+    METRIC_HASH_CALLS,
+    METRIC_HASH_BYTES,
+    METRIC_DEST_LOOKUPS,
+    METRIC_DEST_COLLISIONS, // slots probed past the home slot of a name
+    METRIC_ARENA_ALLOCS,
+    METRIC_ARENA_BYTES,
+    METRIC_ARENA_CHUNKS,
+    METRIC_PARTITIONS_SCANNED,  // partitions a per-country query looked into, see partition.h
+    METRIC_PARTITIONS_PRUNED,   // partitions it skipped on their zone maps
+    METRIC_COUNTER_COUNT
+} MetricCounter;
+
+typedef enum MetricFormat
+{
+    METRIC_FORMAT_PROMETHEUS,
+    METRIC_FORMAT_JSON
+} MetricFormat;
+
+#ifdef PARCEL_METRICS
+
+extern thread_local unsigned int metricPathLength;
+
+uint64_t metricNow(void);
+void recordOpLatency(MetricOp op, uint64_t nanos);
+void recordQueryLatency(const char* name, uint64_t nanos);
+void addMetricCounter(MetricCounter counter, uint64_t amount);
+void recordPathLength(void);
+
+#define METRIC_START(timer)                         uint64_t timer = metricNow()
+#define METRIC_STOP(op, timer)                      recordOpLatency(op, metricNow() - (timer))
+#define METRIC_STOP_QUERY(name, timer)              recordQueryLatency(name, metricNow() - (timer))
+#define METRIC_ADD(counter, amount)                 addMetricCounter(counter, amount)
+#define METRIC_PATH_STEP()                          (metricPathLength++)
+#define METRIC_PATH_DONE()                          recordPathLength()
+
+#else
+
+#define METRIC_START(timer)
+#define METRIC_STOP(op, timer)
+#define METRIC_STOP_QUERY(name, timer)
+#define METRIC_ADD(counter, amount)
+#define METRIC_PATH_STEP()
+#define METRIC_PATH_DONE()
+
+#endif
+
+bool parseMetricFormat(const char* name, MetricFormat* format);
+void writeMetrics(OutBuf* out, const DestTable* table, MetricFormat format);
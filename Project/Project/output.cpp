@@ -0,0 +1,517 @@
+/*
+* FILENAME      : output.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the output buffer declared in output.h. Parcel rows are formatted straight
+*   into the buffer, digits written backwards from the end of a small scratch array, since a formatted
+*   printf per row is what dominates listing millions of parcels.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "output.h"
+
+#define OUT_DIGITS_SIZE     32      // any int64_t, with a sign and a decimal point
+
+static void reserveOutBuf(OutBuf* out, size_t extra);
+static void outVprintf(OutBuf* out, const char* format, va_list args);
+static size_t formatInteger(char* digitsEnd, int64_t value, char** digits);
+static size_t formatCents(char* digitsEnd, int64_t cents, char** digits);
+static char* putPadded(char* p, const char* text, size_t len, size_t width);
+static char* putCsvField(char* p, const char* text, size_t len);
+static char* putJsonString(char* p, const char* text, size_t len);
+
+/*
+* FUNCTION      : initOutBuf
+* DESCRIPTION   : This functoin allocates an empty output buffer.
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer to be initialised.
+*   FILE* sink      :   the stream the buffer is written to, or NULL to keep the text in memory.
+* RETURNS       : void
+*/
+void initOutBuf(OutBuf* out, FILE* sink)
+{
+    out->Data = (char*)malloc(OUTBUF_INITIAL_SIZE);
+    if (out->Data == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    out->Length = 0;
+    out->Capacity = OUTBUF_INITIAL_SIZE;
+    out->Sink = sink;
+    out->Format = OUT_FORMAT_TABLE;
+    out->Skip = 0;
+    out->Limit = OUT_NO_LIMIT;
+}
+
+/*
+* FUNCTION      : outWrite
+* DESCRIPTION   : This functoin appends raw bytes to the buffer.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer.
+*   const char* data    :   the bytes to append.
+*   size_t len          :   the number of bytes.
+* RETURNS       : void
+*/
+void outWrite(OutBuf* out, const char* data, size_t len)
+{
+    reserveOutBuf(out, len);
+    memcpy(out->Data + out->Length, data, len);
+    out->Length += len;
+    if (out->Sink != NULL && out->Length >= OUTBUF_FLUSH_SIZE)
+    {
+        flushOutBuf(out);
+    }
+}
+
+/*
+* FUNCTION      : outPrintf
+* DESCRIPTION   : This functoin appends printf-formatted text to the buffer.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer.
+*   const char* format  :   a printf format string, followed by its arguments.
+* RETURNS       : void
+*/
+void outPrintf(OutBuf* out, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    outVprintf(out, format, args);
+    va_end(args);
+}
+
+/*
+* FUNCTION      : outLabel
+* DESCRIPTION   :
+*   This functoin appends printf-formatted text that only the table format shows, such as a banner
+*   above a list of parcels or the echo of a query, so the other formats carry nothing but rows.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer.
+*   const char* format  :   a printf format string, followed by its arguments.
+* RETURNS       : void
+*/
+void outLabel(OutBuf* out, const char* format, ...)
+{
+    if (out->Format != OUT_FORMAT_TABLE)
+    {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    outVprintf(out, format, args);
+    va_end(args);
+}
+
+/*
+* FUNCTION      : outParcelRow
+* DESCRIPTION   :
+*   This functoin appends one parcel in the buffer's row format. The table row is the one printParcel
+*   has always printed, "Destination:\t%10s\t Weight: %6d gms\t Value: $%8.2f\n", built by hand.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer.
+*   const char* dest    :   the destination of the parcel.
+*   int weight          :   the weight of the parcel, in grams.
+*   int64_t cents       :   the value of the parcel, in cents.
+* RETURNS       : void
+*/
+void outParcelRow(OutBuf* out, const char* dest, int weight, int64_t cents)
+{
+    char weightDigits[OUT_DIGITS_SIZE];
+    char centsDigits[OUT_DIGITS_SIZE];
+    char* weightText = NULL;
+    char* centsText = NULL;
+    size_t destLen = strlen(dest);
+
+    reserveOutBuf(out, destLen * 6 + OUT_ROW_RESERVE);      // a JSON escape takes up to six bytes
+    char* p = out->Data + out->Length;
+    switch (out->Format)
+    {
+    case OUT_FORMAT_TABLE:
+    {
+        size_t weightLen = formatInteger(weightDigits + OUT_DIGITS_SIZE, weight, &weightText);
+        size_t centsLen = formatCents(centsDigits + OUT_DIGITS_SIZE, cents, &centsText);
+        memcpy(p, "Destination:\t", 13);
+        p = putPadded(p + 13, dest, destLen, 10);
+        memcpy(p, "\t Weight: ", 10);
+        p = putPadded(p + 10, weightText, weightLen, 6);
+        memcpy(p, " gms\t Value: $", 14);
+        p = putPadded(p + 14, centsText, centsLen, 8);
+        *p++ = '\n';
+        break;
+    }
+    case OUT_FORMAT_CSV:
+    {
+        size_t weightLen = formatInteger(weightDigits + OUT_DIGITS_SIZE, weight, &weightText);
+        size_t centsLen = formatCents(centsDigits + OUT_DIGITS_SIZE, cents, &centsText);
+        p = putCsvField(p, dest, destLen);
+        *p++ = ',';
+        memcpy(p, weightText, weightLen);
+        p += weightLen;
+        *p++ = ',';
+        memcpy(p, centsText, centsLen);
+        p += centsLen;
+        *p++ = '\n';
+        break;
+    }
+    case OUT_FORMAT_JSON:
+    {
+        size_t weightLen = formatInteger(weightDigits + OUT_DIGITS_SIZE, weight, &weightText);
+        size_t centsLen = formatCents(centsDigits + OUT_DIGITS_SIZE, cents, &centsText);
+        memcpy(p, "{\"dest\":", 8);
+        p = putJsonString(p + 8, dest, destLen);
+        memcpy(p, ",\"weight\":", 10);
+        memcpy(p + 10, weightText, weightLen);
+        p += 10 + weightLen;
+        memcpy(p, ",\"value\":", 9);
+        memcpy(p + 9, centsText, centsLen);
+        p += 9 + centsLen;
+        memcpy(p, "}\n", 2);
+        p += 2;
+        break;
+    }
+    case OUT_FORMAT_BINARY:
+    {
+        int32_t weight32 = weight;
+        uint16_t nameLen = destLen > UINT16_MAX ? UINT16_MAX : (uint16_t)destLen;
+        memcpy(p, &weight32, sizeof weight32);
+        p += sizeof weight32;
+        memcpy(p, &cents, sizeof cents);
+        p += sizeof cents;
+        memcpy(p, &nameLen, sizeof nameLen);
+        p += sizeof nameLen;
+        memcpy(p, dest, nameLen);
+        p += nameLen;
+        break;
+    }
+    }
+    out->Length = (size_t)(p - out->Data);
+    if (out->Sink != NULL && out->Length >= OUTBUF_FLUSH_SIZE)
+    {
+        flushOutBuf(out);
+    }
+}
+
+/*
+* FUNCTION      : parseOutFormat
+* DESCRIPTION   : This functoin converts the name of a row format to its OutFormat.
+* PARAMETERS    :
+*   const char* name    :   table, csv, json or binary.
+*   OutFormat* format   :   receives the format.
+* RETURNS       :
+*   bool    : true, if the name is a row format. otherwise, false.
+*/
+bool parseOutFormat(const char* name, OutFormat* format)
+{
+    static const char* const names[] = { "table", "csv", "json", "binary" };
+    for (size_t i = 0; i < sizeof names / sizeof names[0]; ++i)
+    {
+        if (strcmp(name, names[i]) == 0)
+        {
+            *format = (OutFormat)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+* FUNCTION      : setOutPage
+* DESCRIPTION   : This functoin starts a page of rows for the next answer.
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer.
+*   size_t offset   :   the number of leading rows to leave out.
+*   size_t limit    :   the most rows to write after them, OUT_NO_LIMIT for all of them.
+* RETURNS       : void
+*/
+void setOutPage(OutBuf* out, size_t offset, size_t limit)
+{
+    out->Skip = offset;
+    out->Limit = limit;
+}
+
+/*
+* FUNCTION      : outTakeRow
+* DESCRIPTION   : This functoin counts one row of an answer against the buffer's page.
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer.
+* RETURNS       :
+*   bool    : true, if the row falls within the page and should be written. otherwise, false.
+*/
+bool outTakeRow(OutBuf* out)
+{
+    if (out->Skip > 0)
+    {
+        out->Skip--;
+        return false;
+    }
+    if (out->Limit == 0)
+    {
+        return false;
+    }
+    out->Limit--;
+    return true;
+}
+
+/*
+* FUNCTION      : outPageFull
+* DESCRIPTION   : This functoin tells whether the buffer's page takes no more rows.
+* PARAMETERS    :
+*   const OutBuf* out   :   the buffer.
+* RETURNS       :
+*   bool    : true, if the limit has been reached. otherwise, false.
+*/
+bool outPageFull(const OutBuf* out)
+{
+    return out->Limit == 0;
+}
+
+/*
+* FUNCTION      : flushOutBuf
+* DESCRIPTION   : This functoin writes a bound buffer's text to its stream and empties it.
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer, an in-memory buffer is left untouched.
+* RETURNS       : void
+*/
+void flushOutBuf(OutBuf* out)
+{
+    if (out->Sink == NULL)
+    {
+        return;
+    }
+    if (out->Length > 0)
+    {
+        fwrite(out->Data, 1, out->Length, out->Sink);
+        out->Length = 0;
+    }
+    fflush(out->Sink);
+}
+
+/*
+* FUNCTION      : freeOutBuf
+* DESCRIPTION   : This functoin flushes a bound buffer and releases its memory.
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer.
+* RETURNS       : void
+*/
+void freeOutBuf(OutBuf* out)
+{
+    flushOutBuf(out);
+    free(out->Data);
+    out->Data = NULL;
+    out->Length = 0;
+    out->Capacity = 0;
+}
+
+/*
+* FUNCTION      : reserveOutBuf
+* DESCRIPTION   : This functoin makes room for a number of extra bytes, doubling the buffer as needed.
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer.
+*   size_t extra    :   the number of bytes about to be appended.
+* RETURNS       : void
+*/
+static void reserveOutBuf(OutBuf* out, size_t extra)
+{
+    if (out->Capacity - out->Length >= extra)
+    {
+        return;
+    }
+    size_t capacity = out->Capacity;
+    while (capacity - out->Length < extra)
+    {
+        capacity *= 2;
+    }
+    char* data = (char*)realloc(out->Data, capacity);
+    if (data == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    out->Data = data;
+    out->Capacity = capacity;
+}
+
+/*
+* FUNCTION      : outVprintf
+* DESCRIPTION   : This functoin appends printf-formatted text to the buffer, for outPrintf and outLabel.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer.
+*   const char* format  :   a printf format string.
+*   va_list args        :   its arguments.
+* RETURNS       : void
+*/
+static void outVprintf(OutBuf* out, const char* format, va_list args)
+{
+    va_list retry;
+    va_copy(retry, args);
+    int needed = vsnprintf(out->Data + out->Length, out->Capacity - out->Length, format, args);
+    if (needed < 0)
+    {
+        va_end(retry);
+        return;
+    }
+    if ((size_t)needed >= out->Capacity - out->Length)
+    {
+        reserveOutBuf(out, (size_t)needed + 1);
+        vsnprintf(out->Data + out->Length, out->Capacity - out->Length, format, retry);
+    }
+    va_end(retry);
+    out->Length += (size_t)needed;
+    if (out->Sink != NULL && out->Length >= OUTBUF_FLUSH_SIZE)
+    {
+        flushOutBuf(out);
+    }
+}
+
+/*
+* FUNCTION      : formatInteger
+* DESCRIPTION   : This functoin writes the decimal digits of a whole number backwards from the end of an array.
+* PARAMETERS    :
+*   char* digitsEnd :   one past the end of an array of OUT_DIGITS_SIZE characters.
+*   int64_t value   :   the number.
+*   char** digits   :   receives the first character written.
+* RETURNS       :
+*   size_t  : the number of characters written.
+*/
+static size_t formatInteger(char* digitsEnd, int64_t value, char** digits)
+{
+    char* p = digitsEnd;
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    do
+    {
+        *--p = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0)
+    {
+        *--p = '-';
+    }
+    *digits = p;
+    return (size_t)(digitsEnd - p);
+}
+
+/*
+* FUNCTION      : formatCents
+* DESCRIPTION   : This functoin writes a number of cents as dollars with two decimals, backwards from the end of an array.
+* PARAMETERS    :
+*   char* digitsEnd :   one past the end of an array of OUT_DIGITS_SIZE characters.
+*   int64_t cents   :   the value in cents.
+*   char** digits   :   receives the first character written.
+* RETURNS       :
+*   size_t  : the number of characters written.
+*/
+static size_t formatCents(char* digitsEnd, int64_t cents, char** digits)
+{
+    char* p = digitsEnd;
+    uint64_t magnitude = cents < 0 ? 0 - (uint64_t)cents : (uint64_t)cents;
+    *--p = (char)('0' + magnitude % 10);
+    *--p = (char)('0' + magnitude / 10 % 10);
+    *--p = '.';
+    magnitude /= 100;
+    do
+    {
+        *--p = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (cents < 0)
+    {
+        *--p = '-';
+    }
+    *digits = p;
+    return (size_t)(digitsEnd - p);
+}
+
+/*
+* FUNCTION      : putPadded
+* DESCRIPTION   : This functoin copies text right-aligned in a field, as printf's %*s does.
+* PARAMETERS    :
+*   char* p             :   where the field starts.
+*   const char* text    :   the text.
+*   size_t len          :   its length.
+*   size_t width        :   the least width of the field.
+* RETURNS       :
+*   char*   : one past the end of the field.
+*/
+static char* putPadded(char* p, const char* text, size_t len, size_t width)
+{
+    for (size_t i = len; i < width; ++i)
+    {
+        *p++ = ' ';
+    }
+    memcpy(p, text, len);
+    return p + len;
+}
+
+/*
+* FUNCTION      : putCsvField
+* DESCRIPTION   : This functoin copies text as a CSV field, quoted only when it holds a comma, quote or line break.
+* PARAMETERS    :
+*   char* p             :   where the field starts.
+*   const char* text    :   the text.
+*   size_t len          :   its length.
+* RETURNS       :
+*   char*   : one past the end of the field.
+*/
+static char* putCsvField(char* p, const char* text, size_t len)
+{
+    if (strcspn(text, ",\"\r\n") >= len)
+    {
+        memcpy(p, text, len);
+        return p + len;
+    }
+    *p++ = '"';
+    for (size_t i = 0; i < len; ++i)
+    {
+        if (text[i] == '"')
+        {
+            *p++ = '"';
+        }
+        *p++ = text[i];
+    }
+    *p++ = '"';
+    return p;
+}
+
+/*
+* FUNCTION      : putJsonString
+* DESCRIPTION   : This functoin copies text as a quoted JSON string, escaping quotes, backslashes and control characters.
+* PARAMETERS    :
+*   char* p             :   where the string starts.
+*   const char* text    :   the text.
+*   size_t len          :   its length.
+* RETURNS       :
+*   char*   : one past the closing quote.
+*/
+static char* putJsonString(char* p, const char* text, size_t len)
+{
+    static const char hex[] = "0123456789abcdef";
+    *p++ = '"';
+    for (size_t i = 0; i < len; ++i)
+    {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '"' || c == '\\')
+        {
+            *p++ = '\\';
+            *p++ = (char)c;
+        }
+        else if (c < 0x20)
+        {
+            memcpy(p, "\\u00", 4);
+            p[4] = hex[c >> 4];
+            p[5] = hex[c & 0xf];
+            p += 6;
+        }
+        else
+        {
+            *p++ = (char)c;
+        }
+    }
+    *p++ = '"';
+    return p;
+}
@@ -0,0 +1,57 @@
+/*
+* FILENAME      : output.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares OutBuf, the growable text buffer every query writes its results into. A buffer
+*   bound to a FILE* is written out in large blocks when it fills up or is flushed; an unbound buffer
+*   simply accumulates text for its owner to collect.
+*
+*   Parcel rows are formatted by hand rather than through printf, in one of four row formats: the
+*   aligned table, CSV, JSON lines or fixed binary records. Each answer can also be paged: a buffer
+*   skips a number of rows and then stops taking rows once its limit is reached, so the tree walks
+*   can stop early. Banners and query echoes are labels, written in the table format only.
+*/
+
+#pragma once
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define OUTBUF_INITIAL_SIZE     (64u << 10)
+#define OUTBUF_FLUSH_SIZE       (1u << 20)      // a bound buffer is written out once it holds this much
+#define OUT_NO_LIMIT            SIZE_MAX        // a page that takes every row
+#define OUT_ROW_RESERVE         96              // room for a row besides its destination, in any format
+
+typedef enum OutFormat
+{
+    OUT_FORMAT_TABLE,       // the aligned, human-readable table
+    OUT_FORMAT_CSV,         // destination,weight,value
+    OUT_FORMAT_JSON,        // one {"dest":..,"weight":..,"value":..} object per line
+    OUT_FORMAT_BINARY       // int32 weight, int64 cents, uint16 name length, then the name, host byte order
+} OutFormat;
+
+typedef struct OutBuf
+{
+    char* Data;
+    size_t Length;
+    size_t Capacity;
+    FILE* Sink;             // NULL for an in-memory buffer
+    OutFormat Format;       // how parcel rows are written
+    size_t Skip;            // rows of the current answer still to be skipped
+    size_t Limit;           // rows of the current answer still to be written
+} OutBuf;
+
+void initOutBuf(OutBuf* out, FILE* sink);
+void outWrite(OutBuf* out, const char* data, size_t len);
+void outPrintf(OutBuf* out, const char* format, ...);
+void outLabel(OutBuf* out, const char* format, ...);
+void outParcelRow(OutBuf* out, const char* dest, int weight, int64_t cents);
+bool parseOutFormat(const char* name, OutFormat* format);
+void setOutPage(OutBuf* out, size_t offset, size_t limit);
+bool outTakeRow(OutBuf* out);
+bool outPageFull(const OutBuf* out);
+void flushOutBuf(OutBuf* out);
+void freeOutBuf(OutBuf* out);
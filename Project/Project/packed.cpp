@@ -0,0 +1,942 @@
+/*
+* FILENAME      : packed.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the packed parcel columns and the row cursor declared in packed.h. A block
+*   stores its weight deltas, then its value offsets, then its arrival offsets, each field as a run of
+*   fixed-width values, so a field is decoded by one loop with a fixed shift pattern and no branch on
+*   the data. In weight order a cursor decodes one block at a time as it moves. In value order it
+*   decodes the blocks that may hold what the caller takes and sorts those rows; for the most valuable
+*   few, the block headers bound the lowest value worth looking at before any block is decoded.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "packed.h"
+#include "destTable.h"
+
+// the bound of a block on the values of its rows, while the blocks are ranked on it
+typedef struct BlockBound
+{
+    int64_t Cents;
+    size_t Rows;
+} BlockBound;
+
+static size_t firstBlockReaching(const PackedColumns* packed, int weight);
+static unsigned int bitsNeeded(uint64_t value);
+static void packBits(uint64_t* words, size_t offset, unsigned int bits, uint64_t value);
+static void unpackBits(const uint64_t* words, size_t offset, unsigned int bits, size_t count, uint64_t* values);
+static void setPackedParcel(Parcel* node, DestId dest, int weight, int64_t cents, uint32_t seq);
+static Parcel* packedRowAt(RowCursor* cursor, int64_t row);
+static Parcel* sortedRowAt(RowCursor* cursor, int64_t row);
+static void collectValueRows(RowCursor* cursor, int64_t minCents, int64_t maxCents, bool fromTop);
+static int64_t valueBound(const PackedColumns* packed, bool fromTop, size_t limit);
+static int compareBoundsAscending(const void* first, const void* second);
+static int compareBoundsDescending(const void* first, const void* second);
+static int comparePackedRows(const void* first, const void* second);
+
+/*
+* FUNCTION      : initPackedColumns
+* DESCRIPTION   : This functoin prepares an empty set of packed columns.
+* PARAMETERS    :
+*   PackedColumns* packed   :   the columns to be initialised.
+* RETURNS       : void
+*/
+void initPackedColumns(PackedColumns* packed)
+{
+    packed->Blocks = NULL;
+    packed->BlockCount = 0;
+    packed->Count = 0;
+    packed->Words = NULL;
+    packed->WordCount = 0;
+}
+
+/*
+* FUNCTION      : packParcelColumns
+* DESCRIPTION   :
+*   This functoin packs rows sorted by weight, then by arrival, replacing whatever the columns held.
+*   A first pass works out the bounds, totals and field widths of every block, and so the exact
+*   number of words needed; the second pass packs the fields into them.
+* PARAMETERS    :
+*   PackedColumns* packed   :   the columns to be filled.
+*   const int* weights      :   the weights, ascending.
+*   const int64_t* cents    :   the value of the row at the same position, in cents.
+*   const uint32_t* seqs    :   the arrival number of the row at the same position.
+*   size_t count            :   the number of rows.
+* RETURNS       : void
+*/
+void packParcelColumns(PackedColumns* packed, const int* weights, const int64_t* cents, const uint32_t* seqs, size_t count)
+{
+    size_t blockCount = (count + PACKED_BLOCK_ROWS - 1) / PACKED_BLOCK_ROWS;
+    size_t wordCount = 0;
+
+    freePackedColumns(packed);
+    packed->Blocks = (PackedBlock*)malloc((blockCount > 0 ? blockCount : 1) * sizeof(PackedBlock));
+    if (packed->Blocks == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    packed->BlockCount = blockCount;
+    packed->Count = count;
+
+    for (size_t b = 0; b < blockCount; ++b)
+    {
+        PackedBlock* block = &packed->Blocks[b];
+        size_t begin = b * PACKED_BLOCK_ROWS;
+        size_t rows = packedBlockRows(packed, b);
+        uint64_t maxDelta = 0;
+        uint32_t maxSeq = seqs[begin];
+
+        block->FirstWeight = weights[begin];
+        block->LastWeight = weights[begin + rows - 1];
+        block->MinCents = cents[begin];
+        block->MaxCents = cents[begin];
+        block->MinSeq = seqs[begin];
+        block->SumWeight = 0;
+        block->SumCents = 0;
+        for (size_t i = begin; i < begin + rows; ++i)
+        {
+            if (i > begin)
+            {
+                uint64_t delta = (uint64_t)((int64_t)weights[i] - (int64_t)weights[i - 1]);
+                maxDelta = delta > maxDelta ? delta : maxDelta;
+            }
+            block->MinCents = cents[i] < block->MinCents ? cents[i] : block->MinCents;
+            block->MaxCents = cents[i] > block->MaxCents ? cents[i] : block->MaxCents;
+            block->MinSeq = seqs[i] < block->MinSeq ? seqs[i] : block->MinSeq;
+            maxSeq = seqs[i] > maxSeq ? seqs[i] : maxSeq;
+            block->SumWeight += weights[i];
+            block->SumCents += cents[i];
+        }
+        block->WeightBits = (uint8_t)bitsNeeded(maxDelta);
+        block->CentsBits = (uint8_t)bitsNeeded((uint64_t)block->MaxCents - (uint64_t)block->MinCents);
+        block->SeqBits = (uint8_t)bitsNeeded((uint64_t)(maxSeq - block->MinSeq));
+        block->Word = wordCount;
+        wordCount += (rows * ((size_t)block->WeightBits + block->CentsBits + block->SeqBits) + 63) / 64;
+    }
+
+    packed->Words = (uint64_t*)calloc(wordCount > 0 ? wordCount : 1, sizeof(uint64_t));
+    if (packed->Words == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    packed->WordCount = wordCount;
+    for (size_t b = 0; b < blockCount; ++b)
+    {
+        const PackedBlock* block = &packed->Blocks[b];
+        size_t begin = b * PACKED_BLOCK_ROWS;
+        size_t rows = packedBlockRows(packed, b);
+        size_t weightOffset = block->Word * 64;
+        size_t centsOffset = weightOffset + rows * block->WeightBits;
+        size_t seqOffset = centsOffset + rows * block->CentsBits;
+        for (size_t i = 0; i < rows; ++i)
+        {
+            int64_t previous = i > 0 ? weights[begin + i - 1] : block->FirstWeight;
+            packBits(packed->Words, weightOffset + i * block->WeightBits, block->WeightBits,
+                (uint64_t)((int64_t)weights[begin + i] - previous));
+            packBits(packed->Words, centsOffset + i * block->CentsBits, block->CentsBits,
+                (uint64_t)cents[begin + i] - (uint64_t)block->MinCents);
+            packBits(packed->Words, seqOffset + i * block->SeqBits, block->SeqBits,
+                (uint64_t)(seqs[begin + i] - block->MinSeq));
+        }
+    }
+}
+
+/*
+* FUNCTION      : freePackedColumns
+* DESCRIPTION   : This functoin frees the blocks and words of a set of packed columns and leaves it empty.
+* PARAMETERS    :
+*   PackedColumns* packed   :   the columns to be released.
+* RETURNS       : void
+*/
+void freePackedColumns(PackedColumns* packed)
+{
+    free(packed->Blocks);
+    free(packed->Words);
+    initPackedColumns(packed);
+}
+
+/*
+* FUNCTION      : packedBytes
+* DESCRIPTION   : This functoin tells how much memory a set of packed columns takes, headers included.
+* PARAMETERS    :
+*   const PackedColumns* packed :   the columns.
+* RETURNS       :
+*   size_t  : the number of bytes.
+*/
+size_t packedBytes(const PackedColumns* packed)
+{
+    return packed->BlockCount * sizeof(PackedBlock) + packed->WordCount * sizeof(uint64_t);
+}
+
+/*
+* FUNCTION      : packedBlockRows
+* DESCRIPTION   : This functoin tells how many rows a block holds.
+* PARAMETERS    :
+*   const PackedColumns* packed :   the columns.
+*   size_t block                :   the block.
+* RETURNS       :
+*   size_t  : PACKED_BLOCK_ROWS, or fewer for the last block.
+*/
+size_t packedBlockRows(const PackedColumns* packed, size_t block)
+{
+    size_t begin = block * PACKED_BLOCK_ROWS;
+    return packed->Count - begin < PACKED_BLOCK_ROWS ? packed->Count - begin : PACKED_BLOCK_ROWS;
+}
+
+/*
+* FUNCTION      : decodePackedBlock
+* DESCRIPTION   :
+*   This functoin decodes the rows of one block into plain arrays. The weights are rebuilt by a
+*   running sum of their deltas; a field that is not wanted is not decoded at all.
+* PARAMETERS    :
+*   const PackedColumns* packed :   the columns.
+*   size_t block                :   the block.
+*   int* weights                :   receives the weights, or NULL.
+*   int64_t* cents              :   receives the values in cents, or NULL.
+*   uint32_t* seqs              :   receives the arrival numbers, or NULL.
+* RETURNS       : void
+*/
+void decodePackedBlock(const PackedColumns* packed, size_t block, int* weights, int64_t* cents, uint32_t* seqs)
+{
+    const PackedBlock* header = &packed->Blocks[block];
+    size_t rows = packedBlockRows(packed, block);
+    size_t weightOffset = header->Word * 64;
+    size_t centsOffset = weightOffset + rows * header->WeightBits;
+    size_t seqOffset = centsOffset + rows * header->CentsBits;
+    uint64_t values[PACKED_BLOCK_ROWS];
+
+    if (weights != NULL)
+    {
+        unpackBits(packed->Words, weightOffset, header->WeightBits, rows, values);
+        int64_t weight = header->FirstWeight;
+        for (size_t i = 0; i < rows; ++i)
+        {
+            weight += (int64_t)values[i];
+            weights[i] = (int)weight;
+        }
+    }
+    if (cents != NULL)
+    {
+        unpackBits(packed->Words, centsOffset, header->CentsBits, rows, values);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            cents[i] = (int64_t)((uint64_t)header->MinCents + values[i]);
+        }
+    }
+    if (seqs != NULL)
+    {
+        unpackBits(packed->Words, seqOffset, header->SeqBits, rows, values);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            seqs[i] = header->MinSeq + (uint32_t)values[i];
+        }
+    }
+}
+
+/*
+* FUNCTION      : getPackedParcel
+* DESCRIPTION   : This functoin decodes one row, by its position in weight order, into a parcel node.
+* PARAMETERS    :
+*   const PackedColumns* packed :   the columns.
+*   DestId dest                 :   the destination the columns belong to.
+*   size_t row                  :   the position of the row, less than Count.
+*   Parcel* node                :   receives the row.
+* RETURNS       :
+*   Parcel* : node.
+*/
+Parcel* getPackedParcel(const PackedColumns* packed, DestId dest, size_t row, Parcel* node)
+{
+    int weights[PACKED_BLOCK_ROWS];
+    int64_t cents[PACKED_BLOCK_ROWS];
+    uint32_t seqs[PACKED_BLOCK_ROWS];
+    size_t i = row % PACKED_BLOCK_ROWS;
+
+    decodePackedBlock(packed, row / PACKED_BLOCK_ROWS, weights, cents, seqs);
+    setPackedParcel(node, dest, weights[i], cents[i], seqs[i]);
+    return node;
+}
+
+/*
+* FUNCTION      : rankOfPackedWeight
+* DESCRIPTION   :
+*   This functoin counts the rows strictly lighter than a given weight, as rankOfWeight does for a
+*   tree. The block is found by a binary search of the headers, and only that block is decoded.
+* PARAMETERS    :
+*   const PackedColumns* packed :   the columns.
+*   int weight                  :   the weight.
+* RETURNS       :
+*   int64_t : the number of lighter rows, which is also the position of the first row at least that heavy.
+*/
+int64_t rankOfPackedWeight(const PackedColumns* packed, int weight)
+{
+    size_t low = firstBlockReaching(packed, weight);
+    if (low == packed->BlockCount)
+    {
+        return (int64_t)packed->Count;
+    }
+    int64_t rank = (int64_t)(low * PACKED_BLOCK_ROWS);
+    if (packed->Blocks[low].FirstWeight >= weight)
+    {
+        return rank;
+    }
+
+    int weights[PACKED_BLOCK_ROWS];
+    size_t rows = packedBlockRows(packed, low);
+    decodePackedBlock(packed, low, weights, NULL, NULL);
+    for (size_t i = 0; i < rows && weights[i] < weight; ++i)
+    {
+        rank++;
+    }
+    return rank;
+}
+
+/*
+* FUNCTION      : sumPackedWeightRange
+* DESCRIPTION   :
+*   This functoin totals the rows weighing within an inclusive range. A block wholly inside the range
+*   is added from its header; only the blocks at the two ends of the range are decoded.
+* PARAMETERS    :
+*   const PackedColumns* packed :   the columns.
+*   int minWgt                  :   the lowest weight of the range.
+*   int maxWgt                  :   the highest weight of the range.
+*   RangeTotals* totals         :   receives the totals.
+* RETURNS       : void
+*/
+void sumPackedWeightRange(const PackedColumns* packed, int minWgt, int maxWgt, RangeTotals* totals)
+{
+    int weights[PACKED_BLOCK_ROWS];
+    int64_t cents[PACKED_BLOCK_ROWS];
+
+    totals->Count = 0;
+    totals->TotalWeight = 0;
+    totals->TotalCents = 0;
+    if (minWgt > maxWgt)
+    {
+        return;
+    }
+    for (size_t b = firstBlockReaching(packed, minWgt); b < packed->BlockCount && packed->Blocks[b].FirstWeight <= maxWgt; ++b)
+    {
+        const PackedBlock* block = &packed->Blocks[b];
+        size_t rows = packedBlockRows(packed, b);
+        if (block->FirstWeight >= minWgt && block->LastWeight <= maxWgt)
+        {
+            totals->Count += (int64_t)rows;
+            totals->TotalWeight += block->SumWeight;
+            totals->TotalCents += block->SumCents;
+            continue;
+        }
+        decodePackedBlock(packed, b, weights, cents, NULL);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            int64_t keep = weights[i] >= minWgt && weights[i] <= maxWgt;
+            totals->Count += keep;
+            totals->TotalWeight += keep * weights[i];
+            totals->TotalCents += keep * cents[i];
+        }
+    }
+}
+
+/*
+* FUNCTION      : scanPackedValueRange
+* DESCRIPTION   :
+*   This functoin totals the rows valued within an inclusive range. A block whose values all lie in
+*   the range is added from its header and one whose values all miss it is skipped; the others are
+*   decoded and run through scanValueRange, so they get the same vector kernels as plain columns.
+* PARAMETERS    :
+*   const PackedColumns* packed :   the columns.
+*   int64_t minCents            :   the lowest value of the range, in cents.
+*   int64_t maxCents            :   the highest value of the range, in cents.
+*   ColumnTotals* totals        :   receives the totals, and the lowest and highest value kept.
+* RETURNS       : void
+*/
+void scanPackedValueRange(const PackedColumns* packed, int64_t minCents, int64_t maxCents, ColumnTotals* totals)
+{
+    int weights[PACKED_BLOCK_ROWS];
+    int64_t cents[PACKED_BLOCK_ROWS];
+    ParcelColumns decoded = { weights, cents, NULL, 0, PACKED_BLOCK_ROWS, false };
+
+    totals->Count = 0;
+    totals->TotalWeight = 0;
+    totals->TotalCents = 0;
+    totals->MinCents = INT64_MAX;
+    totals->MaxCents = INT64_MIN;
+    for (size_t b = 0; b < packed->BlockCount; ++b)
+    {
+        const PackedBlock* block = &packed->Blocks[b];
+        ColumnTotals part;
+        if (block->MaxCents < minCents || block->MinCents > maxCents)
+        {
+            continue;
+        }
+        if (block->MinCents >= minCents && block->MaxCents <= maxCents)
+        {
+            part.Count = (int64_t)packedBlockRows(packed, b);
+            part.TotalWeight = block->SumWeight;
+            part.TotalCents = block->SumCents;
+            part.MinCents = block->MinCents;
+            part.MaxCents = block->MaxCents;
+        }
+        else
+        {
+            decoded.Count = packedBlockRows(packed, b);
+            decodePackedBlock(packed, b, weights, cents, NULL);
+            scanValueRange(&decoded, 0, decoded.Count, minCents, maxCents, &part);
+        }
+        totals->Count += part.Count;
+        totals->TotalWeight += part.TotalWeight;
+        totals->TotalCents += part.TotalCents;
+        totals->MinCents = part.MinCents < totals->MinCents ? part.MinCents : totals->MinCents;
+        totals->MaxCents = part.MaxCents > totals->MaxCents ? part.MaxCents : totals->MaxCents;
+    }
+}
+
+/*
+* FUNCTION      : initRowCursor
+* DESCRIPTION   :
+*   This functoin points a cursor at one of a destination's orders, before any seek. The caller also
+*   tells which keys it takes and how many parcels at most; a tree cursor ignores both, but a packed
+*   cursor in value order only sorts the rows that can be taken, so it must not be moved back past
+*   where it seeks to or further than limit parcels from there.
+* PARAMETERS    :
+*   RowCursor* cursor           :   the cursor.
+*   const Destination* dest     :   the destination.
+*   CursorIndex index           :   the order to walk.
+*   int64_t low                 :   the lowest key taken.
+*   int64_t high                :   the highest key taken.
+*   size_t limit                :   the most parcels taken.
+* RETURNS       : void
+*/
+void initRowCursor(RowCursor* cursor, const Destination* dest, CursorIndex index, int64_t low, int64_t high, size_t limit)
+{
+    cursor->Packed = dest->Packed.Count > 0 ? &dest->Packed : NULL;
+    cursor->Dest = dest->Id;
+    cursor->Index = index;
+    cursor->Low = low;
+    cursor->High = high;
+    cursor->Limit = limit;
+    cursor->Row = -1;
+    cursor->Block = SIZE_MAX;
+    cursor->Sorted = NULL;
+    cursor->SortedCount = 0;
+    initParcelCursor(&cursor->Tree, index == CURSOR_BY_WEIGHT ? dest->Root : dest->ValueRoot, index);
+}
+
+/*
+* FUNCTION      : seekFirstRow
+* DESCRIPTION   : This functoin moves a cursor to the parcel with the lowest key.
+* PARAMETERS    :
+*   RowCursor* cursor   :   the cursor.
+* RETURNS       :
+*   Parcel* : the parcel, or NULL if there is none.
+*/
+Parcel* seekFirstRow(RowCursor* cursor)
+{
+    if (cursor->Packed == NULL)
+    {
+        return seekFirstParcel(&cursor->Tree);
+    }
+    if (cursor->Index == CURSOR_BY_WEIGHT)
+    {
+        return packedRowAt(cursor, 0);
+    }
+    collectValueRows(cursor, cursor->Low, cursor->High, false);
+    return sortedRowAt(cursor, 0);
+}
+
+/*
+* FUNCTION      : seekLastRow
+* DESCRIPTION   : This functoin moves a cursor to the parcel with the highest key.
+* PARAMETERS    :
+*   RowCursor* cursor   :   the cursor.
+* RETURNS       :
+*   Parcel* : the parcel, or NULL if there is none.
+*/
+Parcel* seekLastRow(RowCursor* cursor)
+{
+    if (cursor->Packed == NULL)
+    {
+        return seekLastParcel(&cursor->Tree);
+    }
+    if (cursor->Index == CURSOR_BY_WEIGHT)
+    {
+        return packedRowAt(cursor, (int64_t)cursor->Packed->Count - 1);
+    }
+    collectValueRows(cursor, cursor->Low, cursor->High, true);
+    return sortedRowAt(cursor, (int64_t)cursor->SortedCount - 1);
+}
+
+/*
+* FUNCTION      : seekRowAtLeast
+* DESCRIPTION   : This functoin moves a cursor to the first parcel whose key is at least a given key.
+* PARAMETERS    :
+*   RowCursor* cursor   :   the cursor.
+*   int64_t key         :   a weight in grams, or a value in cents.
+* RETURNS       :
+*   Parcel* : the parcel, or NULL if every key is lower.
+*/
+Parcel* seekRowAtLeast(RowCursor* cursor, int64_t key)
+{
+    if (cursor->Packed == NULL)
+    {
+        return seekParcelAtLeast(&cursor->Tree, key);
+    }
+    if (cursor->Index == CURSOR_BY_WEIGHT)
+    {
+        if (key > INT_MAX)
+        {
+            return packedRowAt(cursor, -1);
+        }
+        return packedRowAt(cursor, rankOfPackedWeight(cursor->Packed, key < INT_MIN ? INT_MIN : (int)key));
+    }
+    collectValueRows(cursor, key > cursor->Low ? key : cursor->Low, cursor->High, false);
+    return sortedRowAt(cursor, 0);
+}
+
+/*
+* FUNCTION      : seekRowAtMost
+* DESCRIPTION   : This functoin moves a cursor to the last parcel whose key is at most a given key.
+* PARAMETERS    :
+*   RowCursor* cursor   :   the cursor.
+*   int64_t key         :   a weight in grams, or a value in cents.
+* RETURNS       :
+*   Parcel* : the parcel, or NULL if every key is higher.
+*/
+Parcel* seekRowAtMost(RowCursor* cursor, int64_t key)
+{
+    if (cursor->Packed == NULL)
+    {
+        return seekParcelAtMost(&cursor->Tree, key);
+    }
+    if (cursor->Index == CURSOR_BY_WEIGHT)
+    {
+        if (key < INT_MIN)
+        {
+            return packedRowAt(cursor, -1);
+        }
+        if (key >= INT_MAX)
+        {
+            return packedRowAt(cursor, (int64_t)cursor->Packed->Count - 1);
+        }
+        return packedRowAt(cursor, rankOfPackedWeight(cursor->Packed, (int)key + 1) - 1);
+    }
+    collectValueRows(cursor, cursor->Low, key < cursor->High ? key : cursor->High, true);
+    return sortedRowAt(cursor, (int64_t)cursor->SortedCount - 1);
+}
+
+/*
+* FUNCTION      : nextRow
+* DESCRIPTION   : This functoin moves a cursor to the parcel with the next higher key.
+* PARAMETERS    :
+*   RowCursor* cursor   :   the cursor.
+* RETURNS       :
+*   Parcel* : the parcel, or NULL once the cursor runs off the end.
+*/
+Parcel* nextRow(RowCursor* cursor)
+{
+    if (cursor->Packed == NULL)
+    {
+        return nextParcel(&cursor->Tree);
+    }
+    if (cursor->Row < 0)
+    {
+        return NULL;
+    }
+    return cursor->Index == CURSOR_BY_WEIGHT ? packedRowAt(cursor, cursor->Row + 1) : sortedRowAt(cursor, cursor->Row + 1);
+}
+
+/*
+* FUNCTION      : prevRow
+* DESCRIPTION   : This functoin moves a cursor to the parcel with the next lower key.
+* PARAMETERS    :
+*   RowCursor* cursor   :   the cursor.
+* RETURNS       :
+*   Parcel* : the parcel, or NULL once the cursor runs off the start.
+*/
+Parcel* prevRow(RowCursor* cursor)
+{
+    if (cursor->Packed == NULL)
+    {
+        return prevParcel(&cursor->Tree);
+    }
+    if (cursor->Row < 0)
+    {
+        return NULL;
+    }
+    return cursor->Index == CURSOR_BY_WEIGHT ? packedRowAt(cursor, cursor->Row - 1) : sortedRowAt(cursor, cursor->Row - 1);
+}
+
+/*
+* FUNCTION      : releaseRowCursor
+* DESCRIPTION   : This functoin frees the rows a cursor sorted. The parcel it handed out last is no longer valid.
+* PARAMETERS    :
+*   RowCursor* cursor   :   the cursor.
+* RETURNS       : void
+*/
+void releaseRowCursor(RowCursor* cursor)
+{
+    free(cursor->Sorted);
+    cursor->Sorted = NULL;
+    cursor->SortedCount = 0;
+    cursor->Row = -1;
+}
+
+/*
+* FUNCTION      : firstBlockReaching
+* DESCRIPTION   : This functoin finds, by a binary search of the headers, the first block whose heaviest row is at least a given weight.
+* PARAMETERS    :
+*   const PackedColumns* packed :   the columns.
+*   int weight                  :   the weight.
+* RETURNS       :
+*   size_t  : the block, or BlockCount if every row is lighter.
+*/
+static size_t firstBlockReaching(const PackedColumns* packed, int weight)
+{
+    size_t low = 0;
+    size_t high = packed->BlockCount;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (packed->Blocks[middle].LastWeight < weight)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/*
+* FUNCTION      : bitsNeeded
+* DESCRIPTION   : This functoin tells how many bits it takes to store a value.
+* PARAMETERS    :
+*   uint64_t value  :   the value.
+* RETURNS       :
+*   unsigned int    : the number of bits, 0 for a value of 0.
+*/
+static unsigned int bitsNeeded(uint64_t value)
+{
+    unsigned int bits = 0;
+    while (bits < 64 && (value >> bits) != 0)
+    {
+        bits++;
+    }
+    return bits;
+}
+
+/*
+* FUNCTION      : packBits
+* DESCRIPTION   : This functoin stores a value in a given number of bits at a bit offset of zeroed words.
+* PARAMETERS    :
+*   uint64_t* words     :   the words.
+*   size_t offset       :   the bit offset.
+*   unsigned int bits   :   the width, the value must fit in it.
+*   uint64_t value      :   the value.
+* RETURNS       : void
+*/
+static void packBits(uint64_t* words, size_t offset, unsigned int bits, uint64_t value)
+{
+    if (bits == 0)
+    {
+        return;
+    }
+    size_t word = offset >> 6;
+    unsigned int shift = (unsigned int)(offset & 63);
+    words[word] |= value << shift;
+    if (shift + bits > 64)
+    {
+        words[word + 1] |= value >> (64 - shift);
+    }
+}
+
+/*
+* FUNCTION      : unpackBits
+* DESCRIPTION   : This functoin reads a run of values of a given width starting at a bit offset.
+* PARAMETERS    :
+*   const uint64_t* words   :   the words.
+*   size_t offset           :   the bit offset of the first value.
+*   unsigned int bits       :   the width of every value.
+*   size_t count            :   the number of values.
+*   uint64_t* values        :   receives the values.
+* RETURNS       : void
+*/
+static void unpackBits(const uint64_t* words, size_t offset, unsigned int bits, size_t count, uint64_t* values)
+{
+    if (bits == 0)
+    {
+        memset(values, 0, count * sizeof(uint64_t));
+        return;
+    }
+    uint64_t mask = bits == 64 ? ~(uint64_t)0 : ((uint64_t)1 << bits) - 1;
+    for (size_t i = 0; i < count; ++i, offset += bits)
+    {
+        size_t word = offset >> 6;
+        unsigned int shift = (unsigned int)(offset & 63);
+        uint64_t value = words[word] >> shift;
+        if (shift + bits > 64)
+        {
+            value |= words[word + 1] << (64 - shift);
+        }
+        values[i] = value & mask;
+    }
+}
+
+/*
+* FUNCTION      : setPackedParcel
+* DESCRIPTION   : This functoin fills a parcel node, as a lone leaf, with a decoded row.
+* PARAMETERS    :
+*   Parcel* node    :   the node.
+*   DestId dest     :   the destination of the row.
+*   int weight      :   the weight of the row.
+*   int64_t cents   :   the value of the row, in cents.
+*   uint32_t seq    :   the arrival number of the row.
+* RETURNS       : void
+*/
+static void setPackedParcel(Parcel* node, DestId dest, int weight, int64_t cents, uint32_t seq)
+{
+    memset(node, 0, sizeof(Parcel));
+    node->Weight = weight;
+    node->Cents = cents;
+    node->Height = 1;
+    node->Count = 1;
+    node->SumWeight = weight;
+    node->SumCents = cents;
+    node->Seq = seq;
+    node->Dest = dest;
+    node->VHeight = 1;
+}
+
+/*
+* FUNCTION      : packedRowAt
+* DESCRIPTION   : This functoin moves a packed cursor in weight order to a row, decoding its block if needed.
+* PARAMETERS    :
+*   RowCursor* cursor   :   the cursor.
+*   int64_t row         :   the position of the row, out of range to run off the end.
+* RETURNS       :
+*   Parcel* : the row, or NULL if it is out of range.
+*/
+static Parcel* packedRowAt(RowCursor* cursor, int64_t row)
+{
+    if (row < 0 || row >= (int64_t)cursor->Packed->Count)
+    {
+        cursor->Row = -1;
+        return NULL;
+    }
+    size_t block = (size_t)row / PACKED_BLOCK_ROWS;
+    size_t i = (size_t)row % PACKED_BLOCK_ROWS;
+    if (block != cursor->Block)
+    {
+        decodePackedBlock(cursor->Packed, block, cursor->Weights, cursor->Cents, cursor->Seqs);
+        cursor->Block = block;
+    }
+    cursor->Row = row;
+    setPackedParcel(&cursor->Current, cursor->Dest, cursor->Weights[i], cursor->Cents[i], cursor->Seqs[i]);
+    return &cursor->Current;
+}
+
+/*
+* FUNCTION      : sortedRowAt
+* DESCRIPTION   : This functoin moves a packed cursor in value order to one of the rows its last seek sorted.
+* PARAMETERS    :
+*   RowCursor* cursor   :   the cursor.
+*   int64_t row         :   the position of the row, out of range to run off the end.
+* RETURNS       :
+*   Parcel* : the row, or NULL if it is out of range.
+*/
+static Parcel* sortedRowAt(RowCursor* cursor, int64_t row)
+{
+    if (row < 0 || row >= (int64_t)cursor->SortedCount)
+    {
+        cursor->Row = -1;
+        return NULL;
+    }
+    const PackedRow* sorted = &cursor->Sorted[row];
+    cursor->Row = row;
+    setPackedParcel(&cursor->Current, cursor->Dest, sorted->Weight, sorted->Cents, sorted->Seq);
+    return &cursor->Current;
+}
+
+/*
+* FUNCTION      : collectValueRows
+* DESCRIPTION   :
+*   This functoin decodes the rows valued within an inclusive range and sorts them by value, then by
+*   arrival, keeping the cursor's limit of them from the low end or from the high end. Blocks whose
+*   values miss the range are not decoded. When the kept end of the range is open, the block headers
+*   first narrow it to the values the limit can reach.
+* PARAMETERS    :
+*   RowCursor* cursor   :   a packed cursor in value order.
+*   int64_t minCents    :   the lowest value of the range.
+*   int64_t maxCents    :   the highest value of the range.
+*   bool fromTop        :   keep the highest values rather than the lowest.
+* RETURNS       : void
+*/
+static void collectValueRows(RowCursor* cursor, int64_t minCents, int64_t maxCents, bool fromTop)
+{
+    const PackedColumns* packed = cursor->Packed;
+    int weights[PACKED_BLOCK_ROWS];
+    int64_t cents[PACKED_BLOCK_ROWS];
+    uint32_t seqs[PACKED_BLOCK_ROWS];
+    size_t capacity = 0;
+    size_t count = 0;
+
+    releaseRowCursor(cursor);
+    if (cursor->Limit == 0 || minCents > maxCents)
+    {
+        return;
+    }
+    if (cursor->Limit < packed->Count && (fromTop ? maxCents == INT64_MAX : minCents == INT64_MIN))
+    {
+        int64_t bound = valueBound(packed, fromTop, cursor->Limit);
+        if (fromTop)
+        {
+            minCents = bound > minCents ? bound : minCents;
+        }
+        else
+        {
+            maxCents = bound < maxCents ? bound : maxCents;
+        }
+    }
+    for (size_t b = 0; b < packed->BlockCount; ++b)
+    {
+        if (packed->Blocks[b].MaxCents >= minCents && packed->Blocks[b].MinCents <= maxCents)
+        {
+            capacity += packedBlockRows(packed, b);
+        }
+    }
+    PackedRow* rows = (PackedRow*)malloc((capacity > 0 ? capacity : 1) * sizeof(PackedRow));
+    if (rows == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t b = 0; b < packed->BlockCount; ++b)
+    {
+        if (packed->Blocks[b].MaxCents < minCents || packed->Blocks[b].MinCents > maxCents)
+        {
+            continue;
+        }
+        size_t blockRows = packedBlockRows(packed, b);
+        decodePackedBlock(packed, b, weights, cents, seqs);
+        for (size_t i = 0; i < blockRows; ++i)
+        {
+            if (cents[i] >= minCents && cents[i] <= maxCents)
+            {
+                rows[count].Cents = cents[i];
+                rows[count].Seq = seqs[i];
+                rows[count].Weight = weights[i];
+                count++;
+            }
+        }
+    }
+    qsort(rows, count, sizeof(PackedRow), comparePackedRows);
+    if (count > cursor->Limit)
+    {
+        if (fromTop)
+        {
+            memmove(rows, rows + (count - cursor->Limit), cursor->Limit * sizeof(PackedRow));
+        }
+        count = cursor->Limit;
+    }
+    cursor->Sorted = rows;
+    cursor->SortedCount = count;
+}
+
+/*
+* FUNCTION      : valueBound
+* DESCRIPTION   :
+*   This functoin finds, from the block headers alone, a value that at least limit rows reach. For the
+*   highest values the blocks are ranked on their lowest value: once the best ranked hold limit rows,
+*   every row worth keeping is valued at least the lowest value of the last of them. The lowest values
+*   are bounded the same way from the other side.
+* PARAMETERS    :
+*   const PackedColumns* packed :   the columns, with more than limit rows.
+*   bool fromTop                :   bound the highest values rather than the lowest.
+*   size_t limit                :   the number of rows kept, at least 1.
+* RETURNS       :
+*   int64_t : the lowest value worth keeping, or the highest when fromTop is false.
+*/
+static int64_t valueBound(const PackedColumns* packed, bool fromTop, size_t limit)
+{
+    BlockBound* bounds = (BlockBound*)malloc(packed->BlockCount * sizeof(BlockBound));
+    if (bounds == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t b = 0; b < packed->BlockCount; ++b)
+    {
+        bounds[b].Cents = fromTop ? packed->Blocks[b].MinCents : packed->Blocks[b].MaxCents;
+        bounds[b].Rows = packedBlockRows(packed, b);
+    }
+    qsort(bounds, packed->BlockCount, sizeof(BlockBound), fromTop ? compareBoundsDescending : compareBoundsAscending);
+
+    size_t rows = 0;
+    int64_t bound = bounds[0].Cents;
+    for (size_t b = 0; b < packed->BlockCount && rows < limit; ++b)
+    {
+        rows += bounds[b].Rows;
+        bound = bounds[b].Cents;
+    }
+    free(bounds);
+    return bound;
+}
+
+/*
+* FUNCTION      : compareBoundsAscending
+* DESCRIPTION   : This functoin is the qsort comparator that ranks block bounds lowest first.
+* PARAMETERS    :
+*   const void* first   :   points to a BlockBound.
+*   const void* second  :   points to another BlockBound.
+* RETURNS       :
+*   int : negative, zero or positive as first sorts before, with or after second.
+*/
+static int compareBoundsAscending(const void* first, const void* second)
+{
+    int64_t a = ((const BlockBound*)first)->Cents;
+    int64_t b = ((const BlockBound*)second)->Cents;
+    return a < b ? -1 : a > b ? 1 : 0;
+}
+
+/*
+* FUNCTION      : compareBoundsDescending
+* DESCRIPTION   : This functoin is the qsort comparator that ranks block bounds highest first.
+* PARAMETERS    :
+*   const void* first   :   points to a BlockBound.
+*   const void* second  :   points to another BlockBound.
+* RETURNS       :
+*   int : negative, zero or positive as first sorts before, with or after second.
+*/
+static int compareBoundsDescending(const void* first, const void* second)
+{
+    return compareBoundsAscending(second, first);
+}
+
+/*
+* FUNCTION      : comparePackedRows
+* DESCRIPTION   : This functoin is the qsort comparator that puts decoded rows in value order, then arrival order.
+* PARAMETERS    :
+*   const void* first   :   points to a PackedRow.
+*   const void* second  :   points to another PackedRow.
+* RETURNS       :
+*   int : negative, zero or positive as first sorts before, with or after second.
+*/
+static int comparePackedRows(const void* first, const void* second)
+{
+    const PackedRow* a = (const PackedRow*)first;
+    const PackedRow* b = (const PackedRow*)second;
+    if (a->Cents != b->Cents)
+    {
+        return a->Cents < b->Cents ? -1 : 1;
+    }
+    return a->Seq < b->Seq ? -1 : a->Seq > b->Seq ? 1 : 0;
+}
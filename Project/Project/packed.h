@@ -0,0 +1,105 @@
+/*
+* FILENAME      : packed.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the compressed encoding of a destination's parcels, used by the partitions of
+*   --compress, which are never changed once loaded. The parcels are sorted by weight, then by arrival,
+*   and cut into blocks of PACKED_BLOCK_ROWS rows. Within a block the weights are bit-packed as deltas
+*   from the row before, and the values and arrival numbers as offsets from the block's lowest one
+*   (frame of reference), each with only as many bits as the block needs. The destination is not
+*   stored at all, since every row of the columns belongs to the destination holding them.
+*
+*   The header of each block keeps its bounds and totals, so a range query sums the blocks it covers
+*   from their headers, skips the blocks it misses and decodes only those it cuts through, a whole
+*   block at a time into plain arrays that the column scan kernels run over.
+*
+*   A RowCursor walks a destination's parcels in weight or value order whether they sit in its trees
+*   or in packed blocks, and hands each one out as a Parcel that can be printed.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "parcel.h"
+#include "columns.h"
+
+#define PACKED_BLOCK_ROWS   128     // rows per block, the unit that is decoded at once
+
+struct Destination;
+
+// the header of a block: its bounds, totals and the number of bits of each of its fields
+typedef struct PackedBlock
+{
+    int FirstWeight;        // the lightest row, which the deltas start from
+    int LastWeight;         // the heaviest row
+    int64_t MinCents;       // the frame of reference of the values
+    int64_t MaxCents;
+    int64_t SumWeight;
+    int64_t SumCents;
+    uint32_t MinSeq;        // the frame of reference of the arrival numbers
+    uint8_t WeightBits;
+    uint8_t CentsBits;
+    uint8_t SeqBits;
+    size_t Word;            // the first word of the block in Words
+} PackedBlock;
+
+typedef struct PackedColumns
+{
+    PackedBlock* Blocks;
+    size_t BlockCount;
+    size_t Count;           // rows, a block holds PACKED_BLOCK_ROWS of them except the last
+    uint64_t* Words;        // the packed fields of every block, each block starting on a word of its own
+    size_t WordCount;
+} PackedColumns;
+
+// a packed row taken out of its block, while the rows are put in value order
+typedef struct PackedRow
+{
+    int64_t Cents;
+    uint32_t Seq;
+    int Weight;
+} PackedRow;
+
+// an in-order position in a destination's parcels, in its trees or in its packed blocks
+typedef struct RowCursor
+{
+    ParcelCursor Tree;                  // used when the destination is not packed
+    const PackedColumns* Packed;        // NULL when the destination is not packed
+    DestId Dest;
+    CursorIndex Index;
+    int64_t Low;                        // the lowest key the caller takes
+    int64_t High;                       // the highest key the caller takes
+    size_t Limit;                       // the most parcels the caller takes from where it seeks
+    int64_t Row;                        // the current row, -1 once the cursor has run off either end
+    size_t Block;                       // the block decoded below, or SIZE_MAX for none
+    int Weights[PACKED_BLOCK_ROWS];
+    int64_t Cents[PACKED_BLOCK_ROWS];
+    uint32_t Seqs[PACKED_BLOCK_ROWS];
+    PackedRow* Sorted;                  // in value order, the rows a seek found, by value then arrival
+    size_t SortedCount;
+    Parcel Current;                     // the current packed row, as a node that can be printed
+} RowCursor;
+
+// functions of PackedColumns
+void initPackedColumns(PackedColumns* packed);
+void packParcelColumns(PackedColumns* packed, const int* weights, const int64_t* cents, const uint32_t* seqs, size_t count);
+void freePackedColumns(PackedColumns* packed);
+size_t packedBytes(const PackedColumns* packed);
+size_t packedBlockRows(const PackedColumns* packed, size_t block);
+void decodePackedBlock(const PackedColumns* packed, size_t block, int* weights, int64_t* cents, uint32_t* seqs);
+Parcel* getPackedParcel(const PackedColumns* packed, DestId dest, size_t row, Parcel* node);
+int64_t rankOfPackedWeight(const PackedColumns* packed, int weight);
+void sumPackedWeightRange(const PackedColumns* packed, int minWgt, int maxWgt, RangeTotals* totals);
+void scanPackedValueRange(const PackedColumns* packed, int64_t minCents, int64_t maxCents, ColumnTotals* totals);
+// functions of RowCursor
+void initRowCursor(RowCursor* cursor, const struct Destination* dest, CursorIndex index, int64_t low, int64_t high, size_t limit);
+Parcel* seekFirstRow(RowCursor* cursor);
+Parcel* seekLastRow(RowCursor* cursor);
+Parcel* seekRowAtLeast(RowCursor* cursor, int64_t key);
+Parcel* seekRowAtMost(RowCursor* cursor, int64_t key);
+Parcel* nextRow(RowCursor* cursor);
+Parcel* prevRow(RowCursor* cursor);
+void releaseRowCursor(RowCursor* cursor);
@@ -0,0 +1,1511 @@
+/*
+* FILENAME      : parcel.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the Parcel node and the per-destination weight tree. The tree is an AVL tree
+*   keyed on weight, so its height stays O(log n) even when parcels arrive already sorted by weight.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdbool.h>
+#include "parcel.h"
+#include "arena.h"
+#include "metrics.h"
+
+/*
+* FUNCTION      : createNewParcel
+* DESCRIPTION   : this functoin creates a new Parcel node for trees.
+* PARAMETERS    : 
+*   Arena* arena    :   the arena that owns the node.
+*   DestId newDest  :   the dictionary id of the desetination of the new parcel.
+*   int   newWgt    :   the weight of the new parcel
+*   int64_t newCents    :   the valuation of the new parcel, in cents
+* 
+* RETURNS       :
+*       Parcel*     : a pointer to the new struct Parcel containing the parcel's info.
+*/
+Parcel* createNewParcel(Arena* arena, DestId newDest, int newWgt, int64_t newCents)
+{
+    Parcel* newNode = (Parcel*)arenaAlloc(arena, sizeof(Parcel));
+    newNode->Dest = newDest;
+    newNode->Cents = newCents;
+    newNode->Weight = newWgt;
+    newNode->Seq = 0;
+    resetParcelLinks(newNode);
+    return newNode;
+}
+
+/*
+* FUNCTION      : resetParcelLinks
+* DESCRIPTION   :
+*   this functoin detaches a parcel from both trees, leaving it as a single-node tree whose subtree
+*   totals are its own weight and value.
+* PARAMETERS    :
+*   Parcel* parcel  :   the parcel to be reset.
+* RETURNS       :  void
+*/
+void resetParcelLinks(Parcel* parcel)
+{
+    parcel->Left = NULL;
+    parcel->Right = NULL;
+    parcel->Height = 1;
+    parcel->Count = 1;
+    parcel->SumWeight = parcel->Weight;
+    parcel->SumCents = parcel->Cents;
+    parcel->VLeft = NULL;
+    parcel->VRight = NULL;
+    parcel->VHeight = 1;
+}
+
+/*
+* FUNCTION      : printParcel
+* DESCRIPTION   :
+*   This functoin prints out the information of a parcel, including its destination, weight and value, in one line
+*   of the buffer's row format, unless the row falls outside the buffer's page.
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer receiving the output.
+*   Parcel* toPrint :   a pointer to the parcel node to be printed out
+* RETURNS       :  void
+*/
+void printParcel(OutBuf* out, Parcel* toPrint)
+{
+    if (toPrint != NULL && outTakeRow(out))
+    {
+        outParcelRow(out, getDestName(toPrint->Dest), toPrint->Weight, toPrint->Cents);
+    }
+}
+/*
+* FUNCTION      : dollarsToCents
+* DESCRIPTION   : this functoin converts a dollar amount typed in a query to the nearest whole number of cents.
+* PARAMETERS    :
+*   double dollars  :   the amount in dollars.
+* RETURNS       : int64_t : the amount in cents.
+*/
+int64_t dollarsToCents(double dollars)
+{
+    return (int64_t)llround(dollars * 100.0);
+}
+
+/*
+* FUNCTION      : parcelHeight
+* DESCRIPTION   : Returns the height of a subtree, an empty subtree has height 0
+* PARAMETERS    : Parcel* node - the root of the subtree
+* RETURNS       : int - the height of the subtree
+*/
+static int parcelHeight(Parcel* node)
+{
+    return node == NULL ? 0 : node->Height;
+}
+
+/*
+* FUNCTION      : updateParcelNode
+* DESCRIPTION   : Recomputes the cached height and subtree totals of a node from its children
+* PARAMETERS    : Parcel* node - the node whose children have changed
+* RETURNS       : void
+*/
+static void updateParcelNode(Parcel* node)
+{
+    int leftHeight = parcelHeight(node->Left);
+    int rightHeight = parcelHeight(node->Right);
+    node->Height = (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+    node->Count = 1;
+    node->SumWeight = node->Weight;
+    node->SumCents = node->Cents;
+    if (node->Left != NULL)
+    {
+        node->Count += node->Left->Count;
+        node->SumWeight += node->Left->SumWeight;
+        node->SumCents += node->Left->SumCents;
+    }
+    if (node->Right != NULL)
+    {
+        node->Count += node->Right->Count;
+        node->SumWeight += node->Right->SumWeight;
+        node->SumCents += node->Right->SumCents;
+    }
+}
+
+/*
+* FUNCTION      : rotateLeft
+* DESCRIPTION   : Rotates a subtree to the left, lifting its right child into its place
+* PARAMETERS    : Parcel* node - the root of the subtree
+* RETURNS       : Parcel* - the new root of the subtree
+*/
+static Parcel* rotateLeft(Parcel* node)
+{
+    Parcel* pivot = node->Right;
+    node->Right = pivot->Left;
+    pivot->Left = node;
+    updateParcelNode(node);
+    updateParcelNode(pivot);
+    return pivot;
+}
+
+/*
+* FUNCTION      : rotateRight
+* DESCRIPTION   : Rotates a subtree to the right, lifting its left child into its place
+* PARAMETERS    : Parcel* node - the root of the subtree
+* RETURNS       : Parcel* - the new root of the subtree
+*/
+static Parcel* rotateRight(Parcel* node)
+{
+    Parcel* pivot = node->Left;
+    node->Left = pivot->Right;
+    pivot->Right = node;
+    updateParcelNode(node);
+    updateParcelNode(pivot);
+    return pivot;
+}
+
+/*
+* FUNCTION      : rebalance
+* DESCRIPTION   :
+*   Restores the AVL property of a node whose subtrees differ in height by at most two, using a single
+*   or double rotation.
+* PARAMETERS    : Parcel* node - the root of the subtree to be rebalanced
+* RETURNS       : Parcel* - the new root of the subtree
+*/
+static Parcel* rebalance(Parcel* node)
+{
+    updateParcelNode(node);
+    int balance = parcelHeight(node->Left) - parcelHeight(node->Right);
+    if (balance > 1)
+    {
+        if (parcelHeight(node->Left->Left) < parcelHeight(node->Left->Right))
+        {
+            node->Left = rotateLeft(node->Left);
+        }
+        node = rotateRight(node);
+    }
+    else if (balance < -1)
+    {
+        if (parcelHeight(node->Right->Right) < parcelHeight(node->Right->Left))
+        {
+            node->Right = rotateRight(node->Right);
+        }
+        node = rotateLeft(node);
+    }
+    return node;
+}
+
+/*
+* FUNCTION      : compareParcelKey
+* DESCRIPTION   : Orders two parcels by weight, then by sequence number for parcels of equal weight
+* PARAMETERS    : Parcel* first - the left-hand parcel
+*                 Parcel* second - the right-hand parcel
+* RETURNS       : int - negative, zero or positive as first sorts before, with or after second
+*/
+static int compareParcelKey(Parcel* first, Parcel* second)
+{
+    if (first->Weight != second->Weight)
+    {
+        return first->Weight < second->Weight ? -1 : 1;
+    }
+    if (first->Seq != second->Seq)
+    {
+        return first->Seq < second->Seq ? -1 : 1;
+    }
+    return 0;
+}
+
+/*
+* FUNCTION      : insertParcelToBST
+* DESCRIPTION   : 
+*   Inserts a new parcel into a Binary Search Tree and rebalances it on the way back up, so the tree
+*   remains an AVL tree of height O(log n) whatever order the parcels arrive in. Parcels are keyed on
+*   (Weight, Seq), so a parcel whose weight is already present is kept next to the existing ones.
+* PARAMETERS    : Parcel* root - The root of the BST
+*                 Parcel* newParcel - The parcel to be inserted, its Seq must be unique within the tree
+* RETURNS       : returns pointer to the new root of the binary search tree
+*/
+Parcel* insertParcelToBST(Parcel* parent, Parcel* newParcel)
+{
+    if (parent == NULL)
+    {
+        return newParcel;
+    }
+    METRIC_PATH_STEP();
+    if (compareParcelKey(newParcel, parent) > 0)
+    {
+       parent->Right = insertParcelToBST(parent->Right, newParcel);
+    }
+    else
+    {
+       parent->Left = insertParcelToBST(parent->Left, newParcel);
+    }
+    return rebalance(parent);
+}
+/*
+* FUNCTION      : removeMinParcel
+* DESCRIPTION   : Unlinks the lightest node of a subtree and rebalances the path back up to the subtree root
+* PARAMETERS    : Parcel* node - the root of the subtree
+*                 Parcel** min - receives the unlinked node
+* RETURNS       : Parcel* - the new root of the subtree
+*/
+static Parcel* removeMinParcel(Parcel* node, Parcel** min)
+{
+    if (node->Left == NULL)
+    {
+        *min = node;
+        return node->Right;
+    }
+    node->Left = removeMinParcel(node->Left, min);
+    return rebalance(node);
+}
+
+/*
+* FUNCTION      : removeParcelFromBST
+* DESCRIPTION   :
+*   Unlinks a parcel from a weight tree and rebalances it on the way back up, so the cached heights and
+*   subtree totals along the path stay correct in O(log n). A node with two children is replaced by its
+*   in-order successor, which is relinked rather than copied because the same nodes also form the
+*   value index.
+* PARAMETERS    : Parcel* parent - The root of the BST
+*                 Parcel* target - The parcel to be removed, it must be in the tree
+* RETURNS       : returns pointer to the new root of the binary search tree
+*/
+Parcel* removeParcelFromBST(Parcel* parent, Parcel* target)
+{
+    if (parent == NULL)
+    {
+        return NULL;
+    }
+    int order = compareParcelKey(target, parent);
+    if (order < 0)
+    {
+        parent->Left = removeParcelFromBST(parent->Left, target);
+    }
+    else if (order > 0)
+    {
+        parent->Right = removeParcelFromBST(parent->Right, target);
+    }
+    else
+    {
+        if (parent->Left == NULL || parent->Right == NULL)
+        {
+            return parent->Left != NULL ? parent->Left : parent->Right;
+        }
+        Parcel* successor = NULL;
+        Parcel* right = removeMinParcel(parent->Right, &successor);
+        successor->Left = parent->Left;
+        successor->Right = right;
+        parent = successor;
+    }
+    return rebalance(parent);
+}
+
+/*
+* FUNCTION      : findParcelByWeightAndValue
+* DESCRIPTION   : Finds the first-arrived parcel of a given weight and value by walking a cursor over that weight
+* PARAMETERS    : Parcel* root - the root of the weight tree
+*                 int weight - the weight of the parcel
+*                 int64_t cents - the value of the parcel in cents
+* RETURNS       : returns a pointer to the parcel, or NULL if no parcel matches
+*/
+Parcel* findParcelByWeightAndValue(Parcel* root, int weight, int64_t cents)
+{
+    ParcelCursor cursor;
+    initParcelCursor(&cursor, root, CURSOR_BY_WEIGHT);
+    for (Parcel* parcel = seekParcelAtLeast(&cursor, weight); parcel != NULL && parcel->Weight == weight;
+        parcel = nextParcel(&cursor))
+    {
+        if (parcel->Cents == cents)
+        {
+            return parcel;
+        }
+    }
+    return NULL;
+}
+
+/*
+* FUNCTION      : buildBalancedBST
+* DESCRIPTION   :
+*   This functoin links nodes that are already in weight order into a perfectly balanced weight tree,
+*   which is always a valid AVL tree, in O(n) without comparing or rotating anything.
+* PARAMETERS    :
+*   Parcel** sorted - the nodes ordered by (Weight, Seq)
+*   size_t count    - the number of nodes
+* RETURNS       : Parcel* - the root of the new tree, NULL when count is 0
+*/
+Parcel* buildBalancedBST(Parcel** sorted, size_t count)
+{
+    if (count == 0)
+    {
+        return NULL;
+    }
+    size_t middle = count / 2;
+    Parcel* node = sorted[middle];
+    node->Left = buildBalancedBST(sorted, middle);
+    node->Right = buildBalancedBST(sorted + middle + 1, count - middle - 1);
+    updateParcelNode(node);
+    return node;
+}
+
+/*
+* FUNCTION      : firstEytzingerSlot
+* DESCRIPTION   :
+*   This functoin returns the slot of the lightest parcel in the Eytzinger layout of a weight tree:
+*   slot k (counted from 1) has its children in slots 2k and 2k+1, so the leftmost slot is the
+*   deepest power of two.
+* PARAMETERS    :
+*   size_t count    - the number of nodes in the layout, at least 1
+* RETURNS       : size_t - the slot, counted from 1
+*/
+size_t firstEytzingerSlot(size_t count)
+{
+    size_t slot = 1;
+    while (slot * 2 <= count)
+    {
+        slot *= 2;
+    }
+    return slot;
+}
+
+/*
+* FUNCTION      : nextEytzingerSlot
+* DESCRIPTION   :
+*   This functoin steps from one slot of an Eytzinger layout to the slot that follows it in weight
+*   order: down to the leftmost slot of the right child if there is one, otherwise up past every
+*   ancestor reached from its right.
+* PARAMETERS    :
+*   size_t slot     - the current slot, counted from 1
+*   size_t count    - the number of nodes in the layout
+* RETURNS       : size_t - the next slot, 0 after the heaviest
+*/
+size_t nextEytzingerSlot(size_t slot, size_t count)
+{
+    if (slot * 2 + 1 <= count)
+    {
+        slot = slot * 2 + 1;
+        while (slot * 2 <= count)
+        {
+            slot *= 2;
+        }
+        return slot;
+    }
+    while (slot & 1)
+    {
+        slot >>= 1;
+    }
+    return slot >> 1;
+}
+
+/*
+* FUNCTION      : linkEytzingerBST
+* DESCRIPTION   :
+*   This functoin links nodes that already sit in Eytzinger order, filled through firstEytzingerSlot
+*   and nextEytzingerSlot, into a weight tree. The tree is complete, so it is a valid AVL tree, and its
+*   top levels share the first cache lines of the array. The totals are computed bottom-up in one
+*   backward pass, since every child sits after its parent.
+* PARAMETERS    :
+*   Parcel* nodes   - the nodes, slot k stored at nodes[k - 1]
+*   size_t count    - the number of nodes
+* RETURNS       : Parcel* - the root of the new tree, NULL when count is 0
+*/
+Parcel* linkEytzingerBST(Parcel* nodes, size_t count)
+{
+    for (size_t slot = count; slot >= 1; --slot)
+    {
+        Parcel* node = &nodes[slot - 1];
+        node->Left = slot * 2 <= count ? &nodes[slot * 2 - 1] : NULL;
+        node->Right = slot * 2 + 1 <= count ? &nodes[slot * 2] : NULL;
+        updateParcelNode(node);
+    }
+    return count == 0 ? NULL : &nodes[0];
+}
+
+/*
+* FUNCTION      : findMaxWeight
+* DESCRIPTION   : Finds and returns the maximum weight in a Binary Search Tree
+* PARAMETERS    : Parcel* root - searching from the root of BST
+*
+* RETURNS       : returns pointer to the parcel, this parcel is the maximum weight
+*/
+Parcel* findMaxWeight(Parcel* root)
+{
+    while (root != NULL && root->Right != NULL)
+    {
+        root = root->Right;
+    }
+    return root;
+}
+/*
+* FUNCTION      : findMinWeight
+* DESCRIPTION   : Finds and returns the minimum weight in a Binary Search Tree
+* PARAMETERS    : Parcel* root - searching from the root of BST
+*
+* RETURNS       : returns pointer to the parcel, this parcel is the minimum weight
+*/
+Parcel* findMinWeight(Parcel* root)
+{
+    while (root != NULL && root->Left != NULL)
+    {
+        root = root->Left;
+    }
+    return root;
+}
+
+/*
+* FUNCTION      : printSectionLowerThanWgt
+* DESCRIPTION   :
+*   This functoin prints out all the parcels lighter than a given weight within a BST.
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer receiving the output.
+*   Parcel* parent  :   the root node of BSTs to display parcels.
+*   int partition   :   the weight partitions parcels in the bst to be displayed.
+* RETURNS       :  void
+*/
+void printSectionLowerThanWgt(OutBuf* out, Parcel* parent, int partition)
+{
+    ParcelCursor cursor;
+    initParcelCursor(&cursor, parent, CURSOR_BY_WEIGHT);
+    for (Parcel* parcel = seekFirstParcel(&cursor); parcel != NULL && parcel->Weight < partition && !outPageFull(out);
+        parcel = nextParcel(&cursor))
+    {
+        printParcel(out, parcel);
+    }
+}
+
+/*
+* FUNCTION      : printSectionHigherThanWgt
+* DESCRIPTION   :
+*   This functoin prints out all the parcels heavier than a given weight within a BST.
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer receiving the output.
+*   Parcel* parent  :   the root node of BSTs to display parcels.
+*   int partition   :   the weight partitions parcels in the bst to be displayed.
+* RETURNS       :  void
+*/
+void printSectionHigherThanWgt(OutBuf* out, Parcel* parent, int partition)
+{
+    ParcelCursor cursor;
+    initParcelCursor(&cursor, parent, CURSOR_BY_WEIGHT);
+    for (Parcel* parcel = seekParcelAtLeast(&cursor, (int64_t)partition + 1); parcel != NULL && !outPageFull(out);
+        parcel = nextParcel(&cursor))
+    {
+        printParcel(out, parcel);
+    }
+}
+
+/*
+* FUNCTION      : printSectionBetweenWeights
+* DESCRIPTION   :
+*   This functoin prints out, in weight ascending order, all the parcels whose weight lies within an
+*   inclusive range. The cursor seeks straight to the lightest match, so it runs in O(log n + k).
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer receiving the output.
+*   Parcel* parent  :   the root node of BSTs to display parcels.
+*   int minWgt      :   the lowest weight to be displayed.
+*   int maxWgt      :   the highest weight to be displayed.
+* RETURNS       :  void
+*/
+void printSectionBetweenWeights(OutBuf* out, Parcel* parent, int minWgt, int maxWgt)
+{
+    ParcelCursor cursor;
+    initParcelCursor(&cursor, parent, CURSOR_BY_WEIGHT);
+    for (Parcel* parcel = seekParcelAtLeast(&cursor, minWgt); parcel != NULL && parcel->Weight <= maxWgt && !outPageFull(out);
+        parcel = nextParcel(&cursor))
+    {
+        printParcel(out, parcel);
+    }
+}
+
+/*
+* FUNCTION      : sumOfLighterThan
+* DESCRIPTION   :
+*   This functoin totals the parcels lighter than a bound (or no heavier, when inclusive) by walking a
+*   single root-to-leaf path and adding whole left subtrees from their cached totals.
+* PARAMETERS    :
+*   Parcel* node        :   the root of the weight tree.
+*   int bound           :   the weight bound.
+*   bool inclusive      :   true to include parcels whose weight equals the bound.
+*   RangeTotals* totals :   receives the totals.
+* RETURNS       :  void
+*/
+static void sumOfLighterThan(Parcel* node, int bound, bool inclusive, RangeTotals* totals)
+{
+    totals->Count = 0;
+    totals->TotalWeight = 0;
+    totals->TotalCents = 0;
+    while (node != NULL)
+    {
+        if (node->Weight < bound || (inclusive && node->Weight == bound))
+        {
+            totals->Count++;
+            totals->TotalWeight += node->Weight;
+            totals->TotalCents += node->Cents;
+            if (node->Left != NULL)
+            {
+                totals->Count += node->Left->Count;
+                totals->TotalWeight += node->Left->SumWeight;
+                totals->TotalCents += node->Left->SumCents;
+            }
+            node = node->Right;
+        }
+        else
+        {
+            node = node->Left;
+        }
+    }
+}
+
+/*
+* FUNCTION      : sumOfWeightRange
+* DESCRIPTION   :
+*   This functoin totals the count, weight and value of the parcels whose weight lies within an
+*   inclusive range, in O(log n) and without visiting the matching parcels.
+* PARAMETERS    :
+*   Parcel* root        :   the root of the weight tree.
+*   int minWgt          :   the lowest weight of the range.
+*   int maxWgt          :   the highest weight of the range.
+*   RangeTotals* totals :   receives the totals.
+* RETURNS       :  void
+*/
+void sumOfWeightRange(Parcel* root, int minWgt, int maxWgt, RangeTotals* totals)
+{
+    RangeTotals below;
+    sumOfLighterThan(root, maxWgt, true, totals);
+    sumOfLighterThan(root, minWgt, false, &below);
+    totals->Count -= below.Count;
+    totals->TotalWeight -= below.TotalWeight;
+    totals->TotalCents -= below.TotalCents;
+    if (totals->Count < 0)
+    {
+        totals->Count = 0;
+        totals->TotalWeight = 0;
+        totals->TotalCents = 0;
+    }
+}
+
+/*
+* FUNCTION      : rankOfWeight
+* DESCRIPTION   : This functoin counts the parcels lighter than a given weight in O(log n).
+* PARAMETERS    :
+*   Parcel* root    :   the root of the weight tree.
+*   int weight      :   the weight to rank.
+* RETURNS       :  int64_t : the number of strictly lighter parcels.
+*/
+int64_t rankOfWeight(Parcel* root, int weight)
+{
+    RangeTotals totals;
+    sumOfLighterThan(root, weight, false, &totals);
+    return totals.Count;
+}
+
+/*
+* FUNCTION      : findKthLightest
+* DESCRIPTION   :
+*   This functoin finds the k-th lightest parcel (k = 1 is the lightest) by descending on subtree
+*   counts, in O(log n). Parcels of equal weight are ranked in arrival order.
+* PARAMETERS    :
+*   Parcel* root    :   the root of the weight tree.
+*   int64_t k       :   the 1-based rank.
+* RETURNS       :
+*   Parcel*     : the parcel of that rank, or NULL if k is out of range.
+*/
+Parcel* findKthLightest(Parcel* root, int64_t k)
+{
+    Parcel* node = root;
+    while (node != NULL)
+    {
+        int64_t leftCount = node->Left == NULL ? 0 : node->Left->Count;
+        if (k <= leftCount)
+        {
+            node = node->Left;
+        }
+        else if (k == leftCount + 1)
+        {
+            return node;
+        }
+        else
+        {
+            k -= leftCount + 1;
+            node = node->Right;
+        }
+    }
+    return NULL;
+}
+
+/*
+* FUNCTION      : findWeightPercentile
+* DESCRIPTION   :
+*   This functoin finds the parcel at a weight percentile using the nearest-rank method: the parcel
+*   of rank ceil(percentile / 100 * n), clamped to [1, n].
+* PARAMETERS    :
+*   Parcel* root        :   the root of the weight tree.
+*   double percentile   :   the percentile, from 0 to 100.
+* RETURNS       :
+*   Parcel*     : the parcel at that percentile, or NULL for an empty tree.
+*/
+Parcel* findWeightPercentile(Parcel* root, double percentile)
+{
+    if (root == NULL)
+    {
+        return NULL;
+    }
+    int64_t k = (int64_t)ceil(percentile / 100.0 * (double)root->Count);
+    if (k < 1)
+    {
+        k = 1;
+    }
+    if (k > root->Count)
+    {
+        k = root->Count;
+    }
+    return findKthLightest(root, k);
+}
+
+/*
+* FUNCTION      : printBSTInOrder
+* DESCRIPTION   :
+*   This functoin prints out all the parcels  within a BST in weight ascending order. The rows before
+*   the buffer's page are skipped by seeking to their rank, so a page deep into a long list costs
+*   O(log n) plus its own rows.
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer receiving the output.
+*   Parcel* parent  :   the root node of BSTs to display parcels.
+* RETURNS       :  void
+*/
+void printBSTInOrder(OutBuf* out, Parcel* parent)
+{
+    if (parent == NULL)
+    {
+        return;
+    }
+    size_t skipped = out->Skip < (size_t)parent->Count ? out->Skip : (size_t)parent->Count;
+    out->Skip -= skipped;
+
+    ParcelCursor cursor;
+    initParcelCursor(&cursor, parent, CURSOR_BY_WEIGHT);
+    for (Parcel* parcel = seekParcelRank(&cursor, (int64_t)skipped); parcel != NULL && !outPageFull(out);
+        parcel = nextParcel(&cursor))
+    {
+        printParcel(out, parcel);
+    }
+}
+
+/*
+* FUNCTION      : valueHeight
+* DESCRIPTION   : Returns the height of a value index subtree, an empty subtree has height 0
+* PARAMETERS    : Parcel* node - the root of the subtree
+* RETURNS       : int - the height of the subtree
+*/
+static int valueHeight(Parcel* node)
+{
+    return node == NULL ? 0 : node->VHeight;
+}
+
+/*
+* FUNCTION      : updateValueNode
+* DESCRIPTION   : Recomputes the cached value index height of a node from its children
+* PARAMETERS    : Parcel* node - the node whose children have changed
+* RETURNS       : void
+*/
+static void updateValueNode(Parcel* node)
+{
+    int leftHeight = valueHeight(node->VLeft);
+    int rightHeight = valueHeight(node->VRight);
+    node->VHeight = (leftHeight > rightHeight ? leftHeight : rightHeight) + 1;
+}
+
+/*
+* FUNCTION      : rotateValueLeft
+* DESCRIPTION   : Rotates a value index subtree to the left, lifting its right child into its place
+* PARAMETERS    : Parcel* node - the root of the subtree
+* RETURNS       : Parcel* - the new root of the subtree
+*/
+static Parcel* rotateValueLeft(Parcel* node)
+{
+    Parcel* pivot = node->VRight;
+    node->VRight = pivot->VLeft;
+    pivot->VLeft = node;
+    updateValueNode(node);
+    updateValueNode(pivot);
+    return pivot;
+}
+
+/*
+* FUNCTION      : rotateValueRight
+* DESCRIPTION   : Rotates a value index subtree to the right, lifting its left child into its place
+* PARAMETERS    : Parcel* node - the root of the subtree
+* RETURNS       : Parcel* - the new root of the subtree
+*/
+static Parcel* rotateValueRight(Parcel* node)
+{
+    Parcel* pivot = node->VLeft;
+    node->VLeft = pivot->VRight;
+    pivot->VRight = node;
+    updateValueNode(node);
+    updateValueNode(pivot);
+    return pivot;
+}
+
+/*
+* FUNCTION      : rebalanceValue
+* DESCRIPTION   : Restores the AVL property of a value index node, as rebalance does for the weight tree
+* PARAMETERS    : Parcel* node - the root of the subtree to be rebalanced
+* RETURNS       : Parcel* - the new root of the subtree
+*/
+static Parcel* rebalanceValue(Parcel* node)
+{
+    updateValueNode(node);
+    int balance = valueHeight(node->VLeft) - valueHeight(node->VRight);
+    if (balance > 1)
+    {
+        if (valueHeight(node->VLeft->VLeft) < valueHeight(node->VLeft->VRight))
+        {
+            node->VLeft = rotateValueLeft(node->VLeft);
+        }
+        node = rotateValueRight(node);
+    }
+    else if (balance < -1)
+    {
+        if (valueHeight(node->VRight->VRight) < valueHeight(node->VRight->VLeft))
+        {
+            node->VRight = rotateValueRight(node->VRight);
+        }
+        node = rotateValueLeft(node);
+    }
+    return node;
+}
+
+/*
+* FUNCTION      : insertParcelToValueBST
+* DESCRIPTION   :
+*   Inserts a parcel into the value index of its destination. The index is an AVL tree keyed on
+*   (Cents, Seq) that links the same nodes as the weight tree, so no parcel data is duplicated.
+* PARAMETERS    : Parcel* parent - The root of the value index
+*                 Parcel* newParcel - The parcel to be inserted, its Seq must be unique within the tree
+* RETURNS       : returns pointer to the new root of the value index
+*/
+Parcel* insertParcelToValueBST(Parcel* parent, Parcel* newParcel)
+{
+    if (parent == NULL)
+    {
+        return newParcel;
+    }
+    else if (newParcel->Cents > parent->Cents ||
+        (newParcel->Cents == parent->Cents && newParcel->Seq > parent->Seq))
+    {
+        parent->VRight = insertParcelToValueBST(parent->VRight, newParcel);
+    }
+    else
+    {
+        parent->VLeft = insertParcelToValueBST(parent->VLeft, newParcel);
+    }
+    return rebalanceValue(parent);
+}
+
+/*
+* FUNCTION      : compareValueKey
+* DESCRIPTION   : Orders two parcels by value, then by sequence number for parcels of equal value
+* PARAMETERS    : Parcel* first - the left-hand parcel
+*                 Parcel* second - the right-hand parcel
+* RETURNS       : int - negative, zero or positive as first sorts before, with or after second
+*/
+static int compareValueKey(Parcel* first, Parcel* second)
+{
+    if (first->Cents != second->Cents)
+    {
+        return first->Cents < second->Cents ? -1 : 1;
+    }
+    if (first->Seq != second->Seq)
+    {
+        return first->Seq < second->Seq ? -1 : 1;
+    }
+    return 0;
+}
+
+/*
+* FUNCTION      : removeMinValueParcel
+* DESCRIPTION   : Unlinks the cheapest node of a value index subtree, as removeMinParcel does for the weight tree
+* PARAMETERS    : Parcel* node - the root of the subtree
+*                 Parcel** min - receives the unlinked node
+* RETURNS       : Parcel* - the new root of the subtree
+*/
+static Parcel* removeMinValueParcel(Parcel* node, Parcel** min)
+{
+    if (node->VLeft == NULL)
+    {
+        *min = node;
+        return node->VRight;
+    }
+    node->VLeft = removeMinValueParcel(node->VLeft, min);
+    return rebalanceValue(node);
+}
+
+/*
+* FUNCTION      : removeParcelFromValueBST
+* DESCRIPTION   : Unlinks a parcel from the value index of its destination, as removeParcelFromBST does for the weight tree
+* PARAMETERS    : Parcel* parent - The root of the value index
+*                 Parcel* target - The parcel to be removed, it must be in the index
+* RETURNS       : returns pointer to the new root of the value index
+*/
+Parcel* removeParcelFromValueBST(Parcel* parent, Parcel* target)
+{
+    if (parent == NULL)
+    {
+        return NULL;
+    }
+    int order = compareValueKey(target, parent);
+    if (order < 0)
+    {
+        parent->VLeft = removeParcelFromValueBST(parent->VLeft, target);
+    }
+    else if (order > 0)
+    {
+        parent->VRight = removeParcelFromValueBST(parent->VRight, target);
+    }
+    else
+    {
+        if (parent->VLeft == NULL || parent->VRight == NULL)
+        {
+            return parent->VLeft != NULL ? parent->VLeft : parent->VRight;
+        }
+        Parcel* successor = NULL;
+        Parcel* right = removeMinValueParcel(parent->VRight, &successor);
+        successor->VLeft = parent->VLeft;
+        successor->VRight = right;
+        parent = successor;
+    }
+    return rebalanceValue(parent);
+}
+
+/*
+* FUNCTION      : buildBalancedValueBST
+* DESCRIPTION   :
+*   This functoin links nodes that are already in value order into a perfectly balanced value index
+*   in O(n), the counterpart of buildBalancedBST.
+* PARAMETERS    :
+*   Parcel** sorted - the nodes ordered by (Cents, Seq)
+*   size_t count    - the number of nodes
+* RETURNS       : Parcel* - the root of the new index, NULL when count is 0
+*/
+Parcel* buildBalancedValueBST(Parcel** sorted, size_t count)
+{
+    if (count == 0)
+    {
+        return NULL;
+    }
+    size_t middle = count / 2;
+    Parcel* node = sorted[middle];
+    node->VLeft = buildBalancedValueBST(sorted, middle);
+    node->VRight = buildBalancedValueBST(sorted + middle + 1, count - middle - 1);
+    updateValueNode(node);
+    return node;
+}
+
+/*
+* FUNCTION      : findCheapestParcel
+* DESCRIPTION   : Finds the cheapest parcel, the first-arrived one if several share the lowest value
+* PARAMETERS    : Parcel* root - the root of the value index
+* RETURNS       : returns a pointer to the cheapest parcel, or NULL for an empty index
+*/
+Parcel* findCheapestParcel(Parcel* root)
+{
+    while (root != NULL && root->VLeft != NULL)
+    {
+        root = root->VLeft;
+    }
+    return root;
+}
+
+/*
+* FUNCTION      : findMostExpensiveParcel
+* DESCRIPTION   : Finds the most expensive parcel, the last-arrived one if several share the highest value
+* PARAMETERS    : Parcel* root - the root of the value index
+* RETURNS       : returns a pointer to the most expensive parcel, or NULL for an empty index
+*/
+Parcel* findMostExpensiveParcel(Parcel* root)
+{
+    while (root != NULL && root->VRight != NULL)
+    {
+        root = root->VRight;
+    }
+    return root;
+}
+
+/*
+* FUNCTION      : printSectionBetweenValues
+* DESCRIPTION   :
+*   This functoin prints out, in value ascending order, all the parcels whose value lies within an
+*   inclusive range. The cursor seeks straight to the cheapest match, so it runs in O(log n + k).
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer receiving the output.
+*   Parcel* parent      :   the root of the value index.
+*   int64_t minCents    :   the lowest value to be displayed, in cents.
+*   int64_t maxCents    :   the highest value to be displayed, in cents.
+* RETURNS       :  void
+*/
+void printSectionBetweenValues(OutBuf* out, Parcel* parent, int64_t minCents, int64_t maxCents)
+{
+    ParcelCursor cursor;
+    initParcelCursor(&cursor, parent, CURSOR_BY_VALUE);
+    for (Parcel* parcel = seekParcelAtLeast(&cursor, minCents);
+        parcel != NULL && parcel->Cents <= maxCents && !outPageFull(out); parcel = nextParcel(&cursor))
+    {
+        printParcel(out, parcel);
+    }
+}
+
+/*
+* FUNCTION      : printMostValuableParcels
+* DESCRIPTION   :
+*   This functoin prints out the most valuable parcels in value descending order, walking a cursor
+*   backwards from the most expensive and stopping after a given number, so it runs in O(log n + k).
+* PARAMETERS    :
+*   OutBuf* out     :   the buffer receiving the output.
+*   Parcel* parent  :   the root of the value index.
+*   int count       :   the most parcels to display.
+* RETURNS       :
+*   int     : how many of the requested parcels were not displayed because the index ran out.
+*/
+int printMostValuableParcels(OutBuf* out, Parcel* parent, int count)
+{
+    ParcelCursor cursor;
+    initParcelCursor(&cursor, parent, CURSOR_BY_VALUE);
+    for (Parcel* parcel = seekLastParcel(&cursor); parcel != NULL && count > 0 && !outPageFull(out);
+        parcel = prevParcel(&cursor))
+    {
+        printParcel(out, parcel);
+        count--;
+    }
+    return count;
+}
+
+/*
+* FUNCTION      : rebalanceCopying
+* DESCRIPTION   :
+*   Restores the AVL property of a node as rebalance does, taking every node a rotation changes from
+*   the copier first, so a subtree that readers may be walking is never changed in place.
+* PARAMETERS    : Parcel* node - the root of the subtree, already taken from the copier
+*                 const PathCopier* copier - hands out nodes that may be changed
+* RETURNS       : Parcel* - the new root of the subtree
+*/
+static Parcel* rebalanceCopying(Parcel* node, const PathCopier* copier)
+{
+    updateParcelNode(node);
+    int balance = parcelHeight(node->Left) - parcelHeight(node->Right);
+    if (balance > 1)
+    {
+        node->Left = copier->Own(copier->Context, node->Left);
+        if (parcelHeight(node->Left->Left) < parcelHeight(node->Left->Right))
+        {
+            node->Left->Right = copier->Own(copier->Context, node->Left->Right);
+            node->Left = rotateLeft(node->Left);
+        }
+        node = rotateRight(node);
+    }
+    else if (balance < -1)
+    {
+        node->Right = copier->Own(copier->Context, node->Right);
+        if (parcelHeight(node->Right->Right) < parcelHeight(node->Right->Left))
+        {
+            node->Right->Left = copier->Own(copier->Context, node->Right->Left);
+            node->Right = rotateRight(node->Right);
+        }
+        node = rotateLeft(node);
+    }
+    return node;
+}
+
+/*
+* FUNCTION      : insertParcelToBSTCopying
+* DESCRIPTION   :
+*   Inserts a parcel into a weight tree by path copying: the nodes on the way down, and those the
+*   rotations move, are taken from the copier, and every other subtree is shared with the tree as it
+*   was. A reader still walking the old root sees it unchanged, and the insert stays O(log n).
+* PARAMETERS    : Parcel* parent - the root of the tree
+*                 Parcel* newParcel - the parcel to be inserted, a single-node tree no reader can reach
+*                 const PathCopier* copier - hands out nodes that may be changed
+* RETURNS       : returns pointer to the new root of the tree
+*/
+Parcel* insertParcelToBSTCopying(Parcel* parent, Parcel* newParcel, const PathCopier* copier)
+{
+    if (parent == NULL)
+    {
+        return newParcel;
+    }
+    parent = copier->Own(copier->Context, parent);
+    if (compareParcelKey(newParcel, parent) > 0)
+    {
+        parent->Right = insertParcelToBSTCopying(parent->Right, newParcel, copier);
+    }
+    else
+    {
+        parent->Left = insertParcelToBSTCopying(parent->Left, newParcel, copier);
+    }
+    return rebalanceCopying(parent, copier);
+}
+
+/*
+* FUNCTION      : removeMinParcelCopying
+* DESCRIPTION   : Unlinks the lightest node of a subtree as removeMinParcel does, by path copying
+* PARAMETERS    : Parcel* node - the root of the subtree
+*                 Parcel** min - receives the unlinked node, as it was in the tree
+*                 const PathCopier* copier - hands out nodes that may be changed
+* RETURNS       : Parcel* - the new root of the subtree
+*/
+static Parcel* removeMinParcelCopying(Parcel* node, Parcel** min, const PathCopier* copier)
+{
+    if (node->Left == NULL)
+    {
+        *min = node;
+        return node->Right;
+    }
+    node = copier->Own(copier->Context, node);
+    node->Left = removeMinParcelCopying(node->Left, min, copier);
+    return rebalanceCopying(node, copier);
+}
+
+/*
+* FUNCTION      : removeParcelFromBSTCopying
+* DESCRIPTION   :
+*   Unlinks the parcel of a given key from a weight tree by path copying, as insertParcelToBSTCopying
+*   inserts one. The node that held the parcel is left in the old tree for the caller to dispose of.
+* PARAMETERS    : Parcel* parent - the root of the tree
+*                 Parcel* target - a parcel with the weight and sequence number to be removed
+*                 Parcel** removed - receives the node that held the parcel, or NULL if there was none
+*                 const PathCopier* copier - hands out nodes that may be changed
+* RETURNS       : returns pointer to the new root of the tree
+*/
+Parcel* removeParcelFromBSTCopying(Parcel* parent, Parcel* target, Parcel** removed, const PathCopier* copier)
+{
+    if (parent == NULL)
+    {
+        return NULL;
+    }
+    int order = compareParcelKey(target, parent);
+    if (order == 0)
+    {
+        *removed = parent;
+        if (parent->Left == NULL || parent->Right == NULL)
+        {
+            return parent->Left != NULL ? parent->Left : parent->Right;
+        }
+        Parcel* successor = NULL;
+        Parcel* right = removeMinParcelCopying(parent->Right, &successor, copier);
+        successor = copier->Own(copier->Context, successor);
+        successor->Left = parent->Left;
+        successor->Right = right;
+        return rebalanceCopying(successor, copier);
+    }
+    parent = copier->Own(copier->Context, parent);
+    if (order < 0)
+    {
+        parent->Left = removeParcelFromBSTCopying(parent->Left, target, removed, copier);
+    }
+    else
+    {
+        parent->Right = removeParcelFromBSTCopying(parent->Right, target, removed, copier);
+    }
+    return rebalanceCopying(parent, copier);
+}
+
+/*
+* FUNCTION      : rebalanceValueCopying
+* DESCRIPTION   : Restores the AVL property of a value index node by path copying, as rebalanceCopying does
+* PARAMETERS    : Parcel* node - the root of the subtree, already taken from the copier
+*                 const PathCopier* copier - hands out nodes that may be changed
+* RETURNS       : Parcel* - the new root of the subtree
+*/
+static Parcel* rebalanceValueCopying(Parcel* node, const PathCopier* copier)
+{
+    updateValueNode(node);
+    int balance = valueHeight(node->VLeft) - valueHeight(node->VRight);
+    if (balance > 1)
+    {
+        node->VLeft = copier->Own(copier->Context, node->VLeft);
+        if (valueHeight(node->VLeft->VLeft) < valueHeight(node->VLeft->VRight))
+        {
+            node->VLeft->VRight = copier->Own(copier->Context, node->VLeft->VRight);
+            node->VLeft = rotateValueLeft(node->VLeft);
+        }
+        node = rotateValueRight(node);
+    }
+    else if (balance < -1)
+    {
+        node->VRight = copier->Own(copier->Context, node->VRight);
+        if (valueHeight(node->VRight->VRight) < valueHeight(node->VRight->VLeft))
+        {
+            node->VRight->VLeft = copier->Own(copier->Context, node->VRight->VLeft);
+            node->VRight = rotateValueRight(node->VRight);
+        }
+        node = rotateValueLeft(node);
+    }
+    return node;
+}
+
+/*
+* FUNCTION      : insertParcelToValueBSTCopying
+* DESCRIPTION   : Inserts a parcel into a value index by path copying, as insertParcelToBSTCopying does
+* PARAMETERS    : Parcel* parent - the root of the value index
+*                 Parcel* newParcel - the parcel to be inserted, a single-node tree no reader can reach
+*                 const PathCopier* copier - hands out nodes that may be changed
+* RETURNS       : returns pointer to the new root of the value index
+*/
+Parcel* insertParcelToValueBSTCopying(Parcel* parent, Parcel* newParcel, const PathCopier* copier)
+{
+    if (parent == NULL)
+    {
+        return newParcel;
+    }
+    parent = copier->Own(copier->Context, parent);
+    if (compareValueKey(newParcel, parent) > 0)
+    {
+        parent->VRight = insertParcelToValueBSTCopying(parent->VRight, newParcel, copier);
+    }
+    else
+    {
+        parent->VLeft = insertParcelToValueBSTCopying(parent->VLeft, newParcel, copier);
+    }
+    return rebalanceValueCopying(parent, copier);
+}
+
+/*
+* FUNCTION      : removeMinValueParcelCopying
+* DESCRIPTION   : Unlinks the cheapest node of a value index subtree by path copying
+* PARAMETERS    : Parcel* node - the root of the subtree
+*                 Parcel** min - receives the unlinked node, as it was in the index
+*                 const PathCopier* copier - hands out nodes that may be changed
+* RETURNS       : Parcel* - the new root of the subtree
+*/
+static Parcel* removeMinValueParcelCopying(Parcel* node, Parcel** min, const PathCopier* copier)
+{
+    if (node->VLeft == NULL)
+    {
+        *min = node;
+        return node->VRight;
+    }
+    node = copier->Own(copier->Context, node);
+    node->VLeft = removeMinValueParcelCopying(node->VLeft, min, copier);
+    return rebalanceValueCopying(node, copier);
+}
+
+/*
+* FUNCTION      : removeParcelFromValueBSTCopying
+* DESCRIPTION   : Unlinks the parcel of a given key from a value index by path copying, as removeParcelFromBSTCopying does
+* PARAMETERS    : Parcel* parent - the root of the value index
+*                 Parcel* target - a parcel with the value and sequence number to be removed
+*                 Parcel** removed - receives the node that held the parcel, or NULL if there was none
+*                 const PathCopier* copier - hands out nodes that may be changed
+* RETURNS       : returns pointer to the new root of the value index
+*/
+Parcel* removeParcelFromValueBSTCopying(Parcel* parent, Parcel* target, Parcel** removed, const PathCopier* copier)
+{
+    if (parent == NULL)
+    {
+        return NULL;
+    }
+    int order = compareValueKey(target, parent);
+    if (order == 0)
+    {
+        *removed = parent;
+        if (parent->VLeft == NULL || parent->VRight == NULL)
+        {
+            return parent->VLeft != NULL ? parent->VLeft : parent->VRight;
+        }
+        Parcel* successor = NULL;
+        Parcel* right = removeMinValueParcelCopying(parent->VRight, &successor, copier);
+        successor = copier->Own(copier->Context, successor);
+        successor->VLeft = parent->VLeft;
+        successor->VRight = right;
+        return rebalanceValueCopying(successor, copier);
+    }
+    parent = copier->Own(copier->Context, parent);
+    if (order < 0)
+    {
+        parent->VLeft = removeParcelFromValueBSTCopying(parent->VLeft, target, removed, copier);
+    }
+    else
+    {
+        parent->VRight = removeParcelFromValueBSTCopying(parent->VRight, target, removed, copier);
+    }
+    return rebalanceValueCopying(parent, copier);
+}
+
+/*
+* FUNCTION      : cursorLeft
+* DESCRIPTION   : Returns the left child of a node in the tree a cursor walks
+* PARAMETERS    : const ParcelCursor* cursor - the cursor
+*                 Parcel* node - the node
+* RETURNS       : Parcel* - the left child, NULL if there is none
+*/
+static Parcel* cursorLeft(const ParcelCursor* cursor, Parcel* node)
+{
+    return cursor->Index == CURSOR_BY_WEIGHT ? node->Left : node->VLeft;
+}
+
+/*
+* FUNCTION      : cursorRight
+* DESCRIPTION   : Returns the right child of a node in the tree a cursor walks
+* PARAMETERS    : const ParcelCursor* cursor - the cursor
+*                 Parcel* node - the node
+* RETURNS       : Parcel* - the right child, NULL if there is none
+*/
+static Parcel* cursorRight(const ParcelCursor* cursor, Parcel* node)
+{
+    return cursor->Index == CURSOR_BY_WEIGHT ? node->Right : node->VRight;
+}
+
+/*
+* FUNCTION      : cursorKey
+* DESCRIPTION   : Returns the key a node is ordered by in the tree a cursor walks
+* PARAMETERS    : const ParcelCursor* cursor - the cursor
+*                 Parcel* node - the node
+* RETURNS       : int64_t - the weight in grams, or the value in cents
+*/
+static int64_t cursorKey(const ParcelCursor* cursor, Parcel* node)
+{
+    return cursor->Index == CURSOR_BY_WEIGHT ? node->Weight : node->Cents;
+}
+
+/*
+* FUNCTION      : descendParcelCursor
+* DESCRIPTION   : Pushes a node and then its leftmost (or rightmost) descendants onto the cursor's path
+* PARAMETERS    : ParcelCursor* cursor - the cursor
+*                 Parcel* node - the first node to push
+*                 bool leftmost - true to follow left children, false to follow right children
+* RETURNS       : Parcel* - the last node pushed, which is the cursor's new position
+*/
+static Parcel* descendParcelCursor(ParcelCursor* cursor, Parcel* node, bool leftmost)
+{
+    while (node != NULL)
+    {
+        cursor->Path[cursor->Depth++] = node;
+        node = leftmost ? cursorLeft(cursor, node) : cursorRight(cursor, node);
+    }
+    return currentParcel(cursor);
+}
+
+/*
+* FUNCTION      : initParcelCursor
+* DESCRIPTION   :
+*   This functoin prepares a cursor over one of a destination's trees. It points at no parcel until
+*   one of the seek functoins positions it. The tree must not change while the cursor is in use.
+* PARAMETERS    :
+*   ParcelCursor* cursor    :   the cursor.
+*   Parcel* root            :   the root of the tree, Root for the weight index or ValueRoot for the value index.
+*   CursorIndex index       :   which of the two trees root belongs to.
+* RETURNS       :  void
+*/
+void initParcelCursor(ParcelCursor* cursor, Parcel* root, CursorIndex index)
+{
+    cursor->Index = index;
+    cursor->Root = root;
+    cursor->Depth = 0;
+}
+
+/*
+* FUNCTION      : seekFirstParcel
+* DESCRIPTION   : This functoin moves a cursor to the first parcel of its tree: the lightest, or the cheapest.
+* PARAMETERS    :
+*   ParcelCursor* cursor    :   the cursor.
+* RETURNS       :
+*   Parcel*     : the parcel, or NULL for an empty tree.
+*/
+Parcel* seekFirstParcel(ParcelCursor* cursor)
+{
+    cursor->Depth = 0;
+    return descendParcelCursor(cursor, cursor->Root, true);
+}
+
+/*
+* FUNCTION      : seekLastParcel
+* DESCRIPTION   : This functoin moves a cursor to the last parcel of its tree: the heaviest, or the most expensive.
+* PARAMETERS    :
+*   ParcelCursor* cursor    :   the cursor.
+* RETURNS       :
+*   Parcel*     : the parcel, or NULL for an empty tree.
+*/
+Parcel* seekLastParcel(ParcelCursor* cursor)
+{
+    cursor->Depth = 0;
+    return descendParcelCursor(cursor, cursor->Root, false);
+}
+
+/*
+* FUNCTION      : seekParcelAtLeast
+* DESCRIPTION   :
+*   This functoin moves a cursor to the first parcel whose key is at least a given one; among equal
+*   keys, that is the first to arrive. The path to it is a prefix of the path searched, which is kept
+*   and then cut back to the last node where the search turned left.
+* PARAMETERS    :
+*   ParcelCursor* cursor    :   the cursor.
+*   int64_t key             :   a weight in grams, or a value in cents.
+* RETURNS       :
+*   Parcel*     : the parcel, or NULL if every key is smaller.
+*/
+Parcel* seekParcelAtLeast(ParcelCursor* cursor, int64_t key)
+{
+    int found = 0;
+    cursor->Depth = 0;
+    for (Parcel* node = cursor->Root; node != NULL; )
+    {
+        cursor->Path[cursor->Depth++] = node;
+        if (cursorKey(cursor, node) >= key)
+        {
+            found = cursor->Depth;
+            node = cursorLeft(cursor, node);
+        }
+        else
+        {
+            node = cursorRight(cursor, node);
+        }
+    }
+    cursor->Depth = found;
+    return currentParcel(cursor);
+}
+
+/*
+* FUNCTION      : seekParcelAtMost
+* DESCRIPTION   :
+*   This functoin moves a cursor to the last parcel whose key is at most a given one; among equal
+*   keys, that is the last to arrive.
+* PARAMETERS    :
+*   ParcelCursor* cursor    :   the cursor.
+*   int64_t key             :   a weight in grams, or a value in cents.
+* RETURNS       :
+*   Parcel*     : the parcel, or NULL if every key is larger.
+*/
+Parcel* seekParcelAtMost(ParcelCursor* cursor, int64_t key)
+{
+    int found = 0;
+    cursor->Depth = 0;
+    for (Parcel* node = cursor->Root; node != NULL; )
+    {
+        cursor->Path[cursor->Depth++] = node;
+        if (cursorKey(cursor, node) <= key)
+        {
+            found = cursor->Depth;
+            node = cursorRight(cursor, node);
+        }
+        else
+        {
+            node = cursorLeft(cursor, node);
+        }
+    }
+    cursor->Depth = found;
+    return currentParcel(cursor);
+}
+
+/*
+* FUNCTION      : seekParcelRank
+* DESCRIPTION   :
+*   This functoin moves a cursor to the parcel with a given number of parcels before it. The weight
+*   index descends on its subtree counts in O(log n); the value index keeps no counts, so it steps
+*   there from the first parcel.
+* PARAMETERS    :
+*   ParcelCursor* cursor    :   the cursor.
+*   int64_t rank            :   the 0-based position of the parcel.
+* RETURNS       :
+*   Parcel*     : the parcel, or NULL if the tree holds no more than rank parcels.
+*/
+Parcel* seekParcelRank(ParcelCursor* cursor, int64_t rank)
+{
+    cursor->Depth = 0;
+    if (cursor->Index == CURSOR_BY_VALUE)
+    {
+        Parcel* parcel = seekFirstParcel(cursor);
+        for (; parcel != NULL && rank > 0; --rank)
+        {
+            parcel = nextParcel(cursor);
+        }
+        return parcel;
+    }
+    for (Parcel* node = cursor->Root; node != NULL; )
+    {
+        int64_t leftCount = node->Left == NULL ? 0 : node->Left->Count;
+        cursor->Path[cursor->Depth++] = node;
+        if (rank < leftCount)
+        {
+            node = node->Left;
+        }
+        else if (rank == leftCount)
+        {
+            return node;
+        }
+        else
+        {
+            rank -= leftCount + 1;
+            node = node->Right;
+        }
+    }
+    cursor->Depth = 0;
+    return NULL;
+}
+
+/*
+* FUNCTION      : nextParcel
+* DESCRIPTION   :
+*   This functoin moves a cursor to the parcel after its current one: down to the leftmost node of the
+*   right subtree if there is one, otherwise up to the first ancestor reached from its left.
+* PARAMETERS    :
+*   ParcelCursor* cursor    :   the cursor.
+* RETURNS       :
+*   Parcel*     : the next parcel, or NULL once the cursor runs off the end.
+*/
+Parcel* nextParcel(ParcelCursor* cursor)
+{
+    if (cursor->Depth == 0)
+    {
+        return NULL;
+    }
+    Parcel* right = cursorRight(cursor, cursor->Path[cursor->Depth - 1]);
+    if (right != NULL)
+    {
+        return descendParcelCursor(cursor, right, true);
+    }
+    Parcel* child = NULL;
+    do
+    {
+        child = cursor->Path[--cursor->Depth];
+    } while (cursor->Depth > 0 && cursorRight(cursor, cursor->Path[cursor->Depth - 1]) == child);
+    return currentParcel(cursor);
+}
+
+/*
+* FUNCTION      : prevParcel
+* DESCRIPTION   : This functoin moves a cursor to the parcel before its current one, the mirror image of nextParcel.
+* PARAMETERS    :
+*   ParcelCursor* cursor    :   the cursor.
+* RETURNS       :
+*   Parcel*     : the previous parcel, or NULL once the cursor runs off the start.
+*/
+Parcel* prevParcel(ParcelCursor* cursor)
+{
+    if (cursor->Depth == 0)
+    {
+        return NULL;
+    }
+    Parcel* left = cursorLeft(cursor, cursor->Path[cursor->Depth - 1]);
+    if (left != NULL)
+    {
+        return descendParcelCursor(cursor, left, false);
+    }
+    Parcel* child = NULL;
+    do
+    {
+        child = cursor->Path[--cursor->Depth];
+    } while (cursor->Depth > 0 && cursorLeft(cursor, cursor->Path[cursor->Depth - 1]) == child);
+    return currentParcel(cursor);
+}
+
+/*
+* FUNCTION      : currentParcel
+* DESCRIPTION   : This functoin returns the parcel a cursor points at.
+* PARAMETERS    :
+*   const ParcelCursor* cursor  :   the cursor.
+* RETURNS       :
+*   Parcel*     : the parcel, or NULL if the cursor is not positioned or has run off either end.
+*/
+Parcel* currentParcel(const ParcelCursor* cursor)
+{
+    return cursor->Depth == 0 ? NULL : cursor->Path[cursor->Depth - 1];
+}
@@ -0,0 +1,120 @@
+/*
+* FILENAME      : parcel.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the Parcel node shared by the per-destination trees and the destination index,
+*   along with the functions that create, print and organise parcels. Every node belongs to two trees
+*   of its destination at once: the primary index ordered by weight (Left/Right) and the secondary
+*   index ordered by value (VLeft/VRight).
+*
+*   A ParcelCursor walks either tree in order, forwards or backwards, from any position it seeks to.
+*   It keeps the path from the root on a fixed stack instead of recursing, so callers can consume
+*   parcels one at a time and stop whenever they like.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+#include "output.h"
+#include "dictionary.h"
+
+#define PARCEL_STACK_DEPTH  128     // enough for any AVL tree that fits in memory
+
+// totals over a set of parcels
+typedef struct RangeTotals
+{
+    int64_t Count;
+    int64_t TotalWeight;
+    int64_t TotalCents;
+} RangeTotals;
+
+typedef enum CursorIndex
+{
+    CURSOR_BY_WEIGHT,   // Left/Right, keyed on (Weight, Seq)
+    CURSOR_BY_VALUE     // VLeft/VRight, keyed on (value in cents, Seq)
+} CursorIndex;
+
+// the fields are ordered so that no padding is needed between them
+typedef struct Parcel
+{
+    int Weight;
+    int Height;         // height of the subtree rooted here, a leaf has height 1
+    int64_t Cents;      // value as exact fixed-point cents, turned into dollars only when printed
+    Parcel* Left;
+    Parcel* Right;
+    int64_t SumWeight;  // total weight of the subtree rooted here
+    int64_t SumCents;   // total value of the subtree rooted here, in cents
+    int Count;          // number of parcels in the subtree rooted here
+    unsigned int Seq;   // arrival order within the destination, breaks ties between equal weights
+    DestId Dest;        // the destination's id in the dictionary, see dictionary.h
+    int VHeight;        // height of the subtree of the secondary index rooted here
+    Parcel* VLeft;      // links of the secondary index, keyed on (Cents, Seq)
+    Parcel* VRight;
+} Parcel;
+
+// an in-order position in one of a destination's trees
+typedef struct ParcelCursor
+{
+    CursorIndex Index;
+    Parcel* Root;
+    Parcel* Path[PARCEL_STACK_DEPTH];   // the nodes from the root down to the current parcel
+    int Depth;                          // 0 once the cursor has run off either end
+} ParcelCursor;
+
+// hands out nodes of a tree that readers may be walking, for the path copying updates below
+typedef struct PathCopier
+{
+    Parcel* (*Own)(void* context, Parcel* node);    // the node itself if no reader can reach it, else a copy
+    void* Context;
+} PathCopier;
+
+// functions of Parcel
+Parcel* createNewParcel(Arena* arena, DestId newDest, int newWgt, int64_t newCents);
+void resetParcelLinks(Parcel* parcel);
+void printParcel(OutBuf* out, Parcel* toPrint);
+int64_t dollarsToCents(double dollars);
+// functions of BST (an AVL tree keyed on weight, augmented with subtree totals)
+Parcel* insertParcelToBST(Parcel* root, Parcel* newParcel);
+Parcel* buildBalancedBST(Parcel** sorted, size_t count);
+size_t firstEytzingerSlot(size_t count);
+size_t nextEytzingerSlot(size_t slot, size_t count);
+Parcel* linkEytzingerBST(Parcel* nodes, size_t count);
+Parcel* removeParcelFromBST(Parcel* root, Parcel* target);
+Parcel* findParcelByWeightAndValue(Parcel* root, int weight, int64_t cents);
+Parcel* findMaxWeight(Parcel* root);
+Parcel* findMinWeight(Parcel* root);
+void printBSTInOrder(OutBuf* out, Parcel* root);
+void printSectionLowerThanWgt(OutBuf* out, Parcel* root, int partitionWgt);
+void printSectionHigherThanWgt(OutBuf* out, Parcel* root, int partitionWgt);
+void printSectionBetweenWeights(OutBuf* out, Parcel* root, int minWgt, int maxWgt);
+// order statistics of the weight tree, answered from the subtree totals in O(log n)
+void sumOfWeightRange(Parcel* root, int minWgt, int maxWgt, RangeTotals* totals);
+int64_t rankOfWeight(Parcel* root, int weight);
+Parcel* findKthLightest(Parcel* root, int64_t k);
+Parcel* findWeightPercentile(Parcel* root, double percentile);
+// functions of the value index (an AVL tree over the same nodes keyed on value)
+Parcel* insertParcelToValueBST(Parcel* root, Parcel* newParcel);
+Parcel* buildBalancedValueBST(Parcel** sorted, size_t count);
+Parcel* removeParcelFromValueBST(Parcel* root, Parcel* target);
+Parcel* findCheapestParcel(Parcel* root);
+Parcel* findMostExpensiveParcel(Parcel* root);
+void printSectionBetweenValues(OutBuf* out, Parcel* root, int64_t minCents, int64_t maxCents);
+int printMostValuableParcels(OutBuf* out, Parcel* root, int count);
+// path copying updates, which copy the nodes they change so older versions of the tree stay intact
+Parcel* insertParcelToBSTCopying(Parcel* root, Parcel* newParcel, const PathCopier* copier);
+Parcel* removeParcelFromBSTCopying(Parcel* root, Parcel* target, Parcel** removed, const PathCopier* copier);
+Parcel* insertParcelToValueBSTCopying(Parcel* root, Parcel* newParcel, const PathCopier* copier);
+Parcel* removeParcelFromValueBSTCopying(Parcel* root, Parcel* target, Parcel** removed, const PathCopier* copier);
+// an in-order cursor over either tree, moving in O(1) amortized and seeking in O(log n)
+void initParcelCursor(ParcelCursor* cursor, Parcel* root, CursorIndex index);
+Parcel* seekFirstParcel(ParcelCursor* cursor);
+Parcel* seekLastParcel(ParcelCursor* cursor);
+Parcel* seekParcelAtLeast(ParcelCursor* cursor, int64_t key);
+Parcel* seekParcelAtMost(ParcelCursor* cursor, int64_t key);
+Parcel* seekParcelRank(ParcelCursor* cursor, int64_t rank);
+Parcel* nextParcel(ParcelCursor* cursor);
+Parcel* prevParcel(ParcelCursor* cursor);
+Parcel* currentParcel(const ParcelCursor* cursor);
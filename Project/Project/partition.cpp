@@ -0,0 +1,1132 @@
+/*
+* FILENAME      : partition.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the partitioned storage declared in partition.h. A destination's own zone map
+*   is read from its summary, which already knows its lightest, heaviest, cheapest and most expensive
+*   parcels, so only the partition's zone map is worked out when it is loaded. Parcels are listed
+*   across partitions by a k-way merge of one cursor per partition, ties going to the older partition.
+*   A destination of a packed partition has no trees; its parcels are walked with a RowCursor and
+*   summed and ranked from its packed columns instead.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include "partition.h"
+#include "dictionary.h"
+#include "metrics.h"
+
+// the weights and values a query looks for, each bound inclusive
+typedef struct QueryRange
+{
+    int64_t MinWeight;
+    int64_t MaxWeight;
+    int64_t MinCents;
+    int64_t MaxCents;
+} QueryRange;
+
+// a parcel waiting in a merge, with the partition it came from
+typedef struct PartitionEntry
+{
+    Parcel* Item;
+    int64_t Key;
+    size_t Source;
+} PartitionEntry;
+
+static const QueryRange anyParcel = { INT64_MIN, INT64_MAX, INT64_MIN, INT64_MAX };
+
+static void computeZoneMap(const DestTable* table, ZoneMap* zone);
+static void destinationZone(const Destination* dest, ZoneMap* zone);
+static bool zoneMeetsRange(const ZoneMap* zone, const QueryRange* range);
+static bool zoneInsideRange(const ZoneMap* zone, const QueryRange* range);
+static Destination** collectCountry(const PartitionSet* set, size_t recent, const char* country,
+    const QueryRange* range, size_t* count);
+static void printMergedParcels(OutBuf* out, Destination** dests, size_t count, CursorIndex index,
+    int64_t low, int64_t high, bool descending, int64_t limit);
+static int64_t rankInDestination(const Destination* dest, int weight);
+static size_t packedTableBytes(const DestTable* table);
+static bool entryBefore(const PartitionEntry* first, const PartitionEntry* second, bool descending);
+static void pushEntry(PartitionEntry* heap, size_t* size, PartitionEntry entry, bool descending);
+static PartitionEntry popEntry(PartitionEntry* heap, size_t* size, bool descending);
+
+/*
+* FUNCTION      : initPartitionSet
+* DESCRIPTION   : This functoin initialises an empty list of partitions.
+* PARAMETERS    :
+*   PartitionSet* set   :   the list.
+* RETURNS       : void
+*/
+void initPartitionSet(PartitionSet* set)
+{
+    set->Oldest = NULL;
+    set->Newest = NULL;
+    set->Count = 0;
+    set->NextNumber = 1;
+    set->Compressed = false;
+}
+
+/*
+* FUNCTION      : addPartitionFromFile
+* DESCRIPTION   :
+*   This functoin loads a courier file into a new destination index, which the bulk loader builds
+*   from sorted rows since it starts out empty, packed if the set is compressed, works out its zone
+*   map and makes it the newest partition. A file that cannot be read adds nothing.
+* PARAMETERS    :
+*   PartitionSet* set   :   the list of partitions.
+*   const char* path    :   the courier file.
+*   LoadResult* result  :   receives the number of loaded and rejected lines.
+* RETURNS       :
+*   Partition*  : the new partition, or NULL if the file could not be read.
+*/
+Partition* addPartitionFromFile(PartitionSet* set, const char* path, LoadResult* result)
+{
+    size_t labelLen = strlen(path);
+    Partition* partition = (Partition*)malloc(sizeof(Partition));
+    char* label = (char*)malloc(labelLen + 1);
+    if (partition == NULL || label == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(label, path, labelLen + 1);
+    initDestTable(&partition->Table, DEST_TABLE_INITIAL_SIZE);
+    partition->Table.Packed = set->Compressed;
+    if (!loadParcelsFromFile(&partition->Table, path, result))
+    {
+        deleteDestTable(&partition->Table);
+        free(label);
+        free(partition);
+        return NULL;
+    }
+    partition->Label = label;
+    partition->Number = set->NextNumber++;
+    partition->Loaded = time(NULL);
+    computeZoneMap(&partition->Table, &partition->Zone);
+
+    partition->Older = set->Newest;
+    partition->Newer = NULL;
+    if (set->Newest != NULL)
+    {
+        set->Newest->Newer = partition;
+    }
+    else
+    {
+        set->Oldest = partition;
+    }
+    set->Newest = partition;
+    set->Count++;
+    return partition;
+}
+
+/*
+* FUNCTION      : expireOldestPartition
+* DESCRIPTION   :
+*   This functoin drops the oldest partition. It is unlinked in O(1) and its index is freed as a
+*   whole, a chunk of the arena at a time, without visiting any of its parcels.
+* PARAMETERS    :
+*   PartitionSet* set   :   the list of partitions.
+* RETURNS       :
+*   bool    : true, if a partition was dropped. false, if there was none.
+*/
+bool expireOldestPartition(PartitionSet* set)
+{
+    Partition* partition = set->Oldest;
+    if (partition == NULL)
+    {
+        return false;
+    }
+    set->Oldest = partition->Newer;
+    if (set->Oldest != NULL)
+    {
+        set->Oldest->Older = NULL;
+    }
+    else
+    {
+        set->Newest = NULL;
+    }
+    set->Count--;
+    deleteDestTable(&partition->Table);
+    free(partition->Label);
+    free(partition);
+    return true;
+}
+
+/*
+* FUNCTION      : deletePartitionSet
+* DESCRIPTION   : This functoin drops every partition.
+* PARAMETERS    :
+*   PartitionSet* set   :   the list of partitions.
+* RETURNS       : void
+*/
+void deletePartitionSet(PartitionSet* set)
+{
+    while (expireOldestPartition(set));
+}
+
+/*
+* FUNCTION      : firstPartitionInScope
+* DESCRIPTION   : This functoin finds the oldest of the newest recent partitions.
+* PARAMETERS    :
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope, PARTITION_ALL for all of them.
+* RETURNS       :
+*   Partition*  : the oldest partition in scope, or NULL if there is none.
+*/
+Partition* firstPartitionInScope(const PartitionSet* set, size_t recent)
+{
+    if (recent == 0)
+    {
+        return NULL;
+    }
+    if (recent >= set->Count)
+    {
+        return set->Oldest;
+    }
+    Partition* partition = set->Newest;
+    for (size_t i = 1; i < recent; ++i)
+    {
+        partition = partition->Older;
+    }
+    return partition;
+}
+
+/*
+* FUNCTION      : collectPartitionTables
+* DESCRIPTION   : This functoin lists the indexes of the partitions in scope, oldest first, for the network-wide queries.
+* PARAMETERS    :
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   size_t* count           :   receives the number of indexes.
+* RETURNS       :
+*   DestTable** : a new array of the indexes, to be freed by the caller.
+*/
+DestTable** collectPartitionTables(const PartitionSet* set, size_t recent, size_t* count)
+{
+    DestTable** tables = (DestTable**)malloc((set->Count > 0 ? set->Count : 1) * sizeof(DestTable*));
+    if (tables == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    *count = 0;
+    for (Partition* partition = firstPartitionInScope(set, recent); partition != NULL; partition = partition->Newer)
+    {
+        tables[(*count)++] = &partition->Table;
+    }
+    return tables;
+}
+
+/*
+* FUNCTION      : printPartitionList
+* DESCRIPTION   :
+*   This functoin displays every partition, oldest first, with when it was loaded and its zone map,
+*   and for a packed partition the memory its packed columns take.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+* RETURNS       : void
+*/
+void printPartitionList(OutBuf* out, const PartitionSet* set)
+{
+    outLabel(out, "\n/================ %zu Partitions, Oldest First ================/\n\n", set->Count);
+    for (Partition* partition = set->Oldest; partition != NULL && !outPageFull(out); partition = partition->Newer)
+    {
+        const ZoneMap* zone = &partition->Zone;
+        if (!outTakeRow(out))
+        {
+            continue;
+        }
+        char loaded[32] = "";
+        strftime(loaded, sizeof loaded, "%Y-%m-%d %H:%M:%S", localtime(&partition->Loaded));
+        outPrintf(out, "Partition %u:\t%s\t Loaded: %s\t Destinations: %zu\t Parcels: %lld", partition->Number,
+            partition->Label, loaded, partition->Table.Count, (long long)zone->Count);
+        if (zone->Count > 0)
+        {
+            outPrintf(out, "\t Weight: %d-%d gms\t Value: $%.2f-$%.2f", zone->MinWeight, zone->MaxWeight,
+                zone->MinCents / 100.0, zone->MaxCents / 100.0);
+        }
+        if (partition->Table.Packed)
+        {
+            outPrintf(out, "\t Packed: %zu bytes", packedTableBytes(&partition->Table));
+        }
+        outPrintf(out, "\n");
+    }
+}
+
+/*
+* FUNCTION      : expireOldestPartitions
+* DESCRIPTION   : This functoin drops up to a given number of the oldest partitions and displays which.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   PartitionSet* set   :   the list of partitions.
+*   int count           :   the most partitions to drop.
+* RETURNS       : void
+*/
+void expireOldestPartitions(OutBuf* out, PartitionSet* set, int count)
+{
+    METRIC_START(queryTimer);
+    for (int i = 0; i < count && set->Oldest != NULL; ++i)
+    {
+        outPrintf(out, "Expired Partition %u:\t%s\t Parcels: %lld\n", set->Oldest->Number, set->Oldest->Label,
+            (long long)set->Oldest->Zone.Count);
+        expireOldestPartition(set);
+    }
+    METRIC_STOP_QUERY("expire", queryTimer);
+}
+
+/*
+* FUNCTION      : loadPartition
+* DESCRIPTION   : This functoin loads a courier file as the newest partition and displays what it holds.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   PartitionSet* set   :   the list of partitions.
+*   const char* path    :   the courier file.
+* RETURNS       : void
+*/
+void loadPartition(OutBuf* out, PartitionSet* set, const char* path)
+{
+    LoadResult result = {};
+    flushOutBuf(out);       // the loader reports malformed lines straight to stdout
+    Partition* partition = addPartitionFromFile(set, path, &result);
+    if (partition == NULL)
+    {
+        outPrintf(out, "**File Open ERROR: %s\n", path);
+        return;
+    }
+    outPrintf(out, "Loaded Partition %u:\t%s\t Destinations: %zu\t Parcels: %lld\n", partition->Number,
+        partition->Label, partition->Table.Count, (long long)partition->Zone.Count);
+}
+
+/*
+* FUNCTION      : findCountryInPartitions
+* DESCRIPTION   : This functoin tells whether any partition in scope has parcels to a given destination.
+* PARAMETERS    :
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination, as the user typed it.
+* RETURNS       :
+*   const char* : the destination's own spelling, or NULL if no partition in scope has parcels to it.
+*/
+const char* findCountryInPartitions(const PartitionSet* set, size_t recent, const char* country)
+{
+    size_t len = strlen(country);
+    for (Partition* partition = firstPartitionInScope(set, recent); partition != NULL; partition = partition->Newer)
+    {
+        Destination* dest = findDestination(&partition->Table, country, len);
+        if (dest != NULL && dest->Summary.Count > 0)
+        {
+            return dest->Name;
+        }
+    }
+    return NULL;
+}
+
+/*
+* FUNCTION      : printAllParcelsInPartitions
+* DESCRIPTION   : This functoin displays all the parcels to a given destination in the partitions in scope, lightest first.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination.
+* RETURNS       : void
+*/
+void printAllParcelsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country)
+{
+    METRIC_START(queryTimer);
+    size_t count = 0;
+    Destination** dests = collectCountry(set, recent, country, &anyParcel, &count);
+    printMergedParcels(out, dests, count, CURSOR_BY_WEIGHT, INT64_MIN, INT64_MAX, false, INT64_MAX);
+    free(dests);
+    METRIC_STOP_QUERY("list", queryTimer);
+}
+
+/*
+* FUNCTION      : printLighterParcelsInPartitions
+* DESCRIPTION   : This functoin displays the parcels to a given destination lighter than a given weight, lightest first.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination.
+*   int wgt                 :   the weight all displayed parcels are lighter than.
+* RETURNS       : void
+*/
+void printLighterParcelsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int wgt)
+{
+    METRIC_START(queryTimer);
+    QueryRange range = { INT64_MIN, (int64_t)wgt - 1, INT64_MIN, INT64_MAX };
+    size_t count = 0;
+
+    outLabel(out, "\n/====================== Lighter than %d gms ===================/\n\n", wgt);
+    Destination** dests = collectCountry(set, recent, country, &range, &count);
+    printMergedParcels(out, dests, count, CURSOR_BY_WEIGHT, range.MinWeight, range.MaxWeight, false, INT64_MAX);
+    free(dests);
+    METRIC_STOP_QUERY("lighter", queryTimer);
+}
+
+/*
+* FUNCTION      : printHeavierParcelsInPartitions
+* DESCRIPTION   : This functoin displays the parcels to a given destination heavier than a given weight, lightest first.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination.
+*   int wgt                 :   the weight all displayed parcels are heavier than.
+* RETURNS       : void
+*/
+void printHeavierParcelsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int wgt)
+{
+    METRIC_START(queryTimer);
+    QueryRange range = { (int64_t)wgt + 1, INT64_MAX, INT64_MIN, INT64_MAX };
+    size_t count = 0;
+
+    outLabel(out, "\n/====================== Heavier than %d gms ==================/\n\n", wgt);
+    Destination** dests = collectCountry(set, recent, country, &range, &count);
+    printMergedParcels(out, dests, count, CURSOR_BY_WEIGHT, range.MinWeight, range.MaxWeight, false, INT64_MAX);
+    free(dests);
+    METRIC_STOP_QUERY("heavier", queryTimer);
+}
+
+/*
+* FUNCTION      : printParcelsBetweenWeightsInPartitions
+* DESCRIPTION   : This functoin displays the parcels to a given destination weighing within an inclusive range, lightest first.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination.
+*   int minWgt              :   the lowest weight to be displayed.
+*   int maxWgt              :   the highest weight to be displayed.
+* RETURNS       : void
+*/
+void printParcelsBetweenWeightsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int minWgt, int maxWgt)
+{
+    METRIC_START(queryTimer);
+    QueryRange range = { minWgt, maxWgt, INT64_MIN, INT64_MAX };
+    size_t count = 0;
+
+    outLabel(out, "\n/================ Weighing from %d to %d gms ================/\n\n", minWgt, maxWgt);
+    Destination** dests = collectCountry(set, recent, country, &range, &count);
+    printMergedParcels(out, dests, count, CURSOR_BY_WEIGHT, range.MinWeight, range.MaxWeight, false, INT64_MAX);
+    free(dests);
+    METRIC_STOP_QUERY("range", queryTimer);
+}
+
+/*
+* FUNCTION      : printWeightRangeTotalsInPartitions
+* DESCRIPTION   :
+*   This functoin displays how many parcels to a given destination weigh within an inclusive range,
+*   with their total weight and value. A destination whose parcels all lie in the range gives its
+*   totals straight from its summary; the others are summed from their trees' subtree totals.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination.
+*   int minWgt              :   the lowest weight of the range.
+*   int maxWgt              :   the highest weight of the range.
+* RETURNS       : void
+*/
+void printWeightRangeTotalsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int minWgt, int maxWgt)
+{
+    METRIC_START(queryTimer);
+    QueryRange range = { minWgt, maxWgt, INT64_MIN, INT64_MAX };
+    RangeTotals totals = {};
+    size_t count = 0;
+
+    Destination** dests = collectCountry(set, recent, country, &range, &count);
+    for (size_t d = 0; d < count; ++d)
+    {
+        ZoneMap zone;
+        destinationZone(dests[d], &zone);
+        RangeTotals part;
+        if (zoneInsideRange(&zone, &range))
+        {
+            part.Count = dests[d]->Summary.Count;
+            part.TotalWeight = dests[d]->Summary.TotalWeight;
+            part.TotalCents = dests[d]->Summary.TotalCents;
+        }
+        else if (dests[d]->Packed.Count > 0)
+        {
+            sumPackedWeightRange(&dests[d]->Packed, minWgt, maxWgt, &part);
+        }
+        else
+        {
+            sumOfWeightRange(dests[d]->Root, minWgt, maxWgt, &part);
+        }
+        totals.Count += part.Count;
+        totals.TotalWeight += part.TotalWeight;
+        totals.TotalCents += part.TotalCents;
+    }
+    free(dests);
+    outPrintf(out, "\nDestination:\t%10s\t Weight: %d-%d gms\t Parcels: %lld\t Total Weight: %8lld gms\t Total: $%7lld.%02lld\n",
+        country, minWgt, maxWgt, (long long)totals.Count, (long long)totals.TotalWeight,
+        (long long)(totals.TotalCents / 100), (long long)(totals.TotalCents % 100));
+    METRIC_STOP_QUERY("rangesum", queryTimer);
+}
+
+/*
+* FUNCTION      : printTotalsInPartitions
+* DESCRIPTION   : This functoin displays the total weight and value of the parcels to a given destination, from the summaries.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination.
+* RETURNS       : void
+*/
+void printTotalsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country)
+{
+    METRIC_START(queryTimer);
+    int64_t totalWeight = 0;
+    int64_t totalCents = 0;
+    size_t count = 0;
+
+    Destination** dests = collectCountry(set, recent, country, &anyParcel, &count);
+    for (size_t d = 0; d < count; ++d)
+    {
+        totalWeight += dests[d]->Summary.TotalWeight;
+        totalCents += dests[d]->Summary.TotalCents;
+    }
+    free(dests);
+    outPrintf(out, "\nDestination:\t%10s\t Total Weight: %8lld gms\t Total: $%7lld.%02lld\n",
+        country, (long long)totalWeight, (long long)(totalCents / 100), (long long)(totalCents % 100));
+    METRIC_STOP_QUERY("totals", queryTimer);
+}
+
+/*
+* FUNCTION      : printLightestAndHeaviestParcelInPartitions
+* DESCRIPTION   :
+*   This functoin displays the lightest and the heaviest parcels to a given destination. As in a
+*   single index, the lightest is the first loaded of its weight and the heaviest the last loaded.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination.
+* RETURNS       : void
+*/
+void printLightestAndHeaviestParcelInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country)
+{
+    METRIC_START(queryTimer);
+    Parcel* lightest = NULL;
+    Parcel* heaviest = NULL;
+    size_t count = 0;
+
+    Destination** dests = collectCountry(set, recent, country, &anyParcel, &count);
+    for (size_t d = 0; d < count; ++d)
+    {
+        const DestSummary* summary = &dests[d]->Summary;
+        if (lightest == NULL || summary->Lightest->Weight < lightest->Weight)
+        {
+            lightest = summary->Lightest;
+        }
+        if (heaviest == NULL || summary->Heaviest->Weight >= heaviest->Weight)
+        {
+            heaviest = summary->Heaviest;
+        }
+    }
+    free(dests);
+    outLabel(out, "\nThe Lightest Parcel:\n");
+    printParcel(out, lightest);
+    outLabel(out, "\nThe Heaviest Parcel:\n");
+    printParcel(out, heaviest);
+    METRIC_STOP_QUERY("minmax", queryTimer);
+}
+
+/*
+* FUNCTION      : printCheapestAndMostExpensiveParcelInPartitions
+* DESCRIPTION   :
+*   This functoin displays the cheapest and the most expensive parcels to a given destination. As in
+*   a single index, the cheapest is the first loaded of its value and the most expensive the last loaded.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination.
+* RETURNS       : void
+*/
+void printCheapestAndMostExpensiveParcelInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country)
+{
+    METRIC_START(queryTimer);
+    Parcel* cheapest = NULL;
+    Parcel* mostExpensive = NULL;
+    size_t count = 0;
+
+    Destination** dests = collectCountry(set, recent, country, &anyParcel, &count);
+    for (size_t d = 0; d < count; ++d)
+    {
+        const DestSummary* summary = &dests[d]->Summary;
+        if (cheapest == NULL || summary->Cheapest->Cents < cheapest->Cents)
+        {
+            cheapest = summary->Cheapest;
+        }
+        if (mostExpensive == NULL || summary->MostExpensive->Cents >= mostExpensive->Cents)
+        {
+            mostExpensive = summary->MostExpensive;
+        }
+    }
+    free(dests);
+    outLabel(out, "\nThe Cheapest Parcel:\n");
+    printParcel(out, cheapest);
+    outLabel(out, "\nThe Most Expensive Parcel:\n");
+    printParcel(out, mostExpensive);
+    METRIC_STOP_QUERY("cheapest", queryTimer);
+}
+
+/*
+* FUNCTION      : printParcelsWithinValueInPartitions
+* DESCRIPTION   : This functoin displays the parcels to a given destination valued within an inclusive range, cheapest first.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination.
+*   int64_t minCents        :   the lowest value to be displayed, in cents.
+*   int64_t maxCents        :   the highest value to be displayed, in cents.
+* RETURNS       : void
+*/
+void printParcelsWithinValueInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int64_t minCents, int64_t maxCents)
+{
+    METRIC_START(queryTimer);
+    QueryRange range = { INT64_MIN, INT64_MAX, minCents, maxCents };
+    size_t count = 0;
+
+    outLabel(out, "\n/================ Valued from $%lld.%02lld to $%lld.%02lld ================/\n\n",
+        (long long)(minCents / 100), (long long)(minCents % 100), (long long)(maxCents / 100), (long long)(maxCents % 100));
+    Destination** dests = collectCountry(set, recent, country, &range, &count);
+    printMergedParcels(out, dests, count, CURSOR_BY_VALUE, minCents, maxCents, false, INT64_MAX);
+    free(dests);
+    METRIC_STOP_QUERY("values", queryTimer);
+}
+
+/*
+* FUNCTION      : printMostValuableParcelsInPartitions
+* DESCRIPTION   : This functoin displays, most valuable first, up to a given number of parcels to a given destination.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination.
+*   int count               :   the most parcels to display.
+* RETURNS       : void
+*/
+void printMostValuableParcelsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int count)
+{
+    METRIC_START(queryTimer);
+    size_t destCount = 0;
+
+    outLabel(out, "\n/================ %d Most Valuable Parcels ================/\n\n", count);
+    Destination** dests = collectCountry(set, recent, country, &anyParcel, &destCount);
+    printMergedParcels(out, dests, destCount, CURSOR_BY_VALUE, INT64_MIN, INT64_MAX, true, count);
+    free(dests);
+    METRIC_STOP_QUERY("top", queryTimer);
+}
+
+/*
+* FUNCTION      : printValueRangeTotalsInPartitions
+* DESCRIPTION   :
+*   This functoin displays how many parcels to a given destination are valued within an inclusive
+*   range, with their total weight and value and the lowest and highest value among them. A
+*   destination whose parcels all lie in the range gives them from its summary; the others are
+*   scanned from their columns, or from the blocks of their packed columns that the range cuts.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination.
+*   int64_t minCents        :   the lowest value of the range, in cents.
+*   int64_t maxCents        :   the highest value of the range, in cents.
+* RETURNS       : void
+*/
+void printValueRangeTotalsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int64_t minCents, int64_t maxCents)
+{
+    METRIC_START(queryTimer);
+    QueryRange range = { INT64_MIN, INT64_MAX, minCents, maxCents };
+    ColumnTotals totals = { 0, 0, 0, INT64_MAX, INT64_MIN };
+    size_t count = 0;
+
+    Destination** dests = collectCountry(set, recent, country, &range, &count);
+    for (size_t d = 0; d < count; ++d)
+    {
+        ZoneMap zone;
+        destinationZone(dests[d], &zone);
+        ColumnTotals part;
+        if (zoneInsideRange(&zone, &range))
+        {
+            part.Count = dests[d]->Summary.Count;
+            part.TotalWeight = dests[d]->Summary.TotalWeight;
+            part.TotalCents = dests[d]->Summary.TotalCents;
+            part.MinCents = zone.MinCents;
+            part.MaxCents = zone.MaxCents;
+        }
+        else if (dests[d]->Packed.Count > 0)
+        {
+            scanPackedValueRange(&dests[d]->Packed, minCents, maxCents, &part);
+        }
+        else
+        {
+            ParcelColumns* columns = getDestColumns(dests[d]);
+            scanValueRange(columns, 0, columns->Count, minCents, maxCents, &part);
+        }
+        totals.Count += part.Count;
+        totals.TotalWeight += part.TotalWeight;
+        totals.TotalCents += part.TotalCents;
+        totals.MinCents = part.MinCents < totals.MinCents ? part.MinCents : totals.MinCents;
+        totals.MaxCents = part.MaxCents > totals.MaxCents ? part.MaxCents : totals.MaxCents;
+    }
+    free(dests);
+    outPrintf(out, "\nDestination:\t%10s\t Value: $%.2f-$%.2f\t Parcels: %lld\t Total Weight: %8lld gms\t Total: $%7lld.%02lld\n",
+        country, minCents / 100.0, maxCents / 100.0, (long long)totals.Count, (long long)totals.TotalWeight,
+        (long long)(totals.TotalCents / 100), (long long)(totals.TotalCents % 100));
+    if (totals.Count > 0)
+    {
+        outPrintf(out, "Lowest Value: $%.2f\t Highest Value: $%.2f\n", totals.MinCents / 100.0, totals.MaxCents / 100.0);
+    }
+    METRIC_STOP_QUERY("valuesum", queryTimer);
+}
+
+/*
+* FUNCTION      : printWeightPercentileInPartitions
+* DESCRIPTION   :
+*   This functoin displays the parcel at a given weight percentile of a destination across the
+*   partitions in scope, by the nearest-rank method. The weight of that parcel is found by a binary
+*   search on weight, counting the lighter parcels of every partition from its subtree totals, or from
+*   one decoded block of its packed columns, so it costs O(log W * p * log n) for p partitions instead
+*   of a walk up to the rank.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* country     :   the destination.
+*   double percentile       :   the percentile, from 0 to 100.
+* RETURNS       : void
+*/
+void printWeightPercentileInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, double percentile)
+{
+    METRIC_START(queryTimer);
+    int64_t total = 0;
+    int low = INT_MAX;
+    int high = INT_MIN;
+    size_t count = 0;
+
+    Destination** dests = collectCountry(set, recent, country, &anyParcel, &count);
+    for (size_t d = 0; d < count; ++d)
+    {
+        total += dests[d]->Summary.Count;
+        low = dests[d]->Summary.Lightest->Weight < low ? dests[d]->Summary.Lightest->Weight : low;
+        high = dests[d]->Summary.Heaviest->Weight > high ? dests[d]->Summary.Heaviest->Weight : high;
+    }
+    if (total > 0)
+    {
+        int64_t k = (int64_t)ceil(percentile / 100.0 * (double)total);
+        k = k < 1 ? 1 : k > total ? total : k;
+
+        // the lowest weight with at least k parcels at or below it
+        while (low < high)
+        {
+            int middle = low + (high - low) / 2;
+            int64_t atMost = 0;
+            for (size_t d = 0; d < count; ++d)
+            {
+                atMost += rankInDestination(dests[d], middle + 1);
+            }
+            if (atMost >= k)
+            {
+                high = middle;
+            }
+            else
+            {
+                low = middle + 1;
+            }
+        }
+
+        // the parcels of that weight are ranked by partition, then by arrival within it
+        int64_t lighter = 0;
+        for (size_t d = 0; d < count; ++d)
+        {
+            lighter += rankInDestination(dests[d], low);
+        }
+        int64_t wanted = k - lighter;
+        for (size_t d = 0; d < count; ++d)
+        {
+            int64_t below = rankInDestination(dests[d], low);
+            int64_t equal = rankInDestination(dests[d], low + 1) - below;
+            if (wanted <= equal)
+            {
+                outLabel(out, "\nThe %.1fth Percentile Parcel (%lld lighter of %lld):\n", percentile,
+                    (long long)lighter, (long long)total);
+                Parcel row;
+                printParcel(out, dests[d]->Packed.Count > 0 ?
+                    getPackedParcel(&dests[d]->Packed, dests[d]->Id, (size_t)(below + wanted - 1), &row) :
+                    findKthLightest(dests[d]->Root, below + wanted));
+                break;
+            }
+            wanted -= equal;
+        }
+    }
+    free(dests);
+    METRIC_STOP_QUERY("percentile", queryTimer);
+}
+
+/*
+* FUNCTION      : printDestinationsStartingWithInPartitions
+* DESCRIPTION   :
+*   This functoin displays every destination whose name starts with a prefix, in alphabetical order,
+*   with the number of parcels each has in the partitions in scope.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   const PartitionSet* set :   the list of partitions.
+*   size_t recent           :   how many of the newest partitions are in scope.
+*   const char* prefix      :   the start of the names, an empty prefix lists every destination.
+* RETURNS       : void
+*/
+void printDestinationsStartingWithInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* prefix)
+{
+    METRIC_START(queryTimer);
+    size_t count = 0;
+    DestId* ids = completeDestName(prefix, strlen(prefix), &count);
+
+    outLabel(out, "\n/================ Destinations Starting with %s ================/\n\n", prefix);
+    for (size_t i = 0; i < count && !outPageFull(out); ++i)
+    {
+        if (!outTakeRow(out))
+        {
+            continue;
+        }
+        int64_t parcels = 0;
+        for (Partition* partition = firstPartitionInScope(set, recent); partition != NULL; partition = partition->Newer)
+        {
+            Destination* dest = findDestination(&partition->Table, getDestName(ids[i]), getDestNameLen(ids[i]));
+            parcels += dest == NULL ? 0 : dest->Summary.Count;
+        }
+        outPrintf(out, "Destination:\t%10s\t Parcels: %lld\n", getDestName(ids[i]), (long long)parcels);
+    }
+    free(ids);
+    METRIC_STOP_QUERY("complete", queryTimer);
+}
+
+/*
+* FUNCTION      : computeZoneMap
+* DESCRIPTION   : This functoin works out the zone map of an index from the summaries of its destinations.
+* PARAMETERS    :
+*   const DestTable* table  :   the index.
+*   ZoneMap* zone           :   receives its zone map.
+* RETURNS       : void
+*/
+static void computeZoneMap(const DestTable* table, ZoneMap* zone)
+{
+    zone->Count = 0;
+    zone->MinWeight = INT_MAX;
+    zone->MaxWeight = INT_MIN;
+    zone->MinCents = INT64_MAX;
+    zone->MaxCents = INT64_MIN;
+    for (size_t i = 0; i < table->Capacity; ++i)
+    {
+        const Destination* dest = table->Slots[i].Dest;
+        if (dest == NULL || dest->Summary.Count == 0)
+        {
+            continue;
+        }
+        ZoneMap destZone;
+        destinationZone(dest, &destZone);
+        zone->Count += destZone.Count;
+        zone->MinWeight = destZone.MinWeight < zone->MinWeight ? destZone.MinWeight : zone->MinWeight;
+        zone->MaxWeight = destZone.MaxWeight > zone->MaxWeight ? destZone.MaxWeight : zone->MaxWeight;
+        zone->MinCents = destZone.MinCents < zone->MinCents ? destZone.MinCents : zone->MinCents;
+        zone->MaxCents = destZone.MaxCents > zone->MaxCents ? destZone.MaxCents : zone->MaxCents;
+    }
+}
+
+/*
+* FUNCTION      : destinationZone
+* DESCRIPTION   : This functoin reads the zone map of a destination off its summary.
+* PARAMETERS    :
+*   const Destination* dest :   the destination, with at least one parcel.
+*   ZoneMap* zone           :   receives its zone map.
+* RETURNS       : void
+*/
+static void destinationZone(const Destination* dest, ZoneMap* zone)
+{
+    zone->Count = dest->Summary.Count;
+    zone->MinWeight = dest->Summary.Lightest->Weight;
+    zone->MaxWeight = dest->Summary.Heaviest->Weight;
+    zone->MinCents = dest->Summary.Cheapest->Cents;
+    zone->MaxCents = dest->Summary.MostExpensive->Cents;
+}
+
+/*
+* FUNCTION      : zoneMeetsRange
+* DESCRIPTION   : This functoin tells whether a zone map may hold parcels that a query looks for.
+* PARAMETERS    :
+*   const ZoneMap* zone         :   the zone map.
+*   const QueryRange* range     :   the weights and values looked for.
+* RETURNS       :
+*   bool    : true, if some parcel of the zone may lie in the range. false, if none can.
+*/
+static bool zoneMeetsRange(const ZoneMap* zone, const QueryRange* range)
+{
+    return zone->Count > 0 &&
+        zone->MaxWeight >= range->MinWeight && zone->MinWeight <= range->MaxWeight &&
+        zone->MaxCents >= range->MinCents && zone->MinCents <= range->MaxCents;
+}
+
+/*
+* FUNCTION      : zoneInsideRange
+* DESCRIPTION   : This functoin tells whether every parcel of a zone map is one a query looks for.
+* PARAMETERS    :
+*   const ZoneMap* zone         :   the zone map.
+*   const QueryRange* range     :   the weights and values looked for.
+* RETURNS       :
+*   bool    : true, if the whole zone lies in the range. otherwise, false.
+*/
+static bool zoneInsideRange(const ZoneMap* zone, const QueryRange* range)
+{
+    return zone->MinWeight >= range->MinWeight && zone->MaxWeight <= range->MaxWeight &&
+        zone->MinCents >= range->MinCents && zone->MaxCents <= range->MaxCents;
+}
+
+/*
+* FUNCTION      : collectCountry
+* DESCRIPTION   :
+*   This functoin lists, oldest first, a destination's record in each partition in scope that may
+*   hold parcels in a range. A partition whose zone map misses the range is skipped before its index
+*   is looked up, and a destination whose own zone map misses it is left out.
+* PARAMETERS    :
+*   const PartitionSet* set     :   the list of partitions.
+*   size_t recent               :   how many of the newest partitions are in scope.
+*   const char* country         :   the destination.
+*   const QueryRange* range     :   the weights and values looked for.
+*   size_t* count               :   receives the number of records.
+* RETURNS       :
+*   Destination**   : a new array of the records, to be freed by the caller.
+*/
+static Destination** collectCountry(const PartitionSet* set, size_t recent, const char* country,
+    const QueryRange* range, size_t* count)
+{
+    size_t len = strlen(country);
+    uint64_t hash = generateHash(country, len);
+    Destination** dests = (Destination**)malloc((set->Count > 0 ? set->Count : 1) * sizeof(Destination*));
+    if (dests == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    *count = 0;
+    for (Partition* partition = firstPartitionInScope(set, recent); partition != NULL; partition = partition->Newer)
+    {
+        if (!zoneMeetsRange(&partition->Zone, range))
+        {
+            METRIC_ADD(METRIC_PARTITIONS_PRUNED, 1);
+            continue;
+        }
+        Destination* dest = findDestinationHashed(&partition->Table, country, len, hash);
+        if (dest == NULL || dest->Summary.Count == 0)
+        {
+            continue;
+        }
+        ZoneMap zone;
+        destinationZone(dest, &zone);
+        if (!zoneMeetsRange(&zone, range))
+        {
+            METRIC_ADD(METRIC_PARTITIONS_PRUNED, 1);
+            continue;
+        }
+        METRIC_ADD(METRIC_PARTITIONS_SCANNED, 1);
+        dests[(*count)++] = dest;
+    }
+    return dests;
+}
+
+/*
+* FUNCTION      : printMergedParcels
+* DESCRIPTION   :
+*   This functoin prints the parcels of several records of a destination whose key lies in a range,
+*   in key order, by a k-way merge of one row cursor per record. Equal keys come out oldest record first,
+*   or newest first when descending, so the order is the one a single index loaded from the same
+*   files in turn would give.
+* PARAMETERS    :
+*   OutBuf* out             :   the buffer receiving the output.
+*   Destination** dests     :   the records, oldest first.
+*   size_t count            :   the number of records.
+*   CursorIndex index       :   the tree to walk, which decides the key.
+*   int64_t low             :   the lowest key printed.
+*   int64_t high            :   the highest key printed.
+*   bool descending         :   print the highest key first.
+*   int64_t limit           :   the most parcels to print.
+* RETURNS       : void
+*/
+static void printMergedParcels(OutBuf* out, Destination** dests, size_t count, CursorIndex index,
+    int64_t low, int64_t high, bool descending, int64_t limit)
+{
+    size_t heapSize = 0;
+    RowCursor* cursors = (RowCursor*)malloc((count > 0 ? count : 1) * sizeof(RowCursor));
+    PartitionEntry* heap = (PartitionEntry*)malloc((count > 0 ? count : 1) * sizeof(PartitionEntry));
+    if (cursors == NULL || heap == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t d = 0; d < count; ++d)
+    {
+        initRowCursor(&cursors[d], dests[d], index, low, high, limit < 0 ? 0 : (size_t)limit);
+        Parcel* first = descending ? seekRowAtMost(&cursors[d], high) : seekRowAtLeast(&cursors[d], low);
+        if (first != NULL)
+        {
+            PartitionEntry entry = { first, index == CURSOR_BY_WEIGHT ? first->Weight : first->Cents, d };
+            if (entry.Key >= low && entry.Key <= high)
+            {
+                pushEntry(heap, &heapSize, entry, descending);
+            }
+        }
+    }
+    while (heapSize > 0 && limit > 0 && !outPageFull(out))
+    {
+        PartitionEntry best = popEntry(heap, &heapSize, descending);
+        printParcel(out, best.Item);
+        limit--;
+        Parcel* following = descending ? prevRow(&cursors[best.Source]) : nextRow(&cursors[best.Source]);
+        if (following != NULL)
+        {
+            PartitionEntry entry = { following,
+                index == CURSOR_BY_WEIGHT ? following->Weight : following->Cents, best.Source };
+            if (entry.Key >= low && entry.Key <= high)
+            {
+                pushEntry(heap, &heapSize, entry, descending);
+            }
+        }
+    }
+    for (size_t d = 0; d < count; ++d)
+    {
+        releaseRowCursor(&cursors[d]);
+    }
+    free(heap);
+    free(cursors);
+}
+
+/*
+* FUNCTION      : rankInDestination
+* DESCRIPTION   : This functoin counts the parcels of a destination strictly lighter than a given weight, in its tree or packed columns.
+* PARAMETERS    :
+*   const Destination* dest :   the destination.
+*   int weight              :   the weight.
+* RETURNS       :
+*   int64_t : the number of lighter parcels.
+*/
+static int64_t rankInDestination(const Destination* dest, int weight)
+{
+    if (dest->Packed.Count > 0)
+    {
+        return rankOfPackedWeight(&dest->Packed, weight);
+    }
+    return rankOfWeight(dest->Root, weight);
+}
+
+/*
+* FUNCTION      : packedTableBytes
+* DESCRIPTION   : This functoin adds up the memory the packed columns of every destination of an index take.
+* PARAMETERS    :
+*   const DestTable* table  :   the index.
+* RETURNS       :
+*   size_t  : the number of bytes.
+*/
+static size_t packedTableBytes(const DestTable* table)
+{
+    size_t bytes = 0;
+    for (size_t i = 0; i < table->Capacity; ++i)
+    {
+        if (table->Slots[i].Dest != NULL)
+        {
+            bytes += packedBytes(&table->Slots[i].Dest->Packed);
+        }
+    }
+    return bytes;
+}
+
+/*
+* FUNCTION      : entryBefore
+* DESCRIPTION   : This functoin tells whether one merge entry is printed before another.
+* PARAMETERS    :
+*   const PartitionEntry* first     :   one entry.
+*   const PartitionEntry* second    :   the other entry.
+*   bool descending                 :   the highest key is printed first.
+* RETURNS       :
+*   bool    : true, if first comes out of the merge before second. otherwise, false.
+*/
+static bool entryBefore(const PartitionEntry* first, const PartitionEntry* second, bool descending)
+{
+    if (first->Key != second->Key)
+    {
+        return descending ? first->Key > second->Key : first->Key < second->Key;
+    }
+    return descending ? first->Source > second->Source : first->Source < second->Source;
+}
+
+/*
+* FUNCTION      : pushEntry
+* DESCRIPTION   : This functoin adds an entry to a binary heap whose root is printed first.
+* PARAMETERS    :
+*   PartitionEntry* heap    :   the heap, with room for the entry.
+*   size_t* size            :   the number of entries, incremented.
+*   PartitionEntry entry    :   the entry.
+*   bool descending         :   the highest key is printed first.
+* RETURNS       : void
+*/
+static void pushEntry(PartitionEntry* heap, size_t* size, PartitionEntry entry, bool descending)
+{
+    size_t i = (*size)++;
+    while (i > 0 && entryBefore(&entry, &heap[(i - 1) / 2], descending))
+    {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = entry;
+}
+
+/*
+* FUNCTION      : popEntry
+* DESCRIPTION   : This functoin removes the entry printed first from a binary heap.
+* PARAMETERS    :
+*   PartitionEntry* heap    :   the heap, not empty.
+*   size_t* size            :   the number of entries, decremented.
+*   bool descending         :   the highest key is printed first.
+* RETURNS       :
+*   PartitionEntry  : the entry that was at the root.
+*/
+static PartitionEntry popEntry(PartitionEntry* heap, size_t* size, bool descending)
+{
+    PartitionEntry best = heap[0];
+    PartitionEntry last = heap[--(*size)];
+    size_t i = 0;
+    for (;;)
+    {
+        size_t child = 2 * i + 1;
+        if (child >= *size)
+        {
+            break;
+        }
+        if (child + 1 < *size && entryBefore(&heap[child + 1], &heap[child], descending))
+        {
+            child++;
+        }
+        if (!entryBefore(&heap[child], &last, descending))
+        {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (*size > 0)
+    {
+        heap[i] = last;
+    }
+    return best;
+}
@@ -0,0 +1,88 @@
+/*
+* FILENAME      : partition.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares partitioned storage. Every courier file loaded, one per shift for instance,
+*   becomes a partition of its own: a destination index of its own that is never changed once loaded,
+*   with a zone map of the lowest and highest weight and value in it. The partitions are kept in a
+*   list from oldest to newest, so the oldest can be expired in O(1) without touching the others, and
+*   a query can look at the newest few only.
+*
+*   The queries below answer as if the partitions in scope were one index loaded from their files in
+*   order: parcels of equal weight or value come out in the order they were loaded. A partition, or
+*   a destination within it, whose zone map cannot meet the range of a query is skipped without a
+*   lookup or a walk of its trees; one that lies wholly inside the range is summed from its totals.
+*
+*   A compressed set packs the parcels of every partition it loads (see packed.h) instead of building
+*   trees for them, which takes a few bytes per parcel instead of a node each. The queries answer the
+*   same either way.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "destTable.h"
+#include "loader.h"
+#include "output.h"
+
+#define PARTITION_ALL       ((size_t)-1)    // a scope that takes every partition
+
+// the extremes of a set of parcels, from which a query can tell it has nothing to look for there
+typedef struct ZoneMap
+{
+    int64_t Count;
+    int MinWeight;
+    int MaxWeight;
+    int64_t MinCents;
+    int64_t MaxCents;
+} ZoneMap;
+
+typedef struct Partition
+{
+    char* Label;                // the file it was loaded from
+    unsigned int Number;        // 1 for the first partition ever loaded, and so on
+    time_t Loaded;
+    DestTable Table;            // its own per-destination index, never changed once loaded
+    ZoneMap Zone;
+    struct Partition* Older;
+    struct Partition* Newer;
+} Partition;
+
+typedef struct PartitionSet
+{
+    Partition* Oldest;
+    Partition* Newest;
+    size_t Count;
+    unsigned int NextNumber;
+    bool Compressed;            // partitions loaded from now on are packed
+} PartitionSet;
+
+// functions of the partition list
+void initPartitionSet(PartitionSet* set);
+Partition* addPartitionFromFile(PartitionSet* set, const char* path, LoadResult* result);
+bool expireOldestPartition(PartitionSet* set);
+void deletePartitionSet(PartitionSet* set);
+Partition* firstPartitionInScope(const PartitionSet* set, size_t recent);
+DestTable** collectPartitionTables(const PartitionSet* set, size_t recent, size_t* count);
+void printPartitionList(OutBuf* out, const PartitionSet* set);
+void expireOldestPartitions(OutBuf* out, PartitionSet* set, int count);
+void loadPartition(OutBuf* out, PartitionSet* set, const char* path);
+// the per-country queries over the newest recent partitions, see query.h
+const char* findCountryInPartitions(const PartitionSet* set, size_t recent, const char* country);
+void printAllParcelsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country);
+void printLighterParcelsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int wgt);
+void printHeavierParcelsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int wgt);
+void printParcelsBetweenWeightsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int minWgt, int maxWgt);
+void printWeightRangeTotalsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int minWgt, int maxWgt);
+void printTotalsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country);
+void printLightestAndHeaviestParcelInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country);
+void printCheapestAndMostExpensiveParcelInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country);
+void printParcelsWithinValueInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int64_t minCents, int64_t maxCents);
+void printMostValuableParcelsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int count);
+void printValueRangeTotalsInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, int64_t minCents, int64_t maxCents);
+void printWeightPercentileInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* country, double percentile);
+void printDestinationsStartingWithInPartitions(OutBuf* out, const PartitionSet* set, size_t recent, const char* prefix);
@@ -15,94 +15,342 @@
 #include <string.h>
 #include <stdbool.h>
 
-#define HASH_TABLE_SIZE     127
-#define ENTRY_SIZE          50
-#define COUNTRY_SIZE        20
-
-typedef struct Parcel 
-{
-    int Weight;
-    float Value;
-    char* Dest;
-    Parcel* Left;
-    Parcel* Right;
-} Parcel;
+#include "parcel.h"
+#include "destTable.h"
+#include "loader.h"
+#include "threadPool.h"
+#include "output.h"
+#include "query.h"
+#include "snapshot.h"
+#include "follow.h"
+#include "concurrent.h"
+#include "server.h"
+#include "bench.h"
+#include "dictionary.h"
+#include "partition.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+#define COUNTRY_SIZE        128
 
 //prototypes
-// functions of Parcel
-Parcel* createNewParcel(char* newDest, int newWgt, float newVal);
-void deleteParcel(Parcel* toDel);
-void printParcel(Parcel* toPrint);
-// functions of BST
-Parcel* insertParcelToBST(Parcel* root, Parcel* newParcel);
-Parcel* findMaxWeight(Parcel* root); 
-Parcel* findMinWeight(Parcel* root); 
-Parcel* findCheapestParcel(Parcel* root);
-Parcel* findMostExpensiveParcel(Parcel* root);
-int sumOfParcelsWgt(Parcel* root);
-float sumOfParcelsVal(Parcel* root);
-void printBSTInOrder(Parcel* root);
-void printSectionLowerThanWgt(Parcel* root, int partitionWgt);
-void printSectionHigherThanWgt(Parcel* root, int partitionWgt);
-void deleteBST(Parcel* root);
-
-// functions for hash table
-int generateHash(char* str);
-void insertHashTableWithBST(Parcel* table[], char* dest, int weight, float value);
-void deleteHashTable(Parcel* table[], int tableSize);
-void printTotalParcelWgtAndValForCountry(Parcel* hashTable[], char* country);
-void printLighterParcelsInCountry(Parcel* table[], char* country,int wgt);
-void printHeavierParcelsInCountry(Parcel* table[], char* country, int wgt);
-void printCheapestAndMostExpensiveParcelInCountry(Parcel* table[], char* country);
-
 // functions to process user input
 void clearNewLineChar(char* string);
-bool validEnteredDestination(Parcel* hashTable[], char* country);
+bool validEnteredDestination(DestTable* table, char* country);
+void printUsage(const char* program);
 
-int main(void) 
+int main(int argc, char* argv[]) 
 {
     // variables
-    char parcelEntry[ENTRY_SIZE] = "";
-    FILE* fPtr = NULL;
-    Parcel* hashTable[HASH_TABLE_SIZE] = { NULL };
-
-    // read the file to load the parcels' information. 
-    fPtr = fopen("couriers.txt", "r");
-    if (fPtr == NULL)
+    LoadResult loadResult = {};
+    DestTable destTable = {};
+    OutBuf console = {};
+    FollowState follow = {};
+    PartitionSet partitions;
+    const char** partitionPaths = (const char**)malloc((size_t)argc * sizeof(const char*));
+    int partitionCount = 0;
+    const char* dataPath = "couriers.txt";
+    const char* batchPath = NULL;
+    const char* snapshotPath = NULL;
+    const char* serveAddress = NULL;
+    const char* genPath = NULL;
+    GenOptions genOptions;
+    bool benchmark = false;
+    int queryCount = BENCH_QUERY_COUNT;
+    int threadCount = 0;
+    bool following = false;
+    bool concurrent = false;
+    bool compress = false;
+    OutFormat rowFormat = OUT_FORMAT_TABLE;
+
+    // command line options
+    if (partitionPaths == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    initGenOptions(&genOptions);
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+        {
+            batchPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--data") == 0 && i + 1 < argc)
+        {
+            dataPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--partition") == 0 && i + 1 < argc)
+        {
+            partitionPaths[partitionCount++] = argv[++i];
+        }
+        else if (strcmp(argv[i], "--compress") == 0)
+        {
+            compress = true;
+        }
+        else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc)
+        {
+            snapshotPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--follow") == 0)
+        {
+            following = true;
+        }
+        else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc)
+        {
+            serveAddress = argv[++i];
+        }
+        else if (strcmp(argv[i], "--concurrent") == 0)
+        {
+            concurrent = true;
+        }
+        else if (strcmp(argv[i], "--gen") == 0 && i + 1 < argc)
+        {
+            genPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc)
+        {
+            genOptions.Rows = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--countries") == 0 && i + 1 < argc)
+        {
+            genOptions.Countries = (unsigned int)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--skew") == 0 && i + 1 < argc)
+        {
+            genOptions.Skew = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--order") == 0 && i + 1 < argc && parseWeightOrder(argv[i + 1], &genOptions.Order))
+        {
+            i++;
+        }
+        else if (strcmp(argv[i], "--dups") == 0 && i + 1 < argc)
+        {
+            genOptions.Duplicates = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            genOptions.Seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--bench") == 0)
+        {
+            benchmark = true;
+        }
+        else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc)
+        {
+            queryCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc && parseOutFormat(argv[i + 1], &rowFormat))
+        {
+            i++;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threadCount = atoi(argv[++i]);
+        }
+        else
+        {
+            printUsage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (following && snapshotPath != NULL)
+    {
+        printf("**--follow cannot be combined with --snapshot\n");
+        exit(EXIT_FAILURE);
+    }
+    if (serveAddress != NULL && batchPath != NULL)
+    {
+        printf("**--serve cannot be combined with --batch\n");
+        exit(EXIT_FAILURE);
+    }
+    if (concurrent && batchPath == NULL)
+    {
+        printf("**--concurrent needs --batch\n");
+        exit(EXIT_FAILURE);
+    }
+    if (partitionCount > 0 && (batchPath == NULL || concurrent || following || snapshotPath != NULL))
+    {
+        printf("**--partition needs --batch, and cannot be combined with --concurrent, --follow or --snapshot\n");
+        exit(EXIT_FAILURE);
+    }
+    if (compress && partitionCount == 0)
     {
-        printf("**File Open ERROR\n");
+        printf("**--compress needs --partition\n");
         exit(EXIT_FAILURE);
     }
 
-    while (fgets(parcelEntry, ENTRY_SIZE, fPtr) != NULL)
+    // write a synthetic courier file, then benchmark the data file, without loading anything else
+    if (genPath != NULL)
     {
-        char country[COUNTRY_SIZE] = "";
-        int weight = 0;
-        float price = 0.0f;        
-        // parse an parcel entry and load it into the Parcel node
-        sscanf_s(parcelEntry,"%[^,0-9], %d, %f", country, COUNTRY_SIZE, &weight, &price);
-        // insert to the BST inside the hash table
-        insertHashTableWithBST(hashTable, country, weight, price);
+        if (!generateCouriers(genPath, &genOptions))
+        {
+            printf("**File Write ERROR: %s\n", genPath);
+            exit(EXIT_FAILURE);
+        }
+        printf("Wrote %llu parcels to %s\n", (unsigned long long)genOptions.Rows, genPath);
     }
-    if (!feof(fPtr))
+    if (benchmark)
     {
-        if (ferror(fPtr))
+        initThreadPool(threadCount);
+        bool benchmarked = runBenchmark(dataPath, queryCount > 0 ? queryCount : 1, genOptions.Seed);
+        stopThreadPool();
+        releaseDestDictionary();
+        if (!benchmarked)
         {
-            printf("**File Reading ERROR\n");
+            printf("**File Open ERROR\n");
             exit(EXIT_FAILURE);
         }
     }
+    if (genPath != NULL || benchmark)
+    {
+        free(partitionPaths);
+        return EXIT_SUCCESS;
+    }
 
-    if (fclose(fPtr) != 0)
+    // the names in countries.txt, when it is there, give the destinations their proper spelling
+    seedDestDictionary("countries.txt");
+    initDestTable(&destTable, DEST_TABLE_INITIAL_SIZE);
+    initThreadPool(threadCount);
+    initOutBuf(&console, stdout);
+    console.Format = rowFormat;
+#ifdef _WIN32
+    if (rowFormat == OUT_FORMAT_BINARY)
     {
-        printf("**File Close ERROR\n");
-        exit(EXIT_FAILURE);
+        _setmode(_fileno(stdout), _O_BINARY);
+    }
+#endif
+
+    // load each courier file as a partition of its own and answer the queries across them
+    if (partitionCount > 0)
+    {
+        FILE* batchFile = strcmp(batchPath, "-") == 0 ? stdin : fopen(batchPath, "r");
+        if (batchFile == NULL)
+        {
+            printf("**File Open ERROR: %s\n", batchPath);
+            exit(EXIT_FAILURE);
+        }
+        initPartitionSet(&partitions);
+        partitions.Compressed = compress;
+        for (int p = 0; p < partitionCount; ++p)
+        {
+            if (addPartitionFromFile(&partitions, partitionPaths[p], &loadResult) == NULL)
+            {
+                printf("**File Open ERROR: %s\n", partitionPaths[p]);
+                exit(EXIT_FAILURE);
+            }
+        }
+        free(partitionPaths);
+        size_t failed = runPartitionBatch(&partitions, batchFile, &console);
+        if (batchFile != stdin)
+        {
+            fclose(batchFile);
+        }
+        freeOutBuf(&console);
+        deletePartitionSet(&partitions);
+        deleteDestTable(&destTable);
+        stopThreadPool();
+        releaseDestDictionary();
+        return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    free(partitionPaths);
+
+    // restore the index from a snapshot of the same courier file, or map the file and load the
+    // parcels' information, then refresh the snapshot. When following, the file stays open instead.
+    if (following)
+    {
+        if (!startFollow(&destTable, dataPath, &follow, &loadResult))
+        {
+            printf("**File Open ERROR\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (snapshotPath == NULL || !loadSnapshot(&destTable, snapshotPath, dataPath))
+    {
+        if (!loadParcelsFromFile(&destTable, dataPath, &loadResult))
+        {
+            printf("**File Open ERROR\n");
+            exit(EXIT_FAILURE);
+        }
+        if (snapshotPath != NULL && !saveSnapshot(&destTable, snapshotPath, dataPath))
+        {
+            printf("**Snapshot Write ERROR: %s\n", snapshotPath);
+        }
+    }
+
+    // answer clients over a socket until stopped
+    if (serveAddress != NULL)
+    {
+        static ConcurrentIndex index;
+        initConcurrentIndex(&index, &destTable);
+        if (following)
+        {
+            startConcurrentFollow(&index, &follow, &loadResult);
+        }
+        bool served = runServer(&index, serveAddress);
+        stopConcurrentFollow(&index);
+        stopConcurrentIndex(&index);
+        freeOutBuf(&console);
+        stopFollow(&follow);
+        deleteDestTable(&destTable);
+        stopThreadPool();
+        releaseDestDictionary();
+        return served ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // answer a file of queries without the menu
+    if (batchPath != NULL)
+    {
+        FILE* batchFile = strcmp(batchPath, "-") == 0 ? stdin : fopen(batchPath, "r");
+        if (batchFile == NULL)
+        {
+            printf("**File Open ERROR: %s\n", batchPath);
+            exit(EXIT_FAILURE);
+        }
+        size_t failed = 0;
+        if (concurrent)
+        {
+            // readers answer from published views while the follow thread, if any, keeps inserting
+            static ConcurrentIndex index;
+            initConcurrentIndex(&index, &destTable);
+            if (following)
+            {
+                startConcurrentFollow(&index, &follow, &loadResult);
+            }
+            failed = runConcurrentBatch(&index, batchFile, &console, following);
+            stopConcurrentFollow(&index);
+            stopConcurrentIndex(&index);
+        }
+        else
+        {
+            failed = runBatchQueries(&destTable, batchFile, &console,
+                following ? &follow : NULL, &loadResult);
+        }
+        if (batchFile != stdin)
+        {
+            fclose(batchFile);
+        }
+        freeOutBuf(&console);
+        stopFollow(&follow);
+        deleteDestTable(&destTable);
+        stopThreadPool();
+        releaseDestDictionary();
+        return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
     // read the data through user menu 
     int choice = 0;
     char userCountry[COUNTRY_SIZE] = "";
     int userWeight = 0;
+    double userMinValue = 0.0;
+    double userMaxValue = 0.0;
+    int userCount = 0;
+    int userMaxWeight = 0;
+    double userPercentile = 0.0;
     int validInput = 0;
 
     do
@@ -114,7 +362,11 @@ int main(void)
         printf("3. Display the total parcel load and valuation for the country\n");
         printf("4. Enter the country name and display cheapest and most expensive parcel's details\n");
         printf("5. Enter the country name and display lightest and heaviest parcel for the country\n");
-        printf("6. Exit the application\n");
+        printf("6. Enter the country name and a value range to display parcels valued within the range\n");
+        printf("7. Enter the country name and a count to display the most valuable parcels for the country\n");
+        printf("8. Enter the country name and a weight range to display the parcel count, load and valuation within the range\n");
+        printf("9. Enter the country name and a percentile to display the parcel at that weight percentile\n");
+        printf("10. Exit the application\n");
         printf("Enter your choice: ");
 
         // Check if the user input is an integer
@@ -123,19 +375,29 @@ int main(void)
 
         if (validInput != 1)
         {
-            printf("Invalid input. Please enter a number between 1 and 6.\n");
+            printf("Invalid input. Please enter a number between 1 and 10.\n");
             continue;
         }
 
+        // take in the parcels appended to the followed file since the last command
+        if (following)
+        {
+            size_t added = pollFollow(&destTable, &follow, &loadResult);
+            if (added > 0)
+            {
+                printf("%zu new parcels loaded\n", added);
+            }
+        }
+
         switch (choice)
         {
         case 1: // display all the parcels' details
             printf("Enter country name: ");
             fgets(userCountry, COUNTRY_SIZE, stdin);
             clearNewLineChar(userCountry);
-            if (validEnteredDestination(hashTable, userCountry))
+            if (validEnteredDestination(&destTable, userCountry))
             {
-                printBSTInOrder(hashTable[generateHash(userCountry)]);
+                printAllParcelsInCountry(&console, &destTable, userCountry);
             }
             else
             {
@@ -147,7 +409,7 @@ int main(void)
             printf("Enter country name: ");
             fgets(userCountry, COUNTRY_SIZE, stdin);
             clearNewLineChar(userCountry);
-            if (!validEnteredDestination(hashTable, userCountry))
+            if (!validEnteredDestination(&destTable, userCountry))
             {
                 printf("Not an Existing Destination!\n");
                 break;
@@ -160,17 +422,17 @@ int main(void)
                 break;
             }
             while (getchar() != '\n'); // Clear the input buffer
-            printHeavierParcelsInCountry(hashTable, userCountry, userWeight);
-            printLighterParcelsInCountry(hashTable, userCountry, userWeight);
+            printHeavierParcelsInCountry(&console, &destTable, userCountry, userWeight);
+            printLighterParcelsInCountry(&console, &destTable, userCountry, userWeight);
             break;
 
         case 3: // display the total parcel load and valuation for the country
             printf("Enter country name: ");
             fgets(userCountry, COUNTRY_SIZE, stdin);
             clearNewLineChar(userCountry);
-            if (validEnteredDestination(hashTable, userCountry))
+            if (validEnteredDestination(&destTable, userCountry))
             {
-                printTotalParcelWgtAndValForCountry(hashTable, userCountry);
+                printTotalParcelWgtAndValForCountry(&console, &destTable, userCountry);
             }
             else
             {
@@ -182,9 +444,9 @@ int main(void)
             printf("Enter country name: ");
             fgets(userCountry, COUNTRY_SIZE, stdin);
             clearNewLineChar(userCountry);
-            if (validEnteredDestination(hashTable, userCountry))
+            if (validEnteredDestination(&destTable, userCountry))
             {
-                printCheapestAndMostExpensiveParcelInCountry(hashTable, userCountry);
+                printCheapestAndMostExpensiveParcelInCountry(&console, &destTable, userCountry);
             }
             else
             {
@@ -196,12 +458,9 @@ int main(void)
             printf("Enter country name: ");
             fgets(userCountry, COUNTRY_SIZE, stdin);
             clearNewLineChar(userCountry);
-            if (validEnteredDestination(hashTable, userCountry))
+            if (validEnteredDestination(&destTable, userCountry))
             {
-                printf("\nThe Lightest Parcel:\n");
-                printParcel(findMinWeight(hashTable[generateHash(userCountry)]));
-                printf("\nThe Heaviest Parcel:\n");
-                printParcel(findMaxWeight(hashTable[generateHash(userCountry)]));
+                printLightestAndHeaviestParcelInCountry(&console, &destTable, userCountry);
             }
             else
             {
@@ -209,524 +468,133 @@ int main(void)
             }
             break;
 
-        case 6:
-            printf("\nExiting...Bye\n");
-            break;
-
-        default:
-            printf("Invalid choice. Please enter a number between 1 and 6.\n");
-            break;
-        }
-
-    } while (choice != 6);
-
-    // free dynamically allocated memory
-    deleteHashTable(hashTable, HASH_TABLE_SIZE);
-	return 0;
-}
-
-
-
-/*
-* FUNCTION      : generateHash
-* DESCRIPTION   : this functoin converts a string to a hash value.
-* PARAMETERS    : unsigned char* str : a string to be convert to a hash value
-* RETURNS       : int : an interger representing the hash value.
-*/
-int generateHash(char* str)
-{
-    /* TITLE        : "djb2 hash" source code
-    * AUTHOR        : Daniel J. Bernstein
-    * DATE          : 1991
-    * AVAILABIILTY  : https://theartincode.stanis.me/008-djb2/
-    */
-    unsigned long hash = 5381;
-    int c = 0;
-    while (c = *str++)
-    {
-        hash = ((hash << 5) + hash) + c;
-    }
-    hash = hash % HASH_TABLE_SIZE;
-    return (int)hash;
-}
-/*
-* FUNCTION      : createNewParcel
-* DESCRIPTION   : this functoin creates a new Parcel node for trees.
-* PARAMETERS    : 
-*   char* newDest   :   the desetination for the new parcel.
-*   int   newWgt    :   the weight of the new parcel
-*   float newVal    :   the valuation of the new parcel
-* 
-* RETURNS       :
-*       Parcel*     : a pointer to the new struct Parcel containing the parcel's info.
-*/
-Parcel* createNewParcel(char* newDest, int newWgt, float newVal)
-{
-    Parcel* newNode = (Parcel*)malloc(sizeof Parcel);
-    if (newNode == NULL)
-    {
-        printf("**ERROR: Out of Memory!\n");
-        exit(EXIT_FAILURE);
-    }
-    newNode->Dest = (char*)malloc(strlen(newDest)+1);
-    if (newNode->Dest == NULL)
-    {
-        printf("**ERROR: Out of Memory!\n");
-        exit(EXIT_FAILURE);
-    }
-    strcpy_s(newNode->Dest, strlen(newDest)+1, newDest);
-    newNode->Value = newVal;
-    newNode->Weight = newWgt;
-    newNode->Left = NULL;
-    newNode->Right = NULL;
-    return newNode;
-}
-
-
-/*
-* FUNCTION      : deleteParcel
-* DESCRIPTION   : 
-*   This functoin frees the dynamically allocated memory of a Parcel node.
-* PARAMETERS    :
-*   Parcel* toDel   :   a pointer to the parcel node to be deleted. 
-* RETURNS       :  void
-*/
-void deleteParcel(Parcel* toDel)
-{
-    free(toDel->Dest);
-    free(toDel);
-}
-
-/*
-* FUNCTION      : printParcel
-* DESCRIPTION   :
-*   This functoin prints out the information of a parcel, including its destination, weight and value, in one line.
-* PARAMETERS    :
-*   Parcel* toDel   :   a pointer to the parcel node to be printed out
-* RETURNS       :  void
-*/
-void printParcel(Parcel* toPrint)
-{
-    if (toPrint != NULL)
-    {
-        printf("Destination:\t%10s\t Weight: %6d gms\t Value: $%8.2f\n", toPrint->Dest, toPrint->Weight, toPrint->Value);
-    }
-}
-/*
-* FUNCTION      : insertParcelToBST
-* DESCRIPTION   : Inserts a new parcel into a Binary Search Tree
-* PARAMETERS    : Parcel* root - The root of the BST
-*                 Parcel* newParcel - The parcel to be inserted
-* RETURNS       : returns pointer to the parcel, this parcel is inserted into the binary search tree
-*/
-Parcel* insertParcelToBST(Parcel* parent, Parcel* newParcel)
-{
-
-    if (parent == NULL)
-    {
-        parent = newParcel;
-    }
-    else if (newParcel->Weight > parent->Weight)
-    {
-       parent->Right = insertParcelToBST(parent->Right, newParcel);
-    }
-    else if (newParcel->Weight < parent->Weight)
-    {
-       parent->Left = insertParcelToBST(parent->Left, newParcel);
-    }
-    return parent;
-}
-/*
-* FUNCTION      : findMaxWeight
-* DESCRIPTION   : Finds and returns the maximum weight in a Binary Search Tree
-* PARAMETERS    : Parcel* root - searching from the root of BST
-*
-* RETURNS       : returns pointer to the parcel, this parcel is the maximum weight
-*/
-Parcel* findMaxWeight(Parcel* root)
-{
-    if (root == NULL || root->Right == NULL)
-    {
-        return root;
-    }
-    return findMaxWeight(root->Right);
-}
-/*
-* FUNCTION      : findMinWeight
-* DESCRIPTION   : Finds and returns the minimum weight in a Binary Search Tree
-* PARAMETERS    : Parcel* root - searching from the root of BST
-*
-* RETURNS       : returns pointer to the parcel, this parcel is the minimum weight
-*/
-Parcel* findMinWeight(Parcel* root)
-{
-    if (root == NULL || root->Left == NULL)
-    {
-        return root;
-    }
-    return findMinWeight(root->Left);
-}
-
-/*
-* FUNCTION      : findCheapestParcel
-* DESCRIPTION   : Finds and returns the cheapest parcel in a Binary Search Tree
-* PARAMETERS    : Parcel* parent - searching from the root of BST
-*
-* RETURNS       : returns a pointer to the parcel, this parcel is the cheapest parcel in the BST
-*/
-Parcel* findCheapestParcel(Parcel* parent)
-{
-    Parcel* cheapest = parent;
-    Parcel* cheapestInLeft = NULL;
-    Parcel* cheapestInRight = NULL;
-
-    if (parent != NULL)
-    {
-        if (parent->Left == NULL && parent->Right == NULL)
-        { }
-        else if (parent->Left == NULL && parent->Right != NULL)
-        {
-            cheapestInRight = findCheapestParcel(parent->Right);
-            if (cheapest->Value > cheapestInRight->Value)
+        case 6: // display parcels valued within a range
+            printf("Enter country name: ");
+            fgets(userCountry, COUNTRY_SIZE, stdin);
+            clearNewLineChar(userCountry);
+            if (!validEnteredDestination(&destTable, userCountry))
             {
-                cheapest = cheapestInRight;
+                printf("Not an Existing Destination!\n");
+                break;
             }
-        }
-        else if (parent->Left != NULL && parent->Right == NULL)
-        {
-            cheapestInLeft = findCheapestParcel(parent->Left);
-            if (cheapest->Value > cheapestInLeft->Value)
+            printf("Enter lowest and highest value: ");
+            if (scanf_s("%lf %lf", &userMinValue, &userMaxValue) != 2)
             {
-                cheapest = cheapestInLeft;
+                printf("Invalid values. Please enter two values.\n");
+                while (getchar() != '\n'); // Clear the input buffer
+                break;
             }
-        }
-        else
-        {
-            cheapestInLeft = findCheapestParcel(parent->Left);
-            cheapestInRight = findCheapestParcel(parent->Right);
-            if (cheapestInLeft->Value < cheapestInRight->Value && 
-                cheapestInLeft->Value < parent->Value)
+            while (getchar() != '\n'); // Clear the input buffer
+            printParcelsWithinValueInCountry(&console, &destTable, userCountry, dollarsToCents(userMinValue), dollarsToCents(userMaxValue));
+            break;
+
+        case 7: // display the most valuable parcels
+            printf("Enter country name: ");
+            fgets(userCountry, COUNTRY_SIZE, stdin);
+            clearNewLineChar(userCountry);
+            if (!validEnteredDestination(&destTable, userCountry))
             {
-                cheapest = cheapestInLeft;
+                printf("Not an Existing Destination!\n");
+                break;
             }
-            if (cheapestInRight->Value < cheapestInLeft->Value &&
-                cheapestInRight->Value < parent->Value) 
+            printf("Enter number of parcels: ");
+            if (scanf_s("%d", &userCount) != 1)
             {
-                cheapest = cheapestInRight;
+                printf("Invalid number. Please enter a number.\n");
+                while (getchar() != '\n'); // Clear the input buffer
+                break;
             }
-        }
-    }
-    return cheapest;
-}
-
-/*
-* FUNCTION      : findMostExpensiveParcel
-* DESCRIPTION   : Finds and returns the most expensive parcel in a Binary Search Tree
-* PARAMETERS    : Parcel* parent - searching from the root of BST
-*
-* RETURNS       : returns a pointer to the parcel, this parcel is the expensive parcel in the BST
-*/
-Parcel* findMostExpensiveParcel(Parcel* parent)
-{
-    Parcel* maxValue = parent;
-    Parcel* maxValueInLeft = NULL;
-    Parcel* maxValueInRight = NULL;
+            while (getchar() != '\n'); // Clear the input buffer
+            printMostValuableParcelsInCountry(&console, &destTable, userCountry, userCount);
+            break;
 
-    if (parent != NULL)
-    {
-        if (parent->Left == NULL && parent->Right == NULL)
-        { }
-        else if (parent->Left == NULL && parent->Right != NULL)
-        {
-            maxValueInRight = findMostExpensiveParcel(parent->Right);
-            if (maxValue->Value < maxValueInRight->Value)
+        case 8: // display totals of parcels within a weight range
+            printf("Enter country name: ");
+            fgets(userCountry, COUNTRY_SIZE, stdin);
+            clearNewLineChar(userCountry);
+            if (!validEnteredDestination(&destTable, userCountry))
             {
-                maxValue = maxValueInRight;
+                printf("Not an Existing Destination!\n");
+                break;
             }
-        }
-        else if (parent->Left != NULL && parent->Right == NULL)
-        {
-            maxValueInLeft = findMostExpensiveParcel(parent->Left);
-            if (maxValue->Value < maxValueInLeft->Value)
+            printf("Enter lowest and highest weight: ");
+            if (scanf_s("%d %d", &userWeight, &userMaxWeight) != 2)
             {
-                maxValue = maxValueInLeft;
+                printf("Invalid weights. Please enter two weights.\n");
+                while (getchar() != '\n'); // Clear the input buffer
+                break;
             }
-        }
-        else
-        {
-            maxValueInLeft = findMostExpensiveParcel(parent->Left);
-            maxValueInRight = findMostExpensiveParcel(parent->Right);
-            if (maxValueInLeft->Value > maxValueInRight->Value &&
-                maxValueInLeft->Value > parent->Value)
+            while (getchar() != '\n'); // Clear the input buffer
+            printWeightRangeTotalsInCountry(&console, &destTable, userCountry, userWeight, userMaxWeight);
+            break;
+
+        case 9: // display the parcel at a weight percentile
+            printf("Enter country name: ");
+            fgets(userCountry, COUNTRY_SIZE, stdin);
+            clearNewLineChar(userCountry);
+            if (!validEnteredDestination(&destTable, userCountry))
             {
-                maxValue = maxValueInLeft;
+                printf("Not an Existing Destination!\n");
+                break;
             }
-            if (maxValueInRight->Value > maxValueInLeft->Value &&
-                maxValueInRight->Value > parent->Value)
+            printf("Enter percentile (0-100): ");
+            if (scanf_s("%lf", &userPercentile) != 1 || userPercentile < 0.0 || userPercentile > 100.0)
             {
-                maxValue = maxValueInRight;
+                printf("Invalid percentile. Please enter a number between 0 and 100.\n");
+                while (getchar() != '\n'); // Clear the input buffer
+                break;
             }
-        }
-    }
-    return maxValue;
-
-}
+            while (getchar() != '\n'); // Clear the input buffer
+            printWeightPercentileInCountry(&console, &destTable, userCountry, userPercentile);
+            break;
 
-/*
-* FUNCTION      : printSectionLowerThanWgt
-* DESCRIPTION   :
-*   This functoin prints out all the parcels lighter than a given weight within a BST.
-* PARAMETERS    :
-*   Parcel* parent  :   the root node of BSTs to display parcels.
-*   int partition   :   the weight partitions parcels in the bst to be displayed.
-* RETURNS       :  void
-*/
-void printSectionLowerThanWgt(Parcel* parent, int partition)
-{
-    if (parent != NULL)
-    {
-        if (parent->Weight < partition)
-        {
-            printBSTInOrder(parent->Left);
-            printParcel(parent);
-            printSectionLowerThanWgt(parent->Right, partition);
-        }
-        else
-        {
-            printSectionLowerThanWgt(parent->Left, partition);
-        }
-    }
-}
+        case 10:
+            printf("\nExiting...Bye\n");
+            break;
 
-/*
-* FUNCTION      : printSectionHigherThanWgt
-* DESCRIPTION   :
-*   This functoin prints out all the parcels heavier than a given weight within a BST.
-* PARAMETERS    :
-*   Parcel* parent  :   the root node of BSTs to display parcels.
-*   int partition   :   the weight partitions parcels in the bst to be displayed.
-* RETURNS       :  void
-*/
-void printSectionHigherThanWgt(Parcel* parent, int partition)
-{
-    if (parent != NULL)
-    {
-        if (parent->Weight > partition)
-        {
-            printSectionHigherThanWgt(parent->Left, partition);
-            printParcel(parent);
-            printBSTInOrder(parent->Right);
-        }
-        else
-        {
-            printSectionHigherThanWgt(parent->Right, partition);
+        default:
+            printf("Invalid choice. Please enter a number between 1 and 10.\n");
+            break;
         }
-    }
-}
-
-/*
-* FUNCTION      : printBSTInOrder
-* DESCRIPTION   :
-*   This functoin prints out all the parcels  within a BST in weight ascending order.
-* PARAMETERS    :
-*   Parcel* parent  :   the root node of BSTs to display parcels.
-* RETURNS       :  void
-*/
-void printBSTInOrder(Parcel* parent)
-{
-    if (parent == NULL)
-    {
-        return;
-    }
-    else
-    {
-        printBSTInOrder(parent->Left);
-        printParcel(parent);
-        printBSTInOrder(parent->Right);
-    }
-}
+        flushOutBuf(&console);
 
-/*
-* FUNCTION      : deleteBST
-* DESCRIPTION   :
-*   This functoin frees memory of all parcel nodes in a BST.
-* PARAMETERS    :
-*   Parcel* parent :  the root node of the BSTs to be deleted.
-* RETURNS       :  void
-*/
-void deleteBST(Parcel* parent)
-{
-    if (parent == NULL)
-    {
-        return;
-    }
-    else
-    {
-        deleteBST(parent->Left);
-        deleteBST(parent->Right);
-        deleteParcel(parent);
-    }
-}
-/*
-* FUNCTION      : insertHashTableWithBST
-* DESCRIPTION   :
-*   This functoin creates a parcel node based on given data and inserts the node 
-*    to a BST within a bucket of a hash table using destination as the key.
-* PARAMETERS    :
-*   Parcel* table[] :  the hash table to contain BSTs.
-*   char* dest      :   the destination of a parcel
-*   int weight      :   the weight of a parcel
-*   float value     :   the value of a parcel
-* RETURNS       :  void
-*/
-void insertHashTableWithBST(Parcel* table[], char* dest, int weight, float value)
-{
-    int hash = generateHash(dest);
-    Parcel* newParcel = createNewParcel(dest, weight, value);
-    table[hash] = insertParcelToBST(table[hash], newParcel);
-}
-
-/*
-* FUNCTION      : deleteHashTable
-* DESCRIPTION   : 
-*   This functoin frees memory of all binary trees in the hash table.
-* PARAMETERS    :
-*   Parcel* table[] :  the hash table containing BSTs to be deleted.  
-*   int tableSize   :   the size of the table
-* RETURNS       :  void
-*/
-void deleteHashTable(Parcel* table[], int tableSize)
-{
-    for (int i = 0; i < tableSize; ++i)
-    {
-        deleteBST(table[i]);
-    }
-}
-/*
-* FUNCTION      : sumOfParcelsWgt
-* DESCRIPTION   : Calculates the total weight of all parcels in a (BST)
-* PARAMETERS    : Parcel* parent - A pointer to the root of the BST to calculate the total weight
-* RETURNS       : int - The total weight of all parcels in the BST
-*/
-int sumOfParcelsWgt(Parcel* parent)
-{
-    int sum = 0;
-    if (parent != NULL)
-    {
-        sum += parent->Weight;
-        sum += sumOfParcelsWgt(parent->Left);
-        sum += sumOfParcelsWgt(parent->Right);
-    }
-    return sum;
-}
-/*
-* FUNCTION      : sumOfParcelsVal
-* DESCRIPTION   : Calculates the total value of all parcels in a BST
-* PARAMETERS    : Parcel* parent - A pointer to the root of the BST to calculate the total value
-* RETURNS       : float - The total value of all parcels in the BST
-*/
-float sumOfParcelsVal(Parcel* parent)
-{
-    float sum = 0;
-    if (parent!= NULL)
-    {
-        sum += parent->Value;
-        sum += sumOfParcelsVal(parent->Left);
-        sum += sumOfParcelsVal(parent->Right);
-    }
-    return sum;
-}
-/*
-* FUNCTION      : printTotalParcelWgtAndValForCountry
-* DESCRIPTION   :
-*   This functoin displays total weight and total value of parcels to a given destination (a country).
-*   within the hash table.
-* PARAMETERS    :
-*   Parcel* table[] :   a pointer to the hash table containing all parcels. 
-*   char* country   :   a string representing the destination country of parcels.
-* RETURNS       :  void
-*/
-void printTotalParcelWgtAndValForCountry(Parcel* table[], char* country)
-{
-    int hash = generateHash(country);
-    printf("\nDestination:\t%10s\t Total Weight: %8d gms\t Total: $%10.2f\n", 
-        country, sumOfParcelsWgt(table[hash]), sumOfParcelsVal(table[hash]));
-}
+    } while (choice != 10);
 
-/*
-* FUNCTION      : printLighterParcelsInCountry
-* DESCRIPTION   :
-*   This functoin displays parcels that are lighter than a given weight being delivered to a given country.
-*   within the hash table
-* PARAMETERS    :
-*   Parcel* table[] :   a pointer to the hash table containing all parcels. 
-*   char* country   :   a string representing the destination country of parcels.
-*   int     wgt     :   the partition weight of the parcel that all displayed parcels are lighter than.
-* RETURNS       :  void
-*/
-void printLighterParcelsInCountry(Parcel* table[], char* country, int wgt)
-{
-    int hash = generateHash(country);
-    printf("\n/====================== Lighter than %d gms ===================/\n\n", wgt);
-    printSectionLowerThanWgt(table[hash], wgt);
-    
+    // free dynamically allocated memory
+    freeOutBuf(&console);
+    stopFollow(&follow);
+    deleteDestTable(&destTable);
+    stopThreadPool();
+    releaseDestDictionary();
+	return 0;
 }
 
-/*
-* FUNCTION      : printHeavierParcelsInCountry
-* DESCRIPTION   :
-*   This functoin displays parcels that are heavier than a given weight being delivered to a given country 
-*   within the hash table. 
-* PARAMETERS    :
-*   Parcel* table[] :   a pointer to the hash table containing all parcels.
-*   char* country   :   a string representing the destination country of parcels.
-*   int     wgt     :   the partition weight of the parcel that all displayed parcels are heavier than.
-* RETURNS       :  void
-*/
-void printHeavierParcelsInCountry(Parcel* table[], char* country, int wgt)
-{
-    int hash = generateHash(country);
-    printf("\n/====================== Heavier than %d gms ==================/\n\n", wgt);
-    printSectionHigherThanWgt(table[hash], wgt);    
-}
 
-/*
-* FUNCTION      : printHeavierParcelsInCountry
-* DESCRIPTION   :
-*   This functoin displays the cheapest and the most expensive parcels to a given destination within the hash table  
-* PARAMETERS    :
-*   Parcel* table[] :   a pointer to the hash table containing all parcels.
-*   char* country   :   a string representing the destination country of parcels.
-* RETURNS       :  void
-*/
-void printCheapestAndMostExpensiveParcelInCountry(Parcel* table[], char* country)
-{
-    int hash = generateHash(country);
-    printf("\nThe Cheapest Parcel:\n");
-    printParcel(findCheapestParcel(table[hash]));
-    printf("\nThe Most Expensive Parcel:\n");
-    printParcel(findMostExpensiveParcel(table[hash]));
-}
 
 /*
 * FUNCTION      : validEnteredDestination
 * DESCRIPTION   :
-*   This functoin validates if an incoming country string exists in the hash table.
+*   This functoin validates if an incoming country string exists in the destination index. The match
+*   ignores case and stray blanks, and a matching entry is replaced by the destination's own spelling.
 * PARAMETERS    :
-*   Parcel* table[] :   a pointer to the hash table containing all parcels.
+*   DestTable* table    :   the destination index containing all parcels.
 *   char* country   :   a string representing the destination country of parcels.
 * RETURNS       :  
 *   bool    : true, if the given country exist in the hash table. otherwise,
 *             false.
 */
-bool validEnteredDestination(Parcel* table[], char* country)
+bool validEnteredDestination(DestTable* table, char* country)
 {
     bool retCode = true;
-    int hash = generateHash(country);
-    if (table[hash] == NULL || strcmp(country, table[hash]->Dest) != 0)
+    Destination* dest = getCountry(table, country);
+    if (dest == NULL || dest->Root == NULL)
     {
         retCode = false;
     }
+    else
+    {
+        memcpy(country, dest->Name, dest->NameLen + 1);     // never longer than the entry it matched
+    }
     return retCode;
 }
 
@@ -744,3 +612,32 @@ void clearNewLineChar(char* string)
         string[len - 1] = '\0';
     }
 }
+
+/*
+* FUNCTION      : printUsage
+* DESCRIPTION   : This functoin displays the command line options.
+* PARAMETERS    :
+*   const char* program :   the name the program was started with.
+* RETURNS       : void
+*/
+void printUsage(const char* program)
+{
+    printf("Usage: %s [--data FILE] [--snapshot FILE | --follow] [--batch FILE|- [--concurrent] | --serve PORT|PATH]\n", program);
+    printf("       %s --partition FILE [--partition FILE ...] [--compress] --batch FILE|-\n", program);
+    printf("       %*s [--format table|csv|json|binary] [--threads N]\n", (int)strlen(program), "");
+    printf("       %s --gen FILE [--rows N] [--countries N] [--skew S] [--order random|sorted|reverse] [--dups P] [--seed N]\n", program);
+    printf("       %s --bench [--data FILE] [--queries N] [--seed N] [--threads N]\n", program);
+    printf("  --data FILE     load parcels from FILE instead of couriers.txt\n");
+    printf("  --partition FILE load FILE as a partition of its own, oldest first; queries look across them\n");
+    printf("  --compress      pack the parcels of every partition into a few bytes each instead of tree nodes\n");
+    printf("  --snapshot FILE restore from FILE if it matches the data file, otherwise load and save it\n");
+    printf("  --follow        keep reading parcels appended to the data file (or pipe) while answering\n");
+    printf("  --batch FILE    answer the queries in FILE, or standard input for -, then exit\n");
+    printf("  --serve ADDR    answer queries from clients on a port of 127.0.0.1 or a Unix socket path\n");
+    printf("  --concurrent    answer batch queries in parallel from lock-free views, following in the background\n");
+    printf("  --gen FILE      write a synthetic courier file: N parcels (1000000) to N countries (200) picked with\n");
+    printf("                  Zipf skew S (1.0), weights in the given order, a share P of repeated lines (0)\n");
+    printf("  --bench         time loading the data file and N (%d) of each query, and report percentiles\n", BENCH_QUERY_COUNT);
+    printf("  --format F      write parcel rows as an aligned table, CSV, JSON lines or binary records\n");
+    printf("  --threads N     load and answer on N threads, 0 uses one per hardware thread\n");
+}
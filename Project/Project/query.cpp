@@ -0,0 +1,1416 @@
+/*
+* FILENAME      : query.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the per-country queries and the batch query language declared in query.h.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "query.h"
+#include "global.h"
+#include "partition.h"
+#include "threadPool.h"
+#include "metrics.h"
+
+#define QUERY_MAX_NUMBERS   4
+#define QUERY_BLOCK_SIZE    256     // queries read ahead by runConcurrentBatch
+#define QUERY_MAX_PAGE      1e15    // an offset or limit at least this large takes every row
+
+typedef enum QueryKind
+{
+    QUERY_LIST,
+    QUERY_SPLIT,
+    QUERY_HEAVIER,
+    QUERY_LIGHTER,
+    QUERY_RANGE,
+    QUERY_RANGESUM,
+    QUERY_TOTALS,
+    QUERY_MINMAX,
+    QUERY_CHEAPEST,
+    QUERY_VALUES,
+    QUERY_TOP,
+    QUERY_PERCENTILE,
+    QUERY_VALUESUM,
+    QUERY_REMOVE,
+    QUERY_UPDATE,
+    QUERY_METRICS,
+    QUERY_NETWORK,
+    QUERY_HEAVIEST,
+    QUERY_LIGHTEST,
+    QUERY_VALUABLE,
+    QUERY_RANKING,
+    QUERY_COMPLETE,
+    QUERY_PARTITIONS,
+    QUERY_EXPIRE,
+    QUERY_LOAD
+} QueryKind;
+
+typedef struct QueryCommand
+{
+    const char* Name;
+    QueryKind Kind;
+    int NumberCount;        // numeric arguments following the destination
+    unsigned int WholeArgs; // bit i is set when argument i must be a whole number
+    bool Writes;            // the command needs the master index: it changes it, or reports its shape
+    bool Global;            // the command looks at every destination and takes none
+    bool Partitioned;       // the command manages partitioned storage, see partition.h
+} QueryCommand;
+
+static const QueryCommand queryCommands[] =
+{
+    { "list",       QUERY_LIST,         0, 0x0, false, false, false },
+    { "split",      QUERY_SPLIT,        1, 0x1, false, false, false },
+    { "heavier",    QUERY_HEAVIER,      1, 0x1, false, false, false },
+    { "lighter",    QUERY_LIGHTER,      1, 0x1, false, false, false },
+    { "range",      QUERY_RANGE,        2, 0x3, false, false, false },
+    { "rangesum",   QUERY_RANGESUM,     2, 0x3, false, false, false },
+    { "totals",     QUERY_TOTALS,       0, 0x0, false, false, false },
+    { "minmax",     QUERY_MINMAX,       0, 0x0, false, false, false },
+    { "cheapest",   QUERY_CHEAPEST,     0, 0x0, false, false, false },
+    { "values",     QUERY_VALUES,       2, 0x0, false, false, false },
+    { "top",        QUERY_TOP,          1, 0x1, false, false, false },
+    { "percentile", QUERY_PERCENTILE,   1, 0x0, false, false, false },
+    { "valuesum",   QUERY_VALUESUM,     2, 0x0, false, false, false },
+    { "remove",     QUERY_REMOVE,       2, 0x1, true, false, false },
+    { "update",     QUERY_UPDATE,       4, 0x5, true, false, false },
+    { "metrics",    QUERY_METRICS,      0, 0x0, true, false, false },
+    { "network",    QUERY_NETWORK,      0, 0x0, false, true, false },
+    { "heaviest",   QUERY_HEAVIEST,     1, 0x1, false, true, false },
+    { "lightest",   QUERY_LIGHTEST,     1, 0x1, false, true, false },
+    { "valuable",   QUERY_VALUABLE,     1, 0x1, false, true, false },
+    { "ranking",    QUERY_RANKING,      1, 0x1, false, true, false },
+    { "complete",   QUERY_COMPLETE,     0, 0x0, false, false, false },
+    { "partitions", QUERY_PARTITIONS,   0, 0x0, true, true, true },
+    { "expire",     QUERY_EXPIRE,       1, 0x1, true, true, true },
+    { "load",       QUERY_LOAD,         0, 0x0, true, false, true },
+};
+
+// a line of the query language taken apart by parseQuery
+typedef struct ParsedQuery
+{
+    const QueryCommand* Command;
+    double Numbers[QUERY_MAX_NUMBERS];
+    char Country[QUERY_LINE_SIZE];  // the destination, or the rest of the line for metrics, complete and load
+    size_t Recent;                  // how many of the newest partitions the query looks at, see partition.h
+} ParsedQuery;
+
+typedef enum ParseStatus
+{
+    PARSE_QUERY,
+    PARSE_IGNORED,      // a blank line or a comment
+    PARSE_MALFORMED
+} ParseStatus;
+
+// a block of queries answered by runConcurrentBatch
+typedef struct QueryBlock
+{
+    ConcurrentIndex* Index;
+    char (*Lines)[QUERY_LINE_SIZE];
+    OutBuf* Results;        // the answer to each query
+    bool* Succeeded;        // whether each query was well formed
+    size_t First;           // the first query of the run being answered in parallel
+} QueryBlock;
+
+static const QueryCommand* findQueryCommand(const char* start, const char* end);
+static bool answerQuery(DestTable* table, const char* line, OutBuf* out);
+static bool answerPartitionQuery(PartitionSet* set, const char* line, OutBuf* out);
+static ParseStatus parseQuery(const char* line, OutBuf* out, ParsedQuery* query);
+static bool checkQueryNumbers(const ParsedQuery* query, OutBuf* out);
+static bool answerMetrics(OutBuf* out, const DestTable* table, const char* format);
+static bool parseQueryOptions(const char* start, const char** end, OutBuf* out, size_t* recent);
+static bool isWord(const char* start, const char* end, const char* word);
+static void runReadQuery(void* context, int taskIndex, int workerIndex);
+static bool parseNumber(const char* start, const char* end, double* number);
+static bool isWholeNumber(double number);
+
+/*
+* FUNCTION      : getCountryTree
+* DESCRIPTION   :
+*   This functoin returns the BST of parcels being delivered to a given country.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+* RETURNS       :
+*   Parcel*     : the root of the country's BST, or NULL if the country is unknown.
+*/
+Parcel* getCountryTree(DestTable* table, const char* country)
+{
+    Destination* dest = getCountry(table, country);
+    return dest == NULL ? NULL : dest->Root;
+}
+
+/*
+* FUNCTION      : getCountry
+* DESCRIPTION   :
+*   This functoin returns the Destination record, with its tree and summary, of a given country.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+* RETURNS       :
+*   Destination*    : the country's record, or NULL if the country is unknown.
+*/
+Destination* getCountry(DestTable* table, const char* country)
+{
+    return findDestination(table, country, strlen(country));
+}
+/*
+* FUNCTION      : printTotalParcelWgtAndValForCountry
+* DESCRIPTION   :
+*   This functoin displays total weight and total value of parcels to a given destination (a country).
+*   within the hash table. Both come straight from the destination's summary; the value is kept in
+*   whole cents, so it is printed without going through floating point.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+* RETURNS       :  void
+*/
+void printTotalParcelWgtAndValForCountry(OutBuf* out, DestTable* table, const char* country)
+{
+    METRIC_START(queryTimer);
+    DestSummary* summary = &getCountry(table, country)->Summary;
+    outPrintf(out, "\nDestination:\t%10s\t Total Weight: %8lld gms\t Total: $%7lld.%02lld\n", 
+        country, (long long)summary->TotalWeight, (long long)(summary->TotalCents / 100),
+        (long long)(summary->TotalCents % 100));
+    METRIC_STOP_QUERY("totals", queryTimer);
+}
+
+/*
+* FUNCTION      : printLighterParcelsInCountry
+* DESCRIPTION   :
+*   This functoin displays parcels that are lighter than a given weight being delivered to a given country.
+*   within the hash table, as the leading rows of the destination's weight-sorted columns
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+*   int     wgt     :   the partition weight of the parcel that all displayed parcels are lighter than.
+* RETURNS       :  void
+*/
+void printLighterParcelsInCountry(OutBuf* out, DestTable* table, const char* country, int wgt)
+{
+    METRIC_START(queryTimer);
+    outLabel(out, "\n/====================== Lighter than %d gms ===================/\n\n", wgt);
+    ParcelColumns* columns = getDestColumns(getCountry(table, country));
+    printColumnRows(out, columns, 0, lowerBoundWeight(columns, wgt));
+    METRIC_STOP_QUERY("lighter", queryTimer);
+}
+
+/*
+* FUNCTION      : printHeavierParcelsInCountry
+* DESCRIPTION   :
+*   This functoin displays parcels that are heavier than a given weight being delivered to a given country 
+*   within the hash table, as the trailing rows of the destination's weight-sorted columns.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+*   int     wgt     :   the partition weight of the parcel that all displayed parcels are heavier than.
+* RETURNS       :  void
+*/
+void printHeavierParcelsInCountry(OutBuf* out, DestTable* table, const char* country, int wgt)
+{
+    METRIC_START(queryTimer);
+    outLabel(out, "\n/====================== Heavier than %d gms ==================/\n\n", wgt);
+    ParcelColumns* columns = getDestColumns(getCountry(table, country));
+    printColumnRows(out, columns, upperBoundWeight(columns, wgt), columns->Count);
+    METRIC_STOP_QUERY("heavier", queryTimer);
+}
+
+/*
+* FUNCTION      : printCheapestAndMostExpensiveParcelInCountry
+* DESCRIPTION   :
+*   This functoin displays the cheapest and the most expensive parcels to a given destination within the hash table  
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+* RETURNS       :  void
+*/
+void printCheapestAndMostExpensiveParcelInCountry(OutBuf* out, DestTable* table, const char* country)
+{
+    METRIC_START(queryTimer);
+    DestSummary* summary = &getCountry(table, country)->Summary;
+    outLabel(out, "\nThe Cheapest Parcel:\n");
+    printParcel(out, summary->Cheapest);
+    outLabel(out, "\nThe Most Expensive Parcel:\n");
+    printParcel(out, summary->MostExpensive);
+    METRIC_STOP_QUERY("cheapest", queryTimer);
+}
+
+/*
+* FUNCTION      : printParcelsWithinValueInCountry
+* DESCRIPTION   :
+*   This functoin displays, cheapest first, the parcels to a given destination whose value lies within
+*   an inclusive range, using the destination's value index.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+*   int64_t minCents    :   the lowest value to be displayed, in cents.
+*   int64_t maxCents    :   the highest value to be displayed, in cents.
+* RETURNS       :  void
+*/
+void printParcelsWithinValueInCountry(OutBuf* out, DestTable* table, const char* country, int64_t minCents, int64_t maxCents)
+{
+    METRIC_START(queryTimer);
+    outLabel(out, "\n/================ Valued from $%lld.%02lld to $%lld.%02lld ================/\n\n",
+        (long long)(minCents / 100), (long long)(minCents % 100), (long long)(maxCents / 100), (long long)(maxCents % 100));
+    printSectionBetweenValues(out, getCountry(table, country)->ValueRoot, minCents, maxCents);
+    METRIC_STOP_QUERY("values", queryTimer);
+}
+
+/*
+* FUNCTION      : printMostValuableParcelsInCountry
+* DESCRIPTION   :
+*   This functoin displays, most valuable first, up to a given number of parcels to a given destination,
+*   using the destination's value index.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+*   int count           :   the most parcels to display.
+* RETURNS       :  void
+*/
+void printMostValuableParcelsInCountry(OutBuf* out, DestTable* table, const char* country, int count)
+{
+    METRIC_START(queryTimer);
+    outLabel(out, "\n/================ %d Most Valuable Parcels ================/\n\n", count);
+    printMostValuableParcels(out, getCountry(table, country)->ValueRoot, count);
+    METRIC_STOP_QUERY("top", queryTimer);
+}
+
+/*
+* FUNCTION      : printWeightRangeTotalsInCountry
+* DESCRIPTION   :
+*   This functoin displays how many parcels to a given destination weigh within an inclusive range,
+*   with their total weight and value, from the weight tree's subtree totals.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+*   int minWgt          :   the lowest weight of the range.
+*   int maxWgt          :   the highest weight of the range.
+* RETURNS       :  void
+*/
+void printWeightRangeTotalsInCountry(OutBuf* out, DestTable* table, const char* country, int minWgt, int maxWgt)
+{
+    METRIC_START(queryTimer);
+    RangeTotals totals;
+    sumOfWeightRange(getCountryTree(table, country), minWgt, maxWgt, &totals);
+    outPrintf(out, "\nDestination:\t%10s\t Weight: %d-%d gms\t Parcels: %lld\t Total Weight: %8lld gms\t Total: $%7lld.%02lld\n",
+        country, minWgt, maxWgt, (long long)totals.Count, (long long)totals.TotalWeight,
+        (long long)(totals.TotalCents / 100), (long long)(totals.TotalCents % 100));
+    METRIC_STOP_QUERY("rangesum", queryTimer);
+}
+
+/*
+* FUNCTION      : printValueRangeTotalsInCountry
+* DESCRIPTION   :
+*   This functoin displays how many parcels to a given destination are valued within an inclusive range,
+*   with their total weight and value and the lowest and highest value among them. The value index has
+*   no subtree totals, so the answer comes from a vectorized scan of the destination's columns.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+*   int64_t minCents    :   the lowest value of the range, in cents.
+*   int64_t maxCents    :   the highest value of the range, in cents.
+* RETURNS       :  void
+*/
+void printValueRangeTotalsInCountry(OutBuf* out, DestTable* table, const char* country, int64_t minCents, int64_t maxCents)
+{
+    METRIC_START(queryTimer);
+    ColumnTotals totals;
+    ParcelColumns* columns = getDestColumns(getCountry(table, country));
+    scanValueRange(columns, 0, columns->Count, minCents, maxCents, &totals);
+    outPrintf(out, "\nDestination:\t%10s\t Value: $%.2f-$%.2f\t Parcels: %lld\t Total Weight: %8lld gms\t Total: $%7lld.%02lld\n",
+        country, minCents / 100.0, maxCents / 100.0, (long long)totals.Count, (long long)totals.TotalWeight,
+        (long long)(totals.TotalCents / 100), (long long)(totals.TotalCents % 100));
+    if (totals.Count > 0)
+    {
+        outPrintf(out, "Lowest Value: $%.2f\t Highest Value: $%.2f\n", totals.MinCents / 100.0, totals.MaxCents / 100.0);
+    }
+    METRIC_STOP_QUERY("valuesum", queryTimer);
+}
+
+/*
+* FUNCTION      : printWeightPercentileInCountry
+* DESCRIPTION   :
+*   This functoin displays the parcel at a given weight percentile of a destination, with its rank.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+*   double percentile   :   the percentile, from 0 to 100.
+* RETURNS       :  void
+*/
+void printWeightPercentileInCountry(OutBuf* out, DestTable* table, const char* country, double percentile)
+{
+    METRIC_START(queryTimer);
+    Parcel* root = getCountryTree(table, country);
+    Parcel* parcel = findWeightPercentile(root, percentile);
+    if (parcel != NULL)
+    {
+        outLabel(out, "\nThe %.1fth Percentile Parcel (%lld lighter of %d):\n", percentile,
+            (long long)rankOfWeight(root, parcel->Weight), root->Count);
+        printParcel(out, parcel);
+    }
+    METRIC_STOP_QUERY("percentile", queryTimer);
+}
+
+/*
+* FUNCTION      : printAllParcelsInCountry
+* DESCRIPTION   :
+*   This functoin displays all the parcels being delivered to a given country, lightest first.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+* RETURNS       :  void
+*/
+void printAllParcelsInCountry(OutBuf* out, DestTable* table, const char* country)
+{
+    METRIC_START(queryTimer);
+    printBSTInOrder(out, getCountryTree(table, country));
+    METRIC_STOP_QUERY("list", queryTimer);
+}
+
+/*
+* FUNCTION      : printParcelsBetweenWeightsInCountry
+* DESCRIPTION   :
+*   This functoin displays, lightest first, the parcels to a given destination whose weight lies within
+*   an inclusive range.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+*   int minWgt          :   the lowest weight to be displayed.
+*   int maxWgt          :   the highest weight to be displayed.
+* RETURNS       :  void
+*/
+void printParcelsBetweenWeightsInCountry(OutBuf* out, DestTable* table, const char* country, int minWgt, int maxWgt)
+{
+    METRIC_START(queryTimer);
+    outLabel(out, "\n/================ Weighing from %d to %d gms ================/\n\n", minWgt, maxWgt);
+    ParcelColumns* columns = getDestColumns(getCountry(table, country));
+    size_t begin = lowerBoundWeight(columns, minWgt);
+    size_t end = upperBoundWeight(columns, maxWgt);
+    if (begin < end)
+    {
+        printColumnRows(out, columns, begin, end);
+    }
+    METRIC_STOP_QUERY("range", queryTimer);
+}
+
+/*
+* FUNCTION      : printLightestAndHeaviestParcelInCountry
+* DESCRIPTION   :
+*   This functoin displays the lightest and the heaviest parcels to a given destination.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+* RETURNS       :  void
+*/
+void printLightestAndHeaviestParcelInCountry(OutBuf* out, DestTable* table, const char* country)
+{
+    METRIC_START(queryTimer);
+    DestSummary* summary = &getCountry(table, country)->Summary;
+    outLabel(out, "\nThe Lightest Parcel:\n");
+    printParcel(out, summary->Lightest);
+    outLabel(out, "\nThe Heaviest Parcel:\n");
+    printParcel(out, summary->Heaviest);
+    METRIC_STOP_QUERY("minmax", queryTimer);
+}
+
+/*
+* FUNCTION      : removeParcelInCountry
+* DESCRIPTION   :
+*   This functoin removes the first-arrived parcel of a given weight and value from a destination, for
+*   a parcel that has been delivered or cancelled, and displays it.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+*   int wgt             :   the weight of the parcel.
+*   int64_t cents       :   the value of the parcel, in cents.
+* RETURNS       :
+*   bool    : true, if a parcel was removed. otherwise, false.
+*/
+bool removeParcelInCountry(OutBuf* out, DestTable* table, const char* country, int wgt, int64_t cents)
+{
+    METRIC_START(queryTimer);
+    Destination* dest = getCountry(table, country);
+    Parcel* parcel = findParcelByWeightAndValue(dest->Root, wgt, cents);
+    if (parcel == NULL)
+    {
+        outPrintf(out, "No Matching Parcel!\n");
+        METRIC_STOP_QUERY("remove", queryTimer);
+        return false;
+    }
+    outLabel(out, "\nRemoved Parcel:\n");
+    printParcel(out, parcel);
+    deleteParcel(table, dest, parcel);
+    METRIC_STOP_QUERY("remove", queryTimer);
+    return true;
+}
+
+/*
+* FUNCTION      : updateParcelInCountry
+* DESCRIPTION   :
+*   This functoin gives the first-arrived parcel of a given weight and value a new weight and value,
+*   for a parcel that has been re-weighed or re-valued, and displays it.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* country :   a string representing the destination country of parcels.
+*   int wgt             :   the current weight of the parcel.
+*   int64_t cents       :   the current value of the parcel, in cents.
+*   int newWgt          :   the new weight.
+*   int64_t newCents    :   the new value, in cents.
+* RETURNS       :
+*   bool    : true, if a parcel was updated. otherwise, false.
+*/
+bool updateParcelInCountry(OutBuf* out, DestTable* table, const char* country, int wgt, int64_t cents, int newWgt, int64_t newCents)
+{
+    METRIC_START(queryTimer);
+    Destination* dest = getCountry(table, country);
+    Parcel* parcel = findParcelByWeightAndValue(dest->Root, wgt, cents);
+    if (parcel == NULL)
+    {
+        outPrintf(out, "No Matching Parcel!\n");
+        METRIC_STOP_QUERY("update", queryTimer);
+        return false;
+    }
+    updateParcelInDestination(dest, parcel, newWgt, newCents);
+    outLabel(out, "\nUpdated Parcel:\n");
+    printParcel(out, parcel);
+    METRIC_STOP_QUERY("update", queryTimer);
+    return true;
+}
+
+/*
+* FUNCTION      : printDestinationsStartingWith
+* DESCRIPTION   :
+*   This functoin displays every destination whose name starts with a prefix, in alphabetical order,
+*   with the number of parcels each has in the index. The names come from the destination dictionary,
+*   so a destination known only from countries.txt is listed with no parcels. Case and stray blanks
+*   in the prefix are ignored, as they are everywhere a destination is looked up.
+* PARAMETERS    :
+*   OutBuf* out         :   the buffer receiving the output.
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* prefix  :   the start of the names, an empty prefix lists every destination.
+* RETURNS       :  void
+*/
+void printDestinationsStartingWith(OutBuf* out, DestTable* table, const char* prefix)
+{
+    METRIC_START(queryTimer);
+    size_t count = 0;
+    DestId* ids = completeDestName(prefix, strlen(prefix), &count);
+
+    outLabel(out, "\n/================ Destinations Starting with %s ================/\n\n", prefix);
+    for (size_t i = 0; i < count && !outPageFull(out); ++i)
+    {
+        Destination* dest = findDestination(table, getDestName(ids[i]), getDestNameLen(ids[i]));
+        if (outTakeRow(out))
+        {
+            outPrintf(out, "Destination:\t%10s\t Parcels: %lld\n", getDestName(ids[i]),
+                (long long)(dest == NULL ? 0 : dest->Summary.Count));
+        }
+    }
+    free(ids);
+    METRIC_STOP_QUERY("complete", queryTimer);
+}
+
+/*
+* FUNCTION      : executeQuery
+* DESCRIPTION   :
+*   This functoin parses one line of the query language and writes its result. The line is echoed
+*   first, prefixed by "> ", so results can be matched to their queries. The destination is whatever
+*   lies between the command and its numeric arguments, which are taken from the end of the line.
+*   A line may end with options for this query alone: "format table|csv|json|binary" picks the row
+*   format, and "offset N" and "limit N" page the rows of the answer.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* line    :   the query, a trailing newline is ignored.
+*   OutBuf* out         :   the buffer receiving the output.
+* RETURNS       :
+*   bool    : true, if the line was a query or was ignored. false, if it was malformed.
+*/
+bool executeQuery(DestTable* table, const char* line, OutBuf* out)
+{
+    OutFormat format = out->Format;
+    bool answered = answerQuery(table, line, out);
+    out->Format = format;
+    setOutPage(out, 0, OUT_NO_LIMIT);
+    return answered;
+}
+
+/*
+* FUNCTION      : answerQuery
+* DESCRIPTION   :
+*   This functoin is executeQuery without restoring the buffer's format and page afterwards.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index containing all parcels.
+*   const char* line    :   the query, a trailing newline is ignored.
+*   OutBuf* out         :   the buffer receiving the output.
+* RETURNS       :
+*   bool    : true, if the line was a query or was ignored. false, if it was malformed.
+*/
+static bool answerQuery(DestTable* table, const char* line, OutBuf* out)
+{
+    ParsedQuery query;
+    ParseStatus status = parseQuery(line, out, &query);
+    if (status != PARSE_QUERY)
+    {
+        return status == PARSE_IGNORED;
+    }
+    const QueryCommand* command = query.Command;
+    const double* numbers = query.Numbers;
+    char* country = query.Country;
+
+    if (command->Partitioned || query.Recent != PARTITION_ALL)
+    {
+        outPrintf(out, "**Invalid query: %s needs partitioned storage, see --partition\n",
+            command->Partitioned ? command->Name : "last");
+        return false;
+    }
+    if (command->Kind == QUERY_METRICS)
+    {
+        return answerMetrics(out, table, country);
+    }
+    if (command->Kind == QUERY_COMPLETE)
+    {
+        printDestinationsStartingWith(out, table, country);
+        return true;
+    }
+    if (!command->Global)
+    {
+        Destination* dest = getCountry(table, country);
+        if (dest == NULL || dest->Root == NULL)
+        {
+            outPrintf(out, "Not an Existing Destination!\n");
+            return true;
+        }
+        // from here on the destination goes by its own spelling, which is never longer than the match
+        memcpy(country, dest->Name, dest->NameLen + 1);
+    }
+    if (!checkQueryNumbers(&query, out))
+    {
+        return false;
+    }
+
+    switch (command->Kind)
+    {
+    case QUERY_LIST:
+        printAllParcelsInCountry(out, table, country);
+        break;
+    case QUERY_SPLIT:
+        printHeavierParcelsInCountry(out, table, country, (int)numbers[0]);
+        printLighterParcelsInCountry(out, table, country, (int)numbers[0]);
+        break;
+    case QUERY_HEAVIER:
+        printHeavierParcelsInCountry(out, table, country, (int)numbers[0]);
+        break;
+    case QUERY_LIGHTER:
+        printLighterParcelsInCountry(out, table, country, (int)numbers[0]);
+        break;
+    case QUERY_RANGE:
+        printParcelsBetweenWeightsInCountry(out, table, country, (int)numbers[0], (int)numbers[1]);
+        break;
+    case QUERY_RANGESUM:
+        printWeightRangeTotalsInCountry(out, table, country, (int)numbers[0], (int)numbers[1]);
+        break;
+    case QUERY_TOTALS:
+        printTotalParcelWgtAndValForCountry(out, table, country);
+        break;
+    case QUERY_MINMAX:
+        printLightestAndHeaviestParcelInCountry(out, table, country);
+        break;
+    case QUERY_CHEAPEST:
+        printCheapestAndMostExpensiveParcelInCountry(out, table, country);
+        break;
+    case QUERY_VALUES:
+        printParcelsWithinValueInCountry(out, table, country, dollarsToCents(numbers[0]), dollarsToCents(numbers[1]));
+        break;
+    case QUERY_TOP:
+        printMostValuableParcelsInCountry(out, table, country, (int)numbers[0]);
+        break;
+    case QUERY_PERCENTILE:
+        printWeightPercentileInCountry(out, table, country, numbers[0]);
+        break;
+    case QUERY_VALUESUM:
+        printValueRangeTotalsInCountry(out, table, country, dollarsToCents(numbers[0]), dollarsToCents(numbers[1]));
+        break;
+    case QUERY_REMOVE:
+        removeParcelInCountry(out, table, country, (int)numbers[0], dollarsToCents(numbers[1]));
+        break;
+    case QUERY_UPDATE:
+        updateParcelInCountry(out, table, country, (int)numbers[0], dollarsToCents(numbers[1]),
+            (int)numbers[2], dollarsToCents(numbers[3]));
+        break;
+    case QUERY_METRICS:
+    case QUERY_COMPLETE:
+    case QUERY_PARTITIONS:
+    case QUERY_EXPIRE:
+    case QUERY_LOAD:
+        break;      // answered before the destination is looked up
+    case QUERY_NETWORK:
+        printNetworkTotals(out, &table, 1);
+        break;
+    case QUERY_HEAVIEST:
+        printTopParcelsAnywhere(out, &table, 1, GLOBAL_HEAVIEST, (int)numbers[0]);
+        break;
+    case QUERY_LIGHTEST:
+        printTopParcelsAnywhere(out, &table, 1, GLOBAL_LIGHTEST, (int)numbers[0]);
+        break;
+    case QUERY_VALUABLE:
+        printTopParcelsAnywhere(out, &table, 1, GLOBAL_MOST_VALUABLE, (int)numbers[0]);
+        break;
+    case QUERY_RANKING:
+        printDestinationRanking(out, &table, 1, (int)numbers[0]);
+        break;
+    }
+    return true;
+}
+
+/*
+* FUNCTION      : executePartitionQuery
+* DESCRIPTION   :
+*   This functoin is executeQuery for partitioned storage. A query looks at every partition, or at
+*   the newest n only when it ends with "last n"; "load", "partitions" and "expire" manage the
+*   partitions themselves. Partitions are never changed once loaded, so remove and update are refused.
+* PARAMETERS    :
+*   PartitionSet* set   :   the partitions.
+*   const char* line    :   the query, a trailing newline is ignored.
+*   OutBuf* out         :   the buffer receiving the output.
+* RETURNS       :
+*   bool    : true, if the line was a query or was ignored. false, if it was malformed.
+*/
+bool executePartitionQuery(PartitionSet* set, const char* line, OutBuf* out)
+{
+    OutFormat format = out->Format;
+    bool answered = answerPartitionQuery(set, line, out);
+    out->Format = format;
+    setOutPage(out, 0, OUT_NO_LIMIT);
+    return answered;
+}
+
+/*
+* FUNCTION      : answerPartitionQuery
+* DESCRIPTION   :
+*   This functoin is executePartitionQuery without restoring the buffer's format and page afterwards.
+* PARAMETERS    :
+*   PartitionSet* set   :   the partitions.
+*   const char* line    :   the query, a trailing newline is ignored.
+*   OutBuf* out         :   the buffer receiving the output.
+* RETURNS       :
+*   bool    : true, if the line was a query or was ignored. false, if it was malformed.
+*/
+static bool answerPartitionQuery(PartitionSet* set, const char* line, OutBuf* out)
+{
+    ParsedQuery query;
+    ParseStatus status = parseQuery(line, out, &query);
+    if (status != PARSE_QUERY)
+    {
+        return status == PARSE_IGNORED;
+    }
+    const QueryCommand* command = query.Command;
+    const double* numbers = query.Numbers;
+    char* country = query.Country;
+    size_t recent = query.Recent;
+
+    if (command->Kind == QUERY_REMOVE || command->Kind == QUERY_UPDATE)
+    {
+        outPrintf(out, "**Invalid query: partitions are never changed once loaded, so %s is not available\n", command->Name);
+        return false;
+    }
+    if (command->Kind == QUERY_METRICS)
+    {
+        static const DestTable noPartition = {};
+        return answerMetrics(out, set->Newest == NULL ? &noPartition : &set->Newest->Table, country);
+    }
+    if (command->Kind == QUERY_COMPLETE)
+    {
+        printDestinationsStartingWithInPartitions(out, set, recent, country);
+        return true;
+    }
+    if (command->Kind == QUERY_LOAD)
+    {
+        if (country[0] == '\0')
+        {
+            outPrintf(out, "**Invalid query: load expects a courier file\n");
+            return false;
+        }
+        loadPartition(out, set, country);
+        return true;
+    }
+    if (!command->Global)
+    {
+        const char* name = findCountryInPartitions(set, recent, country);
+        if (name == NULL)
+        {
+            outPrintf(out, "Not an Existing Destination!\n");
+            return true;
+        }
+        memcpy(country, name, strlen(name) + 1);
+    }
+    if (!checkQueryNumbers(&query, out))
+    {
+        return false;
+    }
+
+    size_t tableCount = 0;
+    DestTable** tables = NULL;
+    switch (command->Kind)
+    {
+    case QUERY_LIST:
+        printAllParcelsInPartitions(out, set, recent, country);
+        break;
+    case QUERY_SPLIT:
+        printHeavierParcelsInPartitions(out, set, recent, country, (int)numbers[0]);
+        printLighterParcelsInPartitions(out, set, recent, country, (int)numbers[0]);
+        break;
+    case QUERY_HEAVIER:
+        printHeavierParcelsInPartitions(out, set, recent, country, (int)numbers[0]);
+        break;
+    case QUERY_LIGHTER:
+        printLighterParcelsInPartitions(out, set, recent, country, (int)numbers[0]);
+        break;
+    case QUERY_RANGE:
+        printParcelsBetweenWeightsInPartitions(out, set, recent, country, (int)numbers[0], (int)numbers[1]);
+        break;
+    case QUERY_RANGESUM:
+        printWeightRangeTotalsInPartitions(out, set, recent, country, (int)numbers[0], (int)numbers[1]);
+        break;
+    case QUERY_TOTALS:
+        printTotalsInPartitions(out, set, recent, country);
+        break;
+    case QUERY_MINMAX:
+        printLightestAndHeaviestParcelInPartitions(out, set, recent, country);
+        break;
+    case QUERY_CHEAPEST:
+        printCheapestAndMostExpensiveParcelInPartitions(out, set, recent, country);
+        break;
+    case QUERY_VALUES:
+        printParcelsWithinValueInPartitions(out, set, recent, country, dollarsToCents(numbers[0]), dollarsToCents(numbers[1]));
+        break;
+    case QUERY_TOP:
+        printMostValuableParcelsInPartitions(out, set, recent, country, (int)numbers[0]);
+        break;
+    case QUERY_PERCENTILE:
+        printWeightPercentileInPartitions(out, set, recent, country, numbers[0]);
+        break;
+    case QUERY_VALUESUM:
+        printValueRangeTotalsInPartitions(out, set, recent, country, dollarsToCents(numbers[0]), dollarsToCents(numbers[1]));
+        break;
+    case QUERY_PARTITIONS:
+        printPartitionList(out, set);
+        break;
+    case QUERY_EXPIRE:
+        expireOldestPartitions(out, set, (int)numbers[0]);
+        break;
+    case QUERY_REMOVE:
+    case QUERY_UPDATE:
+    case QUERY_METRICS:
+    case QUERY_COMPLETE:
+    case QUERY_LOAD:
+        break;      // answered before the destination is looked up
+    case QUERY_NETWORK:
+    case QUERY_HEAVIEST:
+    case QUERY_LIGHTEST:
+    case QUERY_VALUABLE:
+    case QUERY_RANKING:
+        tables = collectPartitionTables(set, recent, &tableCount);
+        if (command->Kind == QUERY_NETWORK)
+        {
+            printNetworkTotals(out, tables, tableCount);
+        }
+        else if (command->Kind == QUERY_RANKING)
+        {
+            printDestinationRanking(out, tables, tableCount, (int)numbers[0]);
+        }
+        else
+        {
+            printTopParcelsAnywhere(out, tables, tableCount, command->Kind == QUERY_HEAVIEST ? GLOBAL_HEAVIEST :
+                command->Kind == QUERY_LIGHTEST ? GLOBAL_LIGHTEST : GLOBAL_MOST_VALUABLE, (int)numbers[0]);
+        }
+        free(tables);
+        break;
+    }
+    return true;
+}
+
+/*
+* FUNCTION      : parseQuery
+* DESCRIPTION   :
+*   This functoin takes one line of the query language apart and echoes it, prefixed by "> ". The
+*   destination is whatever lies between the command and its numeric arguments, which are taken from
+*   the end of the line; for metrics, complete and load the rest of the line is kept as it is. The
+*   numbers are only parsed here, checkQueryNumbers tells whether they suit the command.
+* PARAMETERS    :
+*   const char* line        :   the query, a trailing newline is ignored.
+*   OutBuf* out             :   the buffer receiving the echo and any complaint, its format and page are set.
+*   ParsedQuery* query      :   receives the parts of the query.
+* RETURNS       :
+*   ParseStatus : PARSE_QUERY for a query, PARSE_IGNORED for a blank line or a comment and PARSE_MALFORMED otherwise.
+*/
+static ParseStatus parseQuery(const char* line, OutBuf* out, ParsedQuery* query)
+{
+    const char* start = line;
+    const char* end = line + strlen(line);
+
+    memset(query->Numbers, 0, sizeof query->Numbers);
+    query->Country[0] = '\0';
+    while (start < end && isspace((unsigned char)*start))
+    {
+        start++;
+    }
+    while (end > start && isspace((unsigned char)end[-1]))
+    {
+        end--;
+    }
+    if (start == end || *start == '#')
+    {
+        return PARSE_IGNORED;
+    }
+    const char* lineEnd = end;
+    bool optionsValid = parseQueryOptions(start, &end, out, &query->Recent);
+    outLabel(out, "> %.*s\n", (int)(lineEnd - start), start);
+    if (!optionsValid)
+    {
+        outPrintf(out, "**Invalid query: offset, limit and last expect whole numbers, format expects table, csv, json or binary\n");
+        return PARSE_MALFORMED;
+    }
+
+    // command
+    const char* word = start;
+    while (word < end && !isspace((unsigned char)*word))
+    {
+        word++;
+    }
+    const QueryCommand* command = findQueryCommand(start, word);
+    query->Command = command;
+    if (command == NULL)
+    {
+        outPrintf(out, "**Unknown query command: %.*s\n", (int)(word - start), start);
+        return PARSE_MALFORMED;
+    }
+    if (command->Kind == QUERY_METRICS || command->Kind == QUERY_COMPLETE || command->Kind == QUERY_LOAD)
+    {
+        // the rest of the line is a format, the start of a name or a path rather than a destination
+        while (word < end && isspace((unsigned char)*word))
+        {
+            word++;
+        }
+        memcpy(query->Country, word, (size_t)(end - word));
+        query->Country[end - word] = '\0';
+        return PARSE_QUERY;
+    }
+
+    // numeric arguments, last one first
+    for (int i = command->NumberCount - 1; i >= 0; --i)
+    {
+        const char* numberEnd = end;
+        while (end > word && !isspace((unsigned char)end[-1]))
+        {
+            end--;
+        }
+        if (!parseNumber(end, numberEnd, &query->Numbers[i]))
+        {
+            outPrintf(out, command->Global ? "**Invalid query: %s expects %d number(s)\n" :
+                "**Invalid query: %s expects a destination and %d number(s)\n", command->Name, command->NumberCount);
+            return PARSE_MALFORMED;
+        }
+        while (end > word && isspace((unsigned char)end[-1]))
+        {
+            end--;
+        }
+    }
+
+    // destination
+    while (word < end && isspace((unsigned char)*word))
+    {
+        word++;
+    }
+    if (command->Global)
+    {
+        if (word != end)
+        {
+            outPrintf(out, "**Invalid query: %s looks at every destination and takes none\n", command->Name);
+            return PARSE_MALFORMED;
+        }
+    }
+    else
+    {
+        if (word == end)
+        {
+            outPrintf(out, "**Invalid query: %s expects a destination\n", command->Name);
+            return PARSE_MALFORMED;
+        }
+        memcpy(query->Country, word, (size_t)(end - word));
+        query->Country[end - word] = '\0';
+    }
+    return PARSE_QUERY;
+}
+
+/*
+* FUNCTION      : checkQueryNumbers
+* DESCRIPTION   :
+*   This functoin tells whether the numeric arguments of a parsed query suit its command, and says why
+*   not when they do not. It runs once the destination is known to exist.
+* PARAMETERS    :
+*   const ParsedQuery* query    :   the query.
+*   OutBuf* out                 :   the buffer receiving any complaint.
+* RETURNS       :
+*   bool    : true, if the numbers are valid. otherwise, false.
+*/
+static bool checkQueryNumbers(const ParsedQuery* query, OutBuf* out)
+{
+    const QueryCommand* command = query->Command;
+    for (int i = 0; i < command->NumberCount; ++i)
+    {
+        if ((command->WholeArgs & (1u << i)) != 0 && !isWholeNumber(query->Numbers[i]))
+        {
+            outPrintf(out, "**Invalid query: %s expects whole numbers of grams\n", command->Name);
+            return false;
+        }
+    }
+    if (command->Kind == QUERY_PERCENTILE && (query->Numbers[0] < 0.0 || query->Numbers[0] > 100.0))
+    {
+        outPrintf(out, "**Invalid query: percentile must be between 0 and 100\n");
+        return false;
+    }
+    if (command->Kind == QUERY_UPDATE && (query->Numbers[2] < 0.0 || query->Numbers[3] < 0.0))
+    {
+        outPrintf(out, "**Invalid query: a parcel cannot have a negative weight or value\n");
+        return false;
+    }
+    return true;
+}
+
+/*
+* FUNCTION      : answerMetrics
+* DESCRIPTION   : This functoin answers a metrics query in the format named after the command.
+* PARAMETERS    :
+*   OutBuf* out                 :   the buffer receiving the metrics.
+*   const DestTable* table      :   the index whose destinations are described.
+*   const char* format          :   the rest of the query, empty for the default format.
+* RETURNS       :
+*   bool    : true, if the format was valid. otherwise, false.
+*/
+static bool answerMetrics(OutBuf* out, const DestTable* table, const char* format)
+{
+    MetricFormat metricFormat = METRIC_FORMAT_PROMETHEUS;
+    if (format[0] != '\0' && !parseMetricFormat(format, &metricFormat))
+    {
+        outPrintf(out, "**Invalid query: metrics expects prometheus or json\n");
+        return false;
+    }
+    writeMetrics(out, table, metricFormat);
+    return true;
+}
+
+/*
+* FUNCTION      : runBatchQueries
+* DESCRIPTION   :
+*   This functoin runs every query read from a stream against the loaded destination index. Lines
+*   longer than QUERY_LINE_SIZE are reported and skipped. When a file is being followed, the lines
+*   appended to it are inserted before each query and each answer is flushed as soon as it is ready.
+* PARAMETERS    :
+*   DestTable* table        :   the destination index containing all parcels.
+*   FILE* input             :   the stream of queries.
+*   OutBuf* out             :   the buffer receiving the output.
+*   FollowState* follow     :   the followed courier file, or NULL.
+*   LoadResult* result      :   the running load counters of the followed file, or NULL.
+* RETURNS       :
+*   size_t  : the number of malformed queries.
+*/
+size_t runBatchQueries(DestTable* table, FILE* input, OutBuf* out, FollowState* follow, LoadResult* result)
+{
+    char line[QUERY_LINE_SIZE] = "";
+    size_t failed = 0;
+
+    while (fgets(line, QUERY_LINE_SIZE, input) != NULL)
+    {
+        if (follow != NULL)
+        {
+            flushOutBuf(out);
+            pollFollow(table, follow, result);
+        }
+        size_t len = strlen(line);
+        if (len == QUERY_LINE_SIZE - 1 && line[len - 1] != '\n' && !feof(input))
+        {
+            int c = 0;
+            while ((c = fgetc(input)) != EOF && c != '\n');
+            outPrintf(out, "**Query longer than %d characters skipped\n", QUERY_LINE_SIZE - 2);
+            failed++;
+            continue;
+        }
+        if (!executeQuery(table, line, out))
+        {
+            failed++;
+        }
+        if (follow != NULL)
+        {
+            flushOutBuf(out);
+        }
+    }
+    return failed;
+}
+
+/*
+* FUNCTION      : runPartitionBatch
+* DESCRIPTION   :
+*   This functoin is runBatchQueries for partitioned storage: every query read from a stream is
+*   answered across the partitions, which the queries may also load and expire as they go.
+* PARAMETERS    :
+*   PartitionSet* set       :   the partitions.
+*   FILE* input             :   the stream of queries.
+*   OutBuf* out             :   the buffer receiving the output.
+* RETURNS       :
+*   size_t  : the number of malformed queries.
+*/
+size_t runPartitionBatch(PartitionSet* set, FILE* input, OutBuf* out)
+{
+    char line[QUERY_LINE_SIZE] = "";
+    size_t failed = 0;
+
+    while (fgets(line, QUERY_LINE_SIZE, input) != NULL)
+    {
+        size_t len = strlen(line);
+        if (len == QUERY_LINE_SIZE - 1 && line[len - 1] != '\n' && !feof(input))
+        {
+            int c = 0;
+            while ((c = fgetc(input)) != EOF && c != '\n');
+            outPrintf(out, "**Query longer than %d characters skipped\n", QUERY_LINE_SIZE - 2);
+            failed++;
+            continue;
+        }
+        if (!executePartitionQuery(set, line, out))
+        {
+            failed++;
+        }
+    }
+    return failed;
+}
+
+/*
+* FUNCTION      : isWriteQuery
+* DESCRIPTION   :
+*   This functoin tells whether a line of the query language must run on the master index, under the
+*   writer lock, rather than on a published view.
+* PARAMETERS    :
+*   const char* line    :   the query.
+* RETURNS       :
+*   bool    : true, if the line is a remove, update or metrics query. otherwise, false.
+*/
+bool isWriteQuery(const char* line)
+{
+    const char* start = line;
+    while (isspace((unsigned char)*start))
+    {
+        start++;
+    }
+    const char* word = start;
+    while (*word != '\0' && !isspace((unsigned char)*word))
+    {
+        word++;
+    }
+    const QueryCommand* command = findQueryCommand(start, word);
+    return command != NULL && command->Writes;
+}
+
+/*
+* FUNCTION      : runConcurrentBatch
+* DESCRIPTION   :
+*   This functoin is runBatchQueries for a concurrent index. Queries are read QUERY_BLOCK_SIZE at a
+*   time; each run of read-only queries is answered in parallel on the thread pool, every one against
+*   the newest published view, while a remove or update is applied to the master index and published
+*   before the queries after it run. Answers are written in the order of the queries. When the input
+*   is live, one query is answered at a time and flushed at once.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+*   FILE* input             :   the stream of queries.
+*   OutBuf* out             :   the buffer receiving the output.
+*   bool live               :   the queries arrive while a file is being followed.
+* RETURNS       :
+*   size_t  : the number of malformed queries.
+*/
+size_t runConcurrentBatch(ConcurrentIndex* index, FILE* input, OutBuf* out, bool live)
+{
+    size_t blockSize = live ? 1 : QUERY_BLOCK_SIZE;
+    QueryBlock block = {};
+    size_t failed = 0;
+
+    block.Index = index;
+    block.Lines = (char(*)[QUERY_LINE_SIZE])malloc(blockSize * QUERY_LINE_SIZE);
+    block.Results = (OutBuf*)malloc(blockSize * sizeof(OutBuf));
+    block.Succeeded = (bool*)malloc(blockSize * sizeof(bool));
+    bool* overlong = (bool*)malloc(blockSize * sizeof(bool));
+    if (block.Lines == NULL || block.Results == NULL || block.Succeeded == NULL || overlong == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t q = 0; q < blockSize; ++q)
+    {
+        initOutBuf(&block.Results[q], NULL);
+        block.Results[q].Format = out->Format;
+    }
+
+    for (;;)
+    {
+        size_t count = 0;
+        while (count < blockSize && fgets(block.Lines[count], QUERY_LINE_SIZE, input) != NULL)
+        {
+            size_t len = strlen(block.Lines[count]);
+            overlong[count] = len == QUERY_LINE_SIZE - 1 && block.Lines[count][len - 1] != '\n' && !feof(input);
+            if (overlong[count])
+            {
+                int c = 0;
+                while ((c = fgetc(input)) != EOF && c != '\n');
+            }
+            count++;
+        }
+        if (count == 0)
+        {
+            break;
+        }
+
+        size_t q = 0;
+        while (q < count)
+        {
+            if (overlong[q])
+            {
+                outPrintf(&block.Results[q], "**Query longer than %d characters skipped\n", QUERY_LINE_SIZE - 2);
+                block.Succeeded[q] = false;
+                q++;
+            }
+            else if (isWriteQuery(block.Lines[q]))
+            {
+                std::lock_guard<std::mutex> lock(index->WriterLock);
+                block.Succeeded[q] = executeQuery(index->Master, block.Lines[q], &block.Results[q]);
+                publishConcurrentIndex(index);
+                q++;
+            }
+            else
+            {
+                size_t last = q;
+                while (last < count && !overlong[last] && !isWriteQuery(block.Lines[last]))
+                {
+                    last++;
+                }
+                block.First = q;
+                runParallel((int)(last - q), runReadQuery, &block);
+                q = last;
+            }
+        }
+
+        for (q = 0; q < count; ++q)
+        {
+            outWrite(out, block.Results[q].Data, block.Results[q].Length);
+            block.Results[q].Length = 0;
+            if (!block.Succeeded[q])
+            {
+                failed++;
+            }
+        }
+        if (live)
+        {
+            flushOutBuf(out);
+        }
+    }
+
+    for (size_t q = 0; q < blockSize; ++q)
+    {
+        freeOutBuf(&block.Results[q]);
+    }
+    free(block.Lines);
+    free(block.Results);
+    free(block.Succeeded);
+    free(overlong);
+    return failed;
+}
+
+/*
+* FUNCTION      : findQueryCommand
+* DESCRIPTION   : This functoin looks up a command word of the query language.
+* PARAMETERS    :
+*   const char* start   :   the first character of the word.
+*   const char* end     :   one past the last character of the word.
+* RETURNS       :
+*   const QueryCommand* : the command, or NULL if there is no such command.
+*/
+static const QueryCommand* findQueryCommand(const char* start, const char* end)
+{
+    for (size_t i = 0; i < sizeof queryCommands / sizeof queryCommands[0]; ++i)
+    {
+        if (isWord(start, end, queryCommands[i].Name))
+        {
+            return &queryCommands[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+* FUNCTION      : runReadQuery
+* DESCRIPTION   : This functoin answers one read-only query of a block against the newest published view.
+* PARAMETERS    :
+*   void* context       :   the QueryBlock being answered.
+*   int taskIndex       :   the query, counted from the block's First.
+*   int workerIndex     :   the calling worker, used as its reader slot.
+* RETURNS       : void
+*/
+static void runReadQuery(void* context, int taskIndex, int workerIndex)
+{
+    QueryBlock* block = (QueryBlock*)context;
+    size_t q = block->First + (size_t)taskIndex;
+    DestTable* view = beginRead(block->Index, workerIndex);
+    block->Succeeded[q] = executeQuery(view, block->Lines[q], &block->Results[q]);
+    endRead(block->Index, workerIndex);
+}
+
+/*
+* FUNCTION      : parseQueryOptions
+* DESCRIPTION   :
+*   This functoin takes the trailing "format", "offset", "limit" and "last" options off a query, in
+*   any order, and applies them to the buffer. Options stop at the first pair of words that is not one.
+* PARAMETERS    :
+*   const char* start   :   the query, without leading white space.
+*   const char** end    :   one past the end of the query, moved back before its options.
+*   OutBuf* out         :   the buffer whose format and page are set.
+*   size_t* recent      :   receives how many of the newest partitions are in scope, PARTITION_ALL without "last".
+* RETURNS       :
+*   bool    : true, if every option had a valid value. otherwise, false.
+*/
+static bool parseQueryOptions(const char* start, const char** end, OutBuf* out, size_t* recent)
+{
+    size_t offset = 0;
+    size_t limit = OUT_NO_LIMIT;
+    char name[QUERY_LINE_SIZE] = "";
+
+    *recent = PARTITION_ALL;
+    for (;;)
+    {
+        const char* valueEnd = *end;
+        const char* value = valueEnd;
+        while (value > start && !isspace((unsigned char)value[-1]))
+        {
+            value--;
+        }
+        const char* keywordEnd = value;
+        while (keywordEnd > start && isspace((unsigned char)keywordEnd[-1]))
+        {
+            keywordEnd--;
+        }
+        const char* keyword = keywordEnd;
+        while (keyword > start && !isspace((unsigned char)keyword[-1]))
+        {
+            keyword--;
+        }
+        if (keyword == start)
+        {
+            break;      // the command itself is never an option
+        }
+
+        double number = 0.0;
+        if (isWord(keyword, keywordEnd, "offset") || isWord(keyword, keywordEnd, "limit"))
+        {
+            if (!parseNumber(value, valueEnd, &number) || number < 0.0 || !isWholeNumber(number))
+            {
+                return false;
+            }
+            size_t rows = number < (double)QUERY_MAX_PAGE ? (size_t)number : OUT_NO_LIMIT;
+            *(isWord(keyword, keywordEnd, "limit") ? &limit : &offset) = rows;
+        }
+        else if (isWord(keyword, keywordEnd, "last"))
+        {
+            if (!parseNumber(value, valueEnd, &number) || number < 0.0 || !isWholeNumber(number))
+            {
+                return false;
+            }
+            *recent = number < (double)QUERY_MAX_PAGE ? (size_t)number : PARTITION_ALL;
+        }
+        else if (isWord(keyword, keywordEnd, "format"))
+        {
+            memcpy(name, value, (size_t)(valueEnd - value));
+            name[valueEnd - value] = '\0';
+            if (!parseOutFormat(name, &out->Format))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            break;
+        }
+        *end = keyword;
+        while (*end > start && isspace((unsigned char)(*end)[-1]))
+        {
+            (*end)--;
+        }
+    }
+    setOutPage(out, offset, limit);
+    return true;
+}
+
+/*
+* FUNCTION      : isWord
+* DESCRIPTION   : This functoin tells whether a span of a query is exactly a given word.
+* PARAMETERS    :
+*   const char* start   :   the first character of the span.
+*   const char* end     :   one past its last character.
+*   const char* word    :   the word.
+* RETURNS       :
+*   bool    : true, if they match. otherwise, false.
+*/
+static bool isWord(const char* start, const char* end, const char* word)
+{
+    return strlen(word) == (size_t)(end - start) && strncmp(word, start, (size_t)(end - start)) == 0;
+}
+
+/*
+* FUNCTION      : parseNumber
+* DESCRIPTION   : This functoin converts a whole token to a number.
+* PARAMETERS    :
+*   const char* start   :   the first character of the token.
+*   const char* end     :   one past the last character of the token.
+*   double* number      :   receives the number.
+* RETURNS       :
+*   bool    : true, if the whole token is a number. otherwise, false.
+*/
+static bool parseNumber(const char* start, const char* end, double* number)
+{
+    char token[64] = "";
+    char* tokenEnd = NULL;
+    if (start == end || (size_t)(end - start) >= sizeof token)
+    {
+        return false;
+    }
+    memcpy(token, start, (size_t)(end - start));
+    token[end - start] = '\0';
+    *number = strtod(token, &tokenEnd);
+    return *tokenEnd == '\0';
+}
+
+/*
+* FUNCTION      : isWholeNumber
+* DESCRIPTION   : This functoin checks that a number is an integer within the range of int.
+* PARAMETERS    :
+*   double number   :   the number to check.
+* RETURNS       :
+*   bool    : true, if the number can be used as an int. otherwise, false.
+*/
+static bool isWholeNumber(double number)
+{
+    return number >= -2147483648.0 && number <= 2147483647.0 && (double)(int)number == number;
+}
@@ -0,0 +1,85 @@
+/*
+* FILENAME      : query.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the per-country queries shared by the interactive menu and the batch mode,
+*   and the small query language the batch mode reads. Every query writes its result to an OutBuf.
+*
+*   A query is one line: a command, a destination name (which may contain spaces) and the command's
+*   numeric arguments, separated by blanks. Blank lines and lines starting with '#' are ignored.
+*       list <country>                      all parcels, lightest first
+*       split <country> <weight>            parcels heavier, then lighter, than the weight
+*       heavier <country> <weight>          parcels heavier than the weight
+*       lighter <country> <weight>          parcels lighter than the weight
+*       range <country> <min> <max>         parcels weighing from min to max grams
+*       rangesum <country> <min> <max>      count, load and valuation of those parcels
+*       totals <country>                    total load and valuation
+*       minmax <country>                    lightest and heaviest parcel
+*       cheapest <country>                  cheapest and most expensive parcel
+*       values <country> <min> <max>        parcels valued from min to max dollars
+*       top <country> <count>               the most valuable parcels
+*       percentile <country> <percent>      the parcel at a weight percentile
+*       valuesum <country> <min> <max>      count, load and valuation of parcels valued from min to max dollars
+*       remove <country> <weight> <value>   remove a parcel that was delivered or cancelled
+*       update <country> <weight> <value> <new weight> <new value>
+*                                           re-weigh or re-value a parcel
+*       metrics [prometheus|json]           the hot-path metrics, see metrics.h
+*   These take no destination and look at all of them, see global.h:
+*       network                             count, load, valuation and extreme parcels of the whole network
+*       heaviest <count>                    the heaviest parcels anywhere
+*       lightest <count>                    the lightest parcels anywhere
+*       valuable <count>                    the most valuable parcels anywhere
+*       ranking <count>                     the most valuable destinations, with their totals
+*   This takes the start of a name instead of a whole one, see dictionary.h:
+*       complete [prefix]                   the destinations whose name starts with the prefix
+*   These manage partitioned storage, see partition.h, where remove and update are not available:
+*       load <file>                         load a courier file as the newest partition
+*       partitions                          every partition, oldest first, with its zone map and packed size
+*       expire <count>                      drop the oldest partitions
+*   Destination names match whatever their case and however many blanks separate their words.
+*   A parcel is identified by its weight and value; when several match, the first to arrive is used.
+*   Any query may end with options that apply to it alone:
+*       format table|csv|json|binary        the format of its parcel rows, see output.h
+*       offset <n>                          leave out its first n parcel rows
+*       limit <n>                           write at most n parcel rows after them
+*       last <n>                            look at the newest n partitions only
+*/
+
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "destTable.h"
+#include "output.h"
+#include "follow.h"
+#include "concurrent.h"
+#include "partition.h"
+
+#define QUERY_LINE_SIZE     1024
+
+Destination* getCountry(DestTable* table, const char* country);
+Parcel* getCountryTree(DestTable* table, const char* country);
+void printAllParcelsInCountry(OutBuf* out, DestTable* table, const char* country);
+void printTotalParcelWgtAndValForCountry(OutBuf* out, DestTable* table, const char* country);
+void printLighterParcelsInCountry(OutBuf* out, DestTable* table, const char* country, int wgt);
+void printHeavierParcelsInCountry(OutBuf* out, DestTable* table, const char* country, int wgt);
+void printParcelsBetweenWeightsInCountry(OutBuf* out, DestTable* table, const char* country, int minWgt, int maxWgt);
+void printCheapestAndMostExpensiveParcelInCountry(OutBuf* out, DestTable* table, const char* country);
+void printLightestAndHeaviestParcelInCountry(OutBuf* out, DestTable* table, const char* country);
+void printParcelsWithinValueInCountry(OutBuf* out, DestTable* table, const char* country, int64_t minCents, int64_t maxCents);
+void printMostValuableParcelsInCountry(OutBuf* out, DestTable* table, const char* country, int count);
+void printWeightRangeTotalsInCountry(OutBuf* out, DestTable* table, const char* country, int minWgt, int maxWgt);
+void printValueRangeTotalsInCountry(OutBuf* out, DestTable* table, const char* country, int64_t minCents, int64_t maxCents);
+void printWeightPercentileInCountry(OutBuf* out, DestTable* table, const char* country, double percentile);
+bool removeParcelInCountry(OutBuf* out, DestTable* table, const char* country, int wgt, int64_t cents);
+bool updateParcelInCountry(OutBuf* out, DestTable* table, const char* country, int wgt, int64_t cents, int newWgt, int64_t newCents);
+void printDestinationsStartingWith(OutBuf* out, DestTable* table, const char* prefix);
+
+bool executeQuery(DestTable* table, const char* line, OutBuf* out);
+size_t runBatchQueries(DestTable* table, FILE* input, OutBuf* out, FollowState* follow, LoadResult* result);
+bool isWriteQuery(const char* line);
+size_t runConcurrentBatch(ConcurrentIndex* index, FILE* input, OutBuf* out, bool live);
+bool executePartitionQuery(PartitionSet* set, const char* line, OutBuf* out);
+size_t runPartitionBatch(PartitionSet* set, FILE* input, OutBuf* out);
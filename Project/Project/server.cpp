@@ -0,0 +1,501 @@
+/*
+* FILENAME      : server.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements server mode declared in server.h. Sockets are non-blocking and watched level
+*   triggered: a readable client is read once per wakeup, every complete request in its buffer is
+*   answered, and the answers are sent in as few writes as the socket allows. What the socket does not
+*   take is kept and sent when it becomes writable again.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "server.h"
+#include "query.h"
+#include "output.h"
+
+#ifdef _WIN32
+
+/*
+* FUNCTION      : runServer
+* DESCRIPTION   : Server mode is built on epoll, which Windows does not have.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+*   const char* address     :   the port or socket path.
+* RETURNS       :
+*   bool    : false.
+*/
+bool runServer(ConcurrentIndex* index, const char* address)
+{
+    printf("**Server mode is not available on Windows\n");
+    return false;
+}
+
+#else
+
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+// a connected client
+typedef struct Connection
+{
+    int Fd;
+    char* Input;
+    size_t InputLength;     // bytes of Input that do not end a request yet
+    bool Overlong;          // the current request is too long and is being skipped
+    OutBuf Output;          // answers not sent yet, from Sent on
+    size_t Sent;
+    bool Closing;           // the client has stopped sending; close once Output is sent
+    uint32_t Events;        // the events epoll is watching for
+} Connection;
+
+static volatile sig_atomic_t serverStopping = 0;
+
+static int openListener(const char* address, bool* isUnix);
+static void onStopSignal(int number);
+static void acceptClients(int epoll, int listener);
+static bool readClient(ConcurrentIndex* index, Connection* client);
+static void answerRequests(ConcurrentIndex* index, Connection* client);
+static void answerRequest(ConcurrentIndex* index, Connection* client, const char* line);
+static bool sendAnswers(Connection* client);
+static void watchClient(int epoll, Connection* client);
+static void closeClient(int epoll, Connection* client);
+
+/*
+* FUNCTION      : runServer
+* DESCRIPTION   :
+*   This functoin answers clients until the process receives SIGINT or SIGTERM. An address made of
+*   digits only is a TCP port on 127.0.0.1; anything else is the path of a Unix domain socket, which
+*   is removed again when the server stops.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index the requests are answered from.
+*   const char* address     :   the port or socket path.
+* RETURNS       :
+*   bool    : true, if the server ran and stopped cleanly. otherwise, false.
+*/
+bool runServer(ConcurrentIndex* index, const char* address)
+{
+    bool isUnix = false;
+    int listener = openListener(address, &isUnix);
+    if (listener < 0)
+    {
+        printf("**Cannot listen on %s: %s\n", address, strerror(errno));
+        return false;
+    }
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll < 0)
+    {
+        printf("**Cannot create epoll instance: %s\n", strerror(errno));
+        close(listener);
+        return false;
+    }
+    struct epoll_event event;
+    memset(&event, 0, sizeof event);
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;      // NULL marks the listener
+    epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event);
+
+    // without SA_RESTART, a signal makes epoll_wait return so the loop can stop
+    struct sigaction action;
+    memset(&action, 0, sizeof action);
+    action.sa_handler = onStopSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Serving queries on %s%s, Ctrl+C to stop\n", isUnix ? "" : "127.0.0.1:", address);
+    fflush(stdout);
+
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    while (!serverStopping)
+    {
+        int ready = epoll_wait(epoll, events, SERVER_MAX_EVENTS, -1);
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            printf("**epoll_wait failed: %s\n", strerror(errno));
+            break;
+        }
+        for (int i = 0; i < ready; ++i)
+        {
+            Connection* client = (Connection*)events[i].data.ptr;
+            if (client == NULL)
+            {
+                acceptClients(epoll, listener);
+                continue;
+            }
+            if ((events[i].events & (EPOLLERR | EPOLLHUP)) != 0 && (events[i].events & EPOLLIN) == 0)
+            {
+                closeClient(epoll, client);
+                continue;
+            }
+            if ((events[i].events & EPOLLIN) != 0 && !readClient(index, client))
+            {
+                closeClient(epoll, client);
+                continue;
+            }
+            if (!sendAnswers(client) || (client->Closing && client->Output.Length == 0))
+            {
+                closeClient(epoll, client);
+                continue;
+            }
+            watchClient(epoll, client);
+        }
+    }
+
+    // clients still connected are dropped with the process
+    printf("Server stopped\n");
+    close(epoll);
+    close(listener);
+    if (isUnix)
+    {
+        unlink(address);
+    }
+    return true;
+}
+
+/*
+* FUNCTION      : openListener
+* DESCRIPTION   : This functoin opens a non-blocking listening socket for a port or a socket path.
+* PARAMETERS    :
+*   const char* address     :   digits for a TCP port on 127.0.0.1, otherwise a socket path.
+*   bool* isUnix            :   receives whether a Unix domain socket was opened.
+* RETURNS       :
+*   int     : the socket, or -1 with errno set.
+*/
+static int openListener(const char* address, bool* isUnix)
+{
+    int listener = -1;
+    *isUnix = strspn(address, "0123456789") != strlen(address);
+
+    if (*isUnix)
+    {
+        struct sockaddr_un local;
+        struct stat info;
+        memset(&local, 0, sizeof local);
+        if (strlen(address) >= sizeof local.sun_path)
+        {
+            errno = ENAMETOOLONG;
+            return -1;
+        }
+        local.sun_family = AF_UNIX;
+        strcpy(local.sun_path, address);
+        // a socket left behind by a server that did not stop cleanly
+        if (stat(address, &info) == 0 && S_ISSOCK(info.st_mode))
+        {
+            unlink(address);
+        }
+        listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listener < 0 || bind(listener, (struct sockaddr*)&local, sizeof local) != 0)
+        {
+            int error = errno;
+            if (listener >= 0)
+            {
+                close(listener);
+            }
+            errno = error;
+            return -1;
+        }
+    }
+    else
+    {
+        struct sockaddr_in local;
+        int reuse = 1;
+        long port = strtol(address, NULL, 10);
+        if (port <= 0 || port > 65535)
+        {
+            errno = EINVAL;
+            return -1;
+        }
+        memset(&local, 0, sizeof local);
+        local.sin_family = AF_INET;
+        local.sin_port = htons((uint16_t)port);
+        local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listener < 0)
+        {
+            return -1;
+        }
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof reuse);
+        if (bind(listener, (struct sockaddr*)&local, sizeof local) != 0)
+        {
+            int error = errno;
+            close(listener);
+            errno = error;
+            return -1;
+        }
+    }
+
+    if (listen(listener, SERVER_BACKLOG) != 0)
+    {
+        int error = errno;
+        close(listener);
+        errno = error;
+        return -1;
+    }
+    return listener;
+}
+
+/*
+* FUNCTION      : onStopSignal
+* DESCRIPTION   : This functoin asks the server loop to stop.
+* PARAMETERS    :
+*   int number  :   the signal received.
+* RETURNS       : void
+*/
+static void onStopSignal(int number)
+{
+    (void)number;
+    serverStopping = 1;
+}
+
+/*
+* FUNCTION      : acceptClients
+* DESCRIPTION   : This functoin accepts every pending connection and starts watching it for requests.
+* PARAMETERS    :
+*   int epoll       :   the epoll instance.
+*   int listener    :   the listening socket.
+* RETURNS       : void
+*/
+static void acceptClients(int epoll, int listener)
+{
+    for (;;)
+    {
+        int fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            return;     // EAGAIN once the queue is empty; other errors only lose that client
+        }
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof noDelay);   // fails harmlessly on a Unix socket
+
+        Connection* client = (Connection*)malloc(sizeof(Connection));
+        if (client == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+        client->Input = (char*)malloc(SERVER_READ_SIZE);
+        if (client->Input == NULL)
+        {
+            printf("**ERROR: Out of Memory!\n");
+            exit(EXIT_FAILURE);
+        }
+        client->Fd = fd;
+        client->InputLength = 0;
+        client->Overlong = false;
+        initOutBuf(&client->Output, NULL);
+        client->Sent = 0;
+        client->Closing = false;
+        client->Events = EPOLLIN;
+
+        struct epoll_event event;
+        memset(&event, 0, sizeof event);
+        event.events = client->Events;
+        event.data.ptr = client;
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            freeOutBuf(&client->Output);
+            free(client->Input);
+            free(client);
+            close(fd);
+        }
+    }
+}
+
+/*
+* FUNCTION      : readClient
+* DESCRIPTION   : This functoin reads what a client has sent and answers every request it completes.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+*   Connection* client      :   a readable client.
+* RETURNS       :
+*   bool    : false, if the connection failed and must be closed. otherwise, true.
+*/
+static bool readClient(ConcurrentIndex* index, Connection* client)
+{
+    ssize_t count = recv(client->Fd, client->Input + client->InputLength, SERVER_READ_SIZE - client->InputLength, 0);
+    if (count < 0)
+    {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    if (count == 0)
+    {
+        client->Closing = true;     // a request without its newline is dropped
+        client->InputLength = 0;
+        return true;
+    }
+    client->InputLength += (size_t)count;
+    answerRequests(index, client);
+    return true;
+}
+
+/*
+* FUNCTION      : answerRequests
+* DESCRIPTION   :
+*   This functoin answers, in order, every complete request at the start of a client's input and
+*   keeps the incomplete one. A request longer than a query line is answered with an error once and
+*   its remaining bytes are skipped up to its newline.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+*   Connection* client      :   the client.
+* RETURNS       : void
+*/
+static void answerRequests(ConcurrentIndex* index, Connection* client)
+{
+    char line[QUERY_LINE_SIZE] = "";
+    char* start = client->Input;
+    char* end = client->Input + client->InputLength;
+
+    while (start < end)
+    {
+        char* newline = (char*)memchr(start, '\n', (size_t)(end - start));
+        size_t length = (newline != NULL ? newline : end) - start;
+        if (!client->Overlong && length > QUERY_LINE_SIZE - 2)
+        {
+            outPrintf(&client->Output, "**Query longer than %d characters skipped\nERR\n", QUERY_LINE_SIZE - 2);
+            client->Overlong = true;
+        }
+        if (newline == NULL)
+        {
+            break;
+        }
+        if (!client->Overlong)
+        {
+            memcpy(line, start, length);
+            line[length] = '\0';
+            answerRequest(index, client, line);
+        }
+        client->Overlong = false;
+        start = newline + 1;
+    }
+
+    if (client->Overlong)
+    {
+        start = end;        // nothing of a skipped request needs to be kept
+    }
+    client->InputLength = (size_t)(end - start);
+    memmove(client->Input, start, client->InputLength);
+}
+
+/*
+* FUNCTION      : answerRequest
+* DESCRIPTION   :
+*   This functoin answers one request. A query that only reads runs on the current published view
+*   without a lock; a remove or update changes the master index under the writer lock and is
+*   published before the next request is answered.
+* PARAMETERS    :
+*   ConcurrentIndex* index  :   the concurrent index.
+*   Connection* client      :   the client, receiving the answer and its status line.
+*   const char* line        :   the request, without its newline.
+* RETURNS       : void
+*/
+static void answerRequest(ConcurrentIndex* index, Connection* client, const char* line)
+{
+    bool succeeded = false;
+    if (isWriteQuery(line))
+    {
+        std::lock_guard<std::mutex> lock(index->WriterLock);
+        succeeded = executeQuery(index->Master, line, &client->Output);
+        publishConcurrentIndex(index);
+    }
+    else
+    {
+        DestTable* view = beginRead(index, 0);      // the server thread is the only reader
+        succeeded = executeQuery(view, line, &client->Output);
+        endRead(index, 0);
+    }
+    outWrite(&client->Output, succeeded ? "OK\n" : "ERR\n", succeeded ? 3 : 4);
+}
+
+/*
+* FUNCTION      : sendAnswers
+* DESCRIPTION   : This functoin sends as much of a client's pending answers as its socket takes.
+* PARAMETERS    :
+*   Connection* client  :   the client.
+* RETURNS       :
+*   bool    : false, if the connection failed and must be closed. otherwise, true.
+*/
+static bool sendAnswers(Connection* client)
+{
+    while (client->Sent < client->Output.Length)
+    {
+        ssize_t count = send(client->Fd, client->Output.Data + client->Sent,
+            client->Output.Length - client->Sent, MSG_NOSIGNAL);
+        if (count < 0)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        client->Sent += (size_t)count;
+    }
+    client->Output.Length = 0;
+    client->Sent = 0;
+    return true;
+}
+
+/*
+* FUNCTION      : watchClient
+* DESCRIPTION   :
+*   This functoin tells epoll what to wait for next: the client becoming writable while answers are
+*   pending, and more requests unless the client has stopped sending or has too much unread.
+* PARAMETERS    :
+*   int epoll           :   the epoll instance.
+*   Connection* client  :   the client.
+* RETURNS       : void
+*/
+static void watchClient(int epoll, Connection* client)
+{
+    uint32_t events = 0;
+    if (!client->Closing && client->Output.Length - client->Sent < SERVER_MAX_PENDING)
+    {
+        events |= EPOLLIN;
+    }
+    if (client->Output.Length > client->Sent)
+    {
+        events |= EPOLLOUT;
+    }
+    if (events != client->Events)
+    {
+        struct epoll_event event;
+        memset(&event, 0, sizeof event);
+        event.events = events;
+        event.data.ptr = client;
+        epoll_ctl(epoll, EPOLL_CTL_MOD, client->Fd, &event);
+        client->Events = events;
+    }
+}
+
+/*
+* FUNCTION      : closeClient
+* DESCRIPTION   : This functoin closes a client's connection and frees its buffers.
+* PARAMETERS    :
+*   int epoll           :   the epoll instance.
+*   Connection* client  :   the client.
+* RETURNS       : void
+*/
+static void closeClient(int epoll, Connection* client)
+{
+    epoll_ctl(epoll, EPOLL_CTL_DEL, client->Fd, NULL);
+    close(client->Fd);
+    freeOutBuf(&client->Output);
+    free(client->Input);
+    free(client);
+}
+
+#endif
@@ -0,0 +1,27 @@
+/*
+* FILENAME      : server.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares server mode, which answers the batch query language (see query.h) over a local
+*   TCP port or a Unix domain socket. Every line a client sends is one request; its answer is the text
+*   the batch mode would print, followed by a status line "OK" or "ERR". A client may send many
+*   requests without waiting: they are answered in order, so the n-th status line closes the n-th
+*   answer. For example:
+*       printf 'totals Canada\nminmax Canada\n' | nc 127.0.0.1 7400
+*
+*   One thread serves every client through epoll; reads run against the published views of a
+*   ConcurrentIndex, so a followed file keeps loading in the background while queries are answered.
+*/
+
+#pragma once
+#include <stdbool.h>
+#include "concurrent.h"
+
+#define SERVER_READ_SIZE        (64u << 10)     // bytes read from a client at a time
+#define SERVER_MAX_PENDING      (4u << 20)      // stop reading from a client that does not read its answers
+#define SERVER_MAX_EVENTS       64
+#define SERVER_BACKLOG          128
+
+bool runServer(ConcurrentIndex* index, const char* address);
@@ -0,0 +1,487 @@
+/*
+* FILENAME      : snapshot.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the binary snapshot declared in snapshot.h. A snapshot is written to a
+*   temporary file and renamed into place, so a crash never leaves a half-written snapshot behind.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "snapshot.h"
+#include "loader.h"
+
+#define SNAPSHOT_ALIGN(size)    (((size) + 7) & ~(uint64_t)7)
+
+// the sections of a payload, as byte offsets from its start
+typedef struct SnapshotLayout
+{
+    uint64_t Dests;
+    uint64_t Names;
+    uint64_t Cents;
+    uint64_t Weights;
+    uint64_t Seqs;
+    uint64_t ValueOrder;
+    uint64_t Size;
+} SnapshotLayout;
+
+static void layoutSnapshot(uint64_t destCount, uint64_t parcelCount, uint64_t namesSize, SnapshotLayout* layout);
+static uint64_t snapshotChecksum(const char* data, size_t size);
+static bool getSourceStamp(const char* sourcePath, uint64_t* size, int64_t* time);
+static uint32_t rowOfParcel(const uint32_t* rowOfSeq, const Parcel* parcel);
+static bool checkSnapshot(const char* path, const MappedFile* file, const char* sourcePath, SnapshotLayout* layout);
+static void rejectSnapshot(const char* path, const char* reason);
+
+/*
+* FUNCTION      : saveSnapshot
+* DESCRIPTION   :
+*   This functoin writes every destination of a loaded index to a snapshot file. The payload is built
+*   in memory, checksummed, and written behind the header in one go.
+* PARAMETERS    :
+*   DestTable* table        :   the destination index to be saved.
+*   const char* path        :   the snapshot file, replaced if it exists.
+*   const char* sourcePath  :   the courier file the index was loaded from, its size and time are recorded.
+* RETURNS       :
+*   bool    : true, if the snapshot was written. otherwise, false.
+*/
+bool saveSnapshot(DestTable* table, const char* path, const char* sourcePath)
+{
+    SnapshotHeader header;
+    SnapshotLayout layout;
+    uint64_t namesSize = 0;
+    uint64_t parcelCount = 0;
+    uint64_t destCount = 0;
+    unsigned int maxSeq = 0;
+
+    memset(&header, 0, sizeof header);
+    memcpy(header.Magic, SNAPSHOT_MAGIC, sizeof header.Magic);
+    header.Version = SNAPSHOT_VERSION;
+    header.ByteOrder = SNAPSHOT_BYTE_ORDER;
+    if (!getSourceStamp(sourcePath, &header.SourceSize, &header.SourceTime))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < table->Capacity; ++i)
+    {
+        Destination* dest = table->Slots[i].Dest;
+        if (dest != NULL)
+        {
+            destCount++;
+            namesSize += dest->NameLen;
+            parcelCount += (uint64_t)dest->Summary.Count;
+            maxSeq = dest->NextSeq > maxSeq ? dest->NextSeq : maxSeq;
+        }
+    }
+    namesSize = SNAPSHOT_ALIGN(namesSize);
+    layoutSnapshot(destCount, parcelCount, namesSize, &layout);
+
+    char* payload = (char*)calloc(1, (size_t)layout.Size + 1);
+    uint32_t* rowOfSeq = (uint32_t*)malloc(((size_t)maxSeq + 1) * sizeof(uint32_t));
+    if (payload == NULL || rowOfSeq == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    SnapshotDest* records = (SnapshotDest*)(payload + layout.Dests);
+    char* names = payload + layout.Names;
+    int64_t* cents = (int64_t*)(payload + layout.Cents);
+    int32_t* weights = (int32_t*)(payload + layout.Weights);
+    uint32_t* seqs = (uint32_t*)(payload + layout.Seqs);
+    uint32_t* valueOrder = (uint32_t*)(payload + layout.ValueOrder);
+
+    uint64_t nameOffset = 0;
+    uint64_t row = 0;
+    SnapshotDest* record = records;
+    for (size_t i = 0; i < table->Capacity; ++i)
+    {
+        Destination* dest = table->Slots[i].Dest;
+        if (dest == NULL)
+        {
+            continue;
+        }
+        ParcelColumns* columns = getDestColumns(dest);
+        DestSummary* summary = &dest->Summary;
+
+        memcpy(names + nameOffset, dest->Name, dest->NameLen);
+        memcpy(cents + row, columns->Cents, columns->Count * sizeof(int64_t));
+        memcpy(weights + row, columns->Weights, columns->Count * sizeof(int32_t));
+        for (size_t r = 0; r < columns->Count; ++r)
+        {
+            seqs[row + r] = columns->Rows[r]->Seq;
+            rowOfSeq[columns->Rows[r]->Seq] = (uint32_t)r;
+        }
+
+        // the value index in order
+        ParcelCursor cursor;
+        uint64_t valueRow = row;
+        initParcelCursor(&cursor, dest->ValueRoot, CURSOR_BY_VALUE);
+        for (Parcel* node = seekFirstParcel(&cursor); node != NULL; node = nextParcel(&cursor))
+        {
+            valueOrder[valueRow++] = rowOfSeq[node->Seq];
+        }
+
+        record->NameOffset = nameOffset;
+        record->NameLen = dest->NameLen;
+        record->FirstRow = row;
+        record->RowCount = columns->Count;
+        record->TotalWeight = summary->TotalWeight;
+        record->TotalCents = summary->TotalCents;
+        record->NextSeq = dest->NextSeq;
+        record->Lightest = rowOfParcel(rowOfSeq, summary->Lightest);
+        record->Heaviest = rowOfParcel(rowOfSeq, summary->Heaviest);
+        record->Cheapest = rowOfParcel(rowOfSeq, summary->Cheapest);
+        record->MostExpensive = rowOfParcel(rowOfSeq, summary->MostExpensive);
+        record++;
+        nameOffset += dest->NameLen;
+        row += columns->Count;
+    }
+    free(rowOfSeq);
+
+    header.DestCount = destCount;
+    header.ParcelCount = parcelCount;
+    header.NamesSize = namesSize;
+    header.PayloadSize = layout.Size;
+    header.Checksum = snapshotChecksum(payload, (size_t)layout.Size);
+
+    // write beside the target, then move it into place
+    size_t pathLen = strlen(path);
+    char* tempPath = (char*)malloc(pathLen + 5);
+    if (tempPath == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(tempPath, path, pathLen);
+    memcpy(tempPath + pathLen, ".tmp", 5);
+
+    bool written = false;
+    FILE* file = fopen(tempPath, "wb");
+    if (file != NULL)
+    {
+        written = fwrite(&header, sizeof header, 1, file) == 1 &&
+            (layout.Size == 0 || fwrite(payload, (size_t)layout.Size, 1, file) == 1);
+        written = fclose(file) == 0 && written;
+        if (written)
+        {
+            remove(path);
+            written = rename(tempPath, path) == 0;
+        }
+        if (!written)
+        {
+            remove(tempPath);
+        }
+    }
+    free(tempPath);
+    free(payload);
+    return written;
+}
+
+/*
+* FUNCTION      : loadSnapshot
+* DESCRIPTION   :
+*   This functoin fills an empty destination index from a snapshot. The snapshot is only used when
+*   its header, size and checksum are intact and it was taken from the courier file as it is now;
+*   otherwise the reason is reported and the index is left empty. Each destination's parcels are
+*   carved from the arena in one block and linked into perfectly balanced trees from the stored
+*   orders, and its columns are copied as they are.
+* PARAMETERS    :
+*   DestTable* table        :   an empty, initialised destination index.
+*   const char* path        :   the snapshot file.
+*   const char* sourcePath  :   the courier file the snapshot must have been taken from.
+* RETURNS       :
+*   bool    : true, if the index was loaded from the snapshot. otherwise, false.
+*/
+bool loadSnapshot(DestTable* table, const char* path, const char* sourcePath)
+{
+    MappedFile file;
+    SnapshotLayout layout;
+
+    if (!mapFile(path, &file))
+    {
+        return false;
+    }
+    if (!checkSnapshot(path, &file, sourcePath, &layout))
+    {
+        unmapFile(&file);
+        return false;
+    }
+
+    const SnapshotHeader* header = (const SnapshotHeader*)file.Data;
+    const char* payload = file.Data + sizeof(SnapshotHeader);
+    const SnapshotDest* records = (const SnapshotDest*)(payload + layout.Dests);
+    const char* names = payload + layout.Names;
+    const int64_t* cents = (const int64_t*)(payload + layout.Cents);
+    const int32_t* weights = (const int32_t*)(payload + layout.Weights);
+    const uint32_t* seqs = (const uint32_t*)(payload + layout.Seqs);
+    const uint32_t* valueOrder = (const uint32_t*)(payload + layout.ValueOrder);
+    Parcel** valueSorted = NULL;
+    size_t valueSortedSize = 0;
+
+    for (uint64_t d = 0; d < header->DestCount; ++d)
+    {
+        const SnapshotDest* record = &records[d];
+        size_t count = (size_t)record->RowCount;
+        Destination* dest = findOrAddDestination(table, names + record->NameOffset, (size_t)record->NameLen);
+        if (dest->Summary.Count != 0)
+        {
+            rejectSnapshot(path, "a destination is stored twice");
+            free(valueSorted);
+            deleteDestTable(table);
+            initDestTable(table, DEST_TABLE_INITIAL_SIZE);
+            unmapFile(&file);
+            return false;
+        }
+        if (count == 0)
+        {
+            continue;
+        }
+
+        Parcel* parcels = (Parcel*)arenaAlloc(&table->Pool, count * sizeof(Parcel));
+        for (size_t r = 0; r < count; ++r)
+        {
+            Parcel* parcel = &parcels[r];
+            parcel->Weight = weights[record->FirstRow + r];
+            parcel->Cents = cents[record->FirstRow + r];
+            parcel->Dest = dest->Id;
+            parcel->Seq = seqs[record->FirstRow + r];
+        }
+        fillParcelColumns(&dest->Columns, weights + record->FirstRow, cents + record->FirstRow, parcels, count);
+
+        if (count > valueSortedSize)
+        {
+            free(valueSorted);
+            valueSorted = (Parcel**)malloc(count * sizeof(Parcel*));
+            if (valueSorted == NULL)
+            {
+                printf("**ERROR: Out of Memory!\n");
+                exit(EXIT_FAILURE);
+            }
+            valueSortedSize = count;
+        }
+        for (size_t r = 0; r < count; ++r)
+        {
+            valueSorted[r] = &parcels[valueOrder[record->FirstRow + r]];
+        }
+
+        dest->Root = buildBalancedBST(dest->Columns.Rows, count);
+        dest->ValueRoot = buildBalancedValueBST(valueSorted, count);
+        dest->NextSeq = record->NextSeq;
+        dest->Summary.Count = (int64_t)count;
+        dest->Summary.TotalWeight = record->TotalWeight;
+        dest->Summary.TotalCents = record->TotalCents;
+        dest->Summary.Lightest = &parcels[record->Lightest];
+        dest->Summary.Heaviest = &parcels[record->Heaviest];
+        dest->Summary.Cheapest = &parcels[record->Cheapest];
+        dest->Summary.MostExpensive = &parcels[record->MostExpensive];
+    }
+
+    free(valueSorted);
+    unmapFile(&file);
+    return true;
+}
+
+/*
+* FUNCTION      : checkSnapshot
+* DESCRIPTION   :
+*   This functoin checks everything loadSnapshot relies on before anything is built: the header, the
+*   size of every section, the checksum, and that every offset and row stays inside its section.
+* PARAMETERS    :
+*   const char* path        :   the snapshot file, for reporting.
+*   const MappedFile* file  :   the mapped snapshot.
+*   const char* sourcePath  :   the courier file the snapshot must have been taken from.
+*   SnapshotLayout* layout  :   receives the section offsets.
+* RETURNS       :
+*   bool    : true, if the snapshot can be loaded. otherwise, false.
+*/
+static bool checkSnapshot(const char* path, const MappedFile* file, const char* sourcePath, SnapshotLayout* layout)
+{
+    const SnapshotHeader* header = (const SnapshotHeader*)file->Data;
+    uint64_t sourceSize = 0;
+    int64_t sourceTime = 0;
+
+    if (file->Size < sizeof(SnapshotHeader) || memcmp(header->Magic, SNAPSHOT_MAGIC, sizeof header->Magic) != 0)
+    {
+        rejectSnapshot(path, "not a snapshot file");
+        return false;
+    }
+    if (header->Version != SNAPSHOT_VERSION || header->ByteOrder != SNAPSHOT_BYTE_ORDER)
+    {
+        rejectSnapshot(path, "written by an incompatible version or machine");
+        return false;
+    }
+    if (!getSourceStamp(sourcePath, &sourceSize, &sourceTime) ||
+        header->SourceSize != sourceSize || header->SourceTime != sourceTime)
+    {
+        rejectSnapshot(path, "the courier file has changed since it was taken");
+        return false;
+    }
+    if (header->DestCount > file->Size || header->ParcelCount > file->Size || header->NamesSize > file->Size ||
+        header->NamesSize % 8 != 0)
+    {
+        rejectSnapshot(path, "the header does not fit the file");
+        return false;
+    }
+    layoutSnapshot(header->DestCount, header->ParcelCount, header->NamesSize, layout);
+    if (header->PayloadSize != layout->Size || file->Size - sizeof(SnapshotHeader) != layout->Size)
+    {
+        rejectSnapshot(path, "the file is truncated");
+        return false;
+    }
+    const char* payload = file->Data + sizeof(SnapshotHeader);
+    if (snapshotChecksum(payload, (size_t)layout->Size) != header->Checksum)
+    {
+        rejectSnapshot(path, "the checksum does not match");
+        return false;
+    }
+
+    const SnapshotDest* records = (const SnapshotDest*)(payload + layout->Dests);
+    const uint32_t* valueOrder = (const uint32_t*)(payload + layout->ValueOrder);
+    uint64_t nextRow = 0;
+    for (uint64_t d = 0; d < header->DestCount; ++d)
+    {
+        const SnapshotDest* record = &records[d];
+        uint64_t count = record->RowCount;
+        bool valid = record->NameLen > 0 && record->NameOffset <= header->NamesSize &&
+            record->NameLen <= header->NamesSize - record->NameOffset &&
+            record->FirstRow == nextRow && count <= header->ParcelCount - nextRow && count < SNAPSHOT_NO_ROW;
+        if (valid && count > 0)
+        {
+            valid = record->Lightest < count && record->Heaviest < count &&
+                record->Cheapest < count && record->MostExpensive < count;
+            for (uint64_t r = 0; valid && r < count; ++r)
+            {
+                valid = valueOrder[record->FirstRow + r] < count;
+            }
+        }
+        if (!valid)
+        {
+            rejectSnapshot(path, "a destination record is corrupt");
+            return false;
+        }
+        nextRow += count;
+    }
+    if (nextRow != header->ParcelCount)
+    {
+        rejectSnapshot(path, "the parcel count does not match");
+        return false;
+    }
+    return true;
+}
+
+/*
+* FUNCTION      : layoutSnapshot
+* DESCRIPTION   : This functoin works out where each section of a payload starts and how long it is.
+* PARAMETERS    :
+*   uint64_t destCount      :   the number of destinations.
+*   uint64_t parcelCount    :   the number of parcels.
+*   uint64_t namesSize      :   the size of the names section, a multiple of 8.
+*   SnapshotLayout* layout  :   receives the offsets.
+* RETURNS       : void
+*/
+static void layoutSnapshot(uint64_t destCount, uint64_t parcelCount, uint64_t namesSize, SnapshotLayout* layout)
+{
+    layout->Dests = 0;
+    layout->Names = layout->Dests + destCount * sizeof(SnapshotDest);
+    layout->Cents = layout->Names + namesSize;
+    layout->Weights = layout->Cents + parcelCount * sizeof(int64_t);
+    layout->Seqs = layout->Weights + parcelCount * sizeof(int32_t);
+    layout->ValueOrder = layout->Seqs + parcelCount * sizeof(uint32_t);
+    layout->Size = SNAPSHOT_ALIGN(layout->ValueOrder + parcelCount * sizeof(uint32_t));
+}
+
+/*
+* FUNCTION      : snapshotChecksum
+* DESCRIPTION   :
+*   This functoin hashes a payload eight bytes at a time over four independent lanes, so the
+*   multiplies overlap. It does not depend on the instruction set, unlike generateHash, so a snapshot
+*   checks out on any build.
+* PARAMETERS    :
+*   const char* data    :   the payload.
+*   size_t size         :   its size, a multiple of 8.
+* RETURNS       : uint64_t : the checksum.
+*/
+static uint64_t snapshotChecksum(const char* data, size_t size)
+{
+    uint64_t lanes[4] = { 0x9E3779B97F4A7C15ull, 0xBF58476D1CE4E5B9ull, 0x94D049BB133111EBull, 0x2545F4914F6CDD1Dull };
+    uint64_t word = 0;
+    size_t i = 0;
+
+    for (; i + 4 * sizeof word <= size; i += 4 * sizeof word)
+    {
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            memcpy(&word, data + i + lane * sizeof word, sizeof word);
+            lanes[lane] = (lanes[lane] ^ word) * 0xFF51AFD7ED558CCDull;
+            lanes[lane] ^= lanes[lane] >> 32;
+        }
+    }
+    for (; i + sizeof word <= size; i += sizeof word)
+    {
+        memcpy(&word, data + i, sizeof word);
+        lanes[0] = (lanes[0] ^ word) * 0xFF51AFD7ED558CCDull;
+        lanes[0] ^= lanes[0] >> 32;
+    }
+
+    uint64_t hash = (uint64_t)size;
+    for (int lane = 0; lane < 4; ++lane)
+    {
+        hash = (hash ^ lanes[lane]) * 0xC4CEB9FE1A85EC53ull;
+        hash ^= hash >> 33;
+    }
+    return hash;
+}
+
+/*
+* FUNCTION      : getSourceStamp
+* DESCRIPTION   : This functoin reads the size and modification time that tie a snapshot to its courier file.
+* PARAMETERS    :
+*   const char* sourcePath  :   the courier file.
+*   uint64_t* size          :   receives its size.
+*   int64_t* time           :   receives its modification time.
+* RETURNS       :
+*   bool    : true, if the file exists. otherwise, false.
+*/
+static bool getSourceStamp(const char* sourcePath, uint64_t* size, int64_t* time)
+{
+    struct stat info;
+    if (stat(sourcePath, &info) != 0)
+    {
+        return false;
+    }
+    *size = (uint64_t)info.st_size;
+    *time = (int64_t)info.st_mtime;
+    return true;
+}
+
+/*
+* FUNCTION      : rowOfParcel
+* DESCRIPTION   : This functoin turns a summary entry into its row within the destination.
+* PARAMETERS    :
+*   const uint32_t* rowOfSeq    :   the row of each sequence number of the destination.
+*   const Parcel* parcel        :   the summary entry, NULL for a destination without parcels.
+* RETURNS       : uint32_t : the row, or SNAPSHOT_NO_ROW.
+*/
+static uint32_t rowOfParcel(const uint32_t* rowOfSeq, const Parcel* parcel)
+{
+    return parcel == NULL ? SNAPSHOT_NO_ROW : rowOfSeq[parcel->Seq];
+}
+
+/*
+* FUNCTION      : rejectSnapshot
+* DESCRIPTION   : This functoin reports why a snapshot is not used.
+* PARAMETERS    :
+*   const char* path    :   the snapshot file.
+*   const char* reason  :   why it was rejected.
+* RETURNS       : void
+*/
+static void rejectSnapshot(const char* path, const char* reason)
+{
+    printf("**Snapshot %s ignored: %s\n", path, reason);
+}
@@ -0,0 +1,63 @@
+/*
+* FILENAME      : snapshot.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the binary snapshot of a loaded destination index. A snapshot holds, for every
+*   destination, its name, summary and weight-sorted parcel columns, plus the value order of its
+*   parcels. Loading one maps the file, checks it and links the parcels straight into balanced trees,
+*   so no text is parsed and no parcel is inserted one by one.
+*
+*   Layout, all fields in the byte order of the machine that wrote it and every section 8-byte aligned:
+*       SnapshotHeader
+*       SnapshotDest[DestCount]
+*       names                       NamesSize bytes, not null terminated
+*       int64_t Cents[ParcelCount]  each destination's rows are contiguous, lightest first
+*       int32_t Weights[ParcelCount]
+*       uint32_t Seq[ParcelCount]
+*       uint32_t ValueOrder[ParcelCount]    rows of each destination in value order, relative to FirstRow
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "destTable.h"
+
+#define SNAPSHOT_MAGIC          "PRCLSNAP"
+#define SNAPSHOT_VERSION        1
+#define SNAPSHOT_BYTE_ORDER     0x01020304u
+#define SNAPSHOT_NO_ROW         0xFFFFFFFFu     // summary entry of a destination without parcels
+
+typedef struct SnapshotHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t ByteOrder;     // SNAPSHOT_BYTE_ORDER as stored by the writer
+    uint64_t SourceSize;    // size of the courier file the index was loaded from
+    int64_t SourceTime;     // modification time of that file
+    uint64_t DestCount;
+    uint64_t ParcelCount;
+    uint64_t NamesSize;     // a multiple of 8
+    uint64_t PayloadSize;   // bytes following the header
+    uint64_t Checksum;      // of the payload
+} SnapshotHeader;
+
+typedef struct SnapshotDest
+{
+    uint64_t NameOffset;    // into the names section
+    uint64_t NameLen;
+    uint64_t FirstRow;
+    uint64_t RowCount;
+    int64_t TotalWeight;
+    int64_t TotalCents;
+    uint32_t NextSeq;
+    uint32_t Lightest;      // summary entries as rows relative to FirstRow
+    uint32_t Heaviest;
+    uint32_t Cheapest;
+    uint32_t MostExpensive;
+    uint32_t Reserved;
+} SnapshotDest;
+
+bool saveSnapshot(DestTable* table, const char* path, const char* sourcePath);
+bool loadSnapshot(DestTable* table, const char* path, const char* sourcePath);
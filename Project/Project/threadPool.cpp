@@ -0,0 +1,196 @@
+/*
+* FILENAME      : threadPool.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file implements the thread pool declared in threadPool.h. Workers sleep on a condition
+*   variable between jobs; within a job they claim task indices from a shared atomic counter, so
+*   uneven tasks balance themselves across threads.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "threadPool.h"
+
+#define MAX_WORKERS     256
+
+static std::thread* workers[MAX_WORKERS];
+static int workerThreads = 0;           // threads started, the caller is not counted
+static std::mutex jobMutex;             // serialises runParallel callers
+static std::mutex stateMutex;
+static std::condition_variable jobReady;
+static std::condition_variable jobDone;
+static unsigned int jobGeneration = 0;
+static int activeWorkers = 0;
+static bool stopping = false;
+static ParallelTask jobTask = NULL;
+static void* jobContext = NULL;
+static int jobTaskCount = 0;
+static std::atomic<int> nextTask(0);
+static thread_local int currentWorker = -1;     // the worker index while a thread runs a task, otherwise -1
+
+static void drainTasks(int workerIndex);
+static void workerLoop(int workerIndex);
+
+/*
+* FUNCTION      : initThreadPool
+* DESCRIPTION   : This functoin starts the pool's worker threads.
+* PARAMETERS    :
+*   int workerCount :   the total number of threads to run tasks on, including the caller. 0 or less
+*                       uses one per hardware thread.
+* RETURNS       : void
+*/
+void initThreadPool(int workerCount)
+{
+    if (workerThreads > 0)
+    {
+        return;
+    }
+    if (workerCount <= 0)
+    {
+        workerCount = (int)std::thread::hardware_concurrency();
+    }
+    if (workerCount > MAX_WORKERS)
+    {
+        workerCount = MAX_WORKERS;
+    }
+    stopping = false;
+    for (int i = 1; i < workerCount; ++i)
+    {
+        workers[workerThreads++] = new std::thread(workerLoop, i);
+    }
+}
+
+/*
+* FUNCTION      : getWorkerCount
+* DESCRIPTION   : This functoin returns how many threads runParallel spreads tasks over.
+* PARAMETERS    : void
+* RETURNS       : int : the number of workers including the caller, at least 1.
+*/
+int getWorkerCount(void)
+{
+    return workerThreads + 1;
+}
+
+/*
+* FUNCTION      : runParallel
+* DESCRIPTION   :
+*   This functoin runs task(context, i, worker) for every i in [0, taskCount) and waits for all of
+*   them. When a task calls runParallel itself, the inner tasks run one after another on that task's
+*   thread, with its worker index, since the pool is already busy with the outer job.
+* PARAMETERS    :
+*   int taskCount       :   the number of tasks.
+*   ParallelTask task   :   the function run for each task.
+*   void* context       :   passed unchanged to every task.
+* RETURNS       : void
+*/
+void runParallel(int taskCount, ParallelTask task, void* context)
+{
+    if (workerThreads == 0 || taskCount <= 1 || currentWorker >= 0)
+    {
+        int workerIndex = currentWorker >= 0 ? currentWorker : 0;
+        for (int i = 0; i < taskCount; ++i)
+        {
+            task(context, i, workerIndex);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> job(jobMutex);
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        jobTask = task;
+        jobContext = context;
+        jobTaskCount = taskCount;
+        nextTask.store(0);
+        activeWorkers = workerThreads;
+        jobGeneration++;
+    }
+    jobReady.notify_all();
+
+    drainTasks(0);
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    jobDone.wait(lock, [] { return activeWorkers == 0; });
+    jobTask = NULL;
+    jobContext = NULL;
+}
+
+/*
+* FUNCTION      : stopThreadPool
+* DESCRIPTION   : This functoin stops and joins every worker thread.
+* PARAMETERS    : void
+* RETURNS       : void
+*/
+void stopThreadPool(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (int i = 0; i < workerThreads; ++i)
+    {
+        workers[i]->join();
+        delete workers[i];
+        workers[i] = NULL;
+    }
+    workerThreads = 0;
+}
+
+/*
+* FUNCTION      : drainTasks
+* DESCRIPTION   : This functoin claims and runs tasks of the current job until none are left.
+* PARAMETERS    :
+*   int workerIndex :   the index of the calling worker.
+* RETURNS       : void
+*/
+static void drainTasks(int workerIndex)
+{
+    int taskIndex = 0;
+    currentWorker = workerIndex;
+    while ((taskIndex = nextTask.fetch_add(1)) < jobTaskCount)
+    {
+        jobTask(jobContext, taskIndex, workerIndex);
+    }
+    currentWorker = -1;
+}
+
+/*
+* FUNCTION      : workerLoop
+* DESCRIPTION   : This functoin is the body of each worker thread: wait for a job, help drain it, repeat.
+* PARAMETERS    :
+*   int workerIndex :   the index of this worker, 1 or more.
+* RETURNS       : void
+*/
+static void workerLoop(int workerIndex)
+{
+    unsigned int seenGeneration = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            jobReady.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+            if (stopping)
+            {
+                return;
+            }
+            seenGeneration = jobGeneration;
+        }
+
+        drainTasks(workerIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (--activeWorkers == 0)
+            {
+                jobDone.notify_one();
+            }
+        }
+    }
+}
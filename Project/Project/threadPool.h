@@ -0,0 +1,21 @@
+/*
+* FILENAME      : threadPool.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares a small fixed-size thread pool. runParallel hands out task indices to the pool's
+*   workers and to the calling thread, and returns once every task has finished. Until the pool is
+*   started, or when it has a single worker, tasks simply run on the calling thread, as do the tasks of
+*   a runParallel called from within a task.
+*/
+
+#pragma once
+
+// taskIndex is in [0, taskCount); workerIndex is in [0, getWorkerCount()) and is 0 for the caller
+typedef void (*ParallelTask)(void* context, int taskIndex, int workerIndex);
+
+void initThreadPool(int workerCount);
+int getWorkerCount(void);
+void runParallel(int taskCount, ParallelTask task, void* context);
+void stopThreadPool(void);
@@ -0,0 +1,96 @@
+/*
+* FILENAME      : arenaTests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file checks the bump allocator: every block is aligned and none overlaps another, whether it
+*   fits in the current chunk, needs a new one or is larger than a chunk.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests.h"
+#include "arena.h"
+
+#define ARENA_TEST_CHUNK    4096
+#define ARENA_TEST_BLOCKS   1000
+
+static void testBlocksAreAlignedAndDisjoint(void);
+static void testStrDupCopiesName(void);
+
+/*
+* FUNCTION      : runArenaTests
+* DESCRIPTION   : This functoin runs the checks of the bump allocator.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+void runArenaTests(void)
+{
+    testBlocksAreAlignedAndDisjoint();
+    testStrDupCopiesName();
+}
+
+/*
+* FUNCTION      : testBlocksAreAlignedAndDisjoint
+* DESCRIPTION   :
+*   This functoin allocates blocks of assorted sizes, some larger than a chunk, fills each with its own
+*   byte and checks afterwards that every block is aligned and still holds its byte.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testBlocksAreAlignedAndDisjoint(void)
+{
+    Arena arena;
+    unsigned char* blocks[ARENA_TEST_BLOCKS];
+    size_t sizes[ARENA_TEST_BLOCKS];
+    uint64_t state = 4;
+    size_t total = 0;
+    initArena(&arena, ARENA_TEST_CHUNK);
+
+    for (int i = 0; i < ARENA_TEST_BLOCKS; ++i)
+    {
+        sizes[i] = i % 100 == 99 ? ARENA_TEST_CHUNK * 3 : 1 + (size_t)(testRandom(&state) % 200);
+        blocks[i] = (unsigned char*)arenaAlloc(&arena, sizes[i]);
+        memset(blocks[i], i & 0xFF, sizes[i]);
+        total += sizes[i];
+    }
+
+    for (int i = 0; i < ARENA_TEST_BLOCKS; ++i)
+    {
+        CHECK((uintptr_t)blocks[i] % ARENA_ALIGNMENT == 0);
+        bool intact = true;
+        for (size_t b = 0; b < sizes[i]; ++b)
+        {
+            intact = intact && blocks[i][b] == (unsigned char)(i & 0xFF);
+        }
+        CHECK(intact);
+    }
+    CHECK(arena.BytesUsed >= total);
+    CHECK(arena.BytesUsed <= arena.BytesReserved);
+    CHECK(arena.ChunkCount > 1);
+
+    releaseArena(&arena);
+    CHECK(arena.Head == NULL);
+}
+
+/*
+* FUNCTION      : testStrDupCopiesName
+* DESCRIPTION   : This functoin checks a duplicated name is a terminated copy of just the bytes asked for.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testStrDupCopiesName(void)
+{
+    Arena arena;
+    initArena(&arena, ARENA_TEST_CHUNK);
+
+    const char* line = "Canada, 120, 15.50";
+    char* name = arenaStrDup(&arena, line, 6);
+    CHECK(strcmp(name, "Canada") == 0);
+    CHECK(name != line);
+
+    releaseArena(&arena);
+}
@@ -0,0 +1,79 @@
+/*
+* FILENAME      : benchTests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file checks the synthetic courier generator: every line it writes must load, only the
+*   destinations it was asked for may appear, and a duplicate must repeat a line it generated.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests.h"
+#include "bench.h"
+#include "loader.h"
+
+#define BENCH_TEST_FILE         "benchTests.tmp"
+#define BENCH_TEST_ROWS         5000
+#define BENCH_TEST_COUNTRIES    8
+
+static void testGeneratedLinesLoad(void);
+
+/*
+* FUNCTION      : runBenchTests
+* DESCRIPTION   : This functoin runs the checks of the courier generator.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+void runBenchTests(void)
+{
+    testGeneratedLinesLoad();
+    remove(BENCH_TEST_FILE);
+}
+
+/*
+* FUNCTION      : testGeneratedLinesLoad
+* DESCRIPTION   :
+*   This functoin generates a file in each weight order, half of it duplicates, loads it and checks
+*   every line was taken, only the asked-for destinations appear and no parcel weighs nothing, which
+*   a duplicate of an unwritten recent line would.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testGeneratedLinesLoad(void)
+{
+    WeightOrder orders[3] = { ORDER_RANDOM, ORDER_SORTED, ORDER_REVERSE };
+    for (int i = 0; i < 3; ++i)
+    {
+        GenOptions options;
+        initGenOptions(&options);
+        options.Rows = BENCH_TEST_ROWS;
+        options.Countries = BENCH_TEST_COUNTRIES;
+        options.Order = orders[i];
+        options.Duplicates = 0.5;
+        options.Seed = 17 + (uint64_t)i;
+        if (!CHECK(generateCouriers(BENCH_TEST_FILE, &options)))
+        {
+            return;
+        }
+
+        DestTable table;
+        LoadResult result = {};
+        initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+        CHECK(loadParcelsFromFile(&table, BENCH_TEST_FILE, &result));
+        CHECK(result.Loaded == BENCH_TEST_ROWS && result.Rejected == 0);
+        CHECK(table.Count <= BENCH_TEST_COUNTRIES);
+        CHECK(findDestination(&table, "Country 0", 9) == NULL);
+        bool weighed = true;
+        for (size_t s = 0; s < table.Capacity; ++s)
+        {
+            Destination* dest = table.Slots[s].Dest;
+            weighed = weighed && (dest == NULL || findMinWeight(dest->Root)->Weight >= 1);
+        }
+        CHECK(weighed);
+        deleteDestTable(&table);
+    }
+}
@@ -0,0 +1,411 @@
+/*
+* FILENAME      : concurrentTests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file checks the published views: a view a reader holds must not change however the master is
+*   changed and republished, whether the changes are replayed by path copying or the destination is
+*   copied in full, and each new view must match the master. A stress run has reader threads walking
+*   views while a follow thread and the test itself keep publishing.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "tests.h"
+#include "concurrent.h"
+
+#define CONCURRENT_TEST_FILE        "concurrentTests.tmp"
+#define CONCURRENT_TEST_PARCELS     400
+#define CONCURRENT_TEST_READERS     3
+#define CONCURRENT_TEST_ROUNDS      150
+
+// a parcel as a view showed it, to be compared after later publishes
+typedef struct SeenParcel
+{
+    int Weight;
+    int64_t Cents;
+    unsigned int Seq;
+} SeenParcel;
+
+static ConcurrentIndex heldIndex;
+static ConcurrentIndex stressIndex;
+static std::atomic<bool> readersStopping;
+static std::atomic<int> readerFailures;
+static std::atomic<long> readerWalks;
+
+static size_t recordTree(Parcel* root, bool byValue, SeenParcel* seen);
+static bool sameAsRecorded(Parcel* root, bool byValue, const SeenParcel* seen, size_t count);
+static bool viewMatchesMaster(DestTable* view, DestTable* master);
+static void changeMaster(DestTable* master, Destination* dest, uint64_t* state, int removals, int additions);
+static bool walkIsSound(Destination* dest);
+static void readerLoop(int reader);
+static void testHeldViewNeverChanges(void);
+static void testReadersDuringPublishes(void);
+
+/*
+* FUNCTION      : runConcurrentTests
+* DESCRIPTION   : This functoin runs the checks of the published views.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+void runConcurrentTests(void)
+{
+    testHeldViewNeverChanges();
+    testReadersDuringPublishes();
+    remove(CONCURRENT_TEST_FILE);
+}
+
+/*
+* FUNCTION      : recordTree
+* DESCRIPTION   : This functoin records the in-order walk of either tree of a destination.
+* PARAMETERS    :
+*   Parcel* root        :   the root of the tree.
+*   bool byValue        :   true to walk the value index, false the weight tree.
+*   SeenParcel* seen    :   receives the parcels in order, room for all of them.
+* RETURNS       :
+*   size_t  : the number of parcels recorded.
+*/
+static size_t recordTree(Parcel* root, bool byValue, SeenParcel* seen)
+{
+    Parcel* stack[PARCEL_STACK_DEPTH];
+    int top = 0;
+    size_t count = 0;
+    Parcel* node = root;
+    while (node != NULL || top > 0)
+    {
+        while (node != NULL)
+        {
+            stack[top++] = node;
+            node = byValue ? node->VLeft : node->Left;
+        }
+        node = stack[--top];
+        seen[count].Weight = node->Weight;
+        seen[count].Cents = node->Cents;
+        seen[count].Seq = node->Seq;
+        count++;
+        node = byValue ? node->VRight : node->Right;
+    }
+    return count;
+}
+
+/*
+* FUNCTION      : sameAsRecorded
+* DESCRIPTION   : This functoin tells whether a tree still holds exactly what recordTree found in it.
+* PARAMETERS    :
+*   Parcel* root            :   the root of the tree.
+*   bool byValue            :   true to walk the value index, false the weight tree.
+*   const SeenParcel* seen  :   the recorded walk.
+*   size_t count            :   the number of parcels recorded.
+* RETURNS       :
+*   bool    : true, if the walk is unchanged. otherwise, false.
+*/
+static bool sameAsRecorded(Parcel* root, bool byValue, const SeenParcel* seen, size_t count)
+{
+    SeenParcel* now = (SeenParcel*)malloc((count + CONCURRENT_TEST_PARCELS) * sizeof(SeenParcel));
+    if (now == NULL)
+    {
+        return false;
+    }
+    bool same = recordTree(root, byValue, now) == count;
+    for (size_t i = 0; same && i < count; ++i)
+    {
+        same = now[i].Weight == seen[i].Weight && now[i].Cents == seen[i].Cents && now[i].Seq == seen[i].Seq;
+    }
+    free(now);
+    return same;
+}
+
+/*
+* FUNCTION      : viewMatchesMaster
+* DESCRIPTION   :
+*   This functoin tells whether every destination of a view holds the same parcels, orders and totals
+*   as the master, and whether the copies' trees are sound.
+* PARAMETERS    :
+*   DestTable* view     :   a published view.
+*   DestTable* master   :   the master index it was published from, unchanged since.
+* RETURNS       :
+*   bool    : true, if the view matches the master. otherwise, false.
+*/
+static bool viewMatchesMaster(DestTable* view, DestTable* master)
+{
+    bool same = view->Count == master->Count;
+    for (size_t i = 0; i < master->Capacity; ++i)
+    {
+        Destination* dest = master->Slots[i].Dest;
+        if (dest == NULL)
+        {
+            continue;
+        }
+        Destination* copy = findDestination(view, dest->Name, dest->NameLen);
+        same = same && copy != NULL && copy->Summary.Count == dest->Summary.Count
+            && copy->Summary.TotalWeight == dest->Summary.TotalWeight && copy->Summary.TotalCents == dest->Summary.TotalCents
+            && sameWeightOrder(dest->Root, copy->Root) && sameValueOrder(dest->ValueRoot, copy->ValueRoot)
+            && checkWeightTree(copy->Root) == (size_t)dest->Summary.Count
+            && checkValueTree(copy->ValueRoot) == (size_t)dest->Summary.Count
+            && getDestColumns(copy)->Count == (size_t)dest->Summary.Count;
+    }
+    return same;
+}
+
+/*
+* FUNCTION      : changeMaster
+* DESCRIPTION   :
+*   This functoin removes, re-values and adds parcels of a master destination at random. The caller
+*   must be the only writer.
+* PARAMETERS    :
+*   DestTable* master   :   the master index.
+*   Destination* dest   :   the destination to change.
+*   uint64_t* state     :   the random generator.
+*   int removals        :   the parcels to remove, each followed by a re-valued one.
+*   int additions       :   the parcels to add.
+* RETURNS       :  void
+*/
+static void changeMaster(DestTable* master, Destination* dest, uint64_t* state, int removals, int additions)
+{
+    for (int i = 0; i < removals && dest->Summary.Count > 1; ++i)
+    {
+        deleteParcel(master, dest, findKthLightest(dest->Root, 1 + (int64_t)(testRandom(state) % (uint64_t)dest->Summary.Count)));
+        Parcel* parcel = findKthLightest(dest->Root, 1 + (int64_t)(testRandom(state) % (uint64_t)dest->Summary.Count));
+        updateParcelInDestination(dest, parcel, parcel->Weight, (int64_t)(testRandom(state) % 5000));
+    }
+    for (int i = 0; i < additions; ++i)
+    {
+        uint64_t draw = testRandom(state);
+        insertHashTableWithBST(master, dest->Name, dest->NameLen, (int)(draw % 100), (int64_t)((draw >> 16) % 5000));
+    }
+}
+
+/*
+* FUNCTION      : testHeldViewNeverChanges
+* DESCRIPTION   :
+*   This functoin holds the first view of an index while the master is changed and published three
+*   times: a few changes that are replayed by path copying, more changes than the log keeps so the
+*   destination is copied in full, and enough additions to reuse the nodes the full copy retired. The
+*   held view must read the same after each, and each new view must match the master.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testHeldViewNeverChanges(void)
+{
+    DestTable master;
+    uint64_t state = 15;
+    SeenParcel* byWeight = (SeenParcel*)malloc(CONCURRENT_TEST_PARCELS * sizeof(SeenParcel));
+    SeenParcel* byValue = (SeenParcel*)malloc(CONCURRENT_TEST_PARCELS * sizeof(SeenParcel));
+    if (!CHECK(byWeight != NULL && byValue != NULL))
+    {
+        free(byWeight);
+        free(byValue);
+        return;
+    }
+    initDestTable(&master, DEST_TABLE_INITIAL_SIZE);
+    Destination* dest = findOrAddDestination(&master, "Nepal", 5);
+    changeMaster(&master, dest, &state, 0, CONCURRENT_TEST_PARCELS);
+    initConcurrentIndex(&heldIndex, &master);
+
+    DestTable* held = beginRead(&heldIndex, 0);
+    Destination* copy = findDestination(held, "Nepal", 5);
+    size_t count = recordTree(copy->Root, false, byWeight);
+    CHECK(recordTree(copy->ValueRoot, true, byValue) == count);
+    CHECK(count == CONCURRENT_TEST_PARCELS);
+    DestSummary summary = copy->Summary;
+
+    int removals[3] = { 3, CONCURRENT_TEST_PARCELS / 3, 0 };
+    int additions[3] = { 5, 0, CONCURRENT_TEST_PARCELS / 2 };
+    for (int round = 0; round < 3; ++round)
+    {
+        changeMaster(&master, dest, &state, removals[round], additions[round]);
+        publishConcurrentIndex(&heldIndex);
+        CHECK(sameAsRecorded(copy->Root, false, byWeight, count));
+        CHECK(sameAsRecorded(copy->ValueRoot, true, byValue, count));
+        CHECK(copy->Summary.Count == summary.Count && copy->Summary.TotalCents == summary.TotalCents);
+        CHECK(viewMatchesMaster(heldIndex.Current.load(), &master));
+    }
+    endRead(&heldIndex, 0);
+
+    publishConcurrentIndex(&heldIndex);
+    stopConcurrentIndex(&heldIndex);
+    deleteDestTable(&master);
+    free(byWeight);
+    free(byValue);
+}
+
+/*
+* FUNCTION      : walkIsSound
+* DESCRIPTION   :
+*   This functoin walks both trees of a destination copy and tells whether they are ordered and hold
+*   as many parcels, and as much weight, as the copy's summary says. It is safe to call from a reader
+*   thread, unlike the checks that count into the test totals.
+* PARAMETERS    :
+*   Destination* dest   :   a destination copy of a view the caller holds.
+* RETURNS       :
+*   bool    : true, if both walks agree with the summary. otherwise, false.
+*/
+static bool walkIsSound(Destination* dest)
+{
+    Parcel* stack[PARCEL_STACK_DEPTH];
+    int top = 0;
+    int64_t count = 0;
+    int64_t weight = 0;
+    Parcel* previous = NULL;
+    Parcel* node = dest->Root;
+    bool sound = true;
+    while (node != NULL || top > 0)
+    {
+        while (node != NULL)
+        {
+            stack[top++] = node;
+            node = node->Left;
+        }
+        node = stack[--top];
+        sound = sound && (previous == NULL || previous->Weight < node->Weight
+            || (previous->Weight == node->Weight && previous->Seq < node->Seq));
+        count++;
+        weight += node->Weight;
+        previous = node;
+        node = node->Right;
+    }
+    sound = sound && count == dest->Summary.Count && weight == dest->Summary.TotalWeight;
+
+    count = 0;
+    previous = NULL;
+    node = dest->ValueRoot;
+    while (node != NULL || top > 0)
+    {
+        while (node != NULL)
+        {
+            stack[top++] = node;
+            node = node->VLeft;
+        }
+        node = stack[--top];
+        sound = sound && (previous == NULL || previous->Cents < node->Cents
+            || (previous->Cents == node->Cents && previous->Seq < node->Seq));
+        count++;
+        previous = node;
+        node = node->VRight;
+    }
+    return sound && count == dest->Summary.Count;
+}
+
+/*
+* FUNCTION      : readerLoop
+* DESCRIPTION   :
+*   This functoin is a reader thread of the stress run: it keeps taking the current view, walking every
+*   destination of it twice with a pause between, and letting it go, until it is told to stop.
+* PARAMETERS    :
+*   int reader  :   the reader's slot.
+* RETURNS       :  void
+*/
+static void readerLoop(int reader)
+{
+    while (!readersStopping.load())
+    {
+        DestTable* view = beginRead(&stressIndex, reader);
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (size_t i = 0; i < view->Capacity; ++i)
+            {
+                if (view->Slots[i].Dest != NULL && !walkIsSound(view->Slots[i].Dest))
+                {
+                    readerFailures.fetch_add(1);
+                }
+            }
+            std::this_thread::yield();
+        }
+        endRead(&stressIndex, reader);
+        readerWalks.fetch_add(1);
+    }
+}
+
+/*
+* FUNCTION      : testReadersDuringPublishes
+* DESCRIPTION   :
+*   This functoin follows a file on a concurrent index while reader threads walk its views. The test
+*   keeps appending lines for the follow thread to publish, and between appends removes, re-values and
+*   adds parcels itself and publishes them, now and then more than the change log keeps. No reader may
+*   ever see an unsound view, and the last view must match the master.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testReadersDuringPublishes(void)
+{
+    DestTable master;
+    FollowState follow = {};
+    LoadResult result = {};
+    uint64_t state = 16;
+    char line[64];
+    FILE* file = fopen(CONCURRENT_TEST_FILE, "wb");
+    if (!CHECK(file != NULL))
+    {
+        return;
+    }
+    for (int i = 0; i < CONCURRENT_TEST_PARCELS; ++i)
+    {
+        fprintf(file, "Stop %d, %d, %d.%02d\n", i % 4, i % 97, i % 300, i % 100);
+    }
+    fclose(file);
+
+    initDestTable(&master, DEST_TABLE_INITIAL_SIZE);
+    CHECK(startFollow(&master, CONCURRENT_TEST_FILE, &follow, &result));
+    initConcurrentIndex(&stressIndex, &master);
+    startConcurrentFollow(&stressIndex, &follow, &result);
+    readersStopping.store(false);
+    readerFailures.store(0);
+    readerWalks.store(0);
+    std::thread* readers[CONCURRENT_TEST_READERS];
+    for (int r = 0; r < CONCURRENT_TEST_READERS; ++r)
+    {
+        readers[r] = new std::thread(readerLoop, r + 1);
+    }
+
+    for (int round = 0; round < CONCURRENT_TEST_ROUNDS; ++round)
+    {
+        file = fopen(CONCURRENT_TEST_FILE, "ab");
+        for (int i = 0; file != NULL && i < 20; ++i)
+        {
+            uint64_t draw = testRandom(&state);
+            sprintf(line, "Stop %d, %d, %d.%02d\n", (int)(draw % 5), (int)((draw >> 8) % 97), (int)((draw >> 16) % 300), round % 100);
+            fputs(line, file);
+        }
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        {
+            std::lock_guard<std::mutex> lock(stressIndex.WriterLock);
+            char name[16];
+            int len = sprintf(name, "Stop %d", (int)(testRandom(&state) % 4));
+            Destination* dest = findDestination(&master, name, (size_t)len);
+            if (dest != NULL)
+            {
+                bool wholesale = round % 10 == 9;
+                changeMaster(&master, dest, &state, wholesale ? (int)(dest->Summary.Count / 3) : 4, 6);
+                publishConcurrentIndex(&stressIndex);
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(3 * CONCURRENT_POLL_MS));
+
+    readersStopping.store(true);
+    for (int r = 0; r < CONCURRENT_TEST_READERS; ++r)
+    {
+        readers[r]->join();
+        delete readers[r];
+    }
+    stopConcurrentFollow(&stressIndex);
+    CHECK(readerFailures.load() == 0);
+    CHECK(readerWalks.load() > 0);
+    CHECK(result.Rejected == 0);
+    publishConcurrentIndex(&stressIndex);
+    CHECK(viewMatchesMaster(stressIndex.Current.load(), &master));
+
+    stopConcurrentIndex(&stressIndex);
+    stopFollow(&follow);
+    deleteDestTable(&master);
+}
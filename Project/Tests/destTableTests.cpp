@@ -0,0 +1,417 @@
+/*
+* FILENAME      : destTableTests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file checks the destination index: every name added must be found again however far the table
+*   has grown, merging one index into another must keep the parcels of a destination in the order
+*   they arrived, a destination's summary must always agree with its parcels, however they are added,
+*   removed or changed, and a destination built in bulk must be the one its parcels would make if they
+*   were inserted one by one.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests.h"
+#include "destTable.h"
+
+#define DEST_TEST_NAMES     5000
+#define DEST_TEST_PARCELS   2000
+#define DEST_TEST_CHANGES   8000
+
+static void testIndexGrowsAndFindsEveryName(void);
+static void testMergeKeepsArrivalOrder(void);
+static void testSummaryFollowsInserts(void);
+static bool summaryMatches(Destination* dest, Parcel** live, int count);
+static void testRemoveAndUpdateKeepIndexes(void);
+static bool sameBuild(Destination* built, Destination* inserted);
+static void testStagedBuildMatchesInserts(void);
+
+/*
+* FUNCTION      : runDestTableTests
+* DESCRIPTION   : This functoin runs the checks of the destination index.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+void runDestTableTests(void)
+{
+    testIndexGrowsAndFindsEveryName();
+    testMergeKeepsArrivalOrder();
+    testSummaryFollowsInserts();
+    testRemoveAndUpdateKeepIndexes();
+    testStagedBuildMatchesInserts();
+}
+
+/*
+* FUNCTION      : testIndexGrowsAndFindsEveryName
+* DESCRIPTION   :
+*   This functoin adds enough names to make the table grow several times and checks each one maps to a
+*   record of its own, that adding a name again finds that record and that an unknown name is not found.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testIndexGrowsAndFindsEveryName(void)
+{
+    DestTable table;
+    char name[32];
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+
+    for (int i = 0; i < DEST_TEST_NAMES; ++i)
+    {
+        int len = sprintf(name, "Country %d", i);
+        findOrAddDestination(&table, name, (size_t)len);
+    }
+    CHECK(table.Count == DEST_TEST_NAMES);
+    CHECK((table.Capacity & (table.Capacity - 1)) == 0);
+    CHECK(table.Count * DEST_TABLE_LOAD_DEN <= table.Capacity * DEST_TABLE_LOAD_NUM);
+
+    bool allFound = true;
+    for (int i = 0; i < DEST_TEST_NAMES; ++i)
+    {
+        int len = sprintf(name, "Country %d", i);
+        Destination* dest = findDestination(&table, name, (size_t)len);
+        allFound = allFound && dest != NULL && dest->NameLen == (size_t)len && memcmp(dest->Name, name, len) == 0
+            && findOrAddDestination(&table, name, (size_t)len) == dest;
+    }
+    CHECK(allFound);
+    CHECK(table.Count == DEST_TEST_NAMES);
+    CHECK(findDestination(&table, "Country", 7) == NULL);
+    CHECK(findDestination(&table, "Country 50000", 13) == NULL);
+
+    deleteDestTable(&table);
+}
+
+/*
+* FUNCTION      : testMergeKeepsArrivalOrder
+* DESCRIPTION   :
+*   This functoin merges an index into one that already has some of its destinations, the way a
+*   parallel load merges its shards, and checks the merged parcels get arrival numbers in the order
+*   they arrived in the source rather than in weight order. Each parcel's value is its arrival.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testMergeKeepsArrivalOrder(void)
+{
+    DestTable target;
+    DestTable source;
+    uint64_t state = 6;
+    initDestTable(&target, DEST_TABLE_INITIAL_SIZE);
+    initDestTable(&source, DEST_TABLE_INITIAL_SIZE);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        insertHashTableWithBST(&target, "Chile", 5, 50, i);
+    }
+    for (int i = 10; i < DEST_TEST_PARCELS; ++i)
+    {
+        insertHashTableWithBST(&source, "Chile", 5, 1 + (int)(testRandom(&state) % 100), i);
+        insertHashTableWithBST(&source, "Peru", 4, 1 + (int)(testRandom(&state) % 100), i);
+    }
+    mergeDestTable(&target, &source);
+
+    Destination* chile = findDestination(&target, "Chile", 5);
+    Destination* peru = findDestination(&target, "Peru", 4);
+    CHECK(target.Count == 2);
+    if (!CHECK(chile != NULL && peru != NULL))
+    {
+        return;
+    }
+    CHECK(checkWeightTree(chile->Root) == DEST_TEST_PARCELS);
+    CHECK(checkWeightTree(peru->Root) == DEST_TEST_PARCELS - 10);
+    CHECK(checkValueTree(chile->ValueRoot) == DEST_TEST_PARCELS);
+    CHECK(checkValueTree(peru->ValueRoot) == DEST_TEST_PARCELS - 10);
+    CHECK(chile->NextSeq == DEST_TEST_PARCELS);
+
+    // file every parcel of the merged destination under its arrival number
+    Parcel** bySeq = (Parcel**)calloc(DEST_TEST_PARCELS, sizeof(Parcel*));
+    Parcel* stack[PARCEL_STACK_DEPTH];
+    int top = 0;
+    Parcel* node = chile->Root;
+    while (node != NULL || top > 0)
+    {
+        while (node != NULL)
+        {
+            stack[top++] = node;
+            node = node->Left;
+        }
+        node = stack[--top];
+        if (node->Seq < DEST_TEST_PARCELS)
+        {
+            bySeq[node->Seq] = node;
+        }
+        node = node->Right;
+    }
+    bool inOrder = true;
+    for (int seq = 0; seq < DEST_TEST_PARCELS; ++seq)
+    {
+        inOrder = inOrder && bySeq[seq] != NULL && bySeq[seq]->Cents == seq;
+    }
+    CHECK(inOrder);
+
+    free(bySeq);
+    deleteDestTable(&target);
+}
+
+/*
+* FUNCTION      : testSummaryFollowsInserts
+* DESCRIPTION   :
+*   This functoin inserts parcels with values up to a hundred billion dollars and checks after each one
+*   that the destination's summary matches totals and extremes worked out from the inserted data, with
+*   the value totals exact to the cent.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testSummaryFollowsInserts(void)
+{
+    DestTable table;
+    uint64_t state = 7;
+    int64_t totalWeight = 0;
+    int64_t totalCents = 0;
+    int lightest = 0;
+    int heaviest = 0;
+    int cheapest = 0;
+    int mostExpensive = 0;
+    int weights[DEST_TEST_PARCELS];
+    int64_t cents[DEST_TEST_PARCELS];
+    bool matches = true;
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+
+    for (int i = 0; i < DEST_TEST_PARCELS; ++i)
+    {
+        weights[i] = 1 + (int)(testRandom(&state) % 300);
+        cents[i] = i % 3 == 0 ? (int64_t)(testRandom(&state) % 10000000000000LL) : (int64_t)(testRandom(&state) % 500);
+        insertHashTableWithBST(&table, "Japan", 5, weights[i], cents[i]);
+
+        totalWeight += weights[i];
+        totalCents += cents[i];
+        lightest = weights[i] < weights[lightest] ? i : lightest;
+        heaviest = weights[i] >= weights[heaviest] ? i : heaviest;
+        cheapest = cents[i] < cents[cheapest] ? i : cheapest;
+        mostExpensive = cents[i] >= cents[mostExpensive] ? i : mostExpensive;
+
+        DestSummary* summary = &findDestination(&table, "Japan", 5)->Summary;
+        matches = matches && summary->Count == i + 1 && summary->TotalWeight == totalWeight
+            && summary->TotalCents == totalCents && summary->Lightest->Seq == (unsigned int)lightest
+            && summary->Heaviest->Seq == (unsigned int)heaviest && summary->Cheapest->Seq == (unsigned int)cheapest
+            && summary->MostExpensive->Seq == (unsigned int)mostExpensive;
+    }
+    CHECK(matches);
+    CHECK(findDestination(&table, "Japan", 5)->Summary.MostExpensive->Cents == cents[mostExpensive]);
+
+    deleteDestTable(&table);
+}
+
+/*
+* FUNCTION      : summaryMatches
+* DESCRIPTION   :
+*   This functoin works out a destination's summary from a list of its parcels and compares it with
+*   the one the destination keeps. A parcel keeps its sequence number when it is changed, so the
+*   sequence number stands for arrival.
+* PARAMETERS    :
+*   Destination* dest   :   the destination.
+*   Parcel** live       :   every parcel of the destination, in any order.
+*   int count           :   the number of parcels.
+* RETURNS       :
+*   bool    : true, if the kept summary is right. otherwise, false.
+*/
+static bool summaryMatches(Destination* dest, Parcel** live, int count)
+{
+    const DestSummary* summary = &dest->Summary;
+    int64_t totalWeight = 0;
+    int64_t totalCents = 0;
+    Parcel* lightest = NULL;
+    Parcel* heaviest = NULL;
+    Parcel* cheapest = NULL;
+    Parcel* mostExpensive = NULL;
+    for (int i = 0; i < count; ++i)
+    {
+        Parcel* p = live[i];
+        totalWeight += p->Weight;
+        totalCents += p->Cents;
+        if (lightest == NULL || p->Weight < lightest->Weight || (p->Weight == lightest->Weight && p->Seq < lightest->Seq))
+        {
+            lightest = p;
+        }
+        if (heaviest == NULL || p->Weight > heaviest->Weight || (p->Weight == heaviest->Weight && p->Seq > heaviest->Seq))
+        {
+            heaviest = p;
+        }
+        if (cheapest == NULL || p->Cents < cheapest->Cents || (p->Cents == cheapest->Cents && p->Seq < cheapest->Seq))
+        {
+            cheapest = p;
+        }
+        if (mostExpensive == NULL || p->Cents > mostExpensive->Cents || (p->Cents == mostExpensive->Cents && p->Seq > mostExpensive->Seq))
+        {
+            mostExpensive = p;
+        }
+    }
+    return summary->Count == count && summary->TotalWeight == totalWeight && summary->TotalCents == totalCents
+        && summary->Lightest == lightest && summary->Heaviest == heaviest
+        && summary->Cheapest == cheapest && summary->MostExpensive == mostExpensive;
+}
+
+/*
+* FUNCTION      : testRemoveAndUpdateKeepIndexes
+* DESCRIPTION   :
+*   This functoin adds, removes and changes parcels of one destination at random and checks that both
+*   trees stay balanced, ordered and totalled, that the summary follows every change, that removed
+*   nodes are handed out again by the next inserts, and that removing every parcel leaves the
+*   destination empty.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testRemoveAndUpdateKeepIndexes(void)
+{
+    DestTable table;
+    Parcel* live[DEST_TEST_CHANGES];
+    int count = 0;
+    int64_t inserted = 0;
+    uint64_t state = 14;
+    bool matches = true;
+    bool reused = true;
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+    Destination* dest = findOrAddDestination(&table, "Korea", 5);
+
+    for (int i = 0; i < DEST_TEST_CHANGES; ++i)
+    {
+        uint64_t draw = testRandom(&state);
+        int weight = 1 + (int)((draw >> 8) % 200);
+        if (count == 0 || draw % 8 < 4)
+        {
+            // inserted values are unique and odd, so the new parcel can be found again
+            Parcel* spare = table.FreeParcels;
+            int64_t cents = 2 * inserted++ + 1;
+            insertHashTableWithBST(&table, "Korea", 5, weight, cents);
+            live[count] = findParcelByWeightAndValue(dest->Root, weight, cents);
+            reused = reused && live[count] != NULL && (spare == NULL || live[count] == spare);
+            count++;
+        }
+        else if (draw % 8 < 6)
+        {
+            int index = (int)((draw >> 32) % (uint64_t)count);
+            deleteParcel(&table, dest, live[index]);
+            live[index] = live[--count];
+        }
+        else
+        {
+            // changed values are even and few, so equal values are common
+            int index = (int)((draw >> 32) % (uint64_t)count);
+            updateParcelInDestination(dest, live[index], weight, 2 * (int64_t)((draw >> 16) % 40));
+        }
+        matches = matches && summaryMatches(dest, live, count);
+        if (i % 500 == 0)
+        {
+            CHECK(checkWeightTree(dest->Root) == (size_t)count);
+            CHECK(checkValueTree(dest->ValueRoot) == (size_t)count);
+        }
+    }
+    CHECK(matches);
+    CHECK(reused);
+    CHECK(checkWeightTree(dest->Root) == (size_t)count);
+    CHECK(checkValueTree(dest->ValueRoot) == (size_t)count);
+
+    while (count > 0)
+    {
+        deleteParcel(&table, dest, live[--count]);
+    }
+    CHECK(dest->Root == NULL && dest->ValueRoot == NULL);
+    CHECK(summaryMatches(dest, live, 0));
+    CHECK(getDestColumns(dest)->Count == 0);
+
+    deleteDestTable(&table);
+}
+
+/*
+* FUNCTION      : sameBuild
+* DESCRIPTION   :
+*   This functoin tells whether a destination built from staged rows holds what one filled by inserts
+*   holds: the same parcels in both orders, sound trees, the same summary, naming the same parcels,
+*   and the same columns.
+* PARAMETERS    :
+*   Destination* built      :   the destination built in bulk.
+*   Destination* inserted   :   the destination filled one parcel at a time.
+* RETURNS       :
+*   bool    : true, if the two match. otherwise, false.
+*/
+static bool sameBuild(Destination* built, Destination* inserted)
+{
+    const DestSummary* a = &built->Summary;
+    const DestSummary* b = &inserted->Summary;
+    bool same = built->NextSeq == inserted->NextSeq && a->Count == b->Count
+        && a->TotalWeight == b->TotalWeight && a->TotalCents == b->TotalCents
+        && a->Lightest->Seq == b->Lightest->Seq && a->Heaviest->Seq == b->Heaviest->Seq
+        && a->Cheapest->Seq == b->Cheapest->Seq && a->MostExpensive->Seq == b->MostExpensive->Seq
+        && sameWeightOrder(built->Root, inserted->Root) && sameValueOrder(built->ValueRoot, inserted->ValueRoot)
+        && checkWeightTree(built->Root) == (size_t)a->Count && checkValueTree(built->ValueRoot) == (size_t)a->Count;
+    ParcelColumns* first = getDestColumns(built);
+    ParcelColumns* second = getDestColumns(inserted);
+    same = same && first->Count == second->Count;
+    for (size_t row = 0; same && row < first->Count; ++row)
+    {
+        same = first->Weights[row] == second->Weights[row] && first->Cents[row] == second->Cents[row]
+            && first->Rows[row]->Seq == second->Rows[row]->Seq;
+    }
+    return same;
+}
+
+/*
+* FUNCTION      : testStagedBuildMatchesInserts
+* DESCRIPTION   :
+*   This functoin stages the same rows into one index and inserts them one by one into another, for
+*   sizes on either side of the insertion sort cutoff, with few distinct weights and values so most
+*   parcels tie, and values past 32 bits in one of them so both value sort passes run. After the bulk
+*   build, and again after more inserts into both, each pair of destinations must match.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testStagedBuildMatchesInserts(void)
+{
+    DestTable staged;
+    DestTable inserted;
+    uint64_t state = 22;
+    size_t sizes[7] = { 1, 2, DEST_BULK_INSERTION_SORT - 1, DEST_BULK_INSERTION_SORT, DEST_BULK_INSERTION_SORT + 1, 1000, 20000 };
+    char name[16];
+    initDestTable(&staged, DEST_TABLE_INITIAL_SIZE);
+    initDestTable(&inserted, DEST_TABLE_INITIAL_SIZE);
+    for (int d = 0; d < 7; ++d)
+    {
+        int len = sprintf(name, "Bulk %d", d);
+        Destination* dest = findOrAddDestination(&staged, name, (size_t)len);
+        for (size_t i = 0; i < sizes[d]; ++i)
+        {
+            uint64_t draw = testRandom(&state);
+            int weight = (int)(draw % 40) - 5;
+            int64_t cents = (int64_t)((draw >> 8) % 25) + (d == 6 ? (int64_t)((draw >> 16) % 3) * 5000000000ll : 0);
+            stageParcelColumn(&dest->Columns, weight, cents);
+            insertHashTableWithBST(&inserted, name, (size_t)len, weight, cents);
+        }
+    }
+    buildStagedDestinations(&staged);
+
+    for (int round = 0; round < 2; ++round)
+    {
+        bool same = true;
+        for (int d = 0; d < 7; ++d)
+        {
+            int len = sprintf(name, "Bulk %d", d);
+            Destination* built = findDestination(&staged, name, (size_t)len);
+            Destination* other = findDestination(&inserted, name, (size_t)len);
+            same = same && built != NULL && other != NULL && sameBuild(built, other);
+        }
+        CHECK(same);
+
+        // a tree built in bulk is an ordinary AVL tree, so later inserts go on as usual
+        for (int i = 0; i < 3000; ++i)
+        {
+            uint64_t draw = testRandom(&state);
+            int len = sprintf(name, "Bulk %d", (int)(draw % 7));
+            insertHashTableWithBST(&staged, name, (size_t)len, (int)((draw >> 8) % 40), (int64_t)((draw >> 16) % 25));
+            insertHashTableWithBST(&inserted, name, (size_t)len, (int)((draw >> 8) % 40), (int64_t)((draw >> 16) % 25));
+        }
+    }
+    deleteDestTable(&staged);
+    deleteDestTable(&inserted);
+}
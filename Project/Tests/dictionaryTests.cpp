@@ -0,0 +1,140 @@
+/*
+* FILENAME      : dictionaryTests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file checks the destination dictionary: names that differ only in case and blanks must share
+*   an id and keep the spelling seen first, completion must list the names under a prefix in order,
+*   and seeding from a file must skip a line too long to read whole instead of splitting it into names.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests.h"
+#include "dictionary.h"
+
+#define DICTIONARY_TEST_FILE    "dictionaryTests.tmp"
+
+static DestId intern(const char* name);
+static void testNamesMatchNormalized(void);
+static void testCompletionListsInOrder(void);
+static void testSeedSkipsOverlongLines(void);
+
+/*
+* FUNCTION      : runDictionaryTests
+* DESCRIPTION   : This functoin runs the checks of the destination dictionary.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+void runDictionaryTests(void)
+{
+    testNamesMatchNormalized();
+    testCompletionListsInOrder();
+    testSeedSkipsOverlongLines();
+    remove(DICTIONARY_TEST_FILE);
+}
+
+/*
+* FUNCTION      : intern
+* DESCRIPTION   : This functoin interns a null-terminated name, see internDestName.
+* PARAMETERS    :
+*   const char* name    :   the name.
+* RETURNS       :
+*   DestId  : the id of the name.
+*/
+static DestId intern(const char* name)
+{
+    return internDestName(name, strlen(name));
+}
+
+/*
+* FUNCTION      : testNamesMatchNormalized
+* DESCRIPTION   :
+*   This functoin interns one name spelled several ways and checks they all get the id and spelling
+*   of the first, while names that really differ get ids of their own.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testNamesMatchNormalized(void)
+{
+    DestId id = intern("Dict Upper Volta");
+    CHECK(intern("dict upper volta") == id);
+    CHECK(intern("  DICT   Upper\tVolta \n") == id);
+    CHECK(strcmp(getDestName(id), "Dict Upper Volta") == 0 && getDestNameLen(id) == 16);
+    CHECK(intern("Dict Upper Voltas") != id);
+    CHECK(intern("Dict UpperVolta") != id);
+    CHECK(sameDestName("Dict  upper volta", 17, "dict Upper Volta ", 17));
+    CHECK(!sameDestName("Dict Upper Volta", 16, "Dict Upper Volt", 15));
+}
+
+/*
+* FUNCTION      : testCompletionListsInOrder
+* DESCRIPTION   :
+*   This functoin interns names out of order under a prefix no other test uses and checks completion
+*   lists exactly those under each prefix, alphabetically, a name that is a prefix of another first.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testCompletionListsInOrder(void)
+{
+    const char* names[5] = { "Compl Nyx", "compl bay", "Compl Baya", "Compl Az", "COMPL B" };
+    const char* ordered[5] = { "Compl Az", "COMPL B", "compl bay", "Compl Baya", "Compl Nyx" };
+    for (int i = 0; i < 5; ++i)
+    {
+        intern(names[i]);
+    }
+
+    size_t count = 0;
+    DestId* ids = completeDestName("compl ", 6, &count);
+    bool same = count == 5;
+    for (size_t i = 0; same && i < count; ++i)
+    {
+        same = strcmp(getDestName(ids[i]), ordered[i]) == 0;
+    }
+    CHECK(same);
+    free(ids);
+
+    ids = completeDestName("COMPL  BA", 9, &count);
+    CHECK(count == 2 && ids[0] == intern("compl bay") && ids[1] == intern("compl baya"));
+    free(ids);
+    ids = completeDestName("Compl Q", 7, &count);
+    CHECK(count == 0);
+    free(ids);
+}
+
+/*
+* FUNCTION      : testSeedSkipsOverlongLines
+* DESCRIPTION   :
+*   This functoin seeds the dictionary from a file with a line several times longer than a seed line
+*   may be between two ordinary names, and checks both names are seeded with their spelling while no
+*   piece of the long line became a name.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testSeedSkipsOverlongLines(void)
+{
+    FILE* file = fopen(DICTIONARY_TEST_FILE, "wb");
+    if (!CHECK(file != NULL))
+    {
+        return;
+    }
+    fputs("Seeded Before\n", file);
+    for (int i = 0; i < DEST_SEED_LINE_SIZE * 3; i += 10)
+    {
+        fputs("Seedlong  ", file);
+    }
+    fputs("\n\n  Seeded AFTER\n", file);
+    fclose(file);
+
+    CHECK(seedDestDictionary(DICTIONARY_TEST_FILE));
+    CHECK(strcmp(getDestName(intern("seeded before")), "Seeded Before") == 0);
+    CHECK(strcmp(getDestName(intern("seeded after")), "Seeded AFTER") == 0);
+    size_t count = 0;
+    DestId* ids = completeDestName("Seedlong", 8, &count);
+    CHECK(count == 0);
+    free(ids);
+    CHECK(!seedDestDictionary("dictionaryTests.missing"));
+}
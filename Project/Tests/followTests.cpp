@@ -0,0 +1,124 @@
+/*
+* FILENAME      : followTests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file checks follow mode: a line still being written must wait for its newline, appended lines
+*   must be picked up by the next poll, an overlong line must be skipped without losing the next one,
+*   and a file that shrinks must be followed again from its start.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests.h"
+#include "follow.h"
+
+#define FOLLOW_TEST_FILE    "followTests.tmp"
+
+static bool writeText(const char* mode, const char* text);
+static int64_t countOf(DestTable* table, const char* name);
+static void testAppendedLinesArePolled(void);
+
+/*
+* FUNCTION      : runFollowTests
+* DESCRIPTION   : This functoin runs the checks of follow mode.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+void runFollowTests(void)
+{
+    testAppendedLinesArePolled();
+    remove(FOLLOW_TEST_FILE);
+}
+
+/*
+* FUNCTION      : writeText
+* DESCRIPTION   : This functoin writes or appends text to the followed file.
+* PARAMETERS    :
+*   const char* mode    :   "wb" to start the file afresh, "ab" to append to it.
+*   const char* text    :   the text to write.
+* RETURNS       :
+*   bool    : true, if the text was written. otherwise, false.
+*/
+static bool writeText(const char* mode, const char* text)
+{
+    FILE* file = fopen(FOLLOW_TEST_FILE, mode);
+    if (file == NULL)
+    {
+        return false;
+    }
+    bool written = fwrite(text, 1, strlen(text), file) == strlen(text);
+    return fclose(file) == 0 && written;
+}
+
+/*
+* FUNCTION      : countOf
+* DESCRIPTION   : This functoin counts the parcels of a destination.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index.
+*   const char* name    :   the destination.
+* RETURNS       :
+*   int64_t : the number of its parcels, 0 if it is not in the index.
+*/
+static int64_t countOf(DestTable* table, const char* name)
+{
+    Destination* dest = findDestination(table, name, strlen(name));
+    return dest == NULL ? 0 : dest->Summary.Count;
+}
+
+/*
+* FUNCTION      : testAppendedLinesArePolled
+* DESCRIPTION   :
+*   This functoin follows a file through a half-written line, an ordinary append, an overlong line and
+*   a truncation, and checks what each poll inserts.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testAppendedLinesArePolled(void)
+{
+    DestTable table;
+    FollowState follow = {};
+    LoadResult result = {};
+    if (!CHECK(writeText("wb", "Chile, 10, 1.00\nChile, 20, 2.00\nPeru, 5")))
+    {
+        return;
+    }
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+    CHECK(startFollow(&table, FOLLOW_TEST_FILE, &follow, &result));
+    CHECK(result.Loaded == 2 && countOf(&table, "Peru") == 0);
+    CHECK(pollFollow(&table, &follow, &result) == 0);
+
+    // the half-written line is read whole once its newline arrives
+    writeText("ab", ", 2.50\nPeru, 6, 1.00\n");
+    CHECK(pollFollow(&table, &follow, &result) == 2);
+    Destination* peru = findDestination(&table, "Peru", 4);
+    CHECK(peru != NULL && peru->Summary.Count == 2 && peru->Summary.TotalWeight == 11 && peru->Summary.TotalCents == 350);
+
+    // a line longer than the buffer is skipped and the line after it still arrives
+    char* overlong = (char*)malloc(FOLLOW_BUFFER_SIZE + 64);
+    if (!CHECK(overlong != NULL))
+    {
+        stopFollow(&follow);
+        deleteDestTable(&table);
+        return;
+    }
+    memset(overlong, 'x', FOLLOW_BUFFER_SIZE + 16);
+    strcpy(overlong + FOLLOW_BUFFER_SIZE + 16, "\nPeru, 7, 1.00\n");
+    writeText("ab", overlong);
+    free(overlong);
+    size_t rejected = result.Rejected;
+    CHECK(pollFollow(&table, &follow, &result) == 1);
+    CHECK(result.Rejected == rejected + 1 && countOf(&table, "Peru") == 3);
+
+    // a truncated file is read again from its start
+    writeText("wb", "Chile, 9, 9.00\n");
+    CHECK(pollFollow(&table, &follow, &result) == 1);
+    CHECK(countOf(&table, "Chile") == 3);
+
+    stopFollow(&follow);
+    CHECK(pollFollow(&table, &follow, &result) == 0);
+    deleteDestTable(&table);
+}
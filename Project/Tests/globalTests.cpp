@@ -0,0 +1,227 @@
+/*
+* FILENAME      : globalTests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file checks the network-wide queries: what the blocks of destinations find on the thread pool
+*   and merge must be what one sort over every parcel of the network finds.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests.h"
+#include "global.h"
+
+#define GLOBAL_TEST_DESTS       60
+#define GLOBAL_TEST_PARCELS     3000
+
+static GlobalOrder sortOrder;
+
+static void fillNetwork(DestTable* table);
+static Parcel** collectParcels(DestTable* table);
+static int compareForOrder(const void* first, const void* second);
+static bool endsWith(const OutBuf* out, const OutBuf* tail);
+static bool printsRow(const OutBuf* out, Parcel* parcel);
+static void testTopParcelsMatchSort(void);
+static void testNetworkTotalsMatchSums(void);
+
+/*
+* FUNCTION      : runGlobalTests
+* DESCRIPTION   : This functoin runs the checks of the network-wide queries.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+void runGlobalTests(void)
+{
+    testTopParcelsMatchSort();
+    testNetworkTotalsMatchSums();
+}
+
+/*
+* FUNCTION      : fillNetwork
+* DESCRIPTION   :
+*   This functoin spreads parcels over the destinations unevenly, a few holding most of them, with no
+*   two parcels of the same weight or value so every order has one right answer.
+* PARAMETERS    :
+*   DestTable* table    :   an empty destination index.
+* RETURNS       : void
+*/
+static void fillNetwork(DestTable* table)
+{
+    uint64_t state = 21;
+    char name[16];
+    for (int i = 0; i < GLOBAL_TEST_PARCELS; ++i)
+    {
+        uint64_t draw = testRandom(&state) % GLOBAL_TEST_DESTS;
+        int len = sprintf(name, "Hub %d", (int)(draw * draw / GLOBAL_TEST_DESTS));
+        insertHashTableWithBST(table, name, (size_t)len, (int)(((int64_t)i * 7919) % 100003),
+            ((int64_t)i * 104729) % 1000003);
+    }
+}
+
+/*
+* FUNCTION      : collectParcels
+* DESCRIPTION   : This functoin gathers every parcel of a destination index, in no particular order.
+* PARAMETERS    :
+*   DestTable* table    :   the destination index.
+* RETURNS       :
+*   Parcel**    : GLOBAL_TEST_PARCELS parcels, for the caller to free.
+*/
+static Parcel** collectParcels(DestTable* table)
+{
+    Parcel** parcels = (Parcel**)malloc(GLOBAL_TEST_PARCELS * sizeof(Parcel*));
+    size_t count = 0;
+    if (parcels == NULL)
+    {
+        printf("**ERROR: Out of Memory!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t s = 0; s < table->Capacity; ++s)
+    {
+        Destination* dest = table->Slots[s].Dest;
+        if (dest == NULL)
+        {
+            continue;
+        }
+        ParcelCursor cursor;
+        initParcelCursor(&cursor, dest->Root, CURSOR_BY_WEIGHT);
+        for (Parcel* parcel = seekFirstParcel(&cursor); parcel != NULL && count < GLOBAL_TEST_PARCELS; parcel = nextParcel(&cursor))
+        {
+            parcels[count++] = parcel;
+        }
+    }
+    return parcels;
+}
+
+/*
+* FUNCTION      : compareForOrder
+* DESCRIPTION   : This functoin is the qsort comparator putting parcels in sortOrder, best first.
+* PARAMETERS    :
+*   const void* first   :   a Parcel* element.
+*   const void* second  :   another Parcel* element.
+* RETURNS       :
+*   int     : negative if the first comes first, positive if the second does.
+*/
+static int compareForOrder(const void* first, const void* second)
+{
+    const Parcel* a = *(Parcel* const*)first;
+    const Parcel* b = *(Parcel* const*)second;
+    int64_t difference = sortOrder == GLOBAL_HEAVIEST ? (int64_t)b->Weight - a->Weight
+        : sortOrder == GLOBAL_LIGHTEST ? (int64_t)a->Weight - b->Weight : b->Cents - a->Cents;
+    return difference < 0 ? -1 : difference > 0 ? 1 : 0;
+}
+
+/*
+* FUNCTION      : endsWith
+* DESCRIPTION   : This functoin tells whether the text of one buffer ends with the text of another.
+* PARAMETERS    :
+*   const OutBuf* out   :   the buffer to look at.
+*   const OutBuf* tail  :   the text it should end with.
+* RETURNS       :
+*   bool    : true, if it does. otherwise, false.
+*/
+static bool endsWith(const OutBuf* out, const OutBuf* tail)
+{
+    return out->Length >= tail->Length && memcmp(out->Data + out->Length - tail->Length, tail->Data, tail->Length) == 0;
+}
+
+/*
+* FUNCTION      : printsRow
+* DESCRIPTION   : This functoin tells whether a buffer holds the row printParcel prints for a parcel.
+* PARAMETERS    :
+*   const OutBuf* out   :   the buffer to look at, null-terminated.
+*   Parcel* parcel      :   the parcel.
+* RETURNS       :
+*   bool    : true, if the row is there. otherwise, false.
+*/
+static bool printsRow(const OutBuf* out, Parcel* parcel)
+{
+    OutBuf row;
+    initOutBuf(&row, NULL);
+    printParcel(&row, parcel);
+    outWrite(&row, "", 1);
+    bool found = strstr(out->Data, row.Data) != NULL;
+    freeOutBuf(&row);
+    return found;
+}
+
+/*
+* FUNCTION      : testTopParcelsMatchSort
+* DESCRIPTION   :
+*   This functoin asks for the heaviest, lightest and most valuable parcels anywhere, one, a few and
+*   more than there are, and checks the rows printed are the head of a sort over the whole network.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testTopParcelsMatchSort(void)
+{
+    DestTable table;
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+    fillNetwork(&table);
+    Parcel** parcels = collectParcels(&table);
+    DestTable* tables[1] = { &table };
+    GlobalOrder orders[3] = { GLOBAL_HEAVIEST, GLOBAL_LIGHTEST, GLOBAL_MOST_VALUABLE };
+    int counts[3] = { 1, 25, GLOBAL_TEST_PARCELS + 5 };
+    for (int o = 0; o < 3; ++o)
+    {
+        sortOrder = orders[o];
+        qsort(parcels, GLOBAL_TEST_PARCELS, sizeof(Parcel*), compareForOrder);
+        for (int c = 0; c < 3; ++c)
+        {
+            OutBuf out;
+            OutBuf expected;
+            initOutBuf(&out, NULL);
+            initOutBuf(&expected, NULL);
+            printTopParcelsAnywhere(&out, tables, 1, orders[o], counts[c]);
+            for (int i = 0; i < counts[c] && i < GLOBAL_TEST_PARCELS; ++i)
+            {
+                printParcel(&expected, parcels[i]);
+            }
+            CHECK(endsWith(&out, &expected));
+            freeOutBuf(&expected);
+            freeOutBuf(&out);
+        }
+    }
+    free(parcels);
+    deleteDestTable(&table);
+}
+
+/*
+* FUNCTION      : testNetworkTotalsMatchSums
+* DESCRIPTION   :
+*   This functoin checks the network totals count every parcel once and name the lightest, heaviest,
+*   cheapest and most expensive parcel of the whole network.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testNetworkTotalsMatchSums(void)
+{
+    DestTable table;
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+    fillNetwork(&table);
+    Parcel** parcels = collectParcels(&table);
+    DestTable* tables[1] = { &table };
+    OutBuf out;
+    initOutBuf(&out, NULL);
+    printNetworkTotals(&out, tables, 1);
+    outWrite(&out, "", 1);
+
+    char expected[64];
+    sprintf(expected, "Parcels: %d\t", GLOBAL_TEST_PARCELS);
+    CHECK(strstr(out.Data, expected) != NULL);
+    GlobalOrder orders[3] = { GLOBAL_HEAVIEST, GLOBAL_LIGHTEST, GLOBAL_MOST_VALUABLE };
+    for (int o = 0; o < 3; ++o)
+    {
+        sortOrder = orders[o];
+        qsort(parcels, GLOBAL_TEST_PARCELS, sizeof(Parcel*), compareForOrder);
+        CHECK(printsRow(&out, parcels[0]));
+    }
+    // the cheapest parcel is the last of the most valuable
+    CHECK(printsRow(&out, parcels[GLOBAL_TEST_PARCELS - 1]));
+    freeOutBuf(&out);
+    free(parcels);
+    deleteDestTable(&table);
+}
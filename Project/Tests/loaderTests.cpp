@@ -0,0 +1,233 @@
+/*
+* FILENAME      : loaderTests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file checks the courier file loader: the line parser must take every well-formed line exactly
+*   and turn down every malformed one, and a mapped file must load the same parcels as its text, in
+*   the same order, whether it is loaded on the thread pool or one line at a time.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests.h"
+#include "loader.h"
+
+#define LOADER_TEST_FILE    "loaderTests.tmp"
+
+static bool parseText(const char* text, ParsedEntry* entry);
+static void testParseWellFormedLines(void);
+static void testParseRejectsMalformedLines(void);
+static void testMapAndLoadFile(void);
+static void testParallelLoadMatchesSerial(void);
+
+/*
+* FUNCTION      : runLoaderTests
+* DESCRIPTION   : This functoin runs the checks of the courier file loader.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+void runLoaderTests(void)
+{
+    testParseWellFormedLines();
+    testParseRejectsMalformedLines();
+    testMapAndLoadFile();
+    testParallelLoadMatchesSerial();
+}
+
+/*
+* FUNCTION      : parseText
+* DESCRIPTION   : This functoin parses a null-terminated line, see parseParcelLine.
+* PARAMETERS    :
+*   const char* text    :   the line, without its newline.
+*   ParsedEntry* entry  :   receives the parcel.
+* RETURNS       :
+*   bool    : true, if the line is a well-formed parcel entry. otherwise, false.
+*/
+static bool parseText(const char* text, ParsedEntry* entry)
+{
+    return parseParcelLine(text, text + strlen(text), entry);
+}
+
+/*
+* FUNCTION      : testParseWellFormedLines
+* DESCRIPTION   :
+*   This functoin parses lines with assorted spacing and value precision and checks each field,
+*   including a value rounded on its third decimal.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testParseWellFormedLines(void)
+{
+    ParsedEntry entry;
+
+    CHECK(parseText("Canada, 120, 15.50", &entry));
+    CHECK(entry.DestLen == 6 && memcmp(entry.Dest, "Canada", 6) == 0);
+    CHECK(entry.Weight == 120);
+    CHECK(entry.Cents == 1550);
+
+    CHECK(parseText("  New Zealand \t,7,3\r", &entry));
+    CHECK(entry.DestLen == 11 && memcmp(entry.Dest, "New Zealand", 11) == 0);
+    CHECK(entry.Weight == 7);
+    CHECK(entry.Cents == 300);
+
+    CHECK(parseText("Peru, 0, .5", &entry) && entry.Weight == 0 && entry.Cents == 50);
+    CHECK(parseText("Peru, 1, 2.345", &entry) && entry.Cents == 235);
+    CHECK(parseText("Peru, 1, 2.344", &entry) && entry.Cents == 234);
+    CHECK(parseText("Peru, 2147483647, 1234567.89", &entry) && entry.Weight == 2147483647
+        && entry.Cents == 123456789);
+}
+
+/*
+* FUNCTION      : testParseRejectsMalformedLines
+* DESCRIPTION   : This functoin checks the parser turns down lines with a missing, extra or malformed field.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testParseRejectsMalformedLines(void)
+{
+    static const char* const malformed[] =
+    {
+        "",
+        "Canada 120 15.50",             // no commas
+        ", 120, 15.50",                 // no destination
+        "  \t, 120, 15.50",
+        "Canada, , 15.50",              // no weight
+        "Canada, -5, 15.50",            // negative weight
+        "Canada, 12a, 15.50",
+        "Canada, 1.5, 15.50",
+        "Canada, 2147483648, 15.50",    // weight past INT_MAX
+        "Canada, 120",                  // no value
+        "Canada, 120,",
+        "Canada, 120, .",
+        "Canada, 120, abc",
+        "Canada, 120, -1.00",
+        "Canada, 120, 15.50 kg",        // trailing text
+        "Canada, 120, 15.50, 3",        // extra field
+        "Canada, 120, 1000000000000000.00",     // past the largest value
+    };
+    ParsedEntry entry;
+
+    for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); ++i)
+    {
+        if (!CHECK(!parseText(malformed[i], &entry)))
+        {
+            printf("  accepted: \"%s\"\n", malformed[i]);
+        }
+    }
+}
+
+/*
+* FUNCTION      : testMapAndLoadFile
+* DESCRIPTION   :
+*   This functoin writes a small courier file with blank lines, CRLF line ends and no final newline,
+*   maps it, and checks the mapping and the parcels it loads; an empty file maps to nothing and a
+*   missing one does not map.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testMapAndLoadFile(void)
+{
+    static const char text[] = "Canada, 10, 1.50\n\nMexico, 3, 2.25\r\n  \nCanada, 10, 0.75\nCanada, 4, 9";
+    FILE* file = fopen(LOADER_TEST_FILE, "wb");
+    if (!CHECK(file != NULL))
+    {
+        return;
+    }
+    fwrite(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+
+    MappedFile mapped;
+    CHECK(mapFile(LOADER_TEST_FILE, &mapped));
+    CHECK(mapped.Size == sizeof(text) - 1);
+    CHECK(mapped.Data != NULL && memcmp(mapped.Data, text, sizeof(text) - 1) == 0);
+    unmapFile(&mapped);
+
+    DestTable table;
+    LoadResult result = {};
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+    CHECK(loadParcelsFromFile(&table, LOADER_TEST_FILE, &result));
+    CHECK(result.Loaded == 4 && result.Rejected == 0 && result.Lines == 6);
+    Destination* canada = findDestination(&table, "Canada", 6);
+    Destination* mexico = findDestination(&table, "Mexico", 6);
+    CHECK(canada != NULL && checkWeightTree(canada->Root) == 3);
+    CHECK(mexico != NULL && checkWeightTree(mexico->Root) == 1);
+    CHECK(table.Count == 2);
+    deleteDestTable(&table);
+
+    file = fopen(LOADER_TEST_FILE, "wb");
+    fclose(file);
+    CHECK(mapFile(LOADER_TEST_FILE, &mapped));
+    CHECK(mapped.Data == NULL && mapped.Size == 0);
+    unmapFile(&mapped);
+
+    remove(LOADER_TEST_FILE);
+    CHECK(!mapFile(LOADER_TEST_FILE, &mapped));
+}
+
+/*
+* FUNCTION      : testParallelLoadMatchesSerial
+* DESCRIPTION   :
+*   This functoin writes a courier file large enough to be loaded on the thread pool, with a few
+*   destinations and weights so that ties abound, and checks every destination's tree comes out the
+*   same, arrival numbers included, as when the same text is loaded one line at a time.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testParallelLoadMatchesSerial(void)
+{
+    size_t capacity = LOADER_PARALLEL_MIN_SIZE + (1u << 20);
+    char* text = (char*)malloc(capacity);
+    size_t size = 0;
+    uint64_t state = 5;
+    if (!CHECK(text != NULL))
+    {
+        return;
+    }
+    while (size < LOADER_PARALLEL_MIN_SIZE + 1000)
+    {
+        uint64_t draw = testRandom(&state);
+        size += (size_t)sprintf(text + size, "Dest %d, %d, %d.%02d\n", (int)(draw % 7), (int)((draw >> 8) % 40),
+            (int)((draw >> 16) % 100), (int)((draw >> 24) % 100));
+    }
+
+    FILE* file = fopen(LOADER_TEST_FILE, "wb");
+    if (!CHECK(file != NULL))
+    {
+        free(text);
+        return;
+    }
+    fwrite(text, 1, size, file);
+    fclose(file);
+
+    DestTable parallel;
+    DestTable serial;
+    LoadResult parallelResult = {};
+    LoadResult serialResult = {};
+    initDestTable(&parallel, DEST_TABLE_INITIAL_SIZE);
+    initDestTable(&serial, DEST_TABLE_INITIAL_SIZE);
+    CHECK(loadParcelsFromFile(&parallel, LOADER_TEST_FILE, &parallelResult));
+    loadParcelBuffer(&serial, text, size, &serialResult);
+    remove(LOADER_TEST_FILE);
+
+    CHECK(parallelResult.Loaded == serialResult.Loaded && parallelResult.Lines == serialResult.Lines);
+    CHECK(parallel.Count == serial.Count);
+    bool same = true;
+    for (size_t i = 0; i < serial.Capacity; ++i)
+    {
+        Destination* dest = serial.Slots[i].Dest;
+        if (dest != NULL)
+        {
+            Destination* other = findDestination(&parallel, dest->Name, dest->NameLen);
+            same = same && other != NULL && sameWeightOrder(dest->Root, other->Root);
+        }
+    }
+    CHECK(same);
+
+    deleteDestTable(&parallel);
+    deleteDestTable(&serial);
+    free(text);
+}
@@ -0,0 +1,177 @@
+/*
+* FILENAME      : packedTests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file checks the compressed encoding of parcels: every row packed must decode to itself, block
+*   by block and one at a time, and the range totals taken from block headers and partly decoded
+*   blocks must be the totals of a plain scan of the same rows.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests.h"
+#include "packed.h"
+
+#define PACKED_TEST_ROWS    (PACKED_BLOCK_ROWS * 9 + 37)    // a last block that is not full
+
+static int testWeights[PACKED_TEST_ROWS];
+static int64_t testCents[PACKED_TEST_ROWS];
+static uint32_t testSeqs[PACKED_TEST_ROWS];
+
+static void fillRows(void);
+static void testRowsDecodeToThemselves(void);
+static void testRangeTotalsMatchScan(void);
+
+/*
+* FUNCTION      : runPackedTests
+* DESCRIPTION   : This functoin runs the checks of the compressed encoding.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+void runPackedTests(void)
+{
+    fillRows();
+    testRowsDecodeToThemselves();
+    testRangeTotalsMatchScan();
+}
+
+/*
+* FUNCTION      : fillRows
+* DESCRIPTION   :
+*   This functoin makes rows sorted by weight, then by arrival, with runs of equal weights, gaps wide
+*   enough to need many bits in one block and none in another, and values from nothing to millions.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void fillRows(void)
+{
+    uint64_t state = 44;
+    int weight = 1;
+    for (int i = 0; i < PACKED_TEST_ROWS; ++i)
+    {
+        uint64_t draw = testRandom(&state);
+        int block = i / PACKED_BLOCK_ROWS;
+        weight += block % 3 == 0 ? 0 : block % 3 == 1 ? (int)(draw % 3) : (int)(draw % 70000);
+        testWeights[i] = weight;
+        testCents[i] = block == 4 ? 1999 : (int64_t)((draw >> 20) % (block % 2 == 0 ? 100 : 900000000));
+        testSeqs[i] = (uint32_t)((draw >> 40) % 5000000);
+    }
+}
+
+/*
+* FUNCTION      : testRowsDecodeToThemselves
+* DESCRIPTION   :
+*   This functoin packs the rows and checks each block decodes to its rows, each row decodes alone to
+*   a parcel of its own, and the packing is smaller than the plain columns, while no rows pack to none.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testRowsDecodeToThemselves(void)
+{
+    PackedColumns packed;
+    initPackedColumns(&packed);
+    packParcelColumns(&packed, testWeights, testCents, testSeqs, PACKED_TEST_ROWS);
+    CHECK(packed.Count == PACKED_TEST_ROWS && packed.BlockCount == PACKED_TEST_ROWS / PACKED_BLOCK_ROWS + 1);
+    CHECK(packedBytes(&packed) < PACKED_TEST_ROWS * (sizeof(int) + sizeof(int64_t) + sizeof(uint32_t)));
+
+    bool same = true;
+    for (size_t b = 0; b < packed.BlockCount; ++b)
+    {
+        int weights[PACKED_BLOCK_ROWS];
+        int64_t cents[PACKED_BLOCK_ROWS];
+        uint32_t seqs[PACKED_BLOCK_ROWS];
+        size_t first = b * PACKED_BLOCK_ROWS;
+        size_t rows = packedBlockRows(&packed, b);
+        decodePackedBlock(&packed, b, weights, cents, seqs);
+        same = same && rows == (first + PACKED_BLOCK_ROWS <= PACKED_TEST_ROWS ? PACKED_BLOCK_ROWS : PACKED_TEST_ROWS - first)
+            && memcmp(weights, testWeights + first, rows * sizeof(int)) == 0
+            && memcmp(cents, testCents + first, rows * sizeof(int64_t)) == 0
+            && memcmp(seqs, testSeqs + first, rows * sizeof(uint32_t)) == 0;
+    }
+    CHECK(same);
+
+    same = true;
+    for (size_t r = 0; r < PACKED_TEST_ROWS; r += 7)
+    {
+        Parcel node;
+        Parcel* parcel = getPackedParcel(&packed, 5, r, &node);
+        same = same && parcel == &node && node.Weight == testWeights[r] && node.Cents == testCents[r]
+            && node.Seq == testSeqs[r] && node.Dest == 5 && node.Left == NULL && node.Count == 1;
+    }
+    CHECK(same);
+    freePackedColumns(&packed);
+
+    initPackedColumns(&packed);
+    packParcelColumns(&packed, testWeights, testCents, testSeqs, 0);
+    CHECK(packed.Count == 0 && packed.BlockCount == 0);
+    freePackedColumns(&packed);
+}
+
+/*
+* FUNCTION      : testRangeTotalsMatchScan
+* DESCRIPTION   :
+*   This functoin totals weight and value ranges that miss every block, cover them all, cover some
+*   whole and cut through others, and checks each against a plain scan of the rows.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testRangeTotalsMatchScan(void)
+{
+    PackedColumns packed;
+    initPackedColumns(&packed);
+    packParcelColumns(&packed, testWeights, testCents, testSeqs, PACKED_TEST_ROWS);
+    int lastWeight = testWeights[PACKED_TEST_ROWS - 1];
+    int weightRanges[7][2] = { { 0, 0 }, { 0, lastWeight }, { testWeights[300], testWeights[900] },
+        { testWeights[130] + 1, testWeights[1100] - 1 }, { testWeights[PACKED_BLOCK_ROWS * 2], testWeights[PACKED_BLOCK_ROWS * 6 - 1] - 1 },
+        { 5, 4 }, { lastWeight + 1, lastWeight + 9 } };
+    int64_t centsRanges[5][2] = { { 0, INT64_MAX }, { 1999, 1999 }, { 10, 90 }, { 50, 450000000 }, { -5, -1 } };
+
+    bool same = true;
+    for (int q = 0; q < 7; ++q)
+    {
+        RangeTotals totals;
+        int64_t count = 0;
+        int64_t weight = 0;
+        int64_t cents = 0;
+        for (int i = 0; i < PACKED_TEST_ROWS; ++i)
+        {
+            if (testWeights[i] >= weightRanges[q][0] && testWeights[i] <= weightRanges[q][1])
+            {
+                count++;
+                weight += testWeights[i];
+                cents += testCents[i];
+            }
+        }
+        sumPackedWeightRange(&packed, weightRanges[q][0], weightRanges[q][1], &totals);
+        same = same && totals.Count == count && totals.TotalWeight == weight && totals.TotalCents == cents;
+    }
+    CHECK(same);
+
+    same = true;
+    for (int q = 0; q < 5; ++q)
+    {
+        ColumnTotals totals;
+        ColumnTotals expected = { 0, 0, 0, INT64_MAX, INT64_MIN };
+        for (int i = 0; i < PACKED_TEST_ROWS; ++i)
+        {
+            if (testCents[i] >= centsRanges[q][0] && testCents[i] <= centsRanges[q][1])
+            {
+                expected.Count++;
+                expected.TotalWeight += testWeights[i];
+                expected.TotalCents += testCents[i];
+                expected.MinCents = testCents[i] < expected.MinCents ? testCents[i] : expected.MinCents;
+                expected.MaxCents = testCents[i] > expected.MaxCents ? testCents[i] : expected.MaxCents;
+            }
+        }
+        scanPackedValueRange(&packed, centsRanges[q][0], centsRanges[q][1], &totals);
+        same = same && totals.Count == expected.Count && totals.TotalWeight == expected.TotalWeight
+            && totals.TotalCents == expected.TotalCents && totals.MinCents == expected.MinCents
+            && totals.MaxCents == expected.MaxCents;
+    }
+    CHECK(same);
+    freePackedColumns(&packed);
+}
@@ -0,0 +1,608 @@
+/*
+* FILENAME      : parcelTests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file checks the per-destination weight tree: whatever order the parcels arrive in, the tree
+*   must stay an AVL tree whose in-order walk meets them lightest first, and parcels of equal weight
+*   in the order they arrived. The value index over the same nodes must do the same by value, and the
+*   columnar copy of the tree must scan to the same totals as its rows.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include "columns.h"
+#include "tests.h"
+
+#define PARCEL_TEST_COUNT   4096
+
+static int checkWeightNode(Parcel* node, Parcel** previous, size_t* count);
+static int checkValueNode(Parcel* node, Parcel** previous, size_t* count);
+static void testSortedInsertStaysBalanced(void);
+static void testRandomInsertKeepsOrder(void);
+static void testEqualWeightsKeepArrivalOrder(void);
+static void testValueIndexOrdersByValue(void);
+static void testOrderStatisticsMatchWalk(void);
+static void testColumnScanMatchesRows(void);
+static void testCursorMatchesWalks(void);
+
+/*
+* FUNCTION      : runParcelTests
+* DESCRIPTION   : This functoin runs the checks of the weight tree.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+void runParcelTests(void)
+{
+    testSortedInsertStaysBalanced();
+    testRandomInsertKeepsOrder();
+    testEqualWeightsKeepArrivalOrder();
+    testValueIndexOrdersByValue();
+    testOrderStatisticsMatchWalk();
+    testColumnScanMatchesRows();
+    testCursorMatchesWalks();
+}
+
+/*
+* FUNCTION      : checkWeightTree
+* DESCRIPTION   :
+*   This functoin checks the invariants of a weight tree: every node's height is one more than its
+*   taller child's, the heights of its two children differ by one at most, and an in-order walk meets
+*   the parcels in ascending order of (Weight, Seq). Every node's count, weight and value totals
+*   must add up over its subtree.
+* PARAMETERS    :
+*   Parcel* root    :   the tree to check.
+* RETURNS       :
+*   size_t  : the number of parcels in the tree.
+*/
+size_t checkWeightTree(Parcel* root)
+{
+    Parcel* previous = NULL;
+    size_t count = 0;
+    checkWeightNode(root, &previous, &count);
+    return count;
+}
+
+/*
+* FUNCTION      : checkValueTree
+* DESCRIPTION   :
+*   This functoin checks the invariants of a value index, the counterpart of checkWeightTree over the
+*   VLeft/VRight links: it must be an AVL tree whose in-order walk meets the parcels in ascending order
+*   of (Cents, Seq).
+* PARAMETERS    :
+*   Parcel* root    :   the index to check.
+* RETURNS       :
+*   size_t  : the number of parcels in the index.
+*/
+size_t checkValueTree(Parcel* root)
+{
+    Parcel* previous = NULL;
+    size_t count = 0;
+    checkValueNode(root, &previous, &count);
+    return count;
+}
+
+/*
+* FUNCTION      : sameWeightOrder
+* DESCRIPTION   :
+*   This functoin walks two weight trees side by side and checks they hold the same parcels in the same
+*   order, with the same weight, value and arrival number each, whatever their shape.
+* PARAMETERS    :
+*   Parcel* first   :   one tree.
+*   Parcel* second  :   the other tree.
+* RETURNS       :
+*   bool    : true, if the in-order walks of the trees match. otherwise, false.
+*/
+bool sameWeightOrder(Parcel* first, Parcel* second)
+{
+    Parcel* firstStack[PARCEL_STACK_DEPTH];
+    Parcel* secondStack[PARCEL_STACK_DEPTH];
+    int firstTop = 0;
+    int secondTop = 0;
+    while (first != NULL || firstTop > 0 || second != NULL || secondTop > 0)
+    {
+        while (first != NULL)
+        {
+            firstStack[firstTop++] = first;
+            first = first->Left;
+        }
+        while (second != NULL)
+        {
+            secondStack[secondTop++] = second;
+            second = second->Left;
+        }
+        if (firstTop == 0 || secondTop == 0)
+        {
+            return false;
+        }
+        first = firstStack[--firstTop];
+        second = secondStack[--secondTop];
+        if (first->Weight != second->Weight || first->Cents != second->Cents || first->Seq != second->Seq)
+        {
+            return false;
+        }
+        first = first->Right;
+        second = second->Right;
+    }
+    return true;
+}
+
+/*
+* FUNCTION      : sameValueOrder
+* DESCRIPTION   :
+*   This functoin walks two value indexes side by side and tells whether they hold the same parcels in
+*   the same order.
+* PARAMETERS    :
+*   Parcel* first   :   the root of the first value index.
+*   Parcel* second  :   the root of the second value index.
+* RETURNS       :
+*   bool    : true, if the walks meet the same (Cents, Weight, Seq) one by one. otherwise, false.
+*/
+bool sameValueOrder(Parcel* first, Parcel* second)
+{
+    Parcel* firstStack[PARCEL_STACK_DEPTH];
+    Parcel* secondStack[PARCEL_STACK_DEPTH];
+    int firstTop = 0;
+    int secondTop = 0;
+    while (first != NULL || firstTop > 0 || second != NULL || secondTop > 0)
+    {
+        while (first != NULL)
+        {
+            firstStack[firstTop++] = first;
+            first = first->VLeft;
+        }
+        while (second != NULL)
+        {
+            secondStack[secondTop++] = second;
+            second = second->VLeft;
+        }
+        if (firstTop == 0 || secondTop == 0)
+        {
+            return false;
+        }
+        first = firstStack[--firstTop];
+        second = secondStack[--secondTop];
+        if (first->Cents != second->Cents || first->Weight != second->Weight || first->Seq != second->Seq)
+        {
+            return false;
+        }
+        first = first->VRight;
+        second = second->VRight;
+    }
+    return true;
+}
+
+/*
+* FUNCTION      : checkWeightNode
+* DESCRIPTION   : This functoin checks the subtree rooted at a node, see checkWeightTree.
+* PARAMETERS    :
+*   Parcel* node        :   the root of the subtree.
+*   Parcel** previous   :   the parcel the in-order walk met last, updated as the walk goes on.
+*   size_t* count       :   the parcels met so far, updated as the walk goes on.
+* RETURNS       :
+*   int     : the height of the subtree.
+*/
+static int checkWeightNode(Parcel* node, Parcel** previous, size_t* count)
+{
+    if (node == NULL)
+    {
+        return 0;
+    }
+    int left = checkWeightNode(node->Left, previous, count);
+    if (*previous != NULL)
+    {
+        CHECK((*previous)->Weight < node->Weight
+            || ((*previous)->Weight == node->Weight && (*previous)->Seq < node->Seq));
+    }
+    *previous = node;
+    (*count)++;
+    int right = checkWeightNode(node->Right, previous, count);
+
+    CHECK(left - right <= 1 && right - left <= 1);
+    CHECK(node->Height == 1 + (left > right ? left : right));
+
+    int nodes = 1;
+    int64_t sumWeight = node->Weight;
+    int64_t sumCents = node->Cents;
+    Parcel* children[2] = { node->Left, node->Right };
+    for (int i = 0; i < 2; ++i)
+    {
+        if (children[i] != NULL)
+        {
+            nodes += children[i]->Count;
+            sumWeight += children[i]->SumWeight;
+            sumCents += children[i]->SumCents;
+        }
+    }
+    CHECK(node->Count == nodes);
+    CHECK(node->SumWeight == sumWeight);
+    CHECK(node->SumCents == sumCents);
+    return node->Height;
+}
+
+/*
+* FUNCTION      : checkValueNode
+* DESCRIPTION   : This functoin checks the subtree of a value index rooted at a node, see checkValueTree.
+* PARAMETERS    :
+*   Parcel* node        :   the root of the subtree.
+*   Parcel** previous   :   the parcel the in-order walk met last, updated as the walk goes on.
+*   size_t* count       :   the parcels met so far, updated as the walk goes on.
+* RETURNS       :
+*   int     : the height of the subtree.
+*/
+static int checkValueNode(Parcel* node, Parcel** previous, size_t* count)
+{
+    if (node == NULL)
+    {
+        return 0;
+    }
+    int left = checkValueNode(node->VLeft, previous, count);
+    if (*previous != NULL)
+    {
+        CHECK((*previous)->Cents < node->Cents
+            || ((*previous)->Cents == node->Cents && (*previous)->Seq < node->Seq));
+    }
+    *previous = node;
+    (*count)++;
+    int right = checkValueNode(node->VRight, previous, count);
+
+    CHECK(left - right <= 1 && right - left <= 1);
+    CHECK(node->VHeight == 1 + (left > right ? left : right));
+    return node->VHeight;
+}
+
+/*
+* FUNCTION      : testSortedInsertStaysBalanced
+* DESCRIPTION   :
+*   This functoin inserts parcels that arrive sorted by weight, which would make a plain search tree a
+*   list, and checks the tree stays within the AVL height bound of 1.44 log2(n).
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testSortedInsertStaysBalanced(void)
+{
+    DestId dest = internDestName("Sorted", 6);
+    Arena arena;
+    Parcel* root = NULL;
+    initArena(&arena, ARENA_CHUNK_SIZE);
+    for (int weight = 1; weight <= PARCEL_TEST_COUNT; ++weight)
+    {
+        root = insertParcelToBST(root, createNewParcel(&arena, dest, weight, 100));
+    }
+
+    CHECK(checkWeightTree(root) == PARCEL_TEST_COUNT);
+    CHECK(root->Height <= 18);      // 1.44 * log2(4096 + 2)
+    CHECK(findMinWeight(root)->Weight == 1);
+    CHECK(findMaxWeight(root)->Weight == PARCEL_TEST_COUNT);
+    releaseArena(&arena);
+}
+
+/*
+* FUNCTION      : testRandomInsertKeepsOrder
+* DESCRIPTION   : This functoin inserts parcels of distinct weights in a shuffled order and checks the tree.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testRandomInsertKeepsOrder(void)
+{
+    DestId dest = internDestName("Shuffled", 8);
+    Arena arena;
+    int weights[PARCEL_TEST_COUNT];
+    uint64_t state = 2;
+    for (int i = 0; i < PARCEL_TEST_COUNT; ++i)
+    {
+        weights[i] = i + 1;
+    }
+    for (int i = PARCEL_TEST_COUNT - 1; i > 0; --i)
+    {
+        int j = (int)(testRandom(&state) % (uint64_t)(i + 1));
+        int swap = weights[i];
+        weights[i] = weights[j];
+        weights[j] = swap;
+    }
+
+    Parcel* root = NULL;
+    initArena(&arena, ARENA_CHUNK_SIZE);
+    for (int i = 0; i < PARCEL_TEST_COUNT; ++i)
+    {
+        Parcel* parcel = createNewParcel(&arena, dest, weights[i], (int64_t)i);
+        parcel->Seq = (unsigned int)i;
+        root = insertParcelToBST(root, parcel);
+        if (i % 512 == 0)
+        {
+            CHECK(checkWeightTree(root) == (size_t)i + 1);
+        }
+    }
+
+    CHECK(checkWeightTree(root) == PARCEL_TEST_COUNT);
+    releaseArena(&arena);
+}
+
+/*
+* FUNCTION      : testEqualWeightsKeepArrivalOrder
+* DESCRIPTION   :
+*   This functoin inserts many parcels over a few weights and checks every one of them is kept, with
+*   the parcels of each weight in the order they arrived.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testEqualWeightsKeepArrivalOrder(void)
+{
+    DestId dest = internDestName("Ties", 4);
+    Arena arena;
+    uint64_t state = 3;
+    Parcel* root = NULL;
+    initArena(&arena, ARENA_CHUNK_SIZE);
+    for (int i = 0; i < PARCEL_TEST_COUNT; ++i)
+    {
+        int weight = 1 + (int)(testRandom(&state) % 16);
+        Parcel* parcel = createNewParcel(&arena, dest, weight, (int64_t)i);
+        parcel->Seq = (unsigned int)i;
+        root = insertParcelToBST(root, parcel);
+    }
+
+    CHECK(checkWeightTree(root) == PARCEL_TEST_COUNT);
+    CHECK(findMinWeight(root)->Weight == 1);
+    CHECK(findMaxWeight(root)->Weight == 16);
+    releaseArena(&arena);
+}
+
+/*
+* FUNCTION      : testValueIndexOrdersByValue
+* DESCRIPTION   :
+*   This functoin links parcels with many equal values into both trees and checks the value index is
+*   balanced and ordered by value, then arrival, and that its ends are the cheapest parcel to arrive
+*   first and the most expensive parcel to arrive last.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testValueIndexOrdersByValue(void)
+{
+    DestId dest = internDestName("Values", 6);
+    Arena arena;
+    uint64_t state = 8;
+    Parcel* root = NULL;
+    Parcel* valueRoot = NULL;
+    Parcel* cheapest = NULL;
+    Parcel* mostExpensive = NULL;
+    initArena(&arena, ARENA_CHUNK_SIZE);
+    for (int i = 0; i < PARCEL_TEST_COUNT; ++i)
+    {
+        Parcel* parcel = createNewParcel(&arena, dest, (int)(testRandom(&state) % 1000), (int64_t)(testRandom(&state) % 64) * 25);
+        parcel->Seq = (unsigned int)i;
+        root = insertParcelToBST(root, parcel);
+        valueRoot = insertParcelToValueBST(valueRoot, parcel);
+        cheapest = cheapest == NULL || parcel->Cents < cheapest->Cents ? parcel : cheapest;
+        mostExpensive = mostExpensive == NULL || parcel->Cents >= mostExpensive->Cents ? parcel : mostExpensive;
+    }
+
+    CHECK(checkWeightTree(root) == PARCEL_TEST_COUNT);
+    CHECK(checkValueTree(valueRoot) == PARCEL_TEST_COUNT);
+    CHECK(findCheapestParcel(valueRoot) == cheapest);
+    CHECK(findMostExpensiveParcel(valueRoot) == mostExpensive);
+    releaseArena(&arena);
+}
+
+/*
+* FUNCTION      : testOrderStatisticsMatchWalk
+* DESCRIPTION   :
+*   This functoin checks the queries answered from the subtree totals against a plain count over the
+*   same parcels: range totals and ranks for every weight, and the k-th lightest for every rank.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testOrderStatisticsMatchWalk(void)
+{
+    DestId dest = internDestName("Totals", 6);
+    Arena arena;
+    uint64_t state = 9;
+    int weights[PARCEL_TEST_COUNT];
+    int64_t cents[PARCEL_TEST_COUNT];
+    Parcel* root = NULL;
+    initArena(&arena, ARENA_CHUNK_SIZE);
+    for (int i = 0; i < PARCEL_TEST_COUNT; ++i)
+    {
+        weights[i] = (int)(testRandom(&state) % 300);
+        cents[i] = (int64_t)(testRandom(&state) % 100000000);
+        Parcel* parcel = createNewParcel(&arena, dest, weights[i], cents[i]);
+        parcel->Seq = (unsigned int)i;
+        root = insertParcelToBST(root, parcel);
+    }
+    CHECK(checkWeightTree(root) == PARCEL_TEST_COUNT);
+
+    for (int low = -1; low <= 300; low += 7)
+    {
+        int high = low + (int)(testRandom(&state) % 60);
+        RangeTotals expected = {};
+        int64_t lighter = 0;
+        for (int i = 0; i < PARCEL_TEST_COUNT; ++i)
+        {
+            lighter += weights[i] < low ? 1 : 0;
+            if (weights[i] >= low && weights[i] <= high)
+            {
+                expected.Count++;
+                expected.TotalWeight += weights[i];
+                expected.TotalCents += cents[i];
+            }
+        }
+        RangeTotals totals;
+        sumOfWeightRange(root, low, high, &totals);
+        CHECK(totals.Count == expected.Count);
+        CHECK(totals.TotalWeight == expected.TotalWeight);
+        CHECK(totals.TotalCents == expected.TotalCents);
+        CHECK(rankOfWeight(root, low) == lighter);
+    }
+
+    Parcel* previous = NULL;
+    for (int64_t k = 1; k <= PARCEL_TEST_COUNT; ++k)
+    {
+        Parcel* kth = findKthLightest(root, k);
+        CHECK(kth != NULL);
+        if (kth != NULL && previous != NULL)
+        {
+            CHECK(previous->Weight < kth->Weight || (previous->Weight == kth->Weight && previous->Seq < kth->Seq));
+        }
+        previous = kth;
+    }
+    CHECK(findKthLightest(root, 0) == NULL);
+    CHECK(findKthLightest(root, PARCEL_TEST_COUNT + 1) == NULL);
+    releaseArena(&arena);
+}
+
+/*
+* FUNCTION      : testColumnScanMatchesRows
+* DESCRIPTION   :
+*   This functoin builds the columns of a tree and checks they hold its in-order walk, then checks
+*   value scans over many row ranges, odd lengths included so the kernels' tails run, against plain
+*   totals of the same rows.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testColumnScanMatchesRows(void)
+{
+    DestId dest = internDestName("Columns", 7);
+    Arena arena;
+    ParcelColumns columns;
+    uint64_t state = 10;
+    Parcel* root = NULL;
+    initArena(&arena, ARENA_CHUNK_SIZE);
+    initParcelColumns(&columns);
+    for (int i = 0; i < PARCEL_TEST_COUNT; ++i)
+    {
+        Parcel* parcel = createNewParcel(&arena, dest, (int)(testRandom(&state) % 2000), (int64_t)(testRandom(&state) % 500000));
+        parcel->Seq = (unsigned int)i;
+        root = insertParcelToBST(root, parcel);
+    }
+    buildParcelColumns(&columns, root, PARCEL_TEST_COUNT);
+    CHECK(columns.Count == PARCEL_TEST_COUNT);
+    CHECK(columns.Rows[0] == findMinWeight(root));
+    for (size_t row = 1; row < columns.Count; ++row)
+    {
+        Parcel* previous = columns.Rows[row - 1];
+        Parcel* current = columns.Rows[row];
+        CHECK(columns.Weights[row] == current->Weight && columns.Cents[row] == current->Cents);
+        CHECK(previous->Weight < current->Weight || (previous->Weight == current->Weight && previous->Seq < current->Seq));
+    }
+    CHECK(lowerBoundWeight(&columns, 1000) == (size_t)rankOfWeight(root, 1000));
+    CHECK(upperBoundWeight(&columns, 1000) == (size_t)rankOfWeight(root, 1001));
+
+    for (int round = 0; round < 200; ++round)
+    {
+        size_t begin = (size_t)(testRandom(&state) % columns.Count);
+        size_t end = begin + (size_t)(testRandom(&state) % (columns.Count - begin + 1));
+        int64_t minCents = (int64_t)(testRandom(&state) % 500000);
+        int64_t maxCents = minCents + (int64_t)(testRandom(&state) % 250000);
+        ColumnTotals expected = { 0, 0, 0, INT64_MAX, INT64_MIN };
+        for (size_t row = begin; row < end; ++row)
+        {
+            if (columns.Cents[row] >= minCents && columns.Cents[row] <= maxCents)
+            {
+                expected.Count++;
+                expected.TotalWeight += columns.Weights[row];
+                expected.TotalCents += columns.Cents[row];
+                expected.MinCents = columns.Cents[row] < expected.MinCents ? columns.Cents[row] : expected.MinCents;
+                expected.MaxCents = columns.Cents[row] > expected.MaxCents ? columns.Cents[row] : expected.MaxCents;
+            }
+        }
+        ColumnTotals totals;
+        scanValueRange(&columns, begin, end, minCents, maxCents, &totals);
+        CHECK(totals.Count == expected.Count);
+        CHECK(totals.TotalWeight == expected.TotalWeight);
+        CHECK(totals.TotalCents == expected.TotalCents);
+        CHECK(totals.MinCents == expected.MinCents);
+        CHECK(totals.MaxCents == expected.MaxCents);
+    }
+    freeParcelColumns(&columns);
+    releaseArena(&arena);
+}
+
+/*
+* FUNCTION      : testCursorMatchesWalks
+* DESCRIPTION   :
+*   This functoin walks both trees of a set of parcels with many equal keys by cursor, forwards and
+*   backwards, and checks every seek against the same parcels sorted by brute force: the first at
+*   least a key, the last at most a key and every rank, then steps on from each to check the path
+*   the seek left behind.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testCursorMatchesWalks(void)
+{
+    DestId dest = internDestName("Cursor", 6);
+    Arena arena;
+    uint64_t state = 20;
+    Parcel* sorted[2][PARCEL_TEST_COUNT];
+    Parcel* roots[2] = { NULL, NULL };
+    initArena(&arena, ARENA_CHUNK_SIZE);
+    for (int i = 0; i < PARCEL_TEST_COUNT; ++i)
+    {
+        Parcel* parcel = createNewParcel(&arena, dest, (int)(testRandom(&state) % 400), (int64_t)(testRandom(&state) % 400));
+        parcel->Seq = (unsigned int)i;
+        roots[CURSOR_BY_WEIGHT] = insertParcelToBST(roots[CURSOR_BY_WEIGHT], parcel);
+        roots[CURSOR_BY_VALUE] = insertParcelToValueBST(roots[CURSOR_BY_VALUE], parcel);
+        // insertion sort on (key, Seq); every new parcel arrives last, so it goes after its equals
+        for (int index = 0; index < 2; ++index)
+        {
+            int64_t key = index == CURSOR_BY_WEIGHT ? parcel->Weight : parcel->Cents;
+            int at = i;
+            while (at > 0 && (index == CURSOR_BY_WEIGHT ? sorted[index][at - 1]->Weight : sorted[index][at - 1]->Cents) > key)
+            {
+                sorted[index][at] = sorted[index][at - 1];
+                at--;
+            }
+            sorted[index][at] = parcel;
+        }
+    }
+
+    for (int index = 0; index < 2; ++index)
+    {
+        ParcelCursor cursor;
+        bool same = true;
+        int row = 0;
+        initParcelCursor(&cursor, roots[index], (CursorIndex)index);
+        for (Parcel* parcel = seekFirstParcel(&cursor); parcel != NULL; parcel = nextParcel(&cursor))
+        {
+            same = same && row < PARCEL_TEST_COUNT && parcel == sorted[index][row++];
+        }
+        CHECK(same && row == PARCEL_TEST_COUNT);
+        for (Parcel* parcel = seekLastParcel(&cursor); parcel != NULL; parcel = prevParcel(&cursor))
+        {
+            same = same && row > 0 && parcel == sorted[index][--row];
+        }
+        CHECK(same && row == 0);
+
+        for (int64_t key = -1; key <= 401; ++key)
+        {
+            int first = 0;
+            while (first < PARCEL_TEST_COUNT
+                && (index == CURSOR_BY_WEIGHT ? sorted[index][first]->Weight : sorted[index][first]->Cents) < key)
+            {
+                first++;
+            }
+            int last = first;
+            while (last < PARCEL_TEST_COUNT
+                && (index == CURSOR_BY_WEIGHT ? sorted[index][last]->Weight : sorted[index][last]->Cents) <= key)
+            {
+                last++;
+            }
+            Parcel* atLeast = seekParcelAtLeast(&cursor, key);
+            same = same && atLeast == (first < PARCEL_TEST_COUNT ? sorted[index][first] : NULL);
+            same = same && (first + 1 >= PARCEL_TEST_COUNT || nextParcel(&cursor) == sorted[index][first + 1]);
+            Parcel* atMost = seekParcelAtMost(&cursor, key);
+            same = same && atMost == (last > 0 ? sorted[index][last - 1] : NULL);
+            same = same && (last < 2 || prevParcel(&cursor) == sorted[index][last - 2]);
+        }
+        CHECK(same);
+
+        for (int rank = 0; rank <= PARCEL_TEST_COUNT; rank += 37)
+        {
+            Parcel* parcel = seekParcelRank(&cursor, rank);
+            same = same && parcel == (rank < PARCEL_TEST_COUNT ? sorted[index][rank] : NULL);
+            same = same && (rank + 1 >= PARCEL_TEST_COUNT || nextParcel(&cursor) == sorted[index][rank + 1]);
+        }
+        CHECK(same);
+    }
+    releaseArena(&arena);
+}
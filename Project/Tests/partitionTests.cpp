@@ -0,0 +1,241 @@
+/*
+* FILENAME      : partitionTests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file checks partitioned storage: every query over the partitions in scope must answer what
+*   it answers over one index loaded from their files in order, ties included, whether a partition or
+*   destination is skipped by its zone map, summed from its totals or walked, and after expiry. Packed
+*   partitions are held to the same answers, so they answer exactly as plain ones do.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests.h"
+#include "loader.h"
+#include "partition.h"
+#include "query.h"
+
+#define PARTITION_TEST_SHIFTS   3
+#define PARTITION_TEST_LINES    1500
+
+static const char* const shiftFiles[PARTITION_TEST_SHIFTS] = { "partitionTests1.tmp", "partitionTests2.tmp", "partitionTests3.tmp" };
+
+// queries over every kind of answer, with ranges below, inside, across and above the zones of the shifts
+static const char* const partitionQueries[] =
+{
+    "list Stop 3", "split Stop 4 250", "heavier Stop 5 900", "lighter Stop 6 120", "lighter Stop 6 0",
+    "range Stop 7 100 400", "range Stop 7 2000 3000", "rangesum Stop 8 0 5000", "rangesum Stop 8 300 600",
+    "rangesum Stop 8 700 650", "totals Stop 9", "minmax Stop 10", "cheapest Stop 11", "values Stop 12 2.00 9.99",
+    "values Stop 12 500 600", "valuesum Stop 13 0 1000", "valuesum Stop 13 3.50 7.25", "top Stop 14 12",
+    "percentile Stop 15 50", "percentile Stop 15 100", "list stop  16", "list Nowhere", "heaviest 40", "lightest 40",
+    "valuable 40", "ranking 10", "network", "complete Stop 1",
+};
+
+static bool writeShift(const char* path, uint64_t seed, int firstStop);
+static void loadOneIndex(DestTable* table, int firstShift);
+static bool sameAnswers(DestTable* table, PartitionSet* set, const char* scope);
+static void testPartitionsMatchOneIndex(bool compressed);
+static void testRecentAndExpiredMatchOneIndex(bool compressed);
+
+/*
+* FUNCTION      : runPartitionTests
+* DESCRIPTION   : This functoin runs the checks of partitioned storage.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+void runPartitionTests(void)
+{
+    bool written = true;
+    for (int s = 0; s < PARTITION_TEST_SHIFTS; ++s)
+    {
+        written = writeShift(shiftFiles[s], 31 + (uint64_t)s, s * 4) && written;
+    }
+    if (CHECK(written))
+    {
+        testPartitionsMatchOneIndex(false);
+        testPartitionsMatchOneIndex(true);
+        testRecentAndExpiredMatchOneIndex(false);
+        testRecentAndExpiredMatchOneIndex(true);
+    }
+    for (int s = 0; s < PARTITION_TEST_SHIFTS; ++s)
+    {
+        remove(shiftFiles[s]);
+    }
+}
+
+/*
+* FUNCTION      : writeShift
+* DESCRIPTION   :
+*   This functoin writes the courier file of one shift. Each shift reaches a window of destinations of
+*   its own, overlapping the next, and heavier parcels than the shift before, so zone maps really part
+*   them; weights and values repeat so ties have to come out in the order they were loaded.
+* PARAMETERS    :
+*   const char* path    :   the file to write.
+*   uint64_t seed       :   the seed of the shift's parcels.
+*   int firstStop       :   the lowest destination number of the shift.
+* RETURNS       :
+*   bool    : true, if the file was written. otherwise, false.
+*/
+static bool writeShift(const char* path, uint64_t seed, int firstStop)
+{
+    FILE* file = fopen(path, "wb");
+    uint64_t state = seed;
+    if (file == NULL)
+    {
+        return false;
+    }
+    for (int i = 0; i < PARTITION_TEST_LINES; ++i)
+    {
+        uint64_t draw = testRandom(&state);
+        fprintf(file, "Stop %d, %d, %d.%02d\n", firstStop + (int)(draw % 10), firstStop * 100 + (int)((draw >> 8) % 60) * 10,
+            (int)((draw >> 20) % 12), (int)((draw >> 32) % 4) * 25);
+    }
+    return fclose(file) == 0;
+}
+
+/*
+* FUNCTION      : loadOneIndex
+* DESCRIPTION   : This functoin loads the shifts from a given one on, in order, into one index.
+* PARAMETERS    :
+*   DestTable* table    :   an empty destination index.
+*   int firstShift      :   the first shift to load.
+* RETURNS       : void
+*/
+static void loadOneIndex(DestTable* table, int firstShift)
+{
+    for (int s = firstShift; s < PARTITION_TEST_SHIFTS; ++s)
+    {
+        LoadResult result = {};
+        CHECK(loadParcelsFromFile(table, shiftFiles[s], &result));
+    }
+}
+
+/*
+* FUNCTION      : sameAnswers
+* DESCRIPTION   :
+*   This functoin asks every test query of one index and of the partitions, and tells whether each was
+*   answered alike, all the output after the echo of the query.
+* PARAMETERS    :
+*   DestTable* table    :   the index.
+*   PartitionSet* set   :   the partitions.
+*   const char* scope   :   what to append to every partition query, such as " last 2", or "".
+* RETURNS       :
+*   bool    : true, if every answer was the same. otherwise, false.
+*/
+static bool sameAnswers(DestTable* table, PartitionSet* set, const char* scope)
+{
+    bool same = true;
+    for (size_t q = 0; q < sizeof(partitionQueries) / sizeof(partitionQueries[0]); ++q)
+    {
+        char line[128];
+        OutBuf expected;
+        OutBuf out;
+        sprintf(line, "%s%s", partitionQueries[q], scope);
+        initOutBuf(&expected, NULL);
+        initOutBuf(&out, NULL);
+        bool answered = executeQuery(table, partitionQueries[q], &expected);
+        bool answeredAlike = executePartitionQuery(set, line, &out) == answered;
+        // past the echo of the query, which carries the scope
+        const char* answer = (const char*)memchr(out.Data, '\n', out.Length);
+        const char* expectedAnswer = (const char*)memchr(expected.Data, '\n', expected.Length);
+        size_t length = answer == NULL ? 0 : out.Length - (size_t)(answer - out.Data);
+        size_t expectedLength = expectedAnswer == NULL ? 0 : expected.Length - (size_t)(expectedAnswer - expected.Data);
+        if (!answeredAlike || answer == NULL || length != expectedLength || memcmp(answer, expectedAnswer, length) != 0)
+        {
+            printf("  differs: %s\n", line);
+            same = false;
+        }
+        freeOutBuf(&out);
+        freeOutBuf(&expected);
+    }
+    return same;
+}
+
+/*
+* FUNCTION      : testPartitionsMatchOneIndex
+* DESCRIPTION   :
+*   This functoin loads every shift as a partition and all of them into one index, and checks every
+*   query answers alike, the partition list and its zone maps being what the shifts hold.
+* PARAMETERS    :
+*   bool compressed :   whether the partitions are packed.
+* RETURNS       :  void
+*/
+static void testPartitionsMatchOneIndex(bool compressed)
+{
+    DestTable table;
+    PartitionSet set;
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+    initPartitionSet(&set);
+    set.Compressed = compressed;
+    loadOneIndex(&table, 0);
+    for (int s = 0; s < PARTITION_TEST_SHIFTS; ++s)
+    {
+        LoadResult result = {};
+        CHECK(addPartitionFromFile(&set, shiftFiles[s], &result) != NULL);
+        CHECK(result.Loaded == PARTITION_TEST_LINES);
+    }
+
+    CHECK(set.Count == PARTITION_TEST_SHIFTS && set.Oldest->Number == 1 && set.Newest->Number == PARTITION_TEST_SHIFTS);
+    int64_t parcels = 0;
+    bool zoned = true;
+    bool stored = true;
+    for (Partition* partition = set.Oldest; partition != NULL; partition = partition->Newer)
+    {
+        int base = (int)(partition->Number - 1) * 400;
+        parcels += partition->Zone.Count;
+        zoned = zoned && partition->Zone.MinWeight >= base && partition->Zone.MaxWeight <= base + 590;
+        for (size_t s = 0; s < partition->Table.Capacity; ++s)
+        {
+            Destination* dest = partition->Table.Slots[s].Dest;
+            stored = stored && (dest == NULL || (compressed ? dest->Root == NULL && dest->Packed.Count == (size_t)dest->Summary.Count
+                : dest->Root != NULL && dest->Packed.Count == 0));
+        }
+    }
+    CHECK(parcels == (int64_t)PARTITION_TEST_SHIFTS * PARTITION_TEST_LINES);
+    CHECK(zoned);
+    CHECK(stored);
+    CHECK(sameAnswers(&table, &set, ""));
+    CHECK(sameAnswers(&table, &set, " last 3"));
+
+    deletePartitionSet(&set);
+    deleteDestTable(&table);
+}
+
+/*
+* FUNCTION      : testRecentAndExpiredMatchOneIndex
+* DESCRIPTION   :
+*   This functoin checks queries over the newest shifts only answer as one index of those shifts does,
+*   and so do queries over every partition once the oldest has been expired.
+* PARAMETERS    :
+*   bool compressed :   whether the partitions are packed.
+* RETURNS       :  void
+*/
+static void testRecentAndExpiredMatchOneIndex(bool compressed)
+{
+    DestTable table;
+    PartitionSet set;
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+    initPartitionSet(&set);
+    set.Compressed = compressed;
+    loadOneIndex(&table, 1);
+    for (int s = 0; s < PARTITION_TEST_SHIFTS; ++s)
+    {
+        LoadResult result = {};
+        addPartitionFromFile(&set, shiftFiles[s], &result);
+    }
+
+    CHECK(sameAnswers(&table, &set, " last 2"));
+    CHECK(expireOldestPartition(&set));
+    CHECK(set.Count == PARTITION_TEST_SHIFTS - 1 && set.Oldest->Number == 2 && set.Oldest->Older == NULL);
+    CHECK(sameAnswers(&table, &set, ""));
+    CHECK(expireOldestPartition(&set) && expireOldestPartition(&set));
+    CHECK(!expireOldestPartition(&set));
+    CHECK(set.Oldest == NULL && set.Newest == NULL && set.Count == 0);
+
+    deletePartitionSet(&set);
+    deleteDestTable(&table);
+}
@@ -0,0 +1,234 @@
+/*
+* FILENAME      : snapshotTests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file checks the binary snapshot: an index saved and loaded again must come back with the same
+*   destinations, parcels, orders and summaries, and a snapshot that is damaged or was taken from an
+*   older courier file must be turned down and leave the index empty.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests.h"
+#include "loader.h"
+#include "snapshot.h"
+
+#define SNAPSHOT_TEST_SOURCE    "snapshotTests.txt"
+#define SNAPSHOT_TEST_FILE      "snapshotTests.snap"
+#define SNAPSHOT_TEST_LINES     20000
+
+static bool sameSeq(Parcel* first, Parcel* second);
+static bool sameDestination(Destination* first, Destination* second);
+static bool writeSource(int lines);
+static void testRoundTripKeepsIndex(void);
+static void testDamagedSnapshotIsRejected(void);
+
+/*
+* FUNCTION      : runSnapshotTests
+* DESCRIPTION   : This functoin runs the checks of the binary snapshot.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+void runSnapshotTests(void)
+{
+    testRoundTripKeepsIndex();
+    testDamagedSnapshotIsRejected();
+    remove(SNAPSHOT_TEST_SOURCE);
+    remove(SNAPSHOT_TEST_FILE);
+}
+
+/*
+* FUNCTION      : sameSeq
+* DESCRIPTION   : This functoin tells whether two summary entries name the same parcel of their destinations.
+* PARAMETERS    :
+*   Parcel* first   :   an entry of the first summary, or NULL.
+*   Parcel* second  :   the same entry of the second summary, or NULL.
+* RETURNS       :
+*   bool    : true, if both are NULL or both are parcels of the same arrival. otherwise, false.
+*/
+static bool sameSeq(Parcel* first, Parcel* second)
+{
+    if (first == NULL || second == NULL)
+    {
+        return first == second;
+    }
+    return first->Seq == second->Seq;
+}
+
+/*
+* FUNCTION      : sameDestination
+* DESCRIPTION   :
+*   This functoin tells whether two destinations hold the same parcels in the same orders, with the
+*   same summary and the same sequence number for the next parcel.
+* PARAMETERS    :
+*   Destination* first  :   the first destination.
+*   Destination* second :   the second destination.
+* RETURNS       :
+*   bool    : true, if the two are the same. otherwise, false.
+*/
+static bool sameDestination(Destination* first, Destination* second)
+{
+    const DestSummary* a = &first->Summary;
+    const DestSummary* b = &second->Summary;
+    return first->NextSeq == second->NextSeq
+        && a->Count == b->Count && a->TotalWeight == b->TotalWeight && a->TotalCents == b->TotalCents
+        && sameSeq(a->Lightest, b->Lightest) && sameSeq(a->Heaviest, b->Heaviest)
+        && sameSeq(a->Cheapest, b->Cheapest) && sameSeq(a->MostExpensive, b->MostExpensive)
+        && sameWeightOrder(first->Root, second->Root) && sameValueOrder(first->ValueRoot, second->ValueRoot)
+        && checkWeightTree(second->Root) == (size_t)b->Count && checkValueTree(second->ValueRoot) == (size_t)b->Count;
+}
+
+/*
+* FUNCTION      : writeSource
+* DESCRIPTION   :
+*   This functoin writes a courier file of random parcels over a few dozen destinations, with repeated
+*   weights and values so ties have to be kept in arrival order.
+* PARAMETERS    :
+*   int lines   :   the number of parcels to write.
+* RETURNS       :
+*   bool    : true, if the file was written. otherwise, false.
+*/
+static bool writeSource(int lines)
+{
+    FILE* file = fopen(SNAPSHOT_TEST_SOURCE, "wb");
+    uint64_t state = 12;
+    if (file == NULL)
+    {
+        return false;
+    }
+    for (int i = 0; i < lines; ++i)
+    {
+        uint64_t draw = testRandom(&state);
+        fprintf(file, "Place %d, %d, %d.%02d\n", (int)(draw % 37), (int)((draw >> 8) % 500),
+            (int)((draw >> 20) % 2000), (int)((draw >> 32) % 100));
+    }
+    return fclose(file) == 0;
+}
+
+/*
+* FUNCTION      : testRoundTripKeepsIndex
+* DESCRIPTION   :
+*   This functoin loads a courier file, saves its index as a snapshot, loads the snapshot into a fresh
+*   index and checks every destination came back the same and still answers from its columns.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testRoundTripKeepsIndex(void)
+{
+    DestTable loaded;
+    DestTable restored;
+    LoadResult result = {};
+    if (!CHECK(writeSource(SNAPSHOT_TEST_LINES)))
+    {
+        return;
+    }
+    initDestTable(&loaded, DEST_TABLE_INITIAL_SIZE);
+    initDestTable(&restored, DEST_TABLE_INITIAL_SIZE);
+    CHECK(loadParcelsFromFile(&loaded, SNAPSHOT_TEST_SOURCE, &result));
+    CHECK(result.Loaded == SNAPSHOT_TEST_LINES);
+    CHECK(saveSnapshot(&loaded, SNAPSHOT_TEST_FILE, SNAPSHOT_TEST_SOURCE));
+    CHECK(loadSnapshot(&restored, SNAPSHOT_TEST_FILE, SNAPSHOT_TEST_SOURCE));
+
+    CHECK(restored.Count == loaded.Count);
+    bool same = true;
+    for (size_t i = 0; i < loaded.Capacity; ++i)
+    {
+        Destination* dest = loaded.Slots[i].Dest;
+        if (dest != NULL)
+        {
+            Destination* other = findDestination(&restored, dest->Name, dest->NameLen);
+            same = same && other != NULL && sameDestination(dest, other);
+            if (other != NULL)
+            {
+                ParcelColumns* columns = getDestColumns(other);
+                same = same && columns->Count == (size_t)other->Summary.Count
+                    && columns->Rows[0] == findMinWeight(other->Root);
+            }
+        }
+    }
+    CHECK(same);
+
+    deleteDestTable(&restored);
+    deleteDestTable(&loaded);
+}
+
+/*
+* FUNCTION      : testDamagedSnapshotIsRejected
+* DESCRIPTION   :
+*   This functoin damages a good snapshot one way at a time, a flipped payload byte, a cut-off tail and
+*   a courier file that has grown since, and checks each is turned down with the index left empty.
+* PARAMETERS    :  void
+* RETURNS       :  void
+*/
+static void testDamagedSnapshotIsRejected(void)
+{
+    DestTable table;
+    LoadResult result = {};
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+    if (!CHECK(writeSource(SNAPSHOT_TEST_LINES / 10)) || !CHECK(loadParcelsFromFile(&table, SNAPSHOT_TEST_SOURCE, &result))
+        || !CHECK(saveSnapshot(&table, SNAPSHOT_TEST_FILE, SNAPSHOT_TEST_SOURCE)))
+    {
+        deleteDestTable(&table);
+        return;
+    }
+    deleteDestTable(&table);
+
+    FILE* file = fopen(SNAPSHOT_TEST_FILE, "rb");
+    if (!CHECK(file != NULL))
+    {
+        return;
+    }
+    fseek(file, 0, SEEK_END);
+    size_t size = (size_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* bytes = (char*)malloc(size);
+    if (!CHECK(bytes != NULL && fread(bytes, 1, size, file) == size))
+    {
+        fclose(file);
+        free(bytes);
+        return;
+    }
+    fclose(file);
+
+    size_t damages[3] = { sizeof(SnapshotHeader) + 1, size / 2, size - 1 };
+    for (int i = 0; i < 3; ++i)
+    {
+        bytes[damages[i]] ^= 0x20;
+        file = fopen(SNAPSHOT_TEST_FILE, "wb");
+        fwrite(bytes, 1, size, file);
+        fclose(file);
+        bytes[damages[i]] ^= 0x20;
+        initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+        CHECK(!loadSnapshot(&table, SNAPSHOT_TEST_FILE, SNAPSHOT_TEST_SOURCE));
+        CHECK(table.Count == 0);
+        deleteDestTable(&table);
+    }
+
+    file = fopen(SNAPSHOT_TEST_FILE, "wb");
+    fwrite(bytes, 1, size - 8, file);
+    fclose(file);
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+    CHECK(!loadSnapshot(&table, SNAPSHOT_TEST_FILE, SNAPSHOT_TEST_SOURCE));
+    CHECK(table.Count == 0);
+    deleteDestTable(&table);
+
+    file = fopen(SNAPSHOT_TEST_FILE, "wb");
+    fwrite(bytes, 1, size, file);
+    fclose(file);
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+    CHECK(loadSnapshot(&table, SNAPSHOT_TEST_FILE, SNAPSHOT_TEST_SOURCE));
+    deleteDestTable(&table);
+
+    file = fopen(SNAPSHOT_TEST_SOURCE, "ab");
+    fprintf(file, "Place 0, 1, 1.00\n");
+    fclose(file);
+    initDestTable(&table, DEST_TABLE_INITIAL_SIZE);
+    CHECK(!loadSnapshot(&table, SNAPSHOT_TEST_FILE, SNAPSHOT_TEST_SOURCE));
+    CHECK(table.Count == 0);
+    deleteDestTable(&table);
+    free(bytes);
+}
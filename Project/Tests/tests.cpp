@@ -0,0 +1,100 @@
+/*
+* FILENAME      : tests.cpp
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file holds the entry point of the test program, which runs every suite and reports how many
+*   checks failed, and the helpers the suites share.
+*/
+
+#pragma warning (disable : 4996)
+#include <stdio.h>
+#include <stdlib.h>
+#include "tests.h"
+#include "threadPool.h"
+
+static int checksRun = 0;
+static int checksFailed = 0;
+
+static void runSuite(const char* name, void (*suite)(void));
+
+int main(void)
+{
+    initThreadPool(4);     // workers of their own even on one core, so the parallel paths really run in parallel
+    runSuite("arena", runArenaTests);
+    runSuite("parcel", runParcelTests);
+    runSuite("destTable", runDestTableTests);
+    runSuite("loader", runLoaderTests);
+    runSuite("snapshot", runSnapshotTests);
+    runSuite("follow", runFollowTests);
+    runSuite("concurrent", runConcurrentTests);
+    runSuite("bench", runBenchTests);
+    runSuite("global", runGlobalTests);
+    runSuite("dictionary", runDictionaryTests);
+    runSuite("packed", runPackedTests);
+    runSuite("partition", runPartitionTests);
+
+    stopThreadPool();
+
+    printf("%d checks, %d failed\n", checksRun, checksFailed);
+    return checksFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*
+* FUNCTION      : runSuite
+* DESCRIPTION   : This functoin runs one suite and reports how many of its checks failed.
+* PARAMETERS    :
+*   const char* name    :   the name of the suite, for the report.
+*   void (*suite)(void) :   the suite.
+* RETURNS       :  void
+*/
+static void runSuite(const char* name, void (*suite)(void))
+{
+    int failedBefore = checksFailed;
+    suite();
+    printf("%-12s %s\n", name, checksFailed == failedBefore ? "ok" : "FAILED");
+}
+
+/*
+* FUNCTION      : checkThat
+* DESCRIPTION   : This functoin counts a check and reports it if it failed, see CHECK in tests.h.
+* PARAMETERS    :
+*   bool passed         :   the outcome of the check.
+*   const char* text    :   the condition that was checked.
+*   const char* file    :   the file of the check.
+*   int line            :   the line of the check.
+* RETURNS       :
+*   bool    : passed, so a caller can stop when a check it depends on failed.
+*/
+bool checkThat(bool passed, const char* text, const char* file, int line)
+{
+    checksRun++;
+    if (!passed)
+    {
+        checksFailed++;
+        if (checksFailed <= TEST_MAX_REPORTED_FAILURES)
+        {
+            printf("**FAILED: %s (%s:%d)\n", text, file, line);
+        }
+    }
+    return passed;
+}
+
+/*
+* FUNCTION      : testRandom
+* DESCRIPTION   :
+*   This functoin returns the next number of a xorshift64* sequence, so every run of the tests sees
+*   the same data.
+* PARAMETERS    :
+*   uint64_t* state :   the state of the sequence, which must not be 0.
+* RETURNS       :
+*   uint64_t    : the next number.
+*/
+uint64_t testRandom(uint64_t* state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
@@ -0,0 +1,40 @@
+/*
+* FILENAME      : tests.h
+* PROJECT       : project
+* PROGRAMMER    : Zhizheng Dong
+* FIRST VERSION : 2026-10-18
+* DESCRIPTION	:
+*	This file declares the checks of the test program. Each suite is a function that runs its checks
+*   one after another; a failed check is reported with its file and line and the suite carries on, and
+*   the program fails if any check did.
+*/
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "parcel.h"
+
+#define TEST_MAX_REPORTED_FAILURES  20      // failed checks reported one by one before keeping count only
+
+// records a failed check with the line it is on
+#define CHECK(condition)    checkThat((condition), #condition, __FILE__, __LINE__)
+
+bool checkThat(bool passed, const char* text, const char* file, int line);
+uint64_t testRandom(uint64_t* state);
+size_t checkWeightTree(Parcel* root);
+size_t checkValueTree(Parcel* root);
+bool sameWeightOrder(Parcel* first, Parcel* second);
+bool sameValueOrder(Parcel* first, Parcel* second);
+// the suites
+void runArenaTests(void);
+void runBenchTests(void);
+void runConcurrentTests(void);
+void runDestTableTests(void);
+void runDictionaryTests(void);
+void runFollowTests(void);
+void runGlobalTests(void);
+void runLoaderTests(void);
+void runPackedTests(void);
+void runParcelTests(void);
+void runPartitionTests(void);
+void runSnapshotTests(void);